@@ -8,9 +8,16 @@
 #include "bench/Benchmark.h"
 #include "bench/BigPath.h"
 #include "include/core/SkCanvas.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkGraphics.h"
 #include "include/core/SkPath.h"
+#include "src/base/SkRandom.h"
+#include "src/core/SkScan.h"
 #include "tools/ToolUtils.h"
 
+#include <cmath>
+#include <memory>
+
 enum Align {
     kLeft_Align,
     kMiddle_Align,
@@ -83,3 +90,117 @@ DEF_BENCH( return new BigPathBench(kRight_Align,    false); )
 DEF_BENCH( return new BigPathBench(kLeft_Align,     true); )
 DEF_BENCH( return new BigPathBench(kMiddle_Align,   true); )
 DEF_BENCH( return new BigPathBench(kRight_Align,    true); )
+
+// A map-like fill over a 4K canvas: small, jagged polygons of 32 edges each.
+static SkPath make_map_path(int polygons) {
+    constexpr int kVertices = 32;
+    SkRandom random;
+    SkPath path;
+    for (int i = 0; i < polygons; ++i) {
+        const SkPoint center = {random.nextRangeF(0, 3840), random.nextRangeF(0, 2160)};
+        const float size = random.nextRangeF(8, 40);
+        for (int j = 0; j < kVertices; ++j) {
+            const float angle = j * 2 * SK_ScalarPI / kVertices;
+            const float radius = size * random.nextRangeF(0.6f, 1);
+            const SkPoint p = center + SkPoint{radius * std::cos(angle),
+                                               radius * std::sin(angle)};
+            j == 0 ? path.moveTo(p) : path.lineTo(p);
+        }
+        path.close();
+    }
+    return path;
+}
+
+// With 3000 polygons, about 100k edges. Compares the anti-aliased rasterizers Skia picks between
+// for such a path.
+class HugePathFillBench : public Benchmark {
+public:
+    enum class Rasterizer { kDefault, kAnalytic, kSparseTiles };
+
+    HugePathFillBench(Rasterizer rasterizer, int polygons)
+            : fRasterizer(rasterizer), fPolygons(polygons) {
+        static const char* kNames[] = {"default", "analytic", "sparsetiles"};
+        fName.printf("hugepath_fill_%d_%s", polygons, kNames[(int)rasterizer]);
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+    SkISize onGetSize() override { return {3840, 2160}; }
+
+    void onDelayedSetup() override { fPath = make_map_path(fPolygons); }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        this->setupPaint(&paint);
+
+        gSkForceAnalyticAA = fRasterizer == Rasterizer::kAnalytic;
+        gSkForceSparseTileAA = fRasterizer == Rasterizer::kSparseTiles;
+        for (int i = 0; i < loops; i++) {
+            canvas->drawPath(fPath, paint);
+        }
+        gSkForceAnalyticAA = gSkForceSparseTileAA = false;
+    }
+
+private:
+    SkPath fPath;
+    SkString fName;
+    Rasterizer fRasterizer;
+    int fPolygons;
+};
+
+// 10 polygons (320 edges) is below the point where sparse tiles are chosen by default.
+DEF_BENCH( return new HugePathFillBench(HugePathFillBench::Rasterizer::kDefault,     10); )
+DEF_BENCH( return new HugePathFillBench(HugePathFillBench::Rasterizer::kAnalytic,    10); )
+DEF_BENCH( return new HugePathFillBench(HugePathFillBench::Rasterizer::kSparseTiles, 10); )
+DEF_BENCH( return new HugePathFillBench(HugePathFillBench::Rasterizer::kDefault,     3000); )
+DEF_BENCH( return new HugePathFillBench(HugePathFillBench::Rasterizer::kAnalytic,    3000); )
+DEF_BENCH( return new HugePathFillBench(HugePathFillBench::Rasterizer::kSparseTiles, 3000); )
+
+// The same map-like fills, rasterized on this thread or in bands on a thread pool, to find the
+// edge count where banding starts to pay off (see SkGraphics::SetPathBandExecutor()).
+class BandedPathFillBench : public Benchmark {
+public:
+    BandedPathFillBench(int polygons, bool banded) : fPolygons(polygons), fBanded(banded) {
+        fName.printf("hugepath_fill_%d_%s", polygons, banded ? "banded" : "unbanded");
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+    SkISize onGetSize() override { return {3840, 2160}; }
+
+    void onDelayedSetup() override {
+        fPath = make_map_path(fPolygons);
+        if (fBanded) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool();
+        }
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        this->setupPaint(&paint);
+
+        SkGraphics::SetPathBandExecutor(fExecutor.get(), 0, 0);
+        for (int i = 0; i < loops; i++) {
+            canvas->drawPath(fPath, paint);
+        }
+        SkGraphics::SetPathBandExecutor(nullptr, 0, 0);
+    }
+
+private:
+    SkPath fPath;
+    SkString fName;
+    int fPolygons;
+    bool fBanded;
+    std::unique_ptr<SkExecutor> fExecutor;
+};
+
+DEF_BENCH( return new BandedPathFillBench(10,    false); )
+DEF_BENCH( return new BandedPathFillBench(10,    true); )
+DEF_BENCH( return new BandedPathFillBench(100,   false); )
+DEF_BENCH( return new BandedPathFillBench(100,   true); )
+DEF_BENCH( return new BandedPathFillBench(1000,  false); )
+DEF_BENCH( return new BandedPathFillBench(1000,  true); )
+DEF_BENCH( return new BandedPathFillBench(3000,  false); )
+DEF_BENCH( return new BandedPathFillBench(3000,  true); )
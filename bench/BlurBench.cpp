@@ -9,6 +9,8 @@
 #include "include/core/SkCanvas.h"
 #include "include/core/SkMaskFilter.h"
 #include "include/core/SkPaint.h"
+#include "include/core/SkPath.h"
+#include "include/core/SkPathBuilder.h"
 #include "include/core/SkShader.h"
 #include "include/core/SkString.h"
 #include "src/base/SkRandom.h"
@@ -101,4 +103,105 @@ DEF_BENCH(return new BlurBench(REAL, kSolid_SkBlurStyle);)
 DEF_BENCH(return new BlurBench(REAL, kOuter_SkBlurStyle);)
 DEF_BENCH(return new BlurBench(REAL, kInner_SkBlurStyle);)
 
+// Sweeps sigma directly, through the triple box scans SkMaskBlurFilter uses from sigma 2 up.
+class BlurSigmaBench : public Benchmark {
+    SkScalar fSigma;
+    SkString fName;
+
+public:
+    BlurSigmaBench(SkScalar sigma) : fSigma(sigma) {
+        fName.printf("blur_sigma_%d", SkScalarRoundToInt(sigma));
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        paint.setMaskFilter(SkMaskFilter::MakeBlur(kNormal_SkBlurStyle, fSigma));
+
+        SkRandom rand;
+        for (int i = 0; i < loops; i++) {
+            SkRect r = SkRect::MakeWH(rand.nextUScalar1() * 400,
+                                      rand.nextUScalar1() * 400);
+            canvas->drawOval(r, paint);
+        }
+    }
+
+private:
+    using INHERITED = Benchmark;
+};
+
+DEF_BENCH(return new BlurSigmaBench(1);)
+DEF_BENCH(return new BlurSigmaBench(2);)
+DEF_BENCH(return new BlurSigmaBench(5);)
+DEF_BENCH(return new BlurSigmaBench(10);)
+DEF_BENCH(return new BlurSigmaBench(20);)
+DEF_BENCH(return new BlurSigmaBench(40);)
+DEF_BENCH(return new BlurSigmaBench(60);)
+DEF_BENCH(return new BlurSigmaBench(100);)
+
+// Draws the same blurred star all over the canvas, like an icon in an animated layout. At whole
+// pixel offsets every draw after the first finds its mask in the cache; at random sub-pixel
+// offsets almost none do.
+class BlurPathBench : public Benchmark {
+    SkScalar fSigma;
+    bool     fWholePixels;
+    SkPath   fStar;
+    SkString fName;
+
+public:
+    BlurPathBench(SkScalar sigma, bool wholePixels) : fSigma(sigma), fWholePixels(wholePixels) {
+        fName.printf("blur_path_%d_%s", SkScalarRoundToInt(sigma),
+                     wholePixels ? "whole_pixels" : "subpixel");
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onDelayedSetup() override {
+        SkPathBuilder builder;
+        for (int i = 0; i < 10; ++i) {
+            const SkScalar radius = i % 2 ? 12 : 30;
+            const SkScalar angle = i * SK_ScalarPI / 5;
+            const SkPoint p = {radius * SkScalarCos(angle), radius * SkScalarSin(angle)};
+            i == 0 ? builder.moveTo(p) : builder.lineTo(p);
+        }
+        fStar = builder.close().detach();
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        paint.setMaskFilter(SkMaskFilter::MakeBlur(kNormal_SkBlurStyle, fSigma));
+
+        SkRandom rand;
+        for (int i = 0; i < loops; i++) {
+            SkScalar x = rand.nextRangeScalar(50, 590),
+                     y = rand.nextRangeScalar(50, 430);
+            if (fWholePixels) {
+                x = SkScalarFloorToScalar(x);
+                y = SkScalarFloorToScalar(y);
+            }
+            canvas->save();
+            canvas->translate(x, y);
+            canvas->drawPath(fStar, paint);
+            canvas->restore();
+        }
+    }
+
+private:
+    using INHERITED = Benchmark;
+};
+
+DEF_BENCH(return new BlurPathBench(4, true);)
+DEF_BENCH(return new BlurPathBench(4, false);)
+DEF_BENCH(return new BlurPathBench(20, true);)
+DEF_BENCH(return new BlurPathBench(20, false);)
+
 DEF_BENCH(return new BlurBench(0, kNormal_SkBlurStyle);)
@@ -12,7 +12,9 @@
 #include "include/core/SkShader.h"
 #include "include/core/SkString.h"
 #include "include/effects/SkImageFilters.h"
+#include "include/private/base/SkFloatingPoint.h"
 #include "src/base/SkRandom.h"
+#include "src/core/SkBlurEngine.h"
 
 #define FILTER_WIDTH_SMALL  32
 #define FILTER_HEIGHT_SMALL 32
@@ -161,3 +163,62 @@ DEF_BENCH(return new BlurImageFilterBench(BLUR_SIGMA_LARGE, BLUR_SIGMA_LARGE, tr
 DEF_BENCH(return new BlurImageFilterBench(BLUR_SIGMA_LARGE, BLUR_SIGMA_LARGE, false, true, true);)
 DEF_BENCH(return new BlurImageFilterBench(BLUR_SIGMA_HUGE, BLUR_SIGMA_HUGE, true, true, true);)
 DEF_BENCH(return new BlurImageFilterBench(BLUR_SIGMA_HUGE, BLUR_SIGMA_HUGE, false, true, true);)
+
+// Sweeps sigma over a 1024x1024 image, with the raster blur engine either downscaling past
+// gSkRasterBlurDownscaleSigma (the default) or blurring at full resolution.
+class BlurImageFilterSigmaBench : public Benchmark {
+public:
+    BlurImageFilterSigmaBench(SkScalar sigma, bool fullRes) : fSigma(sigma), fFullRes(fullRes) {
+        fName.printf("blur_image_filter_sigma_%d%s", SkScalarRoundToInt(sigma),
+                     fullRes ? "_fullres" : "");
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        // Only the raster blur engine can be made to blur large sigmas at full resolution.
+        return !fFullRes || backend == Backend::kRaster;
+    }
+
+    void onDelayedSetup() override {
+        fCheckerboard = make_checkerboard(1024, 1024);
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        SkPaint paint;
+        paint.setImageFilter(SkImageFilters::Blur(fSigma, fSigma, nullptr));
+
+        const float oldDownscaleSigma = gSkRasterBlurDownscaleSigma;
+        if (fFullRes) {
+            gSkRasterBlurDownscaleSigma = SK_FloatInfinity;
+        }
+        for (int i = 0; i < loops; i++) {
+            canvas->drawImage(fCheckerboard, 0, 0, SkSamplingOptions(), &paint);
+        }
+        gSkRasterBlurDownscaleSigma = oldDownscaleSigma;
+    }
+
+    SkISize onGetSize() override { return {1024, 1024}; }
+
+private:
+    SkString fName;
+    SkScalar fSigma;
+    bool fFullRes;
+    sk_sp<SkImage> fCheckerboard;
+    using INHERITED = Benchmark;
+};
+
+DEF_BENCH(return new BlurImageFilterSigmaBench(8, false);)
+DEF_BENCH(return new BlurImageFilterSigmaBench(16, false);)
+DEF_BENCH(return new BlurImageFilterSigmaBench(24, false);)
+DEF_BENCH(return new BlurImageFilterSigmaBench(32, false);)
+DEF_BENCH(return new BlurImageFilterSigmaBench(32, true);)
+DEF_BENCH(return new BlurImageFilterSigmaBench(48, false);)
+DEF_BENCH(return new BlurImageFilterSigmaBench(48, true);)
+DEF_BENCH(return new BlurImageFilterSigmaBench(64, false);)
+DEF_BENCH(return new BlurImageFilterSigmaBench(64, true);)
+DEF_BENCH(return new BlurImageFilterSigmaBench(100, false);)
+DEF_BENCH(return new BlurImageFilterSigmaBench(100, true);)
@@ -13,6 +13,7 @@
 #include "include/core/SkString.h"
 #include "src/base/SkRandom.h"
 #include "src/core/SkBlurMask.h"
+#include "src/core/SkMaskBlurFilter.h"
 
 #define SMALL   SkIntToScalar(2)
 #define REAL    1.5f
@@ -155,6 +156,57 @@ private:
     using INHERITED = BlurRectSeparableBench;
 };
 
+// Blurs a fixed 256x256 mask by sigma, with SkMaskBlurFilter scanning several rows at once or,
+// for comparison, one at a time.
+class BlurRectSigmaBench : public Benchmark {
+    SkScalar      fSigma;
+    bool          fScalar;
+    SkString      fName;
+    SkMaskBuilder fSrcMask;
+
+public:
+    BlurRectSigmaBench(SkScalar sigma, bool scalar) : fSigma(sigma), fScalar(scalar) {
+        fName.printf("blurrect_sigma_%d_%s", SkScalarRoundToInt(sigma),
+                     scalar ? "scalar" : "lanes");
+    }
+
+    ~BlurRectSigmaBench() override {
+        SkMaskBuilder::FreeImage(fSrcMask.image());
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == Backend::kNonRendering;
+    }
+
+    void onDelayedSetup() override {
+        fSrcMask.bounds() = SkIRect::MakeWH(256, 256);
+        fSrcMask.format() = SkMask::kA8_Format;
+        fSrcMask.rowBytes() = 256;
+        fSrcMask.image() = SkMaskBuilder::AllocImage(fSrcMask.computeTotalImageSize());
+        memset(fSrcMask.image(), 0xff, fSrcMask.computeTotalImageSize());
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        gSkForceScalarMaskBlur = fScalar;
+        for (int i = 0; i < loops; i++) {
+            SkMaskBuilder mask;
+            if (!SkBlurMask::BoxBlur(&mask, fSrcMask, fSigma, kNormal_SkBlurStyle)) {
+                break;
+            }
+            SkMaskBuilder::FreeImage(mask.image());
+        }
+        gSkForceScalarMaskBlur = false;
+    }
+
+private:
+    using INHERITED = Benchmark;
+};
+
 class BlurRectGaussianBench: public BlurRectSeparableBench {
 public:
     BlurRectGaussianBench(SkScalar rad) : INHERITED(rad) {
@@ -202,6 +254,22 @@ DEF_BENCH(return new BlurRectDirectBench(kMedBig);)
 DEF_BENCH(return new BlurRectBoxFilterBench(kMedium);)
 DEF_BENCH(return new BlurRectBoxFilterBench(kMedBig);)
 
+DEF_BENCH(return new BlurRectSigmaBench(1, false);)
+DEF_BENCH(return new BlurRectSigmaBench(2, false);)
+DEF_BENCH(return new BlurRectSigmaBench(2, true);)
+DEF_BENCH(return new BlurRectSigmaBench(5, false);)
+DEF_BENCH(return new BlurRectSigmaBench(5, true);)
+DEF_BENCH(return new BlurRectSigmaBench(10, false);)
+DEF_BENCH(return new BlurRectSigmaBench(10, true);)
+DEF_BENCH(return new BlurRectSigmaBench(20, false);)
+DEF_BENCH(return new BlurRectSigmaBench(20, true);)
+DEF_BENCH(return new BlurRectSigmaBench(40, false);)
+DEF_BENCH(return new BlurRectSigmaBench(40, true);)
+DEF_BENCH(return new BlurRectSigmaBench(60, false);)
+DEF_BENCH(return new BlurRectSigmaBench(60, true);)
+DEF_BENCH(return new BlurRectSigmaBench(100, false);)
+DEF_BENCH(return new BlurRectSigmaBench(100, true);)
+
 #if 0
 // disable Gaussian benchmarks; the algorithm works well enough
 // and serves as a baseline for ground truth, but it's too slow
@@ -15,13 +15,20 @@
 #include "include/core/SkString.h"
 #include "src/base/SkAutoMalloc.h"
 
+#include <memory>
+
+class SkExecutor;
+
 /**
  *  Time SkCodec.
  */
 class CodecBench : public Benchmark {
 public:
-    // Calls encoded->ref()
-    CodecBench(SkString basename, SkData* encoded, SkColorType colorType, SkAlphaType alphaType);
+    // Calls encoded->ref(). If threads > 0, decodes with SkCodec::Options::fExecutor set to a
+    // thread pool of that size.
+    CodecBench(SkString basename, SkData* encoded, SkColorType colorType, SkAlphaType alphaType,
+               int threads = 0);
+    ~CodecBench() override;
 
 protected:
     const char* onGetName() override;
@@ -34,8 +41,10 @@ private:
     const SkColorType       fColorType;
     const SkAlphaType       fAlphaType;
     sk_sp<SkData>           fData;
+    const int               fThreads;
     SkImageInfo             fInfo;          // Set in onDelayedSetup.
     SkAutoMalloc            fPixelStorage;
+    std::unique_ptr<SkExecutor> fExecutor;  // Set in onDelayedSetup, if fThreads > 0.
     using INHERITED = Benchmark;
 };
 #endif // CodecBench_DEFINED
@@ -7,12 +7,15 @@
 
 #include "bench/Benchmark.h"
 #include "include/core/SkBitmap.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkStream.h"
 #include "include/encode/SkJpegEncoder.h"
 #include "include/encode/SkPngEncoder.h"
 #include "include/encode/SkWebpEncoder.h"
 #include "tools/DecodeUtils.h"
 
+#include <memory>
+
 // Like other Benchmark subclasses, Encoder benchmarks are run by:
 // nanobench --match ^Encode_
 //
@@ -75,17 +78,66 @@ static bool encode_webp_lossless(SkWStream* dst, const SkPixmap& src) {
 static bool encode_png(SkWStream* dst,
                        const SkPixmap& src,
                        SkPngEncoder::FilterFlag filters,
-                       int zlibLevel) {
+                       int zlibLevel,
+                       SkPngEncoder::FilterSelection filterSelection) {
     SkPngEncoder::Options opts;
     opts.fFilterFlags = filters;
     opts.fZLibLevel = zlibLevel;
+    opts.fFilterSelection = filterSelection;
     return SkPngEncoder::Encode(dst, src, opts);
 }
 
+// Times PNG encodes that filter and compress bands of rows in parallel, on a pool of `threads`
+// (SkPngEncoder::Options::fExecutor). For throughput, divide the size of the image's rows by the
+// time: mandrill_1600.png is 7.3MB of RGB.
+class PngParallelEncodeBench : public Benchmark {
+public:
+    PngParallelEncodeBench(const char* filename, int zlibLevel, int threads)
+        : fSourceFilename(filename)
+        , fZLibLevel(zlibLevel)
+        , fThreads(threads)
+        , fName(SkStringPrintf("Encode_%s_PNG_%d_%dthreads", filename, zlibLevel, threads)) {}
+
+    bool isSuitableFor(Backend backend) override { return backend == Backend::kNonRendering; }
+
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        SkAssertResult(ToolUtils::GetResourceAsBitmap(fSourceFilename, &fBitmap));
+        fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkPngEncoder::Options opts;
+        opts.fZLibLevel = fZLibLevel;
+        opts.fExecutor = fExecutor.get();
+        while (loops-- > 0) {
+            SkNullWStream dst;
+            SkAssertResult(SkPngEncoder::Encode(&dst, fBitmap.pixmap(), opts));
+            SkASSERT(dst.bytesWritten() > 0);
+        }
+    }
+
+private:
+    const char*                 fSourceFilename;
+    const int                   fZLibLevel;
+    const int                   fThreads;
+    SkString                    fName;
+    SkBitmap                    fBitmap;
+    std::unique_ptr<SkExecutor> fExecutor;
+};
+
 #define PNG(FLAG, ZLIBLEVEL) [](SkWStream* d, const SkPixmap& s) { \
-           return encode_png(d, s, SkPngEncoder::FilterFlag::FLAG, ZLIBLEVEL); }
+           return encode_png(d, s, SkPngEncoder::FilterFlag::FLAG, ZLIBLEVEL, \
+                             SkPngEncoder::FilterSelection::kPerRow); }
+
+// All filters, but chosen on every eighth row only (SkPngEncoder::FilterSelection::kSampled).
+#define PNG_SAMPLED(ZLIBLEVEL) [](SkWStream* d, const SkPixmap& s) { \
+           return encode_png(d, s, SkPngEncoder::FilterFlag::kAll, ZLIBLEVEL, \
+                             SkPngEncoder::FilterSelection::kSampled); }
 
-static const char* srcs[2] = {"images/mandrill_512.png", "images/color_wheel.jpg"};
+static const char* srcs[3] = {"images/mandrill_512.png", "images/color_wheel.jpg",
+                              "images/mandrill_1600.png"};
 
 // The Android Photos app uses a quality of 90 on JPEG encodes
 DEF_BENCH(return new EncodeBench(srcs[0], &encode_jpeg, "JPEG"));
@@ -110,6 +162,10 @@ DEF_BENCH(return new EncodeBench(srcs[0], PNG(kNone, 6), "PNG_6n"));
 DEF_BENCH(return new EncodeBench(srcs[0], PNG(kNone, 3), "PNG_3n"));
 DEF_BENCH(return new EncodeBench(srcs[0], PNG(kNone, 1), "PNG_1n"));
 
+DEF_BENCH(return new EncodeBench(srcs[0], PNG_SAMPLED(6), "PNG_6sampled"));
+DEF_BENCH(return new EncodeBench(srcs[0], PNG_SAMPLED(3), "PNG_3sampled"));
+DEF_BENCH(return new EncodeBench(srcs[0], PNG_SAMPLED(1), "PNG_1sampled"));
+
 DEF_BENCH(return new EncodeBench(srcs[1], PNG(kAll, 6), "PNG"));
 DEF_BENCH(return new EncodeBench(srcs[1], PNG(kAll, 3), "PNG_3"));
 DEF_BENCH(return new EncodeBench(srcs[1], PNG(kAll, 1), "PNG_1"));
@@ -122,4 +178,29 @@ DEF_BENCH(return new EncodeBench(srcs[1], PNG(kNone, 6), "PNG_6n"));
 DEF_BENCH(return new EncodeBench(srcs[1], PNG(kNone, 3), "PNG_3n"));
 DEF_BENCH(return new EncodeBench(srcs[1], PNG(kNone, 1), "PNG_1n"));
 
+DEF_BENCH(return new EncodeBench(srcs[1], PNG_SAMPLED(6), "PNG_6sampled"));
+DEF_BENCH(return new EncodeBench(srcs[1], PNG_SAMPLED(3), "PNG_3sampled"));
+DEF_BENCH(return new EncodeBench(srcs[1], PNG_SAMPLED(1), "PNG_1sampled"));
+
+// Serial and parallel encodes of a bigger image.
+DEF_BENCH(return new EncodeBench(srcs[2], PNG(kAll, 9), "PNG_9"));
+DEF_BENCH(return new EncodeBench(srcs[2], PNG(kAll, 6), "PNG"));
+DEF_BENCH(return new EncodeBench(srcs[2], PNG(kAll, 1), "PNG_1"));
+DEF_BENCH(return new EncodeBench(srcs[2], PNG(kSub, 1), "PNG_1s"));
+DEF_BENCH(return new EncodeBench(srcs[2], PNG_SAMPLED(9), "PNG_9sampled"));
+DEF_BENCH(return new EncodeBench(srcs[2], PNG_SAMPLED(6), "PNG_6sampled"));
+DEF_BENCH(return new EncodeBench(srcs[2], PNG_SAMPLED(1), "PNG_1sampled"));
+
+#define PNG_PARALLEL(ZLIBLEVEL)                                              \
+    DEF_BENCH(return new PngParallelEncodeBench(srcs[2], ZLIBLEVEL, 1));    \
+    DEF_BENCH(return new PngParallelEncodeBench(srcs[2], ZLIBLEVEL, 2));    \
+    DEF_BENCH(return new PngParallelEncodeBench(srcs[2], ZLIBLEVEL, 4));    \
+    DEF_BENCH(return new PngParallelEncodeBench(srcs[2], ZLIBLEVEL, 8));
+
+PNG_PARALLEL(9)
+PNG_PARALLEL(6)
+PNG_PARALLEL(1)
+
+#undef PNG_PARALLEL
+#undef PNG_SAMPLED
 #undef PNG
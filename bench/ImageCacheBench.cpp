@@ -6,7 +6,11 @@
  */
 
 #include "bench/Benchmark.h"
+#include "include/core/SkString.h"
 #include "src/core/SkResourceCache.h"
+#include "src/core/SkTaskGroup.h"
+
+#include <cstdint>
 
 namespace {
 static void* gGlobalAddress;
@@ -72,6 +76,63 @@ private:
     using INHERITED = Benchmark;
 };
 
+// Hammers one cache from many threads, as raster worker threads do: mostly hits, with a miss and
+// an add now and then. Compares a single LRU under one lock with a sharded cache.
+class ImageCacheMTBench : public Benchmark {
+    enum {
+        KEY_COUNT = 4096,
+        OPS_PER_THREAD = 1000,
+    };
+
+    const int fThreads;
+    const int fShards;
+    SkString fName;
+    SkShardedResourceCache fCache;
+
+public:
+    ImageCacheMTBench(int threads, int shards)
+        : fThreads(threads)
+        , fShards(shards)
+        // Room for about 90% of the keys, so a few lookups miss and evict.
+        , fCache(shards, KEY_COUNT * 9 / 10 * TestRec(TestKey(0), 0).bytesUsed()) {
+        fName.printf("imagecache_mt_%dthreads_%dshards", threads, shards);
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    bool isSuitableFor(Backend backend) override { return backend == Backend::kNonRendering; }
+
+    void onDelayedSetup() override {
+        for (int i = 0; i < KEY_COUNT; ++i) {
+            fCache.add(new TestRec(TestKey(i), i));
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int loop = 0; loop < loops; ++loop) {
+            SkTaskGroup().batch(fThreads, [&](int thread) {
+                uint32_t seed = 0x9E3779B9u * (thread + 1) + loop;
+                for (int i = 0; i < OPS_PER_THREAD; ++i) {
+                    seed = seed * 1664525u + 1013904223u;
+                    const intptr_t value = (seed >> 8) % KEY_COUNT;
+                    TestKey key(value);
+                    if (!fCache.find(key, TestRec::Visitor, nullptr)) {
+                        fCache.add(new TestRec(key, value));
+                    }
+                }
+            });
+        }
+    }
+
+private:
+    using INHERITED = Benchmark;
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 
 DEF_BENCH( return new ImageCacheBench(); )
+DEF_BENCH( return new ImageCacheMTBench(8, 1); )
+DEF_BENCH( return new ImageCacheMTBench(8, 16); )
+DEF_BENCH( return new ImageCacheMTBench(32, 1); )
+DEF_BENCH( return new ImageCacheMTBench(32, 16); )
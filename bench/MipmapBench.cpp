@@ -8,21 +8,32 @@
 #include "bench/Benchmark.h"
 #include "include/core/SkBitmap.h"
 #include "include/core/SkColorSpace.h"
+#include "include/core/SkExecutor.h"
 #include "src/core/SkMipmap.h"
 
+#include <memory>
+
 class MipmapBench: public Benchmark {
     SkBitmap fBitmap;
     SkString fName;
     const int fW, fH;
-    bool fHalfFoat;
+    const SkColorType fColorType;
+    const bool fThreaded;
+    std::unique_ptr<SkExecutor> fExecutor;
 
 public:
-    MipmapBench(int w, int h, bool halfFloat = false)
-        : fW(w), fH(h), fHalfFoat(halfFloat)
+    MipmapBench(int w, int h, SkColorType ct = kN32_SkColorType, bool threaded = false)
+        : fW(w), fH(h), fColorType(ct), fThreaded(threaded)
     {
         fName.printf("mipmap_build_%dx%d", w, h);
-        if (halfFloat) {
-            fName.append("_f16");
+        switch (ct) {
+            case kRGBA_F16_SkColorType:     fName.append("_f16");     break;
+            case kRGBA_1010102_SkColorType: fName.append("_1010102"); break;
+            case kRGB_565_SkColorType:      fName.append("_565");     break;
+            default:                                                  break;
+        }
+        if (threaded) {
+            fName.append("_mt");
         }
     }
 
@@ -34,16 +45,18 @@ protected:
     const char* onGetName() override { return fName.c_str(); }
 
     void onDelayedSetup() override {
-        SkColorType ct = fHalfFoat ? kRGBA_F16_SkColorType : kN32_SkColorType;
-        SkImageInfo info = SkImageInfo::Make(fW, fH, ct, kPremul_SkAlphaType,
+        SkImageInfo info = SkImageInfo::Make(fW, fH, fColorType, kPremul_SkAlphaType,
                                              SkColorSpace::MakeSRGB());
         fBitmap.allocPixels(info);
         fBitmap.eraseColor(SK_ColorWHITE);  // so we don't read uninitialized memory
+        if (fThreaded) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool();
+        }
     }
 
     void onDraw(int loops, SkCanvas*) override {
         for (int i = 0; i < loops * 4; i++) {
-            SkMipmap::Build(fBitmap, nullptr)->unref();
+            SkMipmap::Build(fBitmap, nullptr, fExecutor.get())->unref();
         }
     }
 
@@ -59,10 +72,20 @@ DEF_BENCH( return new MipmapBench(512, 511); )
 DEF_BENCH( return new MipmapBench(511, 512); )
 DEF_BENCH( return new MipmapBench(512, 512); )
 
-DEF_BENCH( return new MipmapBench(512, 512, true); )
-DEF_BENCH( return new MipmapBench(511, 511, true); )
+DEF_BENCH( return new MipmapBench(512, 512, kRGBA_F16_SkColorType); )
+DEF_BENCH( return new MipmapBench(511, 511, kRGBA_F16_SkColorType); )
 
 DEF_BENCH( return new MipmapBench(2048, 2048); )
 DEF_BENCH( return new MipmapBench(2047, 2047); )
 DEF_BENCH( return new MipmapBench(2048, 2047); )
 DEF_BENCH( return new MipmapBench(2047, 2048); )
+
+// Per color type throughput on a photo sized image, built on one thread and in bands on a pool.
+//
+DEF_BENCH( return new MipmapBench(4032, 3024); )
+DEF_BENCH( return new MipmapBench(4032, 3024, kRGBA_F16_SkColorType); )
+DEF_BENCH( return new MipmapBench(4032, 3024, kRGBA_1010102_SkColorType); )
+DEF_BENCH( return new MipmapBench(4032, 3024, kRGB_565_SkColorType); )
+DEF_BENCH( return new MipmapBench(4032, 3024, kN32_SkColorType, true); )
+DEF_BENCH( return new MipmapBench(4032, 3024, kRGBA_F16_SkColorType, true); )
+DEF_BENCH( return new MipmapBench(4032, 3024, kRGBA_1010102_SkColorType, true); )
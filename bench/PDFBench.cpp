@@ -8,12 +8,17 @@
 #include "bench/Benchmark.h"
 
 #include "include/core/SkBitmap.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkColorPriv.h"
 #include "include/core/SkData.h"
 #include "include/core/SkExecutor.h"
+#include "include/core/SkFont.h"
 #include "include/core/SkImage.h"
+#include "include/core/SkPaint.h"
 #include "include/core/SkPath.h"
 #include "include/core/SkPixmap.h"
 #include "include/core/SkStream.h"
+#include "include/core/SkString.h"
 #include "include/docs/SkPDFJpegHelpers.h"
 #include "include/effects/SkGradientShader.h"
 #include "include/private/base/SkTo.h"
@@ -25,6 +30,8 @@
 #include "tools/Resources.h"
 #include "tools/fonts/FontToolUtils.h"
 
+#include <vector>
+
 namespace {
 struct WStreamWriteTextBenchmark : public Benchmark {
     std::unique_ptr<SkWStream> fWStream;
@@ -307,6 +314,79 @@ struct PDFClipPathBenchmark : public Benchmark {
     }
 };
 
+// Times a document of many pages, each with its own image, some paths and some text, made with
+// and without an executor to compress, encode and subset while the next page is drawn.
+class PDFMultiPageBench : public Benchmark {
+public:
+    explicit PDFMultiPageBench(int threads)
+            : fThreads(threads)
+            , fName(SkStringPrintf("PDFMultiPage_%dthreads", threads)) {}
+
+protected:
+    static constexpr int kPages = 50;
+
+    const char* onGetName() override { return fName.c_str(); }
+    bool isSuitableFor(Backend backend) override {
+        return backend == Backend::kNonRendering;
+    }
+    void onDelayedSetup() override {
+        SkRandom random;
+        for (int i = 0; i < kPages; ++i) {
+            // Smooth enough to compress like a photo, noisy enough to take some work.
+            SkBitmap bitmap;
+            bitmap.allocN32Pixels(256, 256);
+            for (int y = 0; y < 256; ++y) {
+                for (int x = 0; x < 256; ++x) {
+                    *bitmap.getAddr32(x, y) = SkPackARGB32(0xFF,
+                                                           SkToU8(x + i),
+                                                           SkToU8(y),
+                                                           SkToU8(random.nextULessThan(32)));
+                }
+            }
+            fImages.push_back(bitmap.asImage());
+        }
+        for (int i = 0; i < 20; ++i) {
+            fPath.moveTo(random.nextRangeF(0, 612), random.nextRangeF(0, 792));
+            fPath.cubicTo(random.nextRangeF(0, 612), random.nextRangeF(0, 792),
+                          random.nextRangeF(0, 612), random.nextRangeF(0, 792),
+                          random.nextRangeF(0, 612), random.nextRangeF(0, 792));
+        }
+        if (fThreads > 0) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+        }
+    }
+    void onDraw(int loops, SkCanvas*) override {
+        SkFont font = ToolUtils::DefaultFont();
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        while (loops-- > 0) {
+            SkNullWStream wStream;
+            SkPDF::Metadata metadata;
+            metadata.fExecutor = fExecutor.get();
+            auto doc = SkPDF::MakeDocument(&wStream, metadata);
+            for (int page = 0; page < kPages; ++page) {
+                SkCanvas* canvas = doc->beginPage(612, 792);
+                canvas->drawImage(fImages[page], 36, 36);
+                paint.setColor(SkColorSetARGB(0xFF, SkToU8(page * 5), 0x80, 0x40));
+                canvas->drawPath(fPath, paint);
+                for (int line = 0; line < 40; ++line) {
+                    canvas->drawString("The quick brown fox jumps over the lazy dog.",
+                                       36, 320 + 11.0f * line, font, paint);
+                }
+                doc->endPage();
+            }
+            doc->close();
+        }
+    }
+
+private:
+    const int fThreads;
+    const SkString fName;
+    std::vector<sk_sp<SkImage>> fImages;
+    SkPath fPath;
+    std::unique_ptr<SkExecutor> fExecutor;
+};
+
 }  // namespace
 DEF_BENCH(return new PDFImageBench;)
 DEF_BENCH(return new PDFJpegImageBench;)
@@ -315,6 +395,9 @@ DEF_BENCH(return new PDFColorComponentBench;)
 DEF_BENCH(return new PDFShaderBench;)
 DEF_BENCH(return new WritePDFTextBenchmark;)
 DEF_BENCH(return new PDFClipPathBenchmark;)
+DEF_BENCH(return new PDFMultiPageBench(0);)
+DEF_BENCH(return new PDFMultiPageBench(1);)
+DEF_BENCH(return new PDFMultiPageBench(4);)
 
 #ifdef SK_PDF_ENABLE_SLOW_TESTS
 #include "include/core/SkExecutor.h"
@@ -10,6 +10,7 @@
 #include "include/core/SkString.h"
 #include "include/private/base/SkTemplates.h"
 #include "src/base/SkRandom.h"
+#include "src/core/SkDynamicRTree.h"
 #include "src/core/SkRTree.h"
 
 using namespace skia_private;
@@ -22,11 +23,17 @@ static const int GRID_WIDTH = 100;
 
 typedef SkRect (*MakeRectProc)(SkRandom&, int, int);
 
+// Each bench runs against both SkRTree ("rtree_") and SkDynamicRTree ("dynamic_rtree_").
+template <typename T> static const char* tree_prefix();
+template <> const char* tree_prefix<SkRTree>() { return "rtree"; }
+template <> const char* tree_prefix<SkDynamicRTree>() { return "dynamic_rtree"; }
+
 // Time how long it takes to build an R-Tree.
+template <typename Tree>
 class RTreeBuildBench : public Benchmark {
 public:
     RTreeBuildBench(const char* name, MakeRectProc proc) : fProc(proc) {
-        fName.printf("rtree_%s_build", name);
+        fName.printf("%s_%s_build", tree_prefix<Tree>(), name);
     }
 
     bool isSuitableFor(Backend backend) override {
@@ -45,7 +52,7 @@ protected:
         }
 
         for (int i = 0; i < loops; ++i) {
-            SkRTree tree;
+            Tree tree;
             tree.insert(rects.data(), NUM_BUILD_RECTS);
         }
     }
@@ -56,10 +63,11 @@ private:
 };
 
 // Time how long it takes to perform queries on an R-Tree.
+template <typename Tree>
 class RTreeQueryBench : public Benchmark {
 public:
     RTreeQueryBench(const char* name, MakeRectProc proc) : fProc(proc) {
-        fName.printf("rtree_%s_query", name);
+        fName.printf("%s_%s_query", tree_prefix<Tree>(), name);
     }
 
     bool isSuitableFor(Backend backend) override {
@@ -91,7 +99,47 @@ protected:
         }
     }
 private:
-    SkRTree fTree;
+    Tree fTree;
+    MakeRectProc fProc;
+    SkString fName;
+    using INHERITED = Benchmark;
+};
+
+// Time how long it takes to move a few percent of an SkDynamicRTree's rects, as when re-recording a
+// mostly unchanged picture, compared to building a new tree from scratch (the _build benches).
+class RTreeUpdateBench : public Benchmark {
+public:
+    RTreeUpdateBench(const char* name, MakeRectProc proc) : fProc(proc) {
+        fName.printf("dynamic_rtree_%s_update", name);
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == Backend::kNonRendering;
+    }
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+    void onDelayedSetup() override {
+        SkRandom rand;
+        AutoTArray<SkRect> rects(NUM_BUILD_RECTS);
+        for (int i = 0; i < NUM_BUILD_RECTS; ++i) {
+            rects[i] = fProc(rand, i, NUM_BUILD_RECTS);
+        }
+        fTree.insert(rects.data(), NUM_BUILD_RECTS);
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        SkRandom rand;
+        for (int i = 0; i < loops; ++i) {
+            for (int j = 0; j < NUM_BUILD_RECTS / 20; ++j) {
+                const int id = rand.nextULessThan(NUM_BUILD_RECTS);
+                fTree.update(id, fProc(rand, id, NUM_BUILD_RECTS));
+            }
+        }
+    }
+private:
+    SkDynamicRTree fTree;
     MakeRectProc fProc;
     SkString fName;
     using INHERITED = Benchmark;
@@ -129,12 +177,25 @@ static inline SkRect make_concentric_rects(SkRandom&, int index, int numRects) {
 
 ///////////////////////////////////////////////////////////////////////////////
 
-DEF_BENCH(return new RTreeBuildBench("XY", &make_XYordered_rects));
-DEF_BENCH(return new RTreeBuildBench("YX", &make_YXordered_rects));
-DEF_BENCH(return new RTreeBuildBench("random", &make_random_rects));
-DEF_BENCH(return new RTreeBuildBench("concentric", &make_concentric_rects));
+DEF_BENCH(return new RTreeBuildBench<SkRTree>("XY", &make_XYordered_rects));
+DEF_BENCH(return new RTreeBuildBench<SkRTree>("YX", &make_YXordered_rects));
+DEF_BENCH(return new RTreeBuildBench<SkRTree>("random", &make_random_rects));
+DEF_BENCH(return new RTreeBuildBench<SkRTree>("concentric", &make_concentric_rects));
+
+DEF_BENCH(return new RTreeQueryBench<SkRTree>("XY", &make_XYordered_rects));
+DEF_BENCH(return new RTreeQueryBench<SkRTree>("YX", &make_YXordered_rects));
+DEF_BENCH(return new RTreeQueryBench<SkRTree>("random", &make_random_rects));
+DEF_BENCH(return new RTreeQueryBench<SkRTree>("concentric", &make_concentric_rects));
+
+DEF_BENCH(return new RTreeBuildBench<SkDynamicRTree>("XY", &make_XYordered_rects));
+DEF_BENCH(return new RTreeBuildBench<SkDynamicRTree>("YX", &make_YXordered_rects));
+DEF_BENCH(return new RTreeBuildBench<SkDynamicRTree>("random", &make_random_rects));
+DEF_BENCH(return new RTreeBuildBench<SkDynamicRTree>("concentric", &make_concentric_rects));
+
+DEF_BENCH(return new RTreeQueryBench<SkDynamicRTree>("XY", &make_XYordered_rects));
+DEF_BENCH(return new RTreeQueryBench<SkDynamicRTree>("YX", &make_YXordered_rects));
+DEF_BENCH(return new RTreeQueryBench<SkDynamicRTree>("random", &make_random_rects));
+DEF_BENCH(return new RTreeQueryBench<SkDynamicRTree>("concentric", &make_concentric_rects));
 
-DEF_BENCH(return new RTreeQueryBench("XY", &make_XYordered_rects));
-DEF_BENCH(return new RTreeQueryBench("YX", &make_YXordered_rects));
-DEF_BENCH(return new RTreeQueryBench("random", &make_random_rects));
-DEF_BENCH(return new RTreeQueryBench("concentric", &make_concentric_rects));
+DEF_BENCH(return new RTreeUpdateBench("XY", &make_XYordered_rects));
+DEF_BENCH(return new RTreeUpdateBench("random", &make_random_rects));
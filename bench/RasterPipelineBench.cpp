@@ -0,0 +1,143 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "bench/Benchmark.h"
+#include "include/core/SkString.h"
+#include "src/base/SkArenaAlloc.h"
+#include "src/core/SkOpts.h"
+#include "src/core/SkRasterPipeline.h"
+#include "src/core/SkRasterPipelineOpContexts.h"
+#include "src/core/SkRasterPipelineOpList.h"
+
+#include <cstdint>
+#include <functional>
+
+// Times a few typical pipelines, writing either 8888 (which runs in lowp) or F16 (which forces
+// highp). The names include both strides, so results from builds or machines that pick different
+// SkOpts targets (e.g. HSW vs. SKX) can be compared side by side.
+class RasterPipelineBench : public Benchmark {
+public:
+    enum class Stages { kBlend, kGradient4, kGradient16, kImageNearest, kImageBilerp };
+
+    RasterPipelineBench(Stages stages, bool highp) : fStages(stages), fHighp(highp) {}
+
+private:
+    // An odd width, so every row has a tail for every stride.
+    static constexpr int kWidth = 1001, kHeight = 16;
+    static constexpr int kImageSize = 64;
+
+    const char* onGetName() override {
+        if (fName.isEmpty()) {
+            // The strides are only known once SkOpts has been initialized.
+            static const char* kNames[] = {
+                    "blend", "gradient4", "gradient16", "image_nearest", "image_bilerp"};
+            fName.printf("SkRasterPipeline_%s_%s_%zux%zu",
+                         kNames[(int)fStages], fHighp ? "highp" : "lowp",
+                         SkOpts::raster_pipeline_lowp_stride,
+                         SkOpts::raster_pipeline_highp_stride);
+        }
+        return fName.c_str();
+    }
+
+    bool isSuitableFor(Backend backend) override { return backend == Backend::kNonRendering; }
+
+    void onDelayedSetup() override {
+        for (int i = 0; i < kWidth * kHeight; i++) {
+            fSrc8888[i] = 0x80402010 + i;
+            fDst8888[i] = 0xFF808080 - i;
+            fDstF16[i] = 0x3C00380034003000;  // (0.125, 0.25, 0.5, 1.0) as halfs
+        }
+        for (int i = 0; i < kImageSize * kImageSize; i++) {
+            fImage[i] = 0xFF000000 | (i * 2654435761u >> 8);
+        }
+
+        fSrcCtx = {fSrc8888, kWidth};
+        fDstCtx = fHighp ? SkRasterPipeline_MemoryCtx{fDstF16, kWidth}
+                         : SkRasterPipeline_MemoryCtx{fDst8888, kWidth};
+
+        const size_t stops = fStages == Stages::kGradient16 ? 16 : 4;
+        fGradientCtx.stopCount = stops;
+        for (int c = 0; c < 4; c++) {
+            fGradientCtx.fs[c] = fGradientStops[c];
+            fGradientCtx.bs[c] = fGradientStops[4 + c];
+            for (size_t i = 0; i < stops; i++) {
+                fGradientStops[c][i] = (c + 1) * 0.01f * i;
+                fGradientStops[4 + c][i] = 0.25f - 0.01f * c;
+            }
+        }
+        fGradientCtx.ts = nullptr;
+
+        fImageCtx.pixels = fImage;
+        fImageCtx.stride = kImageSize;
+        fImageCtx.width = kImageSize;
+        fImageCtx.height = kImageSize;
+
+        SkRasterPipeline p(&fAlloc);
+        switch (fStages) {
+            case Stages::kBlend:
+                p.append(SkRasterPipelineOp::load_8888, &fSrcCtx);
+                break;
+            case Stages::kGradient4:
+            case Stages::kGradient16:
+                p.append(SkRasterPipelineOp::seed_shader);
+                p.append(SkRasterPipelineOp::matrix_scale_translate, fGradientMatrix);
+                p.append(SkRasterPipelineOp::evenly_spaced_gradient, &fGradientCtx);
+                break;
+            case Stages::kImageNearest:
+            case Stages::kImageBilerp:
+                p.append(SkRasterPipelineOp::seed_shader);
+                p.append(SkRasterPipelineOp::matrix_2x3, fImageMatrix);
+                p.append(fStages == Stages::kImageNearest ? SkRasterPipelineOp::gather_8888
+                                                          : SkRasterPipelineOp::bilerp_clamp_8888,
+                         &fImageCtx);
+                break;
+        }
+        p.append(fHighp ? SkRasterPipelineOp::load_f16_dst : SkRasterPipelineOp::load_8888_dst,
+                 &fDstCtx);
+        p.append(SkRasterPipelineOp::srcover);
+        p.append(fHighp ? SkRasterPipelineOp::store_f16 : SkRasterPipelineOp::store_8888,
+                 &fDstCtx);
+        fPipeline = p.compile();
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; i++) {
+            fPipeline(0, 0, kWidth, kHeight);
+        }
+    }
+
+    Stages   fStages;
+    bool     fHighp;
+    SkString fName;
+
+    SkSTArenaAlloc<2048>                                  fAlloc;
+    std::function<void(size_t, size_t, size_t, size_t)>  fPipeline;
+
+    uint32_t fSrc8888[kWidth * kHeight];
+    uint32_t fDst8888[kWidth * kHeight];
+    uint64_t fDstF16 [kWidth * kHeight];
+    uint32_t fImage  [kImageSize * kImageSize];
+
+    SkRasterPipeline_MemoryCtx   fSrcCtx, fDstCtx;
+    SkRasterPipeline_GradientCtx fGradientCtx;
+    SkRasterPipeline_GatherCtx   fImageCtx;
+    float fGradientStops[8][17];
+    float fGradientMatrix[4] = {1.0f / kWidth, 1.0f / kHeight, 0, 0};
+    // Rotated and scaled; the samplers clamp anything that lands outside the image.
+    float fImageMatrix[6]    = {0.3f, 0.1f, -3.0f, -0.1f, 0.3f, 2.0f};
+};
+
+DEF_BENCH(return new RasterPipelineBench(RasterPipelineBench::Stages::kBlend,        false);)
+DEF_BENCH(return new RasterPipelineBench(RasterPipelineBench::Stages::kBlend,        true );)
+DEF_BENCH(return new RasterPipelineBench(RasterPipelineBench::Stages::kGradient4,    false);)
+DEF_BENCH(return new RasterPipelineBench(RasterPipelineBench::Stages::kGradient4,    true );)
+DEF_BENCH(return new RasterPipelineBench(RasterPipelineBench::Stages::kGradient16,   false);)
+DEF_BENCH(return new RasterPipelineBench(RasterPipelineBench::Stages::kGradient16,   true );)
+DEF_BENCH(return new RasterPipelineBench(RasterPipelineBench::Stages::kImageNearest, false);)
+DEF_BENCH(return new RasterPipelineBench(RasterPipelineBench::Stages::kImageNearest, true );)
+DEF_BENCH(return new RasterPipelineBench(RasterPipelineBench::Stages::kImageBilerp,  false);)
+DEF_BENCH(return new RasterPipelineBench(RasterPipelineBench::Stages::kImageBilerp,  true );)
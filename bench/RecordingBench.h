@@ -29,13 +29,15 @@ protected:
 
 class RecordingBench : public PictureCentricBench {
 public:
-    RecordingBench(const char* name, const SkPicture*, bool useBBH);
+    // recordFlags are SkPictureRecorder::RecordFlags.
+    RecordingBench(const char* name, const SkPicture*, bool useBBH, uint32_t recordFlags = 0);
 
 protected:
     void onDraw(int loops, SkCanvas*) override;
 
 private:
-    bool fUseBBH;
+    bool     fUseBBH;
+    uint32_t fRecordFlags;
 
     using INHERITED = PictureCentricBench;
 };
@@ -7,6 +7,8 @@
 
 #include "bench/GpuTools.h"
 #include "bench/SKPBench.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkPixmap.h"
 #include "include/core/SkSurface.h"
 #include "include/gpu/ganesh/GrDirectContext.h"
 #include "include/gpu/ganesh/SkSurfaceGanesh.h"
@@ -30,13 +32,17 @@ static DEFINE_int(GPUbenchTileW, 1600, "Tile width  used for GPU SKP playback.")
 static DEFINE_int(GPUbenchTileH, 512, "Tile height used for GPU SKP playback.");
 
 SKPBench::SKPBench(const char* name, const SkPicture* pic, const SkIRect& clip, SkScalar scale,
-                   bool doLooping)
+                   bool doLooping, int threads)
     : fPic(SkRef(pic))
     , fClip(clip)
     , fScale(scale)
     , fName(name)
-    , fDoLooping(doLooping) {
+    , fDoLooping(doLooping)
+    , fThreads(threads) {
     fUniqueName.printf("%s_%.2g", name, scale);  // Scale makes this unqiue for perf.skia.org traces.
+    if (fThreads > 0) {
+        fUniqueName.appendf("_%dthreads", fThreads);
+    }
 }
 
 SKPBench::~SKPBench() {
@@ -67,6 +73,20 @@ void SKPBench::onPerCanvasPreDraw(SkCanvas* canvas) {
     int tileW = gpu ? FLAGS_GPUbenchTileW : FLAGS_CPUbenchTileW,
         tileH = gpu ? FLAGS_GPUbenchTileH : FLAGS_CPUbenchTileH;
 
+    // In parallel mode, raster playback draws the whole clip as one big tile, splitting it
+    // across threads itself.
+    fParallel = fThreads > 0 && !gpu;
+    if (fParallel) {
+        if (!fExecutor) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+        }
+        tileW = bounds.width();
+        tileH = bounds.height();
+        fParallelMatrix = canvas->getLocalToDeviceAs3x3();
+        fParallelMatrix.preScale(fScale, fScale);
+        fParallelMatrix.preTranslate(-bounds.fLeft / fScale, -bounds.fTop / fScale);
+    }
+
     tileW = std::min(tileW, bounds.width());
     tileH = std::min(tileH, bounds.height());
 
@@ -132,6 +152,14 @@ void SKPBench::drawMPDPicture() {
 }
 
 void SKPBench::drawPicture() {
+    if (fParallel) {
+        SkPixmap pixmap;
+        SkAssertResult(fSurfaces[0]->peekPixels(&pixmap));
+        fPic->playbackParallel(pixmap, fExecutor.get(), &fParallelMatrix,
+                               &fSurfaces[0]->props());
+        return;
+    }
+
     for (int j = 0; j < fTileRects.size(); ++j) {
         const SkMatrix trans = SkMatrix::Translate(-fTileRects[j].fLeft / fScale,
                                                    -fTileRects[j].fTop / fScale);
@@ -10,18 +10,25 @@
 
 #include "bench/Benchmark.h"
 #include "include/core/SkCanvas.h"
+#include "include/core/SkMatrix.h"
 #include "include/core/SkPicture.h"
 #include "include/private/base/SkTDArray.h"
 
+#include <memory>
+
+class SkExecutor;
 class SkSurface;
 
 /**
  * Runs an SkPicture as a benchmark by repeatedly drawing it scaled inside a device clip.
+ *
+ * If threads > 0, CPU playback instead draws the whole clip at once with
+ * SkPicture::playbackParallel(), on a pool of that many threads.
  */
 class SKPBench : public Benchmark {
 public:
     SKPBench(const char* name, const SkPicture*, const SkIRect& devClip, SkScalar scale,
-             bool doLooping);
+             bool doLooping, int threads = 0);
     ~SKPBench() override;
 
     bool shouldLoop() const override {
@@ -64,6 +71,11 @@ private:
 
     const bool fDoLooping;
 
+    const int                   fThreads;
+    std::unique_ptr<SkExecutor> fExecutor;
+    bool                        fParallel = false;  // Set per canvas: only raster is parallel.
+    SkMatrix                    fParallelMatrix;
+
     using INHERITED = Benchmark;
 };
 
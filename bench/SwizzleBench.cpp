@@ -6,39 +6,180 @@
  */
 
 #include "bench/Benchmark.h"
+#include "include/codec/SkCodec.h"
+#include "include/core/SkColor.h"
+#include "include/core/SkImageInfo.h"
+#include "include/core/SkString.h"
+#include "include/private/SkEncodedInfo.h"
 #include "src/codec/SkSwizzler.h"
 #include "src/core/SkSwizzlePriv.h"
+#include "tools/ToolUtils.h"
+
+#include <memory>
 
 class SwizzleBench : public Benchmark {
 public:
 
     SwizzleBench(const char* name, SkOpts::Swizzle_8888_u32 fn) : fName(name), fFn_u32(fn) {}
     SwizzleBench(const char* name, SkOpts::Swizzle_8888_u8  fn) : fName(name), fFn_u8 (fn) {}
+    SwizzleBench(const char* name, SkOpts::Swizzle_8_u8     fn) : fName(name), fFn_8  (fn) {}
+    SwizzleBench(const char* name, SkOpts::Swizzle_8888_index fn)
+        : fName(name), fFn_index(fn) {}
 
     bool isSuitableFor(Backend backend) override { return backend == Backend::kNonRendering; }
     const char* onGetName() override { return fName; }
     void onDraw(int loops, SkCanvas*) override {
         static const int K = 1023; // Arbitrary, but nice to be a non-power-of-two to trip up SIMD.
-        uint32_t dst[K], src[K];
+        // Big enough for 16-bit RGBA sources.
+        uint32_t dst[K], src[2*K], table[256] = {};
         while (loops --> 0) {
-            if (fFn_u32) { fFn_u32(dst,                 src, K); }
-            if (fFn_u8)  { fFn_u8 (dst, (const uint8_t*)src, K); }
+            if (fFn_u32)   { fFn_u32  (dst,                 src, K); }
+            if (fFn_u8)    { fFn_u8   (dst, (const uint8_t*)src, K); }
+            if (fFn_8)     { fFn_8    ((uint8_t*)dst, (const uint8_t*)src, K); }
+            if (fFn_index) { fFn_index(dst, (const uint8_t*)src, K, table); }
         }
     }
 private:
     const char* fName;
-    SkOpts::Swizzle_8888_u32 fFn_u32 = nullptr;
-    SkOpts::Swizzle_8888_u8  fFn_u8  = nullptr;
+    SkOpts::Swizzle_8888_u32   fFn_u32   = nullptr;
+    SkOpts::Swizzle_8888_u8    fFn_u8    = nullptr;
+    SkOpts::Swizzle_8_u8       fFn_8     = nullptr;
+    SkOpts::Swizzle_8888_index fFn_index = nullptr;
 };
 
 
 DEF_BENCH(return new SwizzleBench("SkOpts::RGBA_to_rgbA", SkOpts::RGBA_to_rgbA));
 DEF_BENCH(return new SwizzleBench("SkOpts::RGBA_to_bgrA", SkOpts::RGBA_to_bgrA));
 DEF_BENCH(return new SwizzleBench("SkOpts::RGBA_to_BGRA", SkOpts::RGBA_to_BGRA));
+DEF_BENCH(return new SwizzleBench("SkOpts::rgbA_to_RGBA", SkOpts::rgbA_to_RGBA));
+DEF_BENCH(return new SwizzleBench("SkOpts::rgbA_to_BGRA", SkOpts::rgbA_to_BGRA));
 DEF_BENCH(return new SwizzleBench("SkOpts::RGB_to_RGB1",  SkOpts::RGB_to_RGB1));
 DEF_BENCH(return new SwizzleBench("SkOpts::RGB_to_BGR1",  SkOpts::RGB_to_BGR1));
 DEF_BENCH(return new SwizzleBench("SkOpts::gray_to_RGB1", SkOpts::gray_to_RGB1));
 DEF_BENCH(return new SwizzleBench("SkOpts::grayA_to_RGBA", SkOpts::grayA_to_RGBA));
 DEF_BENCH(return new SwizzleBench("SkOpts::grayA_to_rgbA", SkOpts::grayA_to_rgbA));
+DEF_BENCH(return new SwizzleBench("SkOpts::grayA_to_A8",   SkOpts::grayA_to_A8));
 DEF_BENCH(return new SwizzleBench("SkOpts::inverted_CMYK_to_RGB1", SkOpts::inverted_CMYK_to_RGB1));
 DEF_BENCH(return new SwizzleBench("SkOpts::inverted_CMYK_to_BGR1", SkOpts::inverted_CMYK_to_BGR1));
+DEF_BENCH(return new SwizzleBench("SkOpts::RGB16_to_RGB1",  SkOpts::RGB16_to_RGB1));
+DEF_BENCH(return new SwizzleBench("SkOpts::RGB16_to_BGR1",  SkOpts::RGB16_to_BGR1));
+DEF_BENCH(return new SwizzleBench("SkOpts::RGBA16_to_RGBA", SkOpts::RGBA16_to_RGBA));
+DEF_BENCH(return new SwizzleBench("SkOpts::RGBA16_to_BGRA", SkOpts::RGBA16_to_BGRA));
+DEF_BENCH(return new SwizzleBench("SkOpts::RGBA16_to_rgbA", SkOpts::RGBA16_to_rgbA));
+DEF_BENCH(return new SwizzleBench("SkOpts::RGBA16_to_bgrA", SkOpts::RGBA16_to_bgrA));
+DEF_BENCH(return new SwizzleBench("SkOpts::index_to_8888",  SkOpts::index_to_8888));
+
+// A row through SkSwizzler, the way the codecs drive it. Unsampled rows take the SkOpts procs
+// above where there is one; sampled rows (and the rest) take SkSwizzler's per-pixel procs.
+class SwizzlerBench : public Benchmark {
+public:
+    SwizzlerBench(const char* layout, SkEncodedInfo::Color color, SkEncodedInfo::Alpha alpha,
+                  int bitsPerComponent, SkColorType dstColorType, SkAlphaType dstAlphaType,
+                  int sampleX)
+        : fColor(color)
+        , fAlpha(alpha)
+        , fBitsPerComponent(bitsPerComponent)
+        , fDstInfo(SkImageInfo::Make(kWidth, 1, dstColorType, dstAlphaType))
+        , fSampleX(sampleX) {
+        fName.printf("SkSwizzler_%s_to_%s%s%s", layout, ToolUtils::colortype_name(dstColorType),
+                     dstAlphaType == kPremul_SkAlphaType ? "_premul" : "",
+                     sampleX > 1 ? "_sampled" : "");
+    }
+
+    bool isSuitableFor(Backend backend) override { return backend == Backend::kNonRendering; }
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        for (int i = 0; i < 256; i++) {
+            fTable[i] = SkPackARGB32(0xFF, i, i, i);
+        }
+        for (int i = 0; i < (int)sizeof(fSrc); i++) {
+            fSrc[i] = (uint8_t)(i * 37);
+        }
+        SkEncodedInfo info = SkEncodedInfo::Make(kWidth, 1, fColor, fAlpha, fBitsPerComponent);
+        fSwizzler = SkSwizzler::Make(info, fTable, fDstInfo, SkCodec::Options());
+        if (fSwizzler && fSampleX > 1) {
+            fSwizzler->setSampleX(fSampleX);
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        if (!fSwizzler) {
+            return;
+        }
+        while (loops --> 0) {
+            fSwizzler->swizzle(fDst, fSrc);
+        }
+    }
+
+private:
+    static constexpr int kWidth = 1023;
+
+    SkString                    fName;
+    const SkEncodedInfo::Color  fColor;
+    const SkEncodedInfo::Alpha  fAlpha;
+    const int                   fBitsPerComponent;
+    const SkImageInfo           fDstInfo;
+    const int                   fSampleX;
+    std::unique_ptr<SkSwizzler> fSwizzler;
+    SkPMColor                   fTable[256];
+    uint8_t                     fSrc[8 * kWidth];  // Up to 16-bit RGBA.
+    uint64_t                    fDst[kWidth];      // Up to F16.
+};
+
+#define DEF_SWIZZLER_BENCH(layout, color, alpha, bits, ct, at)                                  \
+    DEF_BENCH(return new SwizzlerBench(layout, SkEncodedInfo::color, SkEncodedInfo::alpha,     \
+                                       bits, ct, at, 1);)                                      \
+    DEF_BENCH(return new SwizzlerBench(layout, SkEncodedInfo::color, SkEncodedInfo::alpha,     \
+                                       bits, ct, at, 2);)
+
+DEF_SWIZZLER_BENCH("bit",     kGray_Color,      kOpaque_Alpha,    1, kN32_SkColorType,
+                   kOpaque_SkAlphaType)
+DEF_SWIZZLER_BENCH("bit",     kGray_Color,      kOpaque_Alpha,    1, kGray_8_SkColorType,
+                   kOpaque_SkAlphaType)
+DEF_SWIZZLER_BENCH("gray",    kGray_Color,      kOpaque_Alpha,    8, kN32_SkColorType,
+                   kOpaque_SkAlphaType)
+DEF_SWIZZLER_BENCH("gray",    kGray_Color,      kOpaque_Alpha,    8, kRGB_565_SkColorType,
+                   kOpaque_SkAlphaType)
+DEF_SWIZZLER_BENCH("grayA",   kGrayAlpha_Color, kUnpremul_Alpha,  8, kN32_SkColorType,
+                   kUnpremul_SkAlphaType)
+DEF_SWIZZLER_BENCH("grayA",   kGrayAlpha_Color, kUnpremul_Alpha,  8, kN32_SkColorType,
+                   kPremul_SkAlphaType)
+DEF_SWIZZLER_BENCH("grayA",   kGrayAlpha_Color, kUnpremul_Alpha,  8, kAlpha_8_SkColorType,
+                   kPremul_SkAlphaType)
+DEF_SWIZZLER_BENCH("index4",  kPalette_Color,   kUnpremul_Alpha,  4, kN32_SkColorType,
+                   kPremul_SkAlphaType)
+DEF_SWIZZLER_BENCH("index8",  kPalette_Color,   kUnpremul_Alpha,  8, kN32_SkColorType,
+                   kPremul_SkAlphaType)
+DEF_SWIZZLER_BENCH("index8",  kPalette_Color,   kUnpremul_Alpha,  8, kRGB_565_SkColorType,
+                   kOpaque_SkAlphaType)
+DEF_SWIZZLER_BENCH("RGB",     kRGB_Color,       kOpaque_Alpha,    8, kN32_SkColorType,
+                   kOpaque_SkAlphaType)
+DEF_SWIZZLER_BENCH("RGB",     kRGB_Color,       kOpaque_Alpha,    8, kRGB_565_SkColorType,
+                   kOpaque_SkAlphaType)
+DEF_SWIZZLER_BENCH("BGR",     kBGR_Color,       kOpaque_Alpha,    8, kN32_SkColorType,
+                   kOpaque_SkAlphaType)
+DEF_SWIZZLER_BENCH("BGR",     kBGR_Color,       kOpaque_Alpha,    8, kRGB_565_SkColorType,
+                   kOpaque_SkAlphaType)
+DEF_SWIZZLER_BENCH("RGBA",    kRGBA_Color,      kUnpremul_Alpha,  8, kN32_SkColorType,
+                   kUnpremul_SkAlphaType)
+DEF_SWIZZLER_BENCH("RGBA",    kRGBA_Color,      kUnpremul_Alpha,  8, kN32_SkColorType,
+                   kPremul_SkAlphaType)
+DEF_SWIZZLER_BENCH("BGRA",    kBGRA_Color,      kUnpremul_Alpha,  8, kN32_SkColorType,
+                   kPremul_SkAlphaType)
+DEF_SWIZZLER_BENCH("RGB16",   kRGB_Color,       kOpaque_Alpha,   16, kRGBA_8888_SkColorType,
+                   kOpaque_SkAlphaType)
+DEF_SWIZZLER_BENCH("RGB16",   kRGB_Color,       kOpaque_Alpha,   16, kBGRA_8888_SkColorType,
+                   kOpaque_SkAlphaType)
+DEF_SWIZZLER_BENCH("RGB16",   kRGB_Color,       kOpaque_Alpha,   16, kRGB_565_SkColorType,
+                   kOpaque_SkAlphaType)
+DEF_SWIZZLER_BENCH("RGBA16",  kRGBA_Color,      kUnpremul_Alpha, 16, kRGBA_8888_SkColorType,
+                   kUnpremul_SkAlphaType)
+DEF_SWIZZLER_BENCH("RGBA16",  kRGBA_Color,      kUnpremul_Alpha, 16, kRGBA_8888_SkColorType,
+                   kPremul_SkAlphaType)
+DEF_SWIZZLER_BENCH("RGBA16",  kRGBA_Color,      kUnpremul_Alpha, 16, kBGRA_8888_SkColorType,
+                   kUnpremul_SkAlphaType)
+DEF_SWIZZLER_BENCH("RGBA16",  kRGBA_Color,      kUnpremul_Alpha, 16, kBGRA_8888_SkColorType,
+                   kPremul_SkAlphaType)
+DEF_SWIZZLER_BENCH("CMYK",    kInvertedCMYK_Color, kOpaque_Alpha, 8, kN32_SkColorType,
+                   kOpaque_SkAlphaType)
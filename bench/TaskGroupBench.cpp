@@ -0,0 +1,119 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "bench/Benchmark.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkString.h"
+#include "include/private/base/SkTemplates.h"
+#include "src/core/SkTaskGroup.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+// Measures how quickly an SkExecutor gets through lots of tiny SkTaskGroup tasks, i.e. how much
+// its own bookkeeping costs as the number of threads competing for work goes up.
+class TaskGroupBench : public Benchmark {
+public:
+    enum class Pool { kFIFO, kWorkStealing };
+
+    TaskGroupBench(Pool pool, int threads) : fPool(pool), fThreads(threads) {
+        fName.printf("taskgroup_%s_%d",
+                     pool == Pool::kFIFO ? "fifo" : "workstealing", threads);
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == Backend::kNonRendering;
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        fExecutor = fPool == Pool::kFIFO ? SkExecutor::MakeFIFOThreadPool(fThreads)
+                                         : SkExecutor::MakeWorkStealingThreadPool(fThreads);
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        static constexpr int kTasks = 1000;
+        std::atomic<int> sum{0};
+        for (int i = 0; i < loops; i++) {
+            SkTaskGroup tg(*fExecutor);
+            tg.batch(kTasks, [&](int j) { sum.fetch_add(j, std::memory_order_relaxed); });
+            tg.wait();
+        }
+    }
+
+private:
+    Pool                        fPool;
+    int                         fThreads;
+    SkString                    fName;
+    std::unique_ptr<SkExecutor> fExecutor;
+
+    using INHERITED = Benchmark;
+};
+
+// Runs the same cheap per-item loop body through SkTaskGroup one add() per item, and through
+// parallelFor() in chunks, to show what dispatching each item separately costs.
+class ParallelForBench : public Benchmark {
+public:
+    explicit ParallelForBench(int grain) : fGrain(grain) {
+        fName = grain > 0 ? SkStringPrintf("taskgroup_parallelfor_%d", grain)
+                          : SkString("taskgroup_add_per_item");
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == Backend::kNonRendering;
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        fExecutor = SkExecutor::MakeWorkStealingThreadPool(4);
+        fValues.reset(kItems);
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; i++) {
+            SkTaskGroup tg(*fExecutor);
+            if (fGrain > 0) {
+                tg.parallelFor(kItems, fGrain, [&](int start, int end, SkArenaAlloc*) {
+                    for (int j = start; j < end; j++) {
+                        fValues[j] = fValues[j] * 3 + 1;
+                    }
+                });
+            } else {
+                for (int j = 0; j < kItems; j++) {
+                    tg.add([&, j] { fValues[j] = fValues[j] * 3 + 1; });
+                }
+                tg.wait();
+            }
+        }
+    }
+
+private:
+    static constexpr int kItems = 1 << 14;
+
+    int                                fGrain;
+    SkString                           fName;
+    std::unique_ptr<SkExecutor>        fExecutor;
+    skia_private::AutoTArray<uint32_t> fValues;
+
+    using INHERITED = Benchmark;
+};
+
+DEF_BENCH( return new TaskGroupBench(TaskGroupBench::Pool::kFIFO,          4); )
+DEF_BENCH( return new TaskGroupBench(TaskGroupBench::Pool::kFIFO,         16); )
+DEF_BENCH( return new TaskGroupBench(TaskGroupBench::Pool::kFIFO,         64); )
+DEF_BENCH( return new TaskGroupBench(TaskGroupBench::Pool::kWorkStealing,  4); )
+DEF_BENCH( return new TaskGroupBench(TaskGroupBench::Pool::kWorkStealing, 16); )
+DEF_BENCH( return new TaskGroupBench(TaskGroupBench::Pool::kWorkStealing, 64); )
+
+DEF_BENCH( return new ParallelForBench(0); )
+DEF_BENCH( return new ParallelForBench(64); )
+DEF_BENCH( return new ParallelForBench(1024); )
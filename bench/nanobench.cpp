@@ -28,6 +28,7 @@
 #include "include/core/SkBBHFactory.h"
 #include "include/core/SkCanvas.h"
 #include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkGraphics.h"
 #include "include/core/SkPictureRecorder.h"
 #include "include/core/SkString.h"
@@ -39,6 +40,8 @@
 #include "src/base/SkTime.h"
 #include "src/core/SkColorSpacePriv.h"
 #include "src/core/SkOSFile.h"
+#include "src/core/SkRecord.h"
+#include "src/core/SkRecorder.h"
 #include "src/core/SkTaskGroup.h"
 #include "src/core/SkTraceEvent.h"
 #include "src/utils/SkJSONWriter.h"
@@ -80,6 +83,7 @@
 #include "tools/graphite/GraphiteToolUtils.h"
 #endif
 
+#include <algorithm>
 #include <cinttypes>
 #include <memory>
 #include <optional>
@@ -150,6 +154,13 @@ static DEFINE_string(zoom, "1.0,0",
                      "function that ping-pongs between 1.0 and zoomMax.");
 static DEFINE_bool(bbh, true, "Build a BBH for SKPs?");
 static DEFINE_bool(loopSKP, true, "Loop SKPs like we do for micro benches?");
+static DEFINE_int(skpThreads, 0,
+                  "If > 0, follow each SKP's playback bench with one that draws it on this many "
+                  "threads using SkPicture::playbackParallel(), and report the speedup. "
+                  "Implies --bbh.");
+static DEFINE_bool(internSKPs, false,
+                   "Record SKPs with SkPictureRecorder::kInternPayloads_RecordFlag, and report "
+                   "the bytes it saves.");
 static DEFINE_int(flushEvery, 10, "Flush --outResultsFile every Nth run.");
 static DEFINE_bool(gpuStats, false, "Print GPU stats after each gpu benchmark?");
 static DEFINE_bool(gpuStatsDump, false, "Dump GPU stats after each benchmark to json");
@@ -175,6 +186,10 @@ static DEFINE_bool(dryRun, false,
 static DEFINE_string(images, "",
                      "List of images and/or directories to decode. A directory with no images"
                      " is treated as a fatal error.");
+static DEFINE_int(codecThreads, 0,
+                  "If > 0, follow the codec benches with ones that decode each image on thread "
+                  "pools of 1, 2, 4, ... up to this many threads, using "
+                  "SkCodec::Options::fExecutor.");
 static DEFINE_bool(simpleCodec, false,
                    "Runs of a subset of the codec tests, always N32, Premul or Opaque");
 
@@ -247,6 +262,41 @@ bool Target::capturePixels(SkBitmap* bmp) {
     return true;
 }
 
+// Draws into a surface that records and then replays its draws across a thread pool, one tile
+// at a time. The replay is forced at the end of each frame so it counts toward the bench's time.
+struct MultiThreadedRasterTarget : public Target {
+    explicit MultiThreadedRasterTarget(const Config& c) : Target(c) {}
+    ~MultiThreadedRasterTarget() override {
+        // The surface may still reference the executor.
+        this->surface.reset();
+    }
+
+    void submitFrame() override { this->flush(); }
+    void submitWorkAndSyncCPU() override { this->flush(); }
+
+    bool init(SkImageInfo info, Benchmark* bench) override {
+        fExecutor = SkExecutor::MakeFIFOThreadPool();
+        this->surface = SkSurfaces::RasterMultiThreaded(info, fExecutor.get());
+        return this->surface != nullptr;
+    }
+    bool capturePixels(SkBitmap* bmp) override {
+        bmp->allocPixels(this->surface->imageInfo());
+        if (!this->surface->readPixels(*bmp, 0, 0)) {
+            SkDebugf("Can't read surface pixels.\n");
+            return false;
+        }
+        return true;
+    }
+
+private:
+    void flush() {
+        SkPixmap unused;
+        this->surface->peekPixels(&unused);
+    }
+
+    std::unique_ptr<SkExecutor> fExecutor;
+};
+
 struct GPUTarget : public Target {
     explicit GPUTarget(const Config& c) : Target(c) {}
     ContextInfo contextInfo;
@@ -684,6 +734,7 @@ static std::optional<Config> create_config(const SkCommandLineConfig* config) {
     CPU_CONFIG("bgra",  Backend::kRaster,  kBGRA_8888_SkColorType, kPremul_SkAlphaType)
     CPU_CONFIG("f16",   Backend::kRaster,   kRGBA_F16_SkColorType, kPremul_SkAlphaType)
     CPU_CONFIG("srgba", Backend::kRaster, kSRGBA_8888_SkColorType, kPremul_SkAlphaType)
+    CPU_CONFIG("mt8888", Backend::kRaster,       kN32_SkColorType, kPremul_SkAlphaType)
 
 #undef CPU_CONFIG
 
@@ -737,7 +788,11 @@ static Target* is_enabled(Benchmark* bench, const Config& config) {
         break;
 #endif
     default:
-        target = new Target(config);
+        if (config.name.equals("mt8888")) {
+            target = new MultiThreadedRasterTarget(config);
+        } else {
+            target = new Target(config);
+        }
         break;
     }
 
@@ -852,6 +907,22 @@ public:
         return SkPicture::MakeFromStream(stream.get());
     }
 
+    // Returns the size of pic after recording it again with the given SkPictureRecorder flags.
+    static double rerecorded_bytes(const SkPicture* pic, uint32_t recordFlags) {
+        SkPictureRecorder recorder;
+        pic->playback(recorder.beginRecording(pic->cullRect(), nullptr, recordFlags));
+        return static_cast<double>(recorder.finishRecordingAsPicture()->approximateBytesUsed());
+    }
+
+    // Returns the payload bytes that interning shares when recording pic again.
+    static double interning_bytes_saved(const SkPicture* pic) {
+        SkRecord record;
+        SkRecorder recorder(&record, pic->cullRect());
+        recorder.setInternPayloads(true);
+        pic->playback(&recorder);
+        return static_cast<double>(recorder.approxBytesSavedByInterning());
+    }
+
     static std::unique_ptr<MSKPPlayer> ReadMSKP(const char* path) {
         // Not strictly necessary, as it will be checked again later,
         // but helps to avoid a lot of pointless work if we're going to skip it.
@@ -968,7 +1039,15 @@ public:
             fBenchType  = "recording";
             fSKPBytes = static_cast<double>(pic->approximateBytesUsed());
             fSKPOps   = pic->approximateOpCount();
-            return new RecordingBench(name.c_str(), pic.get(), FLAGS_bbh);
+            fSKPBytesSaved = 0;
+            uint32_t recordFlags = 0;
+            if (FLAGS_internSKPs) {
+                recordFlags = SkPictureRecorder::kInternPayloads_RecordFlag;
+                fSKPBytes = rerecorded_bytes(pic.get(), recordFlags);
+                fSKPBytesSaved = interning_bytes_saved(pic.get());
+                name.append("_intern");
+            }
+            return new RecordingBench(name.c_str(), pic.get(), FLAGS_bbh, recordFlags);
         }
 
         // Add all .skps as DeserializePictureBenchs.
@@ -988,6 +1067,14 @@ public:
 
         // Then once each for each scale as SKPBenches (playback).
         while (fCurrentScale < fScales.size()) {
+            if (fParallelSKP) {
+                sk_sp<SkPicture> pic = std::move(fParallelSKP);
+                fSourceType = "skp";
+                fBenchType = "parallel_playback";
+                return new SKPBench(fParallelSKPName.c_str(), pic.get(), fClip,
+                                    fScales[fCurrentScale], FLAGS_loopSKP, FLAGS_skpThreads);
+            }
+
             while (fCurrentSKP < fSKPs.size()) {
                 const SkString& path = fSKPs[fCurrentSKP++];
                 sk_sp<SkPicture> pic = ReadPicture(path.c_str());
@@ -995,7 +1082,7 @@ public:
                     continue;
                 }
 
-                if (FLAGS_bbh) {
+                if (FLAGS_bbh || FLAGS_skpThreads > 0) {
                     // The SKP we read off disk doesn't have a BBH.  Re-record so it grows one.
                     SkRTreeFactory factory;
                     SkPictureRecorder recorder;
@@ -1007,6 +1094,11 @@ public:
                 SkString name = SkOSPath::Basename(path.c_str());
                 fSourceType = "skp";
                 fBenchType = "playback";
+                if (FLAGS_skpThreads > 0) {
+                    // Next time, play the same picture back in parallel.
+                    fParallelSKP = pic;
+                    fParallelSKPName = name;
+                }
                 return new SKPBench(name.c_str(), pic.get(), fClip, fScales[fCurrentScale],
                                     FLAGS_loopSKP);
             }
@@ -1134,6 +1226,33 @@ public:
             fCurrentColorType = 0;
         }
 
+        // Time decoding each image, split over more and more threads.
+        while (FLAGS_codecThreads > 0 && fCurrentThreadedCodec < fImages.size()) {
+            const SkString& path = fImages[fCurrentThreadedCodec];
+            const int threads = fCurrentCodecThreads;
+            fCurrentCodecThreads *= 2;
+            if (fCurrentCodecThreads > FLAGS_codecThreads) {
+                fCurrentCodecThreads = 1;
+                fCurrentThreadedCodec++;
+            }
+            if (CommandLineFlags::ShouldSkip(FLAGS_match, path.c_str())) {
+                continue;
+            }
+            sk_sp<SkData> encoded(SkData::MakeFromFileName(path.c_str()));
+            std::unique_ptr<SkCodec> codec(SkCodec::MakeFromData(encoded));
+            if (!codec) {
+                continue;
+            }
+            SkAlphaType alphaType = codec->getInfo().alphaType();
+            if (kUnpremul_SkAlphaType == alphaType) {
+                alphaType = kPremul_SkAlphaType;
+            }
+            fSourceType = "image";
+            fBenchType = "skcodec";
+            return new CodecBench(SkOSPath::Basename(path.c_str()), encoded.get(),
+                                  kN32_SkColorType, alphaType, threads);
+        }
+
         // Run AndroidCodecBenches
         const int sampleSizes[] = { 2, 4, 8 };
         for (; fCurrentAndroidCodec < fImages.size(); fCurrentAndroidCodec++) {
@@ -1267,13 +1386,21 @@ public:
         }
     }
 
+    const char* benchType() const { return fBenchType; }
+
     void fillCurrentMetrics(NanoJSONResultsWriter& log) const {
         if (0 == strcmp(fBenchType, "recording")) {
             log.appendMetric("bytes", fSKPBytes);
             log.appendMetric("ops", fSKPOps);
+            if (FLAGS_internSKPs) {
+                log.appendMetric("bytes_saved", fSKPBytesSaved);
+            }
         }
     }
 
+    // Bytes saved by --internSKPs for the current recording bench.
+    double skpBytesSaved() const { return fSKPBytesSaved; }
+
 private:
 #ifdef SK_ENABLE_ANDROID_UTILS
     enum SubsetType {
@@ -1302,10 +1429,12 @@ private:
     SkScalar           fZoomMax;
     double             fZoomPeriodMs;
 
-    double fSKPBytes, fSKPOps;
+    double fSKPBytes, fSKPOps, fSKPBytesSaved = 0;
 
     const char* fSourceType;  // What we're benching: bench, GM, SKP, ...
     const char* fBenchType;   // How we bench it: micro, recording, playback, ...
+    sk_sp<SkPicture> fParallelSKP;  // With --skpThreads, the next SKP to play back in parallel.
+    SkString         fParallelSKPName;
     int fCurrentRecording = 0;
     int fCurrentDeserialPicture = 0;
     int fCurrentMSKP = 0;
@@ -1321,6 +1450,8 @@ private:
 #endif
     int fCurrentColorType = 0;
     int fCurrentAlphaType = 0;
+    int fCurrentThreadedCodec = 0;
+    int fCurrentCodecThreads = 1;
     int fCurrentSampleSize = 0;
     int fCurrentAnimSKP = 0;
 };
@@ -1468,8 +1599,16 @@ int main(int argc, char** argv) {
     int runs = 0;
     BenchmarkStream benchStream;
     AutoreleasePool pool;
+    // With --skpThreads, each SKP's serial playback medians (one per config), to compare against
+    // the parallel playback bench that follows it.
+    TArray<double> serialSKPMedians;
     while (Benchmark* b = benchStream.next()) {
         std::unique_ptr<Benchmark> bench(b);
+        const bool parallelSKP = 0 == strcmp(benchStream.benchType(), "parallel_playback");
+        if (!parallelSKP) {
+            serialSKPMedians.reset(configs.size());
+            std::fill(serialSKPMedians.begin(), serialSKPMedians.end(), 0.0);
+        }
         if (CommandLineFlags::ShouldSkip(FLAGS_match, bench->getUniqueName())) {
             continue;
         }
@@ -1592,6 +1731,13 @@ int main(int argc, char** argv) {
             // Metrics
             log.appendMetric("min_ms", stats.min);
             log.appendMetric("min_ratio", sk_ieee_double_divide(stats.median, stats.min));
+            double speedup = 0;
+            if (FLAGS_skpThreads > 0 && 0 == strcmp(benchStream.benchType(), "playback")) {
+                serialSKPMedians[i] = stats.median;
+            } else if (parallelSKP && serialSKPMedians[i] > 0) {
+                speedup = serialSKPMedians[i] / stats.median;
+                log.appendMetric("speedup", speedup);
+            }
             log.beginArray("samples");
             for (double sample : samples) {
                 log.appendDoubleDigits(sample, 16);
@@ -1661,6 +1807,15 @@ int main(int argc, char** argv) {
                         );
             }
 
+            if (speedup > 0) {
+                SkDebugf("%.2fx speedup on %d threads\t%s\t%s\n",
+                         speedup, FLAGS_skpThreads, config, bench->getUniqueName());
+            }
+            if (FLAGS_internSKPs && 0 == strcmp(benchStream.benchType(), "recording")) {
+                SkDebugf("%.0f bytes saved by interning\t%s\t%s\n",
+                         benchStream.skpBytesSaved(), config, bench->getUniqueName());
+            }
+
             if (FLAGS_gpuStats && Benchmark::Backend::kGanesh == configs[i].backend) {
                 target->dumpStats();
             }
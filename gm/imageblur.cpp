@@ -6,18 +6,31 @@
  */
 
 #include "gm/gm.h"
+#include "include/core/SkBitmap.h"
 #include "include/core/SkCanvas.h"
 #include "include/core/SkColor.h"
 #include "include/core/SkFont.h"
+#include "include/core/SkImage.h"
 #include "include/core/SkImageFilter.h"
 #include "include/core/SkPaint.h"
+#include "include/core/SkRect.h"
+#include "include/core/SkSamplingOptions.h"
 #include "include/core/SkScalar.h"
+#include "include/core/SkSurfaceProps.h"
+#include "include/core/SkTileMode.h"
 #include "include/core/SkTypeface.h"
 #include "include/effects/SkImageFilters.h"
+#include "include/private/base/SkFloatingPoint.h"
 #include "src/base/SkRandom.h"
+#include "src/core/SkBlurEngine.h"
+#include "src/core/SkSpecialImage.h"
 #include "tools/ToolUtils.h"
 #include "tools/fonts/FontToolUtils.h"
 
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+
 #define WIDTH 500
 #define HEIGHT 500
 
@@ -45,3 +58,74 @@ DEF_SIMPLE_GM_BG(imageblur,       canvas, WIDTH, HEIGHT, SK_ColorBLACK) {
 DEF_SIMPLE_GM_BG(imageblur_large, canvas, WIDTH, HEIGHT, SK_ColorBLACK) {
     imageblurgm_draw(80.0f, 80.0f, canvas);
 }
+
+// Past gSkRasterBlurDownscaleSigma, the raster blur engine blurs a downscaled image and upscales
+// the result. Each column is one sigma: blurred at full resolution on top, the default (downscaled
+// past the threshold) in the middle, and the difference between the two, scaled up 32x, at the
+// bottom. The difference should stay faint: a few levels at most, mostly at sharp edges.
+DEF_SIMPLE_GM_BG(imageblur_raster_downscale, canvas, 6 * 160, 3 * 160, SK_ColorBLACK) {
+    static constexpr int kSize = 160;
+    SkBitmap shapes;
+    shapes.allocN32Pixels(kSize, kSize);
+    shapes.eraseColor(SK_ColorTRANSPARENT);
+    {
+        SkCanvas offscreen(shapes);
+        SkPaint shapePaint;
+        shapePaint.setColor(SK_ColorWHITE);
+        offscreen.drawRect(SkRect::MakeXYWH(20, 20, 50, 120), shapePaint);
+        shapePaint.setColor(SK_ColorRED);
+        offscreen.drawCircle(110, 50, 30, shapePaint);
+        shapePaint.setColor(SK_ColorGREEN);
+        offscreen.drawRect(SkRect::MakeXYWH(80, 100, 60, 8), shapePaint);
+    }
+    auto onBlack = [](const std::function<void(SkCanvas*)>& draw) {
+        SkBitmap bitmap;
+        bitmap.allocN32Pixels(kSize, kSize);
+        SkCanvas offscreen(bitmap);
+        offscreen.clear(SK_ColorBLACK);
+        draw(&offscreen);
+        return bitmap;
+    };
+    // The blur algorithm itself never downscales, so calling it directly gives the full
+    // resolution blur without changing the threshold that other threads' blurs see.
+    auto fullRes = [&](float sigma) {
+        const SkBlurEngine::Algorithm* algorithm =
+                SkBlurEngine::GetRasterBlurEngine()->findAlgorithm({sigma, sigma},
+                                                                   shapes.colorType());
+        const SkIRect bounds = SkIRect::MakeSize(shapes.dimensions());
+        sk_sp<SkSpecialImage> blurred = algorithm->blur(
+                {sigma, sigma}, SkSpecialImages::MakeFromRaster(bounds, shapes, SkSurfaceProps()),
+                bounds, SkTileMode::kDecal, bounds);
+        return onBlack([&](SkCanvas* canvas) { blurred->draw(canvas, 0, 0); });
+    };
+
+    int x = 0;
+    for (float sigma : {16.f, 24.f, 32.f, 48.f, 64.f, 100.f}) {
+        SkBitmap full = fullRes(sigma);
+        SkBitmap downscaled = onBlack([&](SkCanvas* canvas) {
+            SkPaint paint;
+            paint.setImageFilter(SkImageFilters::Blur(sigma, sigma, nullptr));
+            canvas->drawImage(shapes.asImage(), 0, 0, SkSamplingOptions(), &paint);
+        });
+
+        SkBitmap diff;
+        diff.allocN32Pixels(kSize, kSize);
+        for (int py = 0; py < kSize; ++py) {
+            for (int px = 0; px < kSize; ++px) {
+                SkColor a = full.getColor(px, py),
+                        b = downscaled.getColor(px, py);
+                auto channel = [](int a, int b) { return std::min(255, 32 * std::abs(a - b)); };
+                *diff.getAddr32(px, py) = SkPreMultiplyARGB(
+                        255,
+                        channel(SkColorGetR(a), SkColorGetR(b)),
+                        channel(SkColorGetG(a), SkColorGetG(b)),
+                        channel(SkColorGetB(a), SkColorGetB(b)));
+            }
+        }
+
+        canvas->drawImage(full.asImage(), x, 0);
+        canvas->drawImage(downscaled.asImage(), x, kSize);
+        canvas->drawImage(diff.asImage(), x, 2 * kSize);
+        x += kSize;
+    }
+}
@@ -30,6 +30,7 @@
 #include <vector>
 
 class SkData;
+class SkExecutor;
 class SkFrameHolder;
 class SkImage;
 class SkPngChunkReader;
@@ -334,6 +335,7 @@ public:
             , fSubset(nullptr)
             , fFrameIndex(0)
             , fPriorFrame(kNoFrame)
+            , fExecutor(nullptr)
         {}
 
         ZeroInitialized            fZeroInitialized;
@@ -377,6 +379,16 @@ public:
          *  If set to kNoFrame, the codec will decode any necessary required frame(s) first.
          */
         int                        fPriorFrame;
+
+        /**
+         *  If not NULL, getPixels() may split the decode into independent parts and run them
+         *  on this executor, returning once they have all finished.
+         *
+         *  Only JPEGs with restart markers at MCU row boundaries can currently be split, when
+         *  decoded whole and unscaled from data in memory. Ignored by scanline and incremental
+         *  decodes.
+         */
+        SkExecutor*                fExecutor;
     };
 
     /**
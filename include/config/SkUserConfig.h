@@ -63,6 +63,12 @@
 */
 //#define SK_DEFAULT_IMAGE_CACHE_LIMIT (1024 * 1024)
 
+/* To split the image cache into independently locked shards, which helps when many threads
+   rasterize at once, define this to the number of shards. If this is undefined, the image cache
+   has a single shard.
+*/
+//#define SK_RESOURCE_CACHE_SHARD_COUNT 16
+
 /*  Define this to set the upper limit for text to support LCD. Values that
     are very large increase the cost in the font cache and draw slower, without
     improving readability. If this is undefined, Skia will use its default
@@ -21,6 +21,11 @@ public:
                                                           bool allowBorrowing = true);
     static std::unique_ptr<SkExecutor> MakeLIFOThreadPool(int threads = 0,
                                                           bool allowBorrowing = true);
+    // Like the above, but each thread has its own work queue and steals from the others when its
+    // own runs dry. This scales better when many small tasks are added at once. No ordering of
+    // work is guaranteed.
+    static std::unique_ptr<SkExecutor> MakeWorkStealingThreadPool(int threads = 0,
+                                                                  bool allowBorrowing = true);
 
     // There is always a default SkExecutor available by calling SkExecutor::GetDefault().
     static SkExecutor& GetDefault();
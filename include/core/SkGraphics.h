@@ -16,6 +16,7 @@
 #include <memory>
 
 class SkData;
+class SkExecutor;
 class SkImageGenerator;
 class SkOpenTypeSVGDecoder;
 class SkTraceMemoryDump;
@@ -140,6 +141,21 @@ public:
      */
     static void PurgeAllCaches();
 
+    /**
+     *  The raster backend can anti-alias a complex filled path faster by splitting it into
+     *  horizontal bands and rasterizing them concurrently. Once set, paths with at least minEdges
+     *  edges (counting each point of the path as one) have the coverage of their bands computed
+     *  on the executor, and then blitted on the drawing thread. Bands are sized so that each of
+     *  the executor's threads gets about two; pass its thread count as threads, or 0 for one
+     *  thread per core, as with SkExecutor::MakeFIFOThreadPool().
+     *
+     *  The executor must outlive all drawing with it. Pass nullptr (the default) to rasterize
+     *  every path on the drawing thread. This may be called while other threads draw; each
+     *  path uses the executor, thread count and minEdges of one call, the last one made before
+     *  the path starts drawing.
+     */
+    static void SetPathBandExecutor(SkExecutor* executor, int threads, int minEdges);
+
     typedef std::unique_ptr<SkImageGenerator>
                                             (*ImageGeneratorFromEncodedDataFactory)(sk_sp<SkData>);
 
@@ -19,6 +19,7 @@
 #include <cstdint>
 
 class GrRecordingContext;
+struct SkIRect;
 
 class SK_API SkImageGenerator {
 public:
@@ -89,6 +90,18 @@ public:
         return this->getPixels(pm.info(), pm.writable_addr(), pm.rowBytes());
     }
 
+    /**
+     *  Decode only the subset of the image into pm, whose dimensions must match the subset's.
+     *
+     *  Unlike the other methods, this may be called from several threads at once, even while
+     *  another thread is in getPixels(). That lets images that draw different parts of one
+     *  generator decode them in parallel.
+     *
+     *  Returns false if the generator can't decode this subset on its own (the default); the
+     *  caller should then decode the whole image with getPixels().
+     */
+    bool getSubsetPixels(const SkPixmap& pm, const SkIRect& subset);
+
     /**
      *  If decoding to YUV is supported, this returns true. Otherwise, this
      *  returns false and the caller will ignore output parameter yuvaPixmapInfo.
@@ -123,6 +136,8 @@ protected:
     virtual sk_sp<SkData> onRefEncodedData() { return nullptr; }
     struct Options {};
     virtual bool onGetPixels(const SkImageInfo&, void*, size_t, const Options&) { return false; }
+    // Must be thread-safe; see getSubsetPixels().
+    virtual bool onGetSubsetPixels(const SkPixmap&, const SkIRect&) { return false; }
     virtual bool onIsValid(GrRecordingContext*) const { return true; }
     virtual bool onIsProtected() const { return false; }
     virtual bool onQueryYUVAInfo(const SkYUVAPixmapInfo::SupportedDataTypes&,
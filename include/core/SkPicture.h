@@ -19,8 +19,11 @@
 
 class SkCanvas;
 class SkData;
+class SkExecutor;
 class SkMatrix;
+class SkPixmap;
 class SkStream;
+class SkSurfaceProps;
 class SkWStream;
 enum class SkFilterMode;
 struct SkDeserialProcs;
@@ -135,6 +138,27 @@ public:
     */
     virtual void playback(SkCanvas* canvas, AbortCallback* callback = nullptr) const = 0;
 
+    /** Draws SkPicture into dst, transformed by matrix, using several threads. dst is split into
+        tiles, and each tile is drawn by its own task on executor. Each task replays only the
+        commands that can touch its tile when SkPicture was recorded with an SkBBoxHierarchy
+        (e.g. from SkRTreeFactory); otherwise every task replays every command, clipped to its
+        tile. Pictures using backdrop filters or resetClip(), which reach outside a tile, or
+        SkDrawable are drawn by a single task. Returns once all tiles are drawn.
+
+        Paths (including transformed rects) that cross tile edges are clipped before they are scan
+        converted, so their edges may differ slightly from those drawn by playback().
+
+        @param dst       pixels to draw into
+        @param executor  runs the tile tasks; if nullptr, SkExecutor::GetDefault() is used
+        @param matrix    transform from SkPicture to dst coordinates; may be nullptr
+        @param props     LCD striping orientation and setting for device independent fonts;
+                         may be nullptr
+        @return          false if dst can't be drawn into, e.g. due to an unsupported color type
+    */
+    bool playbackParallel(const SkPixmap& dst, SkExecutor* executor,
+                          const SkMatrix* matrix = nullptr,
+                          const SkSurfaceProps* props = nullptr) const;
+
     /** Returns cull SkRect for this picture, passed in when SkPicture was created.
         Returned SkRect does not specify clipping SkRect for SkPicture; cull is hint
         of SkPicture bounds.
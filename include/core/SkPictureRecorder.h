@@ -13,6 +13,7 @@
 #include "include/core/SkScalar.h"
 #include "include/private/base/SkAPI.h"
 
+#include <cstdint>
 #include <memory>
 
 #ifdef SK_BUILD_FOR_ANDROID_FRAMEWORK
@@ -34,6 +35,14 @@ public:
     SkPictureRecorder();
     ~SkPictureRecorder();
 
+    enum RecordFlags : uint32_t {
+        // Store paths, text blobs and paint effects (shaders, filters, etc.) once per distinct
+        // content, shared by every draw that uses them, even if the caller created them
+        // separately. Saves memory when a picture repeats the same payloads many times, at the
+        // cost of hashing each one as it's recorded.
+        kInternPayloads_RecordFlag = 1 << 0,
+    };
+
     /** Returns the canvas that records the drawing commands.
         @param bounds the cull rect used when recording this picture. Any drawing the falls outside
                       of this rect is undefined, and may be drawn or it may not.
@@ -41,9 +50,11 @@ public:
         @param recordFlags optional flags that control recording.
         @return the canvas.
     */
-    SkCanvas* beginRecording(const SkRect& bounds, sk_sp<SkBBoxHierarchy> bbh);
+    SkCanvas* beginRecording(const SkRect& bounds, sk_sp<SkBBoxHierarchy> bbh,
+                             uint32_t recordFlags = 0);
 
-    SkCanvas* beginRecording(const SkRect& bounds, SkBBHFactory* bbhFactory = nullptr);
+    SkCanvas* beginRecording(const SkRect& bounds, SkBBHFactory* bbhFactory = nullptr,
+                             uint32_t recordFlags = 0);
 
     SkCanvas* beginRecording(SkScalar width, SkScalar height,
                              SkBBHFactory* bbhFactory = nullptr) {
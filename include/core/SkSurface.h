@@ -30,6 +30,7 @@ class SkBitmap;
 class SkCanvas;
 class SkCapabilities;
 class SkColorSpace;
+class SkExecutor;
 class SkPaint;
 class SkSurface;
 struct SkIRect;
@@ -82,6 +83,26 @@ inline sk_sp<SkSurface> Raster(const SkImageInfo& imageInfo,
     return Raster(imageInfo, 0, props);
 }
 
+/** Allocates raster SkSurface whose SkCanvas records draws instead of executing them right away.
+    Recorded draws are played back when the pixels are next needed: by makeImageSnapshot(),
+    peekPixels(), readPixels(), writePixels() or draw(). Playback splits the surface into tiles
+    and renders them in parallel on executor, which helps large surfaces on many-core machines.
+
+    Like a picture-recording canvas, the returned SkSurface's SkCanvas can't read or write pixels
+    itself; use the SkSurface methods instead. Pixel memory is zeroed before use.
+
+    @param imageInfo  width, height, SkColorType, SkAlphaType, SkColorSpace,
+                      of raster surface; width and height must be greater than zero
+    @param executor   runs the tile tasks; if nullptr, SkExecutor::GetDefault() is used.
+                      Must outlive the returned SkSurface.
+    @param props      LCD striping orientation and setting for device independent fonts;
+                      may be nullptr
+    @return           SkSurface if parameters are valid and memory was allocated, else nullptr.
+*/
+SK_API sk_sp<SkSurface> RasterMultiThreaded(const SkImageInfo& imageInfo,
+                                            SkExecutor* executor,
+                                            const SkSurfaceProps* props = nullptr);
+
 /** Allocates raster SkSurface. SkCanvas returned by SkSurface draws directly into the
     provided pixels.
 
@@ -19,6 +19,7 @@
 
 class GrDirectContext;
 class SkData;
+class SkExecutor;
 class SkImage;
 class SkPixmap;
 class SkWStream;
@@ -39,15 +40,27 @@ enum class FilterFlag : int {
 
 inline FilterFlag operator|(FilterFlag x, FilterFlag y) { return (FilterFlag)((int)x | (int)y); }
 
+/**
+ *  How often to choose between multiple filters (see Options::fFilterFlags).
+ */
+enum class FilterSelection : int {
+    // Estimate the cost of every allowed filter on every row, as libpng does.
+    kPerRow,
+    // Estimate the costs on every eighth row only, and filter the rows up to the next one the
+    // same way. Images tend to change slowly from row to row, so this gives nearly the same
+    // output size for a fraction of the cost.
+    kSampled,
+};
+
 struct Options {
     /**
      *  Selects which filtering strategies to use.
      *
-     *  If a single filter is chosen, libpng will use that filter for every row.
+     *  If a single filter is chosen, that filter is used for every row.
      *
-     *  If multiple filters are chosen, libpng will use a heuristic to guess which filter
-     *  will encode smallest, then apply that filter.  This happens on a per row basis,
-     *  different rows can use different filters.
+     *  If multiple filters are chosen, libpng's heuristic is used to guess which filter
+     *  will encode smallest, then that filter is applied.  This happens on a per row basis,
+     *  different rows can use different filters (see fFilterSelection).
      *
      *  Using a single filter (or less filters) is typically faster.  Trying all of the
      *  filters may help minimize the output file size.
@@ -56,6 +69,14 @@ struct Options {
      */
     FilterFlag fFilterFlags = FilterFlag::kAll;
 
+    /**
+     *  When multiple filters are chosen, whether the heuristic runs on every row or on a sample
+     *  of them.  kSampled is faster, typically at the cost of a slightly larger output.
+     *
+     *  The default picks the same filters as libpng.
+     */
+    FilterSelection fFilterSelection = FilterSelection::kPerRow;
+
     /**
      *  Must be in [0, 9] where 9 corresponds to maximal compression.  This value is passed
      *  directly to zlib.  0 is a special case to skip zlib entirely, creating dramatically
@@ -94,6 +115,15 @@ struct Options {
      */
     const SkPixmap* fGainmap = nullptr;
     const SkGainmapInfo* fGainmapInfo = nullptr;
+
+    /**
+     *  If not NULL, rows are filtered and compressed in parallel on this executor, in bands
+     *  that are each deflated on their own and joined into a single zlib stream. The output is
+     *  a valid PNG, slightly larger than a serial encode's.
+     *
+     *  Images too small to split into more than one band are encoded serially.
+     */
+    SkExecutor* fExecutor = nullptr;
 };
 
 /**
@@ -12,6 +12,7 @@
 #include "include/core/SkData.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkPixmap.h"
+#include "include/core/SkRect.h"
 #include "include/core/SkStream.h"
 #include "include/core/SkTypes.h"
 #include "src/codec/SkPixmapUtilsPriv.h"
@@ -25,7 +26,8 @@ std::unique_ptr<SkImageGenerator> SkCodecImageGenerator::MakeFromEncodedCodec(
         return nullptr;
     }
 
-    return std::unique_ptr<SkImageGenerator>(new SkCodecImageGenerator(std::move(codec), at));
+    return std::unique_ptr<SkImageGenerator>(
+            new SkCodecImageGenerator(std::move(codec), at, std::move(data)));
 }
 
 std::unique_ptr<SkImageGenerator> SkCodecImageGenerator::MakeFromCodec(
@@ -52,11 +54,17 @@ static SkImageInfo adjust_info(SkCodec* codec, std::optional<SkAlphaType> at) {
 }
 
 SkCodecImageGenerator::SkCodecImageGenerator(std::unique_ptr<SkCodec> codec,
-                                             std::optional<SkAlphaType> at)
-        : SkImageGenerator(adjust_info(codec.get(), at)), fCodec(std::move(codec)) {}
+                                             std::optional<SkAlphaType> at,
+                                             sk_sp<SkData> encodedData)
+        : SkImageGenerator(adjust_info(codec.get(), at))
+        , fCodec(std::move(codec))
+        , fEncodedData(std::move(encodedData)) {}
 
 sk_sp<SkData> SkCodecImageGenerator::onRefEncodedData() {
     SkASSERT(fCodec);
+    if (fEncodedData) {
+        return fEncodedData;
+    }
     if (!fCachedData) {
         std::unique_ptr<SkStream> stream = fCodec->getEncodedData();
         fCachedData = stream->getData();
@@ -91,6 +99,30 @@ bool SkCodecImageGenerator::onGetPixels(const SkImageInfo& requestInfo, void* re
     return this->getPixels(requestInfo, requestPixels, requestRowBytes, nullptr);
 }
 
+bool SkCodecImageGenerator::onGetSubsetPixels(const SkPixmap& dst, const SkIRect& subset) {
+    // Another thread may be decoding with fCodec, so this decodes with a codec of its own. That's
+    // only worth it if the codec can decode the subset directly, without reorienting the image.
+    if (!fEncodedData || fCodec->getOrigin() != kTopLeft_SkEncodedOrigin) {
+        return false;
+    }
+    std::unique_ptr<SkCodec> codec = SkCodec::MakeFromData(fEncodedData);
+    SkIRect validSubset = subset;
+    if (!codec || !codec->getValidSubset(&validSubset) || validSubset != subset) {
+        return false;
+    }
+
+    SkCodec::Options options;
+    options.fSubset = &validSubset;
+    switch (codec->getPixels(dst, &options)) {
+        case SkCodec::kSuccess:
+        case SkCodec::kIncompleteInput:
+        case SkCodec::kErrorInInput:
+            return true;
+        default:
+            return false;
+    }
+}
+
 bool SkCodecImageGenerator::onQueryYUVAInfo(
         const SkYUVAPixmapInfo::SupportedDataTypes& supportedDataTypes,
         SkYUVAPixmapInfo* yuvaPixmapInfo) const {
@@ -19,6 +19,8 @@
 #include <optional>
 
 enum SkAlphaType : int;
+class SkPixmap;
+struct SkIRect;
 struct SkImageInfo;
 
 class SkCodecImageGenerator : public SkImageGenerator {
@@ -110,6 +112,8 @@ protected:
                      size_t rowBytes,
                      const Options& opts) override;
 
+    bool onGetSubsetPixels(const SkPixmap&, const SkIRect&) override;
+
     bool onQueryYUVAInfo(const SkYUVAPixmapInfo::SupportedDataTypes&,
                          SkYUVAPixmapInfo*) const override;
 
@@ -119,9 +123,13 @@ private:
     /*
      * Takes ownership of codec
      */
-    SkCodecImageGenerator(std::unique_ptr<SkCodec>, std::optional<SkAlphaType>);
+    SkCodecImageGenerator(std::unique_ptr<SkCodec>, std::optional<SkAlphaType>,
+                          sk_sp<SkData> encodedData = nullptr);
 
     std::unique_ptr<SkCodec> fCodec;
     sk_sp<SkData> fCachedData = nullptr;
+    // The data fCodec was made from, if known up front. Unlike fCachedData, it never changes, so
+    // onGetSubsetPixels() can read it without the caller's lock.
+    const sk_sp<SkData> fEncodedData;
 };
 #endif  // SkCodecImageGenerator_DEFINED
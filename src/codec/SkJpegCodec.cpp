@@ -26,20 +26,26 @@
 #include "src/codec/SkJpegDecoderMgr.h"
 #include "src/codec/SkJpegMetadataDecoderImpl.h"
 #include "src/codec/SkJpegPriv.h"
+#include "src/codec/SkJpegRestartIndex.h"
 #include "src/codec/SkParseEncodedOrigin.h"
 #include "src/codec/SkSwizzler.h"
+#include "src/core/SkTaskGroup.h"
 
 #ifdef SK_CODEC_DECODES_JPEG_GAINMAPS
 #include "include/private/SkGainmapInfo.h"
 #endif  // SK_CODEC_DECODES_JPEG_GAINMAPS
 
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <csetjmp>
 #include <cstring>
 #include <utility>
+#include <vector>
 
 using namespace skia_private;
 
+class SkArenaAlloc;
 class SkSampler;
 struct SkGainmapInfo;
 
@@ -487,6 +493,10 @@ SkCodec::Result SkJpegCodec::onGetPixels(const SkImageInfo& dstInfo,
         return kUnimplemented;
     }
 
+    if (this->decodeInBands(dstInfo, dst, dstRowBytes, options)) {
+        return kSuccess;
+    }
+
     // Get a pointer to the decompress info since we will use it quite frequently
     jpeg_decompress_struct* dinfo = fDecoderMgr->dinfo();
 
@@ -564,6 +574,102 @@ SkCodec::Result SkJpegCodec::onGetPixels(const SkImageInfo& dstInfo,
     return kSuccess;
 }
 
+const SkJpegRestartIndex* SkJpegCodec::restartIndex() {
+    if (!fRestartIndexBuilt) {
+        fRestartIndexBuilt = true;
+        // Bands are cut from the encoded data, so it all has to be in memory.
+        SkStream* stream = this->stream();
+        if (stream->getMemoryBase() && stream->hasLength()) {
+            fRestartIndex = SkJpegRestartIndex::Make(
+                    SkData::MakeWithoutCopy(stream->getMemoryBase(), stream->getLength()));
+        }
+    }
+    return fRestartIndex.get();
+}
+
+bool SkJpegCodec::decodeInBands(const SkImageInfo& dstInfo, void* dst, size_t dstRowBytes,
+                                const Options& options) {
+    // Splitting costs each band its own header parse, plus (with vertically subsampled chroma)
+    // up to a restart interval above and an MCU row below for upsampling context, so bands
+    // are kept large.
+    static constexpr int kMinBandPixels  = 1 << 18;
+    static constexpr int kMinBandMcuRows = 32;
+    static constexpr int kMaxBands       = 32;
+
+    if (!options.fExecutor || options.fFrameIndex != 0 ||
+        dstInfo.dimensions() != this->dimensions() ||
+        (int64_t)dstInfo.width() * dstInfo.height() < 2 * kMinBandPixels) {
+        return false;
+    }
+    if (!this->restartIndex()) {
+        return false;
+    }
+    const SkJpegRestartIndex& index = *fRestartIndex;
+    const std::vector<int>& restartRows = index.restartRows();
+    const int mcuRows = index.mcuRows(),
+              mcuHeight = index.mcuRowHeight();
+
+    // Start each band at the first restart row at or after an even split of the image.
+    const int64_t pixels = (int64_t)index.width() * index.height();
+    const int targetBands = (int)std::min<int64_t>({kMaxBands,
+                                                    pixels / kMinBandPixels,
+                                                    mcuRows / kMinBandMcuRows});
+    std::vector<int> bandRows;
+    for (int i = 0; i < targetBands; i++) {
+        auto row = std::lower_bound(restartRows.begin(), restartRows.end(),
+                                    (int)((int64_t)i * mcuRows / targetBands));
+        if (row != restartRows.end() && (bandRows.empty() || *row > bandRows.back())) {
+            bandRows.push_back(*row);
+        }
+    }
+    if (bandRows.size() < 2) {
+        return false;
+    }
+    bandRows.push_back(mcuRows);
+    const int bands = (int)bandRows.size() - 1;
+
+    // If the file didn't supply the profile, the bands have to be told about it too.
+    const skcms_ICCProfile* profile = this->getEncodedInfo().profile();
+
+    Options bandOptions = options;
+    bandOptions.fExecutor = nullptr;
+
+    std::atomic<bool> failed{false};
+    SkTaskGroup(*options.fExecutor).parallelFor(bands, 1, [&](int start, int end, SkArenaAlloc*) {
+        for (int band = start; band < end && !failed; band++) {
+            const int firstRow = bandRows[band],
+                      endRow = bandRows[band + 1];
+            int decodeFirstRow = firstRow,
+                decodeEndRow = endRow;
+            if (index.needsVerticalContext()) {
+                if (firstRow > 0) {
+                    decodeFirstRow = *(std::lower_bound(restartRows.begin(), restartRows.end(),
+                                                        firstRow) - 1);
+                }
+                decodeEndRow = std::min(endRow + 1, mcuRows);
+            }
+
+            Result result;
+            std::unique_ptr<SkCodec> codec = SkJpegCodec::MakeFromStream(
+                    SkMemoryStream::Make(index.makeBand(decodeFirstRow, decodeEndRow)),
+                    &result,
+                    profile ? SkEncodedInfo::ICCProfile::Make(*profile) : nullptr);
+
+            const int top = firstRow * mcuHeight,
+                      rows = std::min(endRow * mcuHeight, index.height()) - top;
+            if (!codec ||
+                kSuccess != codec->startScanlineDecode(
+                                    dstInfo.makeDimensions(codec->dimensions()), &bandOptions) ||
+                !codec->skipScanlines((firstRow - decodeFirstRow) * mcuHeight) ||
+                rows != codec->getScanlines(SkTAddOffset<void>(dst, top * dstRowBytes),
+                                            rows, dstRowBytes)) {
+                failed = true;
+            }
+        }
+    });
+    return !failed;
+}
+
 bool SkJpegCodec::allocateStorage(const SkImageInfo& dstInfo) {
     int dstWidth = dstInfo.width();
 
@@ -657,6 +763,8 @@ SkSampler* SkJpegCodec::getSampler(bool createIfNecessary) {
 
 SkCodec::Result SkJpegCodec::onStartScanlineDecode(const SkImageInfo& dstInfo,
         const Options& options) {
+    fRegionCodec.reset();
+
     // Set the jump location for libjpeg errors
     skjpeg_error_mgr::AutoPushJmpBuf jmp(fDecoderMgr->errorMgr());
     if (setjmp(jmp)) {
@@ -722,6 +830,10 @@ SkCodec::Result SkJpegCodec::onStartScanlineDecode(const SkImageInfo& dstInfo,
 }
 
 int SkJpegCodec::onGetScanlines(void* dst, int count, size_t dstRowBytes) {
+    if (fRegionCodec) {
+        return fRegionCodec->getScanlines(dst, count, dstRowBytes);
+    }
+
     int rows = 0;
     this->readRows(this->dstInfo(), dst, dstRowBytes, count, this->options(), &rows);
     if (rows < count) {
@@ -733,6 +845,13 @@ int SkJpegCodec::onGetScanlines(void* dst, int count, size_t dstRowBytes) {
 }
 
 bool SkJpegCodec::onSkipScanlines(int count) {
+    if (fRegionCodec) {
+        return fRegionCodec->skipScanlines(count);
+    }
+    if (this->skipToRestartRow(count)) {
+        return true;
+    }
+
     // Set the jump location for libjpeg errors
     skjpeg_error_mgr::AutoPushJmpBuf jmp(fDecoderMgr->errorMgr());
     if (setjmp(jmp)) {
@@ -742,6 +861,51 @@ bool SkJpegCodec::onSkipScanlines(int count) {
     return (uint32_t) count == jpeg_skip_scanlines(fDecoderMgr->dinfo(), count);
 }
 
+bool SkJpegCodec::skipToRestartRow(int count) {
+    // Only an unscaled decode that hasn't read any rows yet can switch to a band, and only if
+    // the band's own swizzler (if any) would sample the same columns.
+    if (this->currScanline() != 0 || this->dstInfo().dimensions() != this->dimensions() ||
+        (fSwizzler && fSwizzler->sampleX() != 1) || !this->restartIndex()) {
+        return false;
+    }
+    const SkJpegRestartIndex& index = *fRestartIndex;
+    const std::vector<int>& restartRows = index.restartRows();
+    const int mcuHeight = index.mcuRowHeight();
+
+    // With vertically subsampled chroma, the first row needs the MCU row above it for context.
+    const int contextRow = count / mcuHeight - (index.needsVerticalContext() ? 1 : 0);
+    auto after = std::upper_bound(restartRows.begin(), restartRows.end(), contextRow);
+    if (after == restartRows.begin() || *(after - 1) == 0) {
+        return false;
+    }
+    const int bandRow = *(after - 1),
+              bandTop = bandRow * mcuHeight;
+
+    const skcms_ICCProfile* profile = this->getEncodedInfo().profile();
+    Result result;
+    std::unique_ptr<SkCodec> codec = SkJpegCodec::MakeFromStream(
+            SkMemoryStream::Make(index.makeBand(bandRow, index.mcuRows())),
+            &result,
+            profile ? SkEncodedInfo::ICCProfile::Make(*profile) : nullptr);
+    if (!codec) {
+        return false;
+    }
+
+    const SkImageInfo bandInfo = this->dstInfo().makeDimensions(codec->dimensions());
+    Options bandOptions = this->options();
+    if (bandOptions.fSubset) {
+        fRegionSubset = SkIRect::MakeXYWH(bandOptions.fSubset->x(), 0,
+                                          bandOptions.fSubset->width(), bandInfo.height());
+        bandOptions.fSubset = &fRegionSubset;
+    }
+    if (kSuccess != codec->startScanlineDecode(bandInfo, &bandOptions) ||
+        !codec->skipScanlines(count - bandTop)) {
+        return false;
+    }
+    fRegionCodec = std::move(codec);
+    return true;
+}
+
 static bool is_yuv_supported(const jpeg_decompress_struct* dinfo,
                              const SkJpegCodec& codec,
                              const SkYUVAPixmapInfo::SupportedDataTypes* supportedDataTypes,
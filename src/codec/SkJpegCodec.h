@@ -23,6 +23,7 @@
 #include <memory>
 
 class JpegDecoderMgr;
+class SkJpegRestartIndex;
 class SkSampler;
 class SkStream;
 class SkSwizzler;
@@ -133,6 +134,25 @@ private:
     Result readRows(const SkImageInfo& dstInfo, void* dst, size_t rowBytes, int count,
                   const Options&, int* rowsDecoded);
 
+    /*
+     * Decodes the whole image as independent bands on options.fExecutor, if its restart markers
+     * allow that. Returns false if it can't, or if any band fails; the caller should then decode
+     * it serially.
+     */
+    bool decodeInBands(const SkImageInfo& dstInfo, void* dst, size_t rowBytes,
+                       const Options& options);
+
+    // Returns the index of the image's restart markers, building it on first use, or nullptr
+    // if the image can't be split into bands.
+    const SkJpegRestartIndex* restartIndex();
+
+    /*
+     * Starts a scanline decode that is about to skip count rows from the top over again, from
+     * the last restart marker above the rows it wants, so the rows above that aren't decoded.
+     * The rest of the decode is passed on to fRegionCodec. Returns false if it can't.
+     */
+    bool skipToRestartRow(int count);
+
     /*
      * Scanline decoding.
      */
@@ -160,6 +180,14 @@ private:
 
     std::unique_ptr<SkSwizzler>        fSwizzler;
 
+    // Built by the first restartIndex(); null if the image can't be split.
+    std::unique_ptr<SkJpegRestartIndex> fRestartIndex;
+    bool                                fRestartIndexBuilt = false;
+    // Decodes the rest of a scanline decode after skipToRestartRow(), which keeps a pointer to
+    // fRegionSubset.
+    std::unique_ptr<SkCodec>            fRegionCodec;
+    SkIRect                             fRegionSubset = SkIRect::MakeEmpty();
+
     friend class SkRawCodec;
 
     using INHERITED = SkCodec;
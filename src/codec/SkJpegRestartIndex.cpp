@@ -0,0 +1,184 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/codec/SkJpegRestartIndex.h"
+
+#include "include/core/SkData.h"
+#include "include/private/base/SkAssert.h"
+#include "src/codec/SkCodecPriv.h"
+#include "src/codec/SkJpegConstants.h"
+#include "src/codec/SkJpegSegmentScan.h"
+
+#include <algorithm>
+#include <cstring>
+
+// Baseline and extended sequential, Huffman-coded frames. Every other start of frame marker
+// (progressive, lossless, hierarchical or arithmetic-coded) is rejected.
+static constexpr uint8_t kJpegMarkerStartOfFrameBaseline = 0xC0;
+static constexpr uint8_t kJpegMarkerStartOfFrameExtended = 0xC1;
+static constexpr uint8_t kJpegMarkerDefineRestartInterval = 0xDD;
+static constexpr uint8_t kJpegMarkerRestart0 = 0xD0;
+static constexpr uint8_t kJpegMarkerRestart7 = 0xD7;
+
+static bool is_unsupported_start_of_frame(uint8_t marker) {
+    // 0xC4 (DHT), 0xC8 (JPG) and 0xCC (DAC) share the range, but aren't frames.
+    return marker >= 0xC2 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC;
+}
+
+static int read_u16(const uint8_t* p) { return (p[0] << 8) | p[1]; }
+
+std::unique_ptr<SkJpegRestartIndex> SkJpegRestartIndex::Make(sk_sp<SkData> jpeg) {
+    if (!jpeg) {
+        return nullptr;
+    }
+    SkJpegSegmentScanner scanner;
+    scanner.onBytes(jpeg->data(), jpeg->size());
+    if (!scanner.isDone()) {
+        return nullptr;
+    }
+
+    std::unique_ptr<SkJpegRestartIndex> index(new SkJpegRestartIndex);
+    const uint8_t* bytes = jpeg->bytes();
+    int frameComponents = 0, scanComponents = 0, maxH = 1, maxV = 1;
+    bool sawFrame = false, sawScan = false;
+    for (const SkJpegSegment& segment : scanner.getSegments()) {
+        const uint8_t marker = segment.marker;
+        if (sawScan) {
+            // Only restart markers may follow the one scan, and they must count up modulo 8.
+            if (marker >= kJpegMarkerRestart0 && marker <= kJpegMarkerRestart7) {
+                const size_t n = index->fRestartMarkerOffsets.size();
+                if (marker != kJpegMarkerRestart0 + (n & 7)) {
+                    return nullptr;
+                }
+                index->fRestartMarkerOffsets.push_back(segment.offset);
+            } else if (marker == kJpegMarkerEndOfImage) {
+                index->fEndOfImageOffset = segment.offset;
+            } else {
+                return nullptr;
+            }
+            continue;
+        }
+
+        const uint8_t* params =
+                bytes + segment.offset + kJpegMarkerCodeSize + kJpegSegmentParameterLengthSize;
+        const size_t paramSize = segment.parameterLength > kJpegSegmentParameterLengthSize
+                                         ? segment.parameterLength - kJpegSegmentParameterLengthSize
+                                         : 0;
+        if (marker == kJpegMarkerStartOfFrameBaseline ||
+            marker == kJpegMarkerStartOfFrameExtended) {
+            if (sawFrame || paramSize < 6 || params[0] != 8) {
+                return nullptr;
+            }
+            index->fHeight = read_u16(params + 1);
+            index->fWidth = read_u16(params + 3);
+            frameComponents = params[5];
+            if (frameComponents < 1 || paramSize < 6 + 3 * (size_t)frameComponents) {
+                return nullptr;
+            }
+            for (int c = 0; c < frameComponents; c++) {
+                const int h = params[6 + 3 * c + 1] >> 4,
+                          v = params[6 + 3 * c + 1] & 0xF;
+                if (h < 1 || h > 4 || v < 1 || v > 4) {
+                    return nullptr;
+                }
+                maxH = std::max(maxH, h);
+                maxV = std::max(maxV, v);
+            }
+            index->fFrameHeightOffset = params + 1 - bytes;
+            sawFrame = true;
+        } else if (is_unsupported_start_of_frame(marker)) {
+            return nullptr;
+        } else if (marker == kJpegMarkerDefineRestartInterval) {
+            if (paramSize < 2) {
+                return nullptr;
+            }
+            index->fRestartInterval = read_u16(params);
+        } else if (marker == kJpegMarkerStartOfScan) {
+            if (!sawFrame || paramSize < 1) {
+                return nullptr;
+            }
+            scanComponents = params[0];
+            index->fHeaderSize = segment.offset + kJpegMarkerCodeSize + segment.parameterLength;
+            sawScan = true;
+        }
+    }
+
+    if (!sawScan || !index->fEndOfImageOffset || index->fWidth <= 0 || index->fHeight <= 0 ||
+        index->fRestartInterval <= 0 || scanComponents != frameComponents) {
+        return nullptr;
+    }
+
+    // A scan of one component has one block per MCU; otherwise an MCU covers a block of each
+    // component at its sampling factors (section A.2).
+    const int mcuWidth  = frameComponents == 1 ? 8 : 8 * maxH;
+    index->fMcuHeight   = frameComponents == 1 ? 8 : 8 * maxV;
+    index->fMcusPerRow  = (index->fWidth + mcuWidth - 1) / mcuWidth;
+    const int mcuRows   = index->mcuRows();
+    const int64_t mcus  = (int64_t)index->fMcusPerRow * mcuRows;
+    const int64_t intervals = (mcus + index->fRestartInterval - 1) / index->fRestartInterval;
+    if ((int64_t)index->fRestartMarkerOffsets.size() != intervals - 1) {
+        SkCodecPrintf("Expected %lld restart markers, found %zu\n",
+                      (long long)(intervals - 1), index->fRestartMarkerOffsets.size());
+        return nullptr;
+    }
+
+    for (int row = 0; row < mcuRows; row++) {
+        if ((int64_t)row * index->fMcusPerRow % index->fRestartInterval == 0) {
+            index->fRestartRows.push_back(row);
+        }
+    }
+    if (index->fRestartRows.size() < 2) {
+        return nullptr;
+    }
+
+    index->fData = std::move(jpeg);
+    return index;
+}
+
+size_t SkJpegRestartIndex::intervalStart(int interval) const {
+    return interval == 0 ? fHeaderSize
+                         : fRestartMarkerOffsets[interval - 1] + kJpegMarkerCodeSize;
+}
+
+size_t SkJpegRestartIndex::intervalEnd(int interval) const {
+    SkASSERT(interval > 0);
+    return interval <= (int)fRestartMarkerOffsets.size() ? fRestartMarkerOffsets[interval - 1]
+                                                         : fEndOfImageOffset;
+}
+
+sk_sp<SkData> SkJpegRestartIndex::makeBand(int firstRow, int endRow) const {
+    SkASSERT(std::binary_search(fRestartRows.begin(), fRestartRows.end(), firstRow));
+    endRow = std::min(endRow, this->mcuRows());
+    SkASSERT(firstRow < endRow);
+
+    // The band's entropy-coded data runs from the start of its first interval to the end of the
+    // interval holding its last MCU.
+    const int firstInterval = this->intervalOfRow(firstRow);
+    const int endInterval =
+            (int)(((int64_t)endRow * fMcusPerRow - 1) / fRestartInterval) + 1;
+    const size_t start = this->intervalStart(firstInterval),
+                 end   = this->intervalEnd(endInterval);
+
+    const size_t size = fHeaderSize + (end - start) + kJpegMarkerCodeSize;
+    sk_sp<SkData> band = SkData::MakeUninitialized(size);
+    uint8_t* dst = static_cast<uint8_t*>(band->writable_data());
+    memcpy(dst, fData->bytes(), fHeaderSize);
+    memcpy(dst + fHeaderSize, fData->bytes() + start, end - start);
+    dst[size - 2] = 0xFF;
+    dst[size - 1] = kJpegMarkerEndOfImage;
+
+    const int height = std::min(endRow * fMcuHeight, fHeight) - firstRow * fMcuHeight;
+    dst[fFrameHeightOffset + 0] = height >> 8;
+    dst[fFrameHeightOffset + 1] = height & 0xFF;
+
+    // The decoder expects the band's restart markers to count from RST0.
+    for (int i = firstInterval; i < endInterval - 1; i++) {
+        const size_t marker = fHeaderSize + (fRestartMarkerOffsets[i] - start) + 1;
+        dst[marker] = kJpegMarkerRestart0 + ((i - firstInterval) & 7);
+    }
+    return band;
+}
@@ -0,0 +1,78 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkJpegRestartIndex_codec_DEFINED
+#define SkJpegRestartIndex_codec_DEFINED
+
+#include "include/core/SkRefCnt.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class SkData;
+
+/*
+ * An index of the restart markers in a JPEG, which lets it be decoded in independent horizontal
+ * bands. The entropy decoder's state is reset at each restart marker, so a band that starts at a
+ * marker which falls on an MCU row boundary can be decoded on its own: makeBand() wraps its
+ * entropy-coded data in a copy of the image's header, with the height changed to the band's.
+ *
+ * Only sequential, Huffman-coded JPEGs whose single scan holds every component can be indexed.
+ */
+class SkJpegRestartIndex {
+public:
+    // Returns nullptr if the image isn't one that can be split into bands, or if fewer than two of
+    // its MCU rows start at a restart marker.
+    static std::unique_ptr<SkJpegRestartIndex> Make(sk_sp<SkData> jpeg);
+
+    int width() const { return fWidth; }
+    int height() const { return fHeight; }
+
+    // The height of an MCU row, in pixels.
+    int mcuRowHeight() const { return fMcuHeight; }
+    // The number of MCU rows in the image.
+    int mcuRows() const { return (fHeight + fMcuHeight - 1) / fMcuHeight; }
+    // True if chroma is subsampled vertically. Upsampling it then blends neighboring MCU rows, so
+    // a band needs one MCU row of context above and below the rows it's used for.
+    bool needsVerticalContext() const { return fMcuHeight > 8; }
+
+    // The MCU rows that begin with a restart marker (or the image), in increasing order. The first
+    // is always zero.
+    const std::vector<int>& restartRows() const { return fRestartRows; }
+
+    // Returns a standalone JPEG holding MCU rows [firstRow, endRow) of this one, where firstRow is
+    // one of restartRows(). Its data may extend past endRow, up to the next restart marker.
+    sk_sp<SkData> makeBand(int firstRow, int endRow) const;
+
+private:
+    SkJpegRestartIndex() = default;
+
+    // The offset of the first byte of the entropy-coded data that follows restart interval i.
+    size_t intervalStart(int interval) const;
+    // The offset just past the entropy-coded data for the intervals before interval, or the end
+    // of all of it if interval is past the last one.
+    size_t intervalEnd(int interval) const;
+    // The interval that MCU row starts.
+    int intervalOfRow(int row) const {
+        return (int)((int64_t)row * fMcusPerRow / fRestartInterval);
+    }
+
+    sk_sp<SkData> fData;
+    int fWidth = 0, fHeight = 0;
+    int fMcuHeight = 0, fMcusPerRow = 0;
+    int fRestartInterval = 0;  // In MCUs.
+
+    size_t fFrameHeightOffset = 0;  // Where the height is stored in the start of frame segment.
+    size_t fHeaderSize = 0;         // Everything up to the end of the start of scan segment.
+    size_t fEndOfImageOffset = 0;
+    std::vector<size_t> fRestartMarkerOffsets;  // Of the 0xFF of each RSTn marker.
+    std::vector<int> fRestartRows;
+};
+
+#endif
@@ -26,6 +26,7 @@
 #include "src/codec/SkCodecPriv.h"
 #include "src/codec/SkPngCompositeChunkReader.h"
 #include "src/codec/SkPngPriv.h"
+#include "src/codec/SkPngRowIndex.h"
 #include "src/codec/SkSwizzler.h"
 
 #include <csetjmp>
@@ -225,6 +226,16 @@ bool SkPngCodec::processData() {
             SkASSERT(false);
     }
 
+    if (fRegionIdat) {
+        // The stand-in chunk holds every row that was asked for.
+        if (!fDecodedIdat) {
+            fDecodedIdat = true;
+            png_process_data(fPng_ptr, fInfo_ptr, (png_bytep)fRegionIdat->data(),
+                             fRegionIdat->size());
+        }
+        return true;
+    }
+
     // Arbitrary buffer size
     constexpr size_t kBufferSize = 4096;
     char buffer[kBufferSize];
@@ -263,6 +274,31 @@ bool SkPngCodec::processData() {
     return true;
 }
 
+int SkPngCodec::skipToRow(int firstRow, int endRow) {
+    // Enough checkpoints for a region decode to start within a few dozen rows of where it's
+    // asked to in most images.
+    static constexpr size_t kRowIndexByteLimit = 2 << 20;
+
+    if (firstRow == 0) {
+        return 0;
+    }
+    if (!fRowIndexBuilt) {
+        fRowIndexBuilt = true;
+        // The index reads the IDAT chunks directly, so they all have to be in memory.
+        SkStream* stream = this->stream();
+        if (stream->getMemoryBase() && stream->hasLength()) {
+            fRowIndex = SkPngRowIndex::Make(
+                    SkData::MakeWithoutCopy(stream->getMemoryBase(), stream->getLength()),
+                    kRowIndexByteLimit);
+        }
+    }
+    if (!fRowIndex) {
+        return 0;
+    }
+    fRegionIdat = fRowIndex->makeIdat(firstRow, endRow);
+    return fRegionIdat ? firstRow : 0;
+}
+
 std::optional<SkSpan<const SkPngCodecBase::PaletteColorEntry>> SkPngCodec::onTryGetPlteChunk() {
     int numColors;
     png_color* palette;
@@ -436,6 +472,7 @@ private:
     int                         fFirstRow;  // FIXME: Move to baseclass?
     int                         fLastRow;
     int                         fRowsNeeded;
+    int                         fRowOffset = 0;  // The row libpng starts at, from skipToRow().
 
     static SkPngNormalDecoder* GetDecoder(png_structp png_ptr) {
         return static_cast<SkPngNormalDecoder*>(png_get_progressive_ptr(png_ptr));
@@ -478,6 +515,7 @@ private:
         fRowBytes = rowBytes;
         fRowsWrittenToOutput = 0;
         fRowsNeeded = fLastRow - fFirstRow + 1;
+        fRowOffset = this->skipToRow(firstRow, lastRow + 1);
         return kSuccess;
     }
 
@@ -500,6 +538,7 @@ private:
     }
 
     void rowCallback(png_bytep row, int rowNum) {
+        rowNum += fRowOffset;
         if (rowNum < fFirstRow) {
             // Ignore this row.
             return;
@@ -994,6 +1033,7 @@ bool SkPngCodec::onRewind() {
     fPng_ptr = png_ptr;
     fInfo_ptr = info_ptr;
     fDecodedIdat = false;
+    fRegionIdat = nullptr;
     return true;
 }
 
@@ -17,8 +17,10 @@
 #include "include/private/SkGainmapInfo.h"
 #include "src/codec/SkPngCodecBase.h"
 
+class SkData;
 class SkPngChunkReader;
 class SkPngCompositeChunkReader;
+class SkPngRowIndex;
 class SkStream;
 struct SkEncodedInfo;
 struct SkImageInfo;
@@ -78,6 +80,15 @@ protected:
      */
     bool processData();
 
+    /**
+     *  Lets the next processData() start at firstRow without decoding the rows above it, by
+     *  giving libpng a stand-in for the IDAT chunks that holds only rows [firstRow, endRow).
+     *
+     *  Returns the row libpng's first row will be: firstRow, or 0 if the rows above will have
+     *  to be decoded after all.
+     */
+    int skipToRow(int firstRow, int endRow);
+
     Result onStartIncrementalDecode(const SkImageInfo& dstInfo, void* pixels, size_t rowBytes,
             const SkCodec::Options&) override;
     Result onIncrementalDecode(int*) override;
@@ -103,6 +114,13 @@ private:
 
     size_t                         fIdatLength;
     bool                           fDecodedIdat;
+
+    // Built by the first skipToRow(); null if the image can't be indexed.
+    std::unique_ptr<SkPngRowIndex> fRowIndex;
+    bool                           fRowIndexBuilt = false;
+    // The stand-in IDAT chunk from skipToRow(), if any, for the current decode.
+    sk_sp<SkData>                  fRegionIdat;
+
     std::unique_ptr<SkStream> fGainmapStream;
     std::optional<SkGainmapInfo> fGainmapInfo;
 };
@@ -0,0 +1,416 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/codec/SkPngRowIndex.h"
+
+#include "include/core/SkData.h"
+#include "include/private/base/SkAssert.h"
+#include "include/private/base/SkMalloc.h"
+#include "include/private/base/SkTFitsIn.h"
+#include "include/private/base/SkTemplates.h"
+#include "src/codec/SkCodecPriv.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+
+#include "zlib.h"  // NO_G3_REWRITE
+
+namespace {
+
+// Allocations are prefixed with their size, so the index can keep count of its inflaters' memory.
+constexpr size_t kAllocHeader = alignof(std::max_align_t);
+
+// Different zlib implementations use different T.
+template <typename T> void* counting_alloc_func(void* bytesAllocated, T items, T size) {
+    if (!SkTFitsIn<size_t>(size) || !size || (SIZE_MAX - kAllocHeader) / size < items) {
+        return nullptr;
+    }
+    const size_t bytes = (size_t)items * (size_t)size;
+    auto header = static_cast<size_t*>(sk_malloc_canfail(kAllocHeader + bytes));
+    if (!header) {
+        return nullptr;
+    }
+    *header = bytes;
+    *static_cast<size_t*>(bytesAllocated) += bytes;
+    return SkTAddOffset<void>(header, kAllocHeader);
+}
+
+void counting_free_func(void* bytesAllocated, void* address) {
+    auto header = SkTAddOffset<size_t>(address, -(ptrdiff_t)kAllocHeader);
+    *static_cast<size_t*>(bytesAllocated) -= *header;
+    sk_free(header);
+}
+
+uint32_t read_u32(const uint8_t* p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+uint8_t* write_u32(uint8_t* p, uint32_t v) {
+    p[0] = v >> 24;
+    p[1] = v >> 16;
+    p[2] = v >> 8;
+    p[3] = v;
+    return p + 4;
+}
+
+bool is_chunk(const uint8_t* chunk, const char* tag) { return 0 == memcmp(chunk + 4, tag, 4); }
+
+// Reverses a row's filter in place (section 9 of the PNG spec).
+bool unfilter(uint8_t filter, uint8_t* row, const uint8_t* prev, size_t rowBytes, size_t bpp) {
+    switch (filter) {
+        case 0:  // None
+            return true;
+        case 1:  // Sub
+            for (size_t i = bpp; i < rowBytes; i++) {
+                row[i] += row[i - bpp];
+            }
+            return true;
+        case 2:  // Up
+            for (size_t i = 0; i < rowBytes; i++) {
+                row[i] += prev[i];
+            }
+            return true;
+        case 3:  // Average
+            for (size_t i = 0; i < rowBytes; i++) {
+                const int left = i >= bpp ? row[i - bpp] : 0;
+                row[i] += (left + prev[i]) >> 1;
+            }
+            return true;
+        case 4:  // Paeth
+            for (size_t i = 0; i < rowBytes; i++) {
+                const int a = i >= bpp ? row[i - bpp] : 0,
+                          b = prev[i],
+                          c = i >= bpp ? prev[i - bpp] : 0;
+                const int pa = std::abs(b - c),
+                          pb = std::abs(a - c),
+                          pc = std::abs(a + b - 2 * c);
+                row[i] += (pa <= pb && pa <= pc) ? a : pb <= pc ? b : c;
+            }
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Lays out uncompressed data as a sequence of deflate stored blocks (RFC 1951, section 3.2.4).
+class StoredBlockWriter {
+public:
+    static constexpr size_t kMaxBlockSize = 0xFFFF;
+
+    static size_t SizeFor(size_t bytes) {
+        const size_t blocks = std::max<size_t>(1, (bytes + kMaxBlockSize - 1) / kMaxBlockSize);
+        return bytes + 5 * blocks;
+    }
+
+    StoredBlockWriter(uint8_t* dst, size_t bytes) : fDst(dst), fLeft(bytes) {}
+
+    // Returns where up to *n more bytes can be written, reducing *n to fit the current block.
+    uint8_t* reserve(size_t* n) {
+        if (!fBlockLeft) {
+            const size_t len = std::min(fLeft, kMaxBlockSize);
+            fDst[0] = len == fLeft ? 1 : 0;  // BFINAL, and BTYPE 00.
+            fDst[1] = len;
+            fDst[2] = len >> 8;
+            fDst[3] = ~len;
+            fDst[4] = ~len >> 8;
+            fDst += 5;
+            fBlockLeft = len;
+        }
+        *n = std::min(*n, fBlockLeft);
+        return fDst;
+    }
+
+    void wrote(size_t n) {
+        SkASSERT(n <= fBlockLeft);
+        fAdler = adler32(fAdler, fDst, n);
+        fDst += n;
+        fBlockLeft -= n;
+        fLeft -= n;
+    }
+
+    uint8_t* end() const { return fDst; }
+    uint32_t adler() const { return (uint32_t)fAdler; }
+
+private:
+    uint8_t* fDst;
+    size_t   fLeft;
+    size_t   fBlockLeft = 0;
+    uLong    fAdler = adler32(0, nullptr, 0);
+};
+
+}  // namespace
+
+struct SkPngRowIndex::Cursor {
+    explicit Cursor(SkPngRowIndex* index)
+            : fIndex(index), fPrevRow(new uint8_t[index->fRowBytes]()) {
+        memset(&fStream, 0, sizeof(fStream));
+        fIndex->fRowBufferBytes += fIndex->fRowBytes;
+    }
+
+    ~Cursor() {
+        inflateEnd(&fStream);
+        fIndex->fRowBufferBytes -= fIndex->fRowBytes;
+    }
+
+    SkPngRowIndex* fIndex;
+    z_stream       fStream;  // zlib keeps a pointer back to this, so Cursors must not move.
+    int            fRow = 0;  // The next row to inflate.
+    size_t         fChunk = 0, fChunkOffset = 0;
+    std::unique_ptr<uint8_t[]> fPrevRow;  // Row fRow - 1, unfiltered. Zeros above the first row.
+};
+
+std::unique_ptr<SkPngRowIndex> SkPngRowIndex::Make(sk_sp<SkData> png, size_t byteLimit) {
+    static constexpr uint8_t kSignature[] = {137, 80, 78, 71, 13, 10, 26, 10};
+    if (!png || png->size() < sizeof(kSignature) ||
+        0 != memcmp(png->data(), kSignature, sizeof(kSignature))) {
+        return nullptr;
+    }
+
+    std::unique_ptr<SkPngRowIndex> index(new SkPngRowIndex(png, byteLimit));
+    const uint8_t* bytes = png->bytes();
+    const size_t size = png->size();
+    uint32_t width = 0;
+    int bitDepth = 0, channels = 0;
+    bool idatsEnded = false;
+    for (size_t offset = sizeof(kSignature); offset + 12 <= size;) {
+        const uint8_t* chunk = bytes + offset;
+        const size_t length = read_u32(chunk);
+        if (length > size - offset - 12) {
+            return nullptr;
+        }
+        if (is_chunk(chunk, "IHDR")) {
+            if (length < 13 || offset != sizeof(kSignature)) {
+                return nullptr;
+            }
+            width = read_u32(chunk + 8);
+            index->fHeight = (int)std::min<uint32_t>(read_u32(chunk + 12), INT32_MAX);
+            bitDepth = chunk[16];
+            switch (chunk[17]) {
+                case 0: channels = 1; break;  // Gray
+                case 2: channels = 3; break;  // RGB
+                case 3: channels = 1; break;  // Palette
+                case 4: channels = 2; break;  // Gray and alpha
+                case 6: channels = 4; break;  // RGBA
+                default: return nullptr;
+            }
+            // Only filter method 0 is defined, and interlaced rows aren't stored in order.
+            if (chunk[19] != 0 || chunk[20] != 0) {
+                return nullptr;
+            }
+        } else if (is_chunk(chunk, "IDAT")) {
+            if (idatsEnded) {
+                return nullptr;
+            }
+            index->fIdatChunks.push_back({offset + 8, length});
+        } else if (!index->fIdatChunks.empty()) {
+            idatsEnded = true;
+        }
+        offset += 12 + length;
+    }
+
+    const size_t bitsPerPixel = (size_t)channels * bitDepth;
+    if (!width || index->fHeight <= 0 || !bitsPerPixel || index->fIdatChunks.empty() ||
+        (uint64_t)width * bitsPerPixel > (uint64_t)INT32_MAX) {
+        return nullptr;
+    }
+    index->fRowBytes = (width * bitsPerPixel + 7) / 8;
+    index->fFilterBpp = std::max<size_t>(1, bitsPerPixel / 8);
+    index->fScratch.reset(new uint8_t[index->fRowBytes + 1]);
+
+    // Space the checkpoints so that enough to cover the image should fit. An inflater's largest
+    // allocation is its 32K window.
+    static constexpr int kMinSpacing = 16;
+    const size_t checkpointBytes = (1 << 15) + (8 << 10) + index->fRowBytes;
+    const int checkpoints = (int)std::max<size_t>(1, byteLimit / checkpointBytes);
+    index->fSpacing = std::max(kMinSpacing, (index->fHeight + checkpoints - 1) / checkpoints);
+
+    index->fEnd = index->makeCursor();
+    if (!index->fEnd) {
+        return nullptr;
+    }
+    return index;
+}
+
+SkPngRowIndex::SkPngRowIndex(sk_sp<SkData> png, size_t byteLimit)
+        : fData(std::move(png)), fByteLimit(byteLimit) {}
+
+SkPngRowIndex::~SkPngRowIndex() {
+    // The cursors update the counts as they're destroyed.
+    fCheckpoints.clear();
+    fEnd.reset();
+}
+
+std::unique_ptr<SkPngRowIndex::Cursor> SkPngRowIndex::makeCursor() {
+    auto cursor = std::make_unique<Cursor>(this);
+    cursor->fStream.zalloc = counting_alloc_func;
+    cursor->fStream.zfree = counting_free_func;
+    cursor->fStream.opaque = &fInflaterBytes;
+    if (Z_OK != inflateInit(&cursor->fStream)) {
+        return nullptr;
+    }
+    return cursor;
+}
+
+std::unique_ptr<SkPngRowIndex::Cursor> SkPngRowIndex::copyCursor(const Cursor& src) {
+    auto cursor = std::make_unique<Cursor>(this);
+    if (Z_OK != inflateCopy(&cursor->fStream, const_cast<z_stream*>(&src.fStream))) {
+        return nullptr;
+    }
+    cursor->fRow = src.fRow;
+    cursor->fChunk = src.fChunk;
+    cursor->fChunkOffset = src.fChunkOffset;
+    memcpy(cursor->fPrevRow.get(), src.fPrevRow.get(), fRowBytes);
+    return cursor;
+}
+
+bool SkPngRowIndex::inflateBytes(Cursor* cursor, uint8_t* dst, size_t n) {
+    z_stream* stream = &cursor->fStream;
+    stream->next_out = dst;
+    stream->avail_out = (uInt)n;
+    while (stream->avail_out) {
+        while (cursor->fChunkOffset == fIdatChunks[cursor->fChunk].fLength) {
+            if (cursor->fChunk + 1 == fIdatChunks.size()) {
+                return false;
+            }
+            cursor->fChunk++;
+            cursor->fChunkOffset = 0;
+        }
+        // Input is set on every call, since a copied cursor's stream still points at the data
+        // its source was given.
+        const Chunk& chunk = fIdatChunks[cursor->fChunk];
+        const uint8_t* in = fData->bytes() + chunk.fOffset + cursor->fChunkOffset;
+        stream->next_in = const_cast<Bytef*>(in);
+        stream->avail_in = (uInt)(chunk.fLength - cursor->fChunkOffset);
+
+        const int result = ::inflate(stream, Z_NO_FLUSH);
+        cursor->fChunkOffset += stream->next_in - in;
+        if (result == Z_STREAM_END) {
+            return stream->avail_out == 0;
+        }
+        if (result != Z_OK) {
+            SkCodecPrintf("inflate failed at row %d: %d\n", cursor->fRow, result);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool SkPngRowIndex::advance(Cursor* cursor) {
+    SkASSERT(cursor->fRow < fHeight);
+    uint8_t* row = fScratch.get();
+    if (!this->inflateBytes(cursor, row, fRowBytes + 1) ||
+        !unfilter(row[0], row + 1, cursor->fPrevRow.get(), fRowBytes, fFilterBpp)) {
+        return false;
+    }
+    memcpy(cursor->fPrevRow.get(), row + 1, fRowBytes);
+    cursor->fRow++;
+    return true;
+}
+
+bool SkPngRowIndex::extendTo(int row) {
+    while (fEnd && fEnd->fRow < row) {
+        if (!this->advance(fEnd.get())) {
+            // The data is corrupt past here; there's nothing more to index.
+            fEnd.reset();
+            return false;
+        }
+        if (fEnd->fRow % fSpacing == 0) {
+            this->addCheckpoint();
+        }
+    }
+    return fEnd != nullptr;
+}
+
+void SkPngRowIndex::addCheckpoint() {
+    std::unique_ptr<Cursor> checkpoint = this->copyCursor(*fEnd);
+    if (!checkpoint) {
+        return;
+    }
+    fCheckpoints.push_back(std::move(checkpoint));
+    while (this->bytesUsed() > fByteLimit && !fCheckpoints.empty()) {
+        fSpacing *= 2;
+        fCheckpoints.erase(std::remove_if(fCheckpoints.begin(), fCheckpoints.end(),
+                                          [this](const std::unique_ptr<Cursor>& c) {
+                                              return c->fRow % fSpacing != 0;
+                                          }),
+                           fCheckpoints.end());
+    }
+}
+
+sk_sp<SkData> SkPngRowIndex::makeIdat(int firstRow, int endRow) {
+    SkASSERT(0 <= firstRow && firstRow < endRow && endRow <= fHeight);
+    const uint64_t rawBytes = (uint64_t)(endRow - firstRow) * (fRowBytes + 1);
+    // The chunk's zlib stream stores the rows uncompressed, after a header claiming a 32K
+    // window and no preset dictionary. A chunk can't be longer than 2^31 - 1 bytes.
+    if (rawBytes > INT32_MAX || 2 + StoredBlockWriter::SizeFor(rawBytes) + 4 > INT32_MAX) {
+        return nullptr;
+    }
+    this->extendTo(firstRow);
+
+    // Start from the end of the index if it's at firstRow, or else the last checkpoint above it.
+    const Cursor* start = nullptr;
+    if (fEnd && fEnd->fRow == firstRow) {
+        start = fEnd.get();
+    } else {
+        auto after = std::upper_bound(fCheckpoints.begin(), fCheckpoints.end(), firstRow,
+                                      [](int row, const std::unique_ptr<Cursor>& c) {
+                                          return row < c->fRow;
+                                      });
+        if (after != fCheckpoints.begin()) {
+            start = (after - 1)->get();
+        }
+    }
+    std::unique_ptr<Cursor> cursor = start ? this->copyCursor(*start) : this->makeCursor();
+    if (!cursor) {
+        return nullptr;
+    }
+    while (cursor->fRow <= firstRow) {
+        if (!this->advance(cursor.get())) {
+            return nullptr;
+        }
+    }
+
+    const size_t payloadBytes = 2 + StoredBlockWriter::SizeFor(rawBytes) + 4;
+    sk_sp<SkData> idat = SkData::MakeUninitialized(8 + payloadBytes + 4);
+    uint8_t* dst = static_cast<uint8_t*>(idat->writable_data());
+    write_u32(dst, (uint32_t)payloadBytes);
+    memcpy(dst + 4, "IDAT", 4);
+    dst[8] = 0x78;
+    dst[9] = 0x01;
+
+    StoredBlockWriter writer(dst + 10, rawBytes);
+    auto write = [&](const uint8_t* src, size_t n) {
+        while (n) {
+            size_t span = n;
+            memcpy(writer.reserve(&span), src, span);
+            writer.wrote(span);
+            src += span;
+            n -= span;
+        }
+    };
+    // The first row no longer has a row above it, so it's written unfiltered...
+    const uint8_t kNone = 0;
+    write(&kNone, 1);
+    write(cursor->fPrevRow.get(), fRowBytes);
+    // ... and the rest are inflated straight into place.
+    for (size_t left = rawBytes - (fRowBytes + 1); left;) {
+        size_t span = left;
+        uint8_t* p = writer.reserve(&span);
+        if (!this->inflateBytes(cursor.get(), p, span)) {
+            return nullptr;
+        }
+        writer.wrote(span);
+        left -= span;
+    }
+
+    uint8_t* end = write_u32(writer.end(), writer.adler());
+    SkASSERT(end == dst + 8 + payloadBytes);
+    write_u32(end, (uint32_t)crc32(0, dst + 4, (uInt)(4 + payloadBytes)));
+    return idat;
+}
@@ -0,0 +1,90 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkPngRowIndex_DEFINED
+#define SkPngRowIndex_DEFINED
+
+#include "include/core/SkRefCnt.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class SkData;
+
+/*
+ * Checkpoints in the IDAT stream of a non-interlaced PNG, which let rows be decoded without first
+ * decoding every row above them. Each checkpoint holds a copy of the inflater's state just before
+ * a row, plus the row above it unfiltered, which the row's filter may refer to.
+ *
+ * makeIdat() inflates from the nearest checkpoint and returns the requested rows as a stand-in
+ * IDAT chunk, which libpng can decode as if they were the top of the image.
+ *
+ * Checkpoints are added as the index is extended down the image, every checkpointSpacing() rows.
+ * If they would take more than the byte limit, every other one is dropped and the spacing
+ * doubled.
+ */
+class SkPngRowIndex {
+public:
+    // Returns nullptr if png isn't a complete, non-interlaced PNG.
+    static std::unique_ptr<SkPngRowIndex> Make(sk_sp<SkData> png, size_t byteLimit);
+
+    ~SkPngRowIndex();
+
+    int height() const { return fHeight; }
+
+    // Returns an IDAT chunk, including its length, type and CRC, whose image data is rows
+    // [firstRow, endRow) of this image, with the first row unfiltered. Returns nullptr if the
+    // image data is corrupt.
+    sk_sp<SkData> makeIdat(int firstRow, int endRow);
+
+    // The memory held by checkpoints, including the one the index is extended from.
+    size_t bytesUsed() const { return fInflaterBytes + fRowBufferBytes; }
+    int checkpointCount() const { return (int)fCheckpoints.size(); }
+    int checkpointSpacing() const { return fSpacing; }
+
+private:
+    struct Cursor;
+
+    SkPngRowIndex(sk_sp<SkData>, size_t byteLimit);
+
+    std::unique_ptr<Cursor> makeCursor();
+    std::unique_ptr<Cursor> copyCursor(const Cursor&);
+
+    // Inflates exactly n bytes at the cursor.
+    bool inflateBytes(Cursor*, uint8_t* dst, size_t n);
+    // Inflates and unfilters the cursor's next row into its previous row.
+    bool advance(Cursor*);
+    // Advances fEnd down to row, adding checkpoints along the way.
+    bool extendTo(int row);
+    void addCheckpoint();
+
+    sk_sp<SkData> fData;
+    const size_t  fByteLimit;
+
+    int    fHeight = 0;
+    size_t fRowBytes = 0;    // Excluding the filter type byte.
+    size_t fFilterBpp = 0;   // The distance to the corresponding byte of the pixel to the left.
+
+    struct Chunk {
+        size_t fOffset;  // Of its data.
+        size_t fLength;
+    };
+    std::vector<Chunk> fIdatChunks;
+    std::unique_ptr<uint8_t[]> fScratch;  // One filtered row.
+
+    int fSpacing = 0;
+    std::vector<std::unique_ptr<Cursor>> fCheckpoints;  // In increasing row order.
+    std::unique_ptr<Cursor> fEnd;                       // Where the index stops.
+
+    // Kept up to date by the inflaters' allocator, and by makeCursor() and ~Cursor.
+    size_t fInflaterBytes = 0;
+    size_t fRowBufferBytes = 0;
+};
+
+#endif
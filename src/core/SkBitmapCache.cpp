@@ -8,6 +8,7 @@
 #include "src/core/SkBitmapCache.h"
 
 #include "include/core/SkBitmap.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkFourByteTag.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkImageInfo.h"
@@ -19,12 +20,15 @@
 #include "include/private/base/SkMalloc.h"
 #include "include/private/base/SkMutex.h"
 #include "include/private/chromium/SkDiscardableMemory.h"
+#include "src/base/SkAutoMalloc.h"
+#include "src/core/SkCachedData.h"
 #include "src/core/SkMipmap.h"
 #include "src/core/SkNextID.h"
 #include "src/core/SkResourceCache.h"
 #include "src/image/SkImage_Base.h"
 
 #include <cstddef>
+#include <memory>
 #include <utility>
 
 /**
@@ -302,7 +306,7 @@ const SkMipmap* SkMipmapCache::AddAndRef(const SkImage_Base* image, SkResourceCa
         return nullptr;
     }
 
-    SkMipmap* mipmap = SkMipmap::Build(src, get_fact(localCache));
+    SkMipmap* mipmap = SkMipmap::Build(src, get_fact(localCache), &SkExecutor::GetDefault());
     if (mipmap) {
         MipMapRec* rec = new MipMapRec(SkBitmapCacheDesc::Make(image), mipmap);
         CHECK_LOCAL(localCache, add, Add, rec);
@@ -310,3 +314,153 @@ const SkMipmap* SkMipmapCache::AddAndRef(const SkImage_Base* image, SkResourceCa
     }
     return mipmap;
 }
+
+namespace {
+static unsigned gMipLevelKeyNamespaceLabel;
+
+struct MipLevelKey : public SkResourceCache::Key {
+public:
+    MipLevelKey(const SkBitmapCacheDesc& desc, int level) : fDesc(desc), fLevel(level) {
+        this->init(&gMipLevelKeyNamespaceLabel,
+                   SkMakeResourceCacheSharedIDForBitmap(fDesc.fImageID),
+                   sizeof(fDesc) + sizeof(fLevel));
+    }
+
+    const SkBitmapCacheDesc fDesc;
+    const int32_t           fLevel;
+};
+
+struct MipLevelRec : public SkResourceCache::Rec {
+    MipLevelRec(const SkBitmapCacheDesc& desc, int level, SkCachedData* data,
+                const SkPixmap& pixmap)
+        : fKey(desc, level)
+        , fData(data)
+        , fInfo(pixmap.info())
+        , fRowBytes(pixmap.rowBytes())
+    {
+        fData->attachToCacheAndRef();
+    }
+
+    ~MipLevelRec() override {
+        fData->detachFromCacheAndUnref();
+    }
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override { return sizeof(*this) + fData->size(); }
+    const char* getCategory() const override { return "mipmap-level"; }
+    SkDiscardableMemory* diagnostic_only_getDiscardable() const override {
+        return fData->diagnostic_only_getDiscardable();
+    }
+
+    struct Result {
+        SkCachedData* fData;
+        SkPixmap      fPixmap;
+    };
+
+    static bool Finder(const SkResourceCache::Rec& baseRec, void* contextResult) {
+        const MipLevelRec& rec = static_cast<const MipLevelRec&>(baseRec);
+        SkCachedData* data = rec.fData;
+        data->ref();
+        // As with MipMapRec, the ref() locks discardable memory, which may fail.
+        if (nullptr == data->data()) {
+            data->unref();
+            return false;
+        }
+        Result* result = static_cast<Result*>(contextResult);
+        result->fData = data;
+        result->fPixmap = SkPixmap(rec.fInfo, data->data(), rec.fRowBytes);
+        return true;
+    }
+
+private:
+    MipLevelKey   fKey;
+    SkCachedData* fData;
+    SkImageInfo   fInfo;
+    size_t        fRowBytes;
+};
+}  // namespace
+
+static SkCachedData* find_level_and_ref(const SkBitmapCacheDesc& desc, int index,
+                                        SkPixmap* level, SkResourceCache* localCache) {
+    MipLevelKey key(desc, index);
+    MipLevelRec::Result result;
+    if (!CHECK_LOCAL(localCache, find, Find, key, MipLevelRec::Finder, &result)) {
+        return nullptr;
+    }
+    *level = result.fPixmap;
+    return result.fData;
+}
+
+SkCachedData* SkMipmapCache::FindOrBuildLevelAndRef(const SkImage_Base* image, int index,
+                                                    SkPixmap* level,
+                                                    SkResourceCache* localCache) {
+    if (index < 0 || index >= SkMipmap::ComputeLevelCount(image->dimensions())) {
+        return nullptr;
+    }
+    const SkBitmapCacheDesc desc = SkBitmapCacheDesc::Make(image);
+    if (SkCachedData* data = find_level_and_ref(desc, index, level, localCache)) {
+        return data;
+    }
+
+    // Start from the closest larger level that's still cached, or else from the image itself.
+    sk_sp<SkCachedData> srcData;
+    SkBitmap base;
+    SkPixmap src;
+    int next = index;
+    while (next > 0 && !srcData) {
+        srcData.reset(find_level_and_ref(desc, --next, &src, localCache));
+    }
+    if (srcData) {
+        next += 1;
+    } else if (!image->getROPixels(nullptr, &base) || !base.peekPixels(&src)) {
+        return nullptr;
+    }
+
+    std::unique_ptr<SkMipmapDownSampler> downsampler = SkMipmap::MakeDownSampler(src);
+    if (!downsampler) {
+        return nullptr;
+    }
+
+    // Like AddAndRef(), build large levels in bands on the default executor.
+    SkExecutor* executor = &SkExecutor::GetDefault();
+
+    // Levels between src and the one we want are built into scratch memory, taking turns with
+    // two buffers, and thrown away.
+    SkAutoMalloc scratch[2];
+    for (; next < index; ++next) {
+        const SkImageInfo info =
+                src.info().makeDimensions(SkMipmap::ComputeLevelSize(image->dimensions(), next));
+        const SkPixmap dst(info, scratch[next & 1].reset(info.computeMinByteSize()),
+                           info.minRowBytes());
+        downsampler->buildLevel(dst, src, executor);
+        src = dst;
+    }
+
+    const SkImageInfo info =
+            src.info().makeDimensions(SkMipmap::ComputeLevelSize(image->dimensions(), index));
+    SkCachedData* data =
+            CHECK_LOCAL(localCache, newCachedData, NewCachedData, info.computeMinByteSize());
+    if (!data) {
+        return nullptr;
+    }
+    const SkPixmap dst(info, data->writable_data(), info.minRowBytes());
+    downsampler->buildLevel(dst, src, executor);
+
+    CHECK_LOCAL(localCache, add, Add, new MipLevelRec(desc, index, data, dst));
+    image->notifyAddedToRasterCache();
+    *level = dst;
+    return data;
+}
+
+uint32_t SkMipmapCache::CachedLevels(const SkBitmapCacheDesc& desc, SkResourceCache* localCache) {
+    const int count = SkMipmap::ComputeLevelCount(desc.fSubset.size());
+    uint32_t levels = 0;
+    for (int i = 0; i < count; ++i) {
+        SkPixmap unused;
+        if (SkCachedData* data = find_level_and_ref(desc, i, &unused, localCache)) {
+            data->unref();
+            levels |= 1u << i;
+        }
+    }
+    return levels;
+}
@@ -15,6 +15,7 @@
 #include <memory>
 
 class SkBitmap;
+class SkCachedData;
 class SkImage;
 class SkImage_Base;
 class SkMipmap;
@@ -65,6 +66,24 @@ public:
                                       SkResourceCache* localCache = nullptr);
     static const SkMipmap* AddAndRef(const SkImage_Base*,
                                      SkResourceCache* localCache = nullptr);
+
+    /**
+     *  Finds one level of the image's mipmap (indexed like SkMipmap::getLevel()). If the level
+     *  isn't cached, it is built from the closest larger level that is (or from the image itself),
+     *  and cached on its own. Levels that are never asked for are never built, and the levels in
+     *  between are only kept while they're needed.
+     *
+     *  On success, sets level to the level's pixels, and returns the data holding them, ref'd
+     *  (and so locked). The caller must unref() it when done with the pixels.
+     */
+    static SkCachedData* FindOrBuildLevelAndRef(const SkImage_Base*, int index, SkPixmap* level,
+                                                SkResourceCache* localCache = nullptr);
+
+    /**
+     *  Returns a mask with bit i set for each level i of the image that FindOrBuildLevelAndRef()
+     *  built and that is still in the cache.
+     */
+    static uint32_t CachedLevels(const SkBitmapCacheDesc&, SkResourceCache* localCache = nullptr);
 };
 
 #endif
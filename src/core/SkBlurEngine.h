@@ -29,6 +29,10 @@ enum class SkFilterMode;
 enum class SkTileMode;
 enum SkColorType : int;
 
+// The sigma above which the raster blur engine blurs a downscaled image and upscales the result,
+// rather than blurring at full resolution. Exposed so tests and benches can compare the two.
+extern float gSkRasterBlurDownscaleSigma;
+
 /**
  * SkBlurEngine is a backend-agnostic provider of blur algorithms. Each Skia backend defines a blur
  * engine with a set of supported algorithms and/or implementations. A given implementation may be
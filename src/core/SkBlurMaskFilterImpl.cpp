@@ -542,6 +542,68 @@ SkBlurMaskFilterImpl::filterRectsToNine(SkSpan<const SkRect> rects,
     return FilterReturn::kTrue;
 }
 
+SkCachedData* SkBlurMaskFilterImpl::filterPathToCachedMask(const SkPath& devPath,
+                                                           const SkMatrix& matrix,
+                                                           const SkIRect& clipBounds,
+                                                           SkTLazy<SkMask>* mask) const {
+    // Paths with more points than this are unlikely to be drawn again, and their keys get large.
+    static constexpr int kMaxCachedPathPoints = 1024;
+    // The whole mask is cached, so a large path mostly clipped out would waste memory.
+    static constexpr size_t kMaxCachedMaskBytes = 256 * 1024;
+    // Without the cache, only the part of the mask within the clip is blurred. When that's less
+    // than this fraction of the mask, blurring all of it to cache costs more than it's likely to
+    // save.
+    static constexpr int kMinVisibleMaskFraction = 4;
+
+    if (devPath.isInverseFillType() || devPath.countPoints() > kMaxCachedPathPoints) {
+        return nullptr;
+    }
+
+    // Blur all of the path, not just what's within this draw's clip, so that the mask can be
+    // reused wherever the path is drawn next. Masks too big to cache don't count as misses.
+    SkMaskBuilder boundsM(nullptr, devPath.getBounds().roundOut(), 0, SkMask::kA8_Format), dstM;
+    if (!this->filterMask(&dstM, boundsM, matrix, nullptr)) {
+        return nullptr;
+    }
+    // computeTotalImageSize() returns 0 when the size overflows.
+    const size_t maskBytes = dstM.computeTotalImageSize();
+    if (maskBytes == 0 || maskBytes > kMaxCachedMaskBytes) {
+        return nullptr;
+    }
+    SkIRect visible;
+    if (!visible.intersect(dstM.fBounds, clipBounds) ||
+        visible.height() * visible.width() * kMinVisibleMaskFraction <
+                dstM.fBounds.height() * dstM.fBounds.width()) {
+        return nullptr;
+    }
+
+    const SkScalar sigma = this->computeXformedSigma(matrix);
+    if (SkCachedData* cache = SkMaskCache::FindAndRef(sigma, fBlurStyle, devPath, mask)) {
+        return cache;
+    }
+
+    SkMaskBuilder srcM;
+    if (!SkDrawBase::DrawToMask(devPath, dstM.fBounds, this, &matrix, &srcM,
+                                SkMaskBuilder::kComputeBoundsAndRenderImage_CreateMode,
+                                SkStrokeRec::kFill_InitStyle)) {
+        return nullptr;
+    }
+    SkAutoMaskFreeImage autoSrc(srcM.image());
+
+    if (!this->filterMask(&dstM, srcM, matrix, nullptr)) {
+        return nullptr;
+    }
+    SkCachedData* cache = copy_mask_to_cacheddata(&dstM);
+    if (!cache) {
+        SkMaskBuilder::FreeImage(dstM.image());
+        return nullptr;
+    }
+    SkMaskCache::Add(sigma, fBlurStyle, devPath, dstM, cache);
+
+    mask->init(dstM.fImage, dstM.fBounds, dstM.fRowBytes, dstM.fFormat);
+    return cache;
+}
+
 void SkBlurMaskFilterImpl::computeFastBounds(const SkRect& src,
                                              SkRect* dst) const {
     // TODO: if we're doing kInner blur, should we return a different outset?
@@ -17,8 +17,10 @@
 
 #include <optional>
 
+class SkCachedData;
 class SkImageFilter;
 class SkMatrix;
+class SkPath;
 class SkRRect;
 class SkReadBuffer;
 class SkWriteBuffer;
@@ -57,6 +59,11 @@ private:
                                                const SkMatrix&,
                                                const SkIRect& clipBounds) const override;
 
+    SkCachedData* filterPathToCachedMask(const SkPath& devPath,
+                                         const SkMatrix&,
+                                         const SkIRect& clipBounds,
+                                         SkTLazy<SkMask>* mask) const override;
+
     bool filterRectMask(SkMaskBuilder* dstM,
                         const SkRect& r,
                         const SkMatrix& matrix,
@@ -7,6 +7,7 @@
 #include "src/core/SkConvertPixels.h"
 
 #include "include/core/SkColorType.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkSize.h"
 #include "include/private/base/SkAssert.h"
@@ -254,7 +255,7 @@ static void convert_with_pipeline(const SkImageInfo& dstInfo, void* dstRow, int
     pipeline.appendLoad(srcInfo.colorType(), &src);
     steps.apply(&pipeline);
     pipeline.appendStore(dstInfo.colorType(), &dst);
-    pipeline.run(0,0, srcInfo.width(), srcInfo.height());
+    pipeline.runParallel(0,0, srcInfo.width(), srcInfo.height(), SkExecutor::GetDefault());
 }
 
 bool SkConvertPixels(const SkImageInfo& dstInfo,       void* dstPixels, size_t dstRB,
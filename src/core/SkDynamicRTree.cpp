@@ -0,0 +1,466 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/core/SkDynamicRTree.h"
+
+#include "include/private/base/SkAssert.h"
+#include "include/private/base/SkFloatingPoint.h"
+#include "include/private/base/SkMalloc.h"
+#include "include/private/base/SkTemplates.h"
+#include "src/base/SkMathPriv.h"
+#include "src/base/SkVx.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+using F = skvx::Vec<SkDynamicRTree::kMaxChildren, float>;
+
+// search() tests children four at a time.
+static_assert(SkDynamicRTree::kMaxChildren % 4 == 0);
+
+// The query's edges, each splatted once up front rather than at every node.
+struct SkDynamicRTree::Query {
+    skvx::float4 fLeft, fTop, fRight, fBottom;
+};
+
+static float area(const SkRect& r) { return r.width() * r.height(); }
+
+static SkRect join(const SkRect& a, const SkRect& b) {
+    return {std::min(a.fLeft, b.fLeft), std::min(a.fTop, b.fTop),
+            std::max(a.fRight, b.fRight), std::max(a.fBottom, b.fBottom)};
+}
+
+void SkDynamicRTree::Node::clear(int i) {
+    fLeft[i] = fTop[i] = SK_FloatInfinity;
+    fRight[i] = fBottom[i] = SK_FloatNegativeInfinity;
+    fChildren[i] = -1;
+}
+
+SkRect SkDynamicRTree::Node::unionOfChildren() const {
+    // The unused slots are inverted, so they never win.
+    return {min(F::Load(fLeft)), min(F::Load(fTop)), max(F::Load(fRight)), max(F::Load(fBottom))};
+}
+
+int SkDynamicRTree::Node::find(int32_t child) const {
+    for (int i = 0; i < fCount; i++) {
+        if (fChildren[i] == child) {
+            return i;
+        }
+    }
+    SkUNREACHABLE;
+}
+
+SkDynamicRTree::SkDynamicRTree() : fCount(0) {
+    fRoot = this->allocateNode(0);
+}
+
+int SkDynamicRTree::allocateNode(uint16_t level) {
+    int index;
+    if (!fFreeNodes.empty()) {
+        index = fFreeNodes.back();
+        fFreeNodes.pop_back();
+    } else {
+        index = (int)fNodes.size();
+        fNodes.emplace_back();
+    }
+    Node& n = fNodes[index];
+    for (int i = 0; i < kMaxChildren; i++) {
+        n.clear(i);
+    }
+    n.fParent = -1;
+    n.fCount = 0;
+    n.fLevel = level;
+    return index;
+}
+
+void SkDynamicRTree::freeNode(int node) {
+    fNodes[node].fCount = 0;
+    fFreeNodes.push_back(node);
+}
+
+void SkDynamicRTree::append(int node, const Entry& e) {
+    Node& n = fNodes[node];
+    SkASSERT(n.fCount < kMaxChildren);
+    const int i = n.fCount++;
+    n.setBounds(i, e.fBounds);
+    n.fChildren[i] = e.fChild;
+    if (n.fLevel == 0) {
+        fLeafOf[e.fChild] = node;
+    } else {
+        fNodes[e.fChild].fParent = node;
+    }
+}
+
+void SkDynamicRTree::removeChild(int node, int i) {
+    Node& n = fNodes[node];
+    const int last = --n.fCount;
+    n.setBounds(i, n.bounds(last));
+    n.fChildren[i] = n.fChildren[last];
+    n.clear(last);
+}
+
+void SkDynamicRTree::adjustBounds(int node) {
+    for (int parent = fNodes[node].fParent; parent >= 0; parent = fNodes[node].fParent) {
+        Node& p = fNodes[parent];
+        const int i = p.find(node);
+        const SkRect bounds = fNodes[node].unionOfChildren();
+        if (bounds == p.bounds(i)) {
+            break;  // Nothing further up can change either.
+        }
+        p.setBounds(i, bounds);
+        node = parent;
+    }
+}
+
+void SkDynamicRTree::insert(const SkRect boundsArray[], int N) {
+    SkASSERT(0 == fCount);
+
+    std::vector<Entry> entries;
+    entries.reserve(N);
+    for (int i = 0; i < N; i++) {
+        if (!boundsArray[i].isEmpty()) {
+            entries.push_back({boundsArray[i], i});
+        }
+    }
+    fLeafOf.assign(N, -1);
+    fCount = (int)entries.size();
+    if (!fCount) {
+        return;
+    }
+    this->freeNode(fRoot);
+
+    auto centerX = [](const Entry& e) { return e.fBounds.fLeft + e.fBounds.fRight;  };
+    auto centerY = [](const Entry& e) { return e.fBounds.fTop  + e.fBounds.fBottom; };
+
+    for (uint16_t level = 0;; level++) {
+        const int n = (int)entries.size();
+        if (n <= kMaxChildren) {
+            fRoot = this->allocateNode(level);
+            for (const Entry& e : entries) {
+                this->append(fRoot, e);
+            }
+            return;
+        }
+
+        // Sort-tile-recursive: sort by x into about sqrt(nodes) vertical slices, each a whole
+        // number of full nodes, then sort each slice by y.
+        const int nodes = (n + kMaxChildren - 1) / kMaxChildren;
+        const int slices = (int)std::ceil(std::sqrt((double)nodes));
+        const int sliceSize = (nodes + slices - 1) / slices * kMaxChildren;
+        std::sort(entries.begin(), entries.end(), [&](const Entry& a, const Entry& b) {
+            return centerX(a) < centerX(b);
+        });
+        for (int s = 0; s < n; s += sliceSize) {
+            std::sort(entries.begin() + s, entries.begin() + std::min(n, s + sliceSize),
+                      [&](const Entry& a, const Entry& b) { return centerY(a) < centerY(b); });
+        }
+
+        // Spread the entries evenly over the nodes, so that each gets at least kMinChildren.
+        std::vector<Entry> parents;
+        parents.reserve(nodes);
+        for (int k = 0; k < nodes; k++) {
+            const int node = this->allocateNode(level);
+            for (int i = n * k / nodes; i < n * (k + 1) / nodes; i++) {
+                this->append(node, entries[i]);
+            }
+            parents.push_back({fNodes[node].unionOfChildren(), node});
+        }
+        entries = std::move(parents);
+    }
+}
+
+void SkDynamicRTree::add(int id, const SkRect& bounds) {
+    SkASSERT(id >= 0);
+    if (bounds.isEmpty()) {
+        return;
+    }
+    if (id >= (int)fLeafOf.size()) {
+        fLeafOf.resize(id + 1, -1);
+    }
+    SkASSERT(fLeafOf[id] < 0);
+    fCount++;
+    this->insertAtLevel({bounds, id}, 0);
+}
+
+void SkDynamicRTree::insertAtLevel(const Entry& e, uint16_t level) {
+    SkASSERT(level <= fNodes[fRoot].fLevel);
+
+    // Descend into the child that needs the least enlargement to hold e, breaking ties by area.
+    int node = fRoot;
+    while (fNodes[node].fLevel > level) {
+        const Node& n = fNodes[node];
+        int best = 0;
+        float bestGrowth = SK_FloatInfinity, bestArea = SK_FloatInfinity;
+        for (int i = 0; i < n.fCount; i++) {
+            const float a = area(n.bounds(i)),
+                        growth = area(join(n.bounds(i), e.fBounds)) - a;
+            if (growth < bestGrowth || (growth == bestGrowth && a < bestArea)) {
+                best = i;
+                bestGrowth = growth;
+                bestArea = a;
+            }
+        }
+        node = n.fChildren[best];
+    }
+
+    if (fNodes[node].fCount < kMaxChildren) {
+        this->append(node, e);
+        this->adjustBounds(node);
+        return;
+    }
+
+    // Split full nodes on the way back up, until one has room for the new sibling.
+    int sibling = this->split(node, e);
+    for (;;) {
+        const int parent = fNodes[node].fParent;
+        if (parent < 0) {
+            const int root = this->allocateNode(fNodes[node].fLevel + 1);
+            this->append(root, {fNodes[node].unionOfChildren(), node});
+            this->append(root, {fNodes[sibling].unionOfChildren(), sibling});
+            fRoot = root;
+            return;
+        }
+        fNodes[parent].setBounds(fNodes[parent].find(node), fNodes[node].unionOfChildren());
+
+        const Entry s = {fNodes[sibling].unionOfChildren(), sibling};
+        if (fNodes[parent].fCount < kMaxChildren) {
+            this->append(parent, s);
+            this->adjustBounds(parent);
+            return;
+        }
+        sibling = this->split(parent, s);
+        node = parent;
+    }
+}
+
+int SkDynamicRTree::split(int node, const Entry& extra) {
+    constexpr int kTotal = kMaxChildren + 1;
+    Entry entries[kTotal];
+    for (int i = 0; i < kMaxChildren; i++) {
+        entries[i] = {fNodes[node].bounds(i), fNodes[node].fChildren[i]};
+    }
+    entries[kMaxChildren] = extra;
+
+    // R*-tree split: pick the axis whose distributions have the smallest total margin, then the
+    // distribution along it with the least overlap (then area) between the two groups.
+    auto sortBy = [&](bool y) {
+        std::sort(entries, entries + kTotal, [y](const Entry& a, const Entry& b) {
+            return y ? a.fBounds.fTop  + a.fBounds.fBottom < b.fBounds.fTop  + b.fBounds.fBottom
+                     : a.fBounds.fLeft + a.fBounds.fRight  < b.fBounds.fLeft + b.fBounds.fRight;
+        });
+    };
+    SkRect prefix[kTotal], suffix[kTotal];
+    auto groupBounds = [&] {
+        prefix[0] = entries[0].fBounds;
+        suffix[kTotal - 1] = entries[kTotal - 1].fBounds;
+        for (int i = 1; i < kTotal; i++) {
+            prefix[i] = join(prefix[i - 1], entries[i].fBounds);
+            suffix[kTotal - 1 - i] = join(suffix[kTotal - i], entries[kTotal - 1 - i].fBounds);
+        }
+    };
+    auto margin = [](const SkRect& r) { return r.width() + r.height(); };
+
+    float margins[2] = {0, 0};
+    for (int axis = 0; axis < 2; axis++) {
+        sortBy(axis);
+        groupBounds();
+        for (int k = kMinChildren; k <= kTotal - kMinChildren; k++) {
+            margins[axis] += margin(prefix[k - 1]) + margin(suffix[k]);
+        }
+    }
+    sortBy(margins[1] < margins[0]);
+    groupBounds();
+
+    int bestK = kMinChildren;
+    float bestOverlap = SK_FloatInfinity, bestArea = SK_FloatInfinity;
+    for (int k = kMinChildren; k <= kTotal - kMinChildren; k++) {
+        SkRect overlap;
+        const float o = overlap.intersect(prefix[k - 1], suffix[k]) ? area(overlap) : 0,
+                    a = area(prefix[k - 1]) + area(suffix[k]);
+        if (o < bestOverlap || (o == bestOverlap && a < bestArea)) {
+            bestK = k;
+            bestOverlap = o;
+            bestArea = a;
+        }
+    }
+
+    const int sibling = this->allocateNode(fNodes[node].fLevel);
+    Node& n = fNodes[node];
+    for (int i = 0; i < kMaxChildren; i++) {
+        n.clear(i);
+    }
+    n.fCount = 0;
+    for (int i = 0; i < kTotal; i++) {
+        this->append(i < bestK ? node : sibling, entries[i]);
+    }
+    return sibling;
+}
+
+bool SkDynamicRTree::remove(int id) {
+    if (id < 0 || id >= (int)fLeafOf.size() || fLeafOf[id] < 0) {
+        return false;
+    }
+    const int leaf = fLeafOf[id];
+    this->removeChild(leaf, fNodes[leaf].find(id));
+    fLeafOf[id] = -1;
+    fCount--;
+
+    // Dissolve any node left with too few children, saving its children to insert again.
+    struct Orphan {
+        Entry    fEntry;
+        uint16_t fLevel;
+    };
+    std::vector<Orphan> orphans;
+    for (int node = leaf; node != fRoot;) {
+        const int parent = fNodes[node].fParent;
+        Node& n = fNodes[node];
+        if (n.fCount < kMinChildren) {
+            for (int i = 0; i < n.fCount; i++) {
+                if (n.fLevel == 0) {
+                    fLeafOf[n.fChildren[i]] = -1;
+                }
+                orphans.push_back({{n.bounds(i), n.fChildren[i]}, n.fLevel});
+            }
+            this->removeChild(parent, fNodes[parent].find(node));
+            this->freeNode(node);
+        } else {
+            fNodes[parent].setBounds(fNodes[parent].find(node), n.unionOfChildren());
+        }
+        node = parent;
+    }
+
+    // A root with a single child is redundant.
+    while (fNodes[fRoot].fLevel > 0 && fNodes[fRoot].fCount == 1) {
+        const int child = fNodes[fRoot].fChildren[0];
+        this->freeNode(fRoot);
+        fRoot = child;
+        fNodes[fRoot].fParent = -1;
+    }
+
+    // Put the highest subtrees back first, while the tree is still tall enough to hold them.
+    std::sort(orphans.begin(), orphans.end(), [](const Orphan& a, const Orphan& b) {
+        return a.fLevel > b.fLevel;
+    });
+    for (const Orphan& o : orphans) {
+        this->insertAtLevel(o.fEntry, o.fLevel);
+    }
+    return true;
+}
+
+void SkDynamicRTree::update(int id, const SkRect& bounds) {
+    // Small moves within the leaf's current bounds just patch the leaf in place.
+    if (id >= 0 && id < (int)fLeafOf.size() && fLeafOf[id] >= 0 && !bounds.isEmpty()) {
+        const int leaf = fLeafOf[id];
+        Node& n = fNodes[leaf];
+        if (n.unionOfChildren().contains(bounds)) {
+            n.setBounds(n.find(id), bounds);
+            this->adjustBounds(leaf);
+            return;
+        }
+    }
+    this->remove(id);
+    this->add(id, bounds);
+}
+
+void SkDynamicRTree::search(const SkRect& query, std::vector<int>* results) const {
+    if (fCount > 0 && !query.isEmpty()) {
+        // Leaves aren't in any particular order, but callers draw the results in order. So rather
+        // than collecting the hits and sorting them, we mark them in a bitmap of all ids, then read
+        // them back out in order.
+        const size_t words = (fLeafOf.size() + 31) / 32;
+        skia_private::AutoSTMalloc<64, uint32_t> hits(words);
+        sk_bzero(hits.get(), words * sizeof(uint32_t));
+
+        const Query q = {query.fLeft, query.fTop, query.fRight, query.fBottom};
+        this->search(fRoot, q, hits.get());
+
+        size_t count = results->size();
+        for (size_t w = 0; w < words; w++) {
+            count += SkPopCount(hits[w]);
+        }
+        size_t out = results->size();
+        results->resize(count);
+        for (size_t w = 0; w < words; w++) {
+            for (uint32_t word = hits[w]; word; word &= word - 1) {
+                (*results)[out++] = (int)(w * 32) + SkCTZ(word);
+            }
+        }
+    }
+}
+
+void SkDynamicRTree::search(int node, const Query& q, uint32_t hitIds[]) const {
+    const Node& n = fNodes[node];
+    // Test the query against four children at a time, gathering the hits into a bitmask. Unused
+    // slots are inverted, so never match.
+    uint32_t hits = 0;
+    for (int i = 0; i < n.fCount; i += 4) {
+        const skvx::int4 mask = (skvx::float4::Load(n.fLeft   + i) < q.fRight) &
+                                (skvx::float4::Load(n.fTop    + i) < q.fBottom) &
+                                (skvx::float4::Load(n.fRight  + i) > q.fLeft) &
+                                (skvx::float4::Load(n.fBottom + i) > q.fTop);
+        const skvx::int4 bits = mask & skvx::int4{1, 2, 4, 8};
+        hits |= (uint32_t)(bits[0] | bits[1] | bits[2] | bits[3]) << i;
+    }
+    for (; hits; hits &= hits - 1) {
+        const int32_t child = n.fChildren[SkCTZ(hits)];
+        if (0 == n.fLevel) {
+            hitIds[child >> 5] |= 1u << (child & 31);
+        } else {
+            this->search(child, q, hitIds);
+        }
+    }
+}
+
+size_t SkDynamicRTree::bytesUsed() const {
+    return sizeof(SkDynamicRTree) + fNodes.capacity() * sizeof(Node) +
+           (fFreeNodes.capacity() + fLeafOf.capacity()) * sizeof(int32_t);
+}
+
+bool SkDynamicRTree::isValid() const {
+    int count = 0;
+    if (!this->isValid(fRoot, -1, nullptr, &count) || count != fCount) {
+        return false;
+    }
+    for (int id = 0; id < (int)fLeafOf.size(); id++) {
+        if (fLeafOf[id] >= 0 && fNodes[fLeafOf[id]].fLevel != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool SkDynamicRTree::isValid(int node, int parent, const SkRect* boundsInParent,
+                             int* count) const {
+    const Node& n = fNodes[node];
+    if (n.fParent != parent || n.fCount > kMaxChildren ||
+        (parent >= 0 && n.fCount < kMinChildren)) {
+        return false;
+    }
+    if (boundsInParent && *boundsInParent != n.unionOfChildren()) {
+        return false;
+    }
+    for (int i = n.fCount; i < kMaxChildren; i++) {
+        if (!(n.fLeft[i] > n.fRight[i])) {
+            return false;  // Unused slots must stay inverted.
+        }
+    }
+    for (int i = 0; i < n.fCount; i++) {
+        const SkRect bounds = n.bounds(i);
+        if (n.fLevel == 0) {
+            const int id = n.fChildren[i];
+            if (bounds.isEmpty() || id < 0 || id >= (int)fLeafOf.size() || fLeafOf[id] != node) {
+                return false;
+            }
+            *count += 1;
+        } else if (fNodes[n.fChildren[i]].fLevel + 1 != n.fLevel ||
+                   !this->isValid(n.fChildren[i], node, &bounds, count)) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,111 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkDynamicRTree_DEFINED
+#define SkDynamicRTree_DEFINED
+
+#include "include/core/SkBBHFactory.h"
+#include "include/core/SkRect.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * An R-tree that, unlike SkRTree, can be updated after it's built: bounding rects can be added,
+ * removed or moved one at a time (Guttman's algorithms, with an R*-style split). That lets a
+ * client that re-records a mostly unchanged picture patch the tree instead of rebuilding it.
+ *
+ * Nodes are stored flat, in one array, and each node keeps its children's bounds as separate
+ * left/top/right/bottom arrays, so search() can test a query against four children at a time
+ * with SIMD.
+ *
+ * Like SkRTree, empty rects are never inserted, and search() returns indices in ascending order.
+ */
+class SkDynamicRTree : public SkBBoxHierarchy {
+public:
+    SkDynamicRTree();
+
+    // Bulk-loads the tree (sort-tile-recursive), which must be empty. Each rect's index is its id.
+    void insert(const SkRect[], int N) override;
+    void search(const SkRect& query, std::vector<int>* results) const override;
+    size_t bytesUsed() const override;
+
+    // Adds bounds for id, which must be >= 0 and not already in the tree. Empty bounds are ignored.
+    void add(int id, const SkRect& bounds);
+    // Removes id's bounds, returning false if id isn't in the tree.
+    bool remove(int id);
+    // Equivalent to remove(id) followed by add(id, bounds).
+    void update(int id, const SkRect& bounds);
+
+    // Methods and constants below here are only public for tests.
+
+    // Return the depth of the tree structure.
+    int getDepth() const { return fCount ? fNodes[fRoot].fLevel + 1 : 0; }
+    // The number of ids in the tree.
+    int getCount() const { return fCount; }
+    // Checks the tree's structural invariants, returning false if any is broken.
+    bool isValid() const;
+
+    // Eight children fill two 128-bit registers per bounds array.
+    static constexpr int kMaxChildren = 8,
+                         kMinChildren = 3;
+
+private:
+    struct Node {
+        // Bounds of each child. Unused slots hold inverted rects, which intersect nothing.
+        float   fLeft[kMaxChildren], fTop[kMaxChildren], fRight[kMaxChildren],
+                fBottom[kMaxChildren];
+        // Ids in leaves (level 0), node indices otherwise.
+        int32_t fChildren[kMaxChildren];
+        int32_t fParent;  // -1 for the root.
+        uint16_t fCount;
+        uint16_t fLevel;
+
+        SkRect bounds(int i) const { return {fLeft[i], fTop[i], fRight[i], fBottom[i]}; }
+        void setBounds(int i, const SkRect& r) {
+            fLeft[i] = r.fLeft; fTop[i] = r.fTop; fRight[i] = r.fRight; fBottom[i] = r.fBottom;
+        }
+        void clear(int i);
+        SkRect unionOfChildren() const;
+        int find(int32_t child) const;
+    };
+
+    struct Entry {
+        SkRect  fBounds;
+        int32_t fChild;
+    };
+
+    int allocateNode(uint16_t level);
+    void freeNode(int node);
+
+    struct Query;  // The query rect's edges, splatted for SIMD comparisons.
+    // Sets the bit for each id whose bounds intersect the query.
+    void search(int node, const Query&, uint32_t hitIds[]) const;
+
+    // Inserts an entry that belongs in a node at the given level.
+    void insertAtLevel(const Entry&, uint16_t level);
+    // Appends entry to node, which must have room, fixing up parent/leaf links.
+    void append(int node, const Entry&);
+    // Splits node, which has kMaxChildren entries plus the extra one, into node and a sibling.
+    // Returns the sibling.
+    int split(int node, const Entry& extra);
+    // Recomputes the bounds stored for node in each of its ancestors.
+    void adjustBounds(int node);
+    // Removes child i of node, refilling its slot from the node's last child.
+    void removeChild(int node, int i);
+
+    bool isValid(int node, int parent, const SkRect* boundsInParent, int* count) const;
+
+    std::vector<Node>    fNodes;
+    std::vector<int32_t> fFreeNodes;
+    std::vector<int32_t> fLeafOf;  // For each id, the leaf holding it, or -1.
+    int fRoot;
+    int fCount;
+};
+
+#endif
@@ -10,8 +10,11 @@
 #include "include/private/base/SkSemaphore.h"
 #include "include/private/base/SkTArray.h"
 #include "src/base/SkNoDestructor.h"
+#include "src/base/SkSpinlock.h"
 
+#include <atomic>
 #include <deque>
+#include <memory>
 #include <thread>
 #include <utility>
 
@@ -143,6 +146,134 @@ private:
     bool                  fAllowBorrowing;
 };
 
+// An SkWorkStealingThreadPool gives each of its threads its own work queue, each behind its own
+// lock. Work added from a pool thread goes on that thread's queue; work added from anywhere else
+// is dealt out round-robin. Threads take work from their own queue first, then steal from the
+// others, so threads rarely contend for the same lock the way they do in SkThreadPool.
+class SkWorkStealingThreadPool final : public SkExecutor {
+public:
+    explicit SkWorkStealingThreadPool(int threads, bool allowBorrowing)
+            : fQueues(new Queue[threads])
+            , fQueueCount((unsigned)threads)
+            , fAllowBorrowing(allowBorrowing) {
+        for (int i = 0; i < threads; i++) {
+            fThreads.emplace_back(&Loop, this, i);
+        }
+    }
+
+    ~SkWorkStealingThreadPool() override {
+        // Signal each thread that it's time to shut down.
+        for (int i = 0; i < fThreads.size(); i++) {
+            this->add(nullptr);
+        }
+        // Wait for each thread to shut down.
+        for (int i = 0; i < fThreads.size(); i++) {
+            fThreads[i].join();
+        }
+    }
+
+    void add(std::function<void(void)> work) override {
+        int index = this->currentThreadIndex();
+        if (index < 0) {
+            index = (int)(fNextQueue.fetch_add(1, std::memory_order_relaxed) % fQueueCount);
+        }
+        {
+            Queue& queue = fQueues[index];
+            SkAutoSpinlock lock(queue.fLock);
+            queue.fWork.emplace_back(std::move(work));
+            queue.fSize.store((int)queue.fWork.size(), std::memory_order_relaxed);
+        }
+        // Tell the Loop() threads to pick it up.
+        fWorkAvailable.signal(1);
+    }
+
+    void borrow() override {
+        // If there is work waiting and we're allowed to borrow work, do it.
+        if (fAllowBorrowing && fWorkAvailable.try_wait()) {
+            int index = this->currentThreadIndex();
+            SkAssertResult(this->do_work(index < 0 ? 0 : index));
+        }
+    }
+
+private:
+    struct alignas(64) Queue {
+        SkSpinlock                            fLock;
+        std::deque<std::function<void(void)>> fWork;
+        std::atomic<int>                      fSize{0};  // fWork.size(), readable without fLock.
+    };
+
+    // The pool and queue index of the current thread, if it's one of our Loop() threads.
+    struct Worker {
+        const SkWorkStealingThreadPool* pool  = nullptr;
+        int                             index = -1;
+    };
+    static Worker& CurrentWorker() {
+        static thread_local Worker worker;
+        return worker;
+    }
+    int currentThreadIndex() const {
+        const Worker& worker = CurrentWorker();
+        return worker.pool == this ? worker.index : -1;
+    }
+
+    // This method should be called only when fWorkAvailable indicates there's work to do.
+    // Each signal of fWorkAvailable matches one piece of work in some queue, so scanning the
+    // queues will find it, even if another thread got to the piece of work we saw first.
+    bool do_work(int start) {
+        std::function<void(void)> work;
+        for (bool found = false; !found;) {
+            for (unsigned i = 0; i < fQueueCount && !found; i++) {
+                Queue& queue = fQueues[(start + i) % fQueueCount];
+                if (queue.fSize.load(std::memory_order_relaxed) == 0) {
+                    continue;
+                }
+                SkAutoSpinlock lock(queue.fLock);
+                if (!queue.fWork.empty()) {
+                    work = pop(&queue.fWork);
+                    queue.fSize.store((int)queue.fWork.size(), std::memory_order_relaxed);
+                    found = true;
+                }
+            }
+        }
+
+        if (!work) {
+            return false;  // This is Loop()'s signal to shut down.
+        }
+
+        work();
+        return true;
+    }
+
+    void waitForWork() {
+        // New work tends to arrive in bursts, so spin a little, backing off, before sleeping.
+        for (int spins = 1; spins <= kMaxSpins; spins *= 2) {
+            if (fWorkAvailable.try_wait()) {
+                return;
+            }
+            for (int i = 0; i < spins; i++) {
+                std::this_thread::yield();
+            }
+        }
+        fWorkAvailable.wait();
+    }
+
+    static void Loop(SkWorkStealingThreadPool* pool, int index) {
+        CurrentWorker() = {pool, index};
+        do {
+            pool->waitForWork();
+        } while (pool->do_work(index));
+    }
+
+    static constexpr int kMaxSpins = 64;
+
+    TArray<std::thread>       fThreads;
+    std::unique_ptr<Queue[]>  fQueues;
+    const unsigned            fQueueCount;
+    std::atomic<unsigned>     fNextQueue{0};
+    SkSemaphore               fWorkAvailable;
+    bool                      fAllowBorrowing;
+};
+
 std::unique_ptr<SkExecutor> SkExecutor::MakeFIFOThreadPool(int threads, bool allowBorrowing) {
     using WorkList = std::deque<std::function<void(void)>>;
     return std::make_unique<SkThreadPool<WorkList>>(threads > 0 ? threads : num_cores(),
@@ -153,3 +284,8 @@ std::unique_ptr<SkExecutor> SkExecutor::MakeLIFOThreadPool(int threads, bool all
     return std::make_unique<SkThreadPool<WorkList>>(threads > 0 ? threads : num_cores(),
                                                     allowBorrowing);
 }
+std::unique_ptr<SkExecutor> SkExecutor::MakeWorkStealingThreadPool(int threads,
+                                                                   bool allowBorrowing) {
+    return std::make_unique<SkWorkStealingThreadPool>(threads > 0 ? threads : num_cores(),
+                                                      allowBorrowing);
+}
@@ -8,6 +8,7 @@
 #include "include/core/SkImageGenerator.h"
 
 #include "include/core/SkColorType.h"
+#include "include/core/SkRect.h"
 #include "include/private/base/SkAssert.h"
 #include "src/core/SkNextID.h"
 
@@ -31,6 +32,15 @@ bool SkImageGenerator::getPixels(const SkImageInfo& info, void* pixels, size_t r
     return this->onGetPixels(info, pixels, rowBytes, defaultOpts);
 }
 
+bool SkImageGenerator::getSubsetPixels(const SkPixmap& pm, const SkIRect& subset) {
+    if (kUnknown_SkColorType == pm.colorType() || !pm.addr() ||
+        pm.dimensions() != subset.size() ||
+        !SkIRect::MakeSize(fInfo.dimensions()).contains(subset)) {
+        return false;
+    }
+    return this->onGetSubsetPixels(pm, subset);
+}
+
 bool SkImageGenerator::queryYUVAInfo(const SkYUVAPixmapInfo::SupportedDataTypes& supportedDataTypes,
                                      SkYUVAPixmapInfo* yuvaPixmapInfo) const {
     SkASSERT(yuvaPixmapInfo);
@@ -22,6 +22,9 @@
 
 namespace {
 
+// The number of rows blurred at once by PlanGauss::Scan::blurLanes().
+constexpr int kLanes = 8;
+
 class PlanGauss final {
 public:
     explicit PlanGauss(double sigma) {
@@ -195,6 +198,68 @@ public:
             }
         }
 
+        // The same as blur(), for N rows at once, one in each lane. load(i) returns the i-th alpha
+        // of every row, and store(i, v) writes the i-th result of every row. buffer has room for
+        // bufferSize() vectors.
+        template <int N, typename Load, typename Store>
+        void blurLanes(int srcCount, int dstCount, skvx::Vec<N, uint32_t>* buffer,
+                       Load&& load, Store&& store) const {
+            using V = skvx::Vec<N, uint32_t>;
+            V* const buffer0 = buffer;
+            V* const buffer0End = buffer0 + (fBuffer0End - fBuffer0);
+            V* const buffer1 = buffer0End;
+            V* const buffer1End = buffer1 + (fBuffer1End - fBuffer1);
+            V* const buffer2 = buffer1End;
+            V* const buffer2End = buffer2 + (fBuffer2End - fBuffer2);
+
+            V* buffer0Cursor = buffer0;
+            V* buffer1Cursor = buffer1;
+            V* buffer2Cursor = buffer2;
+            V sum0, sum1, sum2;
+            auto reset = [&] {
+                std::fill(buffer0, buffer2End, V(0));
+                sum0 = sum1 = sum2 = 0;
+            };
+            auto step = [&](const V& leadingEdge) {
+                sum0 += leadingEdge;
+                sum1 += sum0;
+                sum2 += sum1;
+
+                const V blurred = skvx::cast<uint32_t>(
+                        (skvx::cast<uint64_t>(sum2) * fWeight + kHalf) >> 32);
+
+                sum2 -= *buffer2Cursor;
+                *buffer2Cursor = sum1;
+                buffer2Cursor = (buffer2Cursor + 1) < buffer2End ? buffer2Cursor + 1 : buffer2;
+
+                sum1 -= *buffer1Cursor;
+                *buffer1Cursor = sum0;
+                buffer1Cursor = (buffer1Cursor + 1) < buffer1End ? buffer1Cursor + 1 : buffer1;
+
+                sum0 -= *buffer0Cursor;
+                *buffer0Cursor = leadingEdge;
+                buffer0Cursor = (buffer0Cursor + 1) < buffer0End ? buffer0Cursor + 1 : buffer0;
+                return skvx::cast<uint8_t>(blurred);
+            };
+
+            // Consume the source generating pixels, then with the leading edge off the right side
+            // of the mask.
+            reset();
+            int dst = 0;
+            for (int src = 0; src < srcCount; ++src) {
+                store(dst++, step(load(src)));
+            }
+            for (int i = 0; i < fNoChangeCount; ++i) {
+                store(dst++, step(V(0)));
+            }
+
+            // Starting from the right, fill in the rest.
+            reset();
+            for (int right = dstCount, src = srcCount; right > dst;) {
+                store(--right, step(load(--src)));
+            }
+        }
+
     private:
         inline static constexpr uint64_t kHalf = static_cast<uint64_t>(1) << 31;
 
@@ -237,6 +302,8 @@ public:
 
 }  // namespace
 
+bool gSkForceScalarMaskBlur{false};
+
 // NB 135 is the largest sigma that will not cause a buffer full of 255 mask values to overflow
 // using the Gauss filter. It also limits the size of buffers used hold intermediate values. The
 // additional + 1 added to window represents adding one more leading element before subtracting the
@@ -1006,44 +1073,57 @@ SkIPoint SkMaskBlurFilter::blur(const SkMask& src, SkMaskBuilder* dst) const {
     }
     auto tmp = alloc.makeArrayDefault<uint8_t>(tmpW * tmpH);
 
+    // Rows are blurred kLanes at a time, one in each lane of a vector, by first transposing them
+    // into `lanes` so each step of the scan loads one alpha from every row. Any rows left over are
+    // blurred one at a time.
+    const bool useLanes = !gSkForceScalarMaskBlur;
+    auto laneBuffer = alloc.makeArrayDefault<skvx::Vec<kLanes, uint32_t>>(bufferSize);
+    auto lanes = alloc.makeArrayDefault<uint32_t>(std::max(srcW, tmpW) * kLanes);
+    auto loadLanes = [&](int i) { return skvx::Vec<kLanes, uint32_t>::Load(lanes + i * kLanes); };
+
     // Blur horizontally, and transpose.
     const PlanGauss::Scan& scanW = planW.makeBlurScan(srcW, buffer);
+    auto blurRows = [&](auto start, auto end) {
+        int y = 0;
+        for (; useLanes && y + kLanes <= srcH; y += kLanes) {
+            for (int lane = 0; lane < kLanes; ++lane) {
+                int x = 0;
+                for (auto alpha = start; alpha < end; ++alpha, ++x) {
+                    lanes[x * kLanes + lane] = *alpha;
+                }
+                start >>= src.fRowBytes;
+                end >>= src.fRowBytes;
+            }
+            scanW.blurLanes<kLanes>(srcW, tmpH, laneBuffer, loadLanes,
+                                    [&](int x, const skvx::Vec<kLanes, uint8_t>& v) {
+                v.store(&tmp[x * tmpW + y]);
+            });
+        }
+        for (; y < srcH; ++y, start >>= src.fRowBytes, end >>= src.fRowBytes) {
+            auto tmpStart = &tmp[y];
+            scanW.blur(start, end, tmpStart, tmpW, tmpStart + tmpW * tmpH);
+        }
+    };
     switch (src.fFormat) {
         case SkMask::kBW_Format: {
             const uint8_t* bwStart = src.fImage;
-            auto start = SkMask::AlphaIter<SkMask::kBW_Format>(bwStart, 0);
-            auto end = SkMask::AlphaIter<SkMask::kBW_Format>(bwStart + (srcW / 8), srcW % 8);
-            for (int y = 0; y < srcH; ++y, start >>= src.fRowBytes, end >>= src.fRowBytes) {
-                auto tmpStart = &tmp[y];
-                scanW.blur(start, end, tmpStart, tmpW, tmpStart + tmpW * tmpH);
-            }
+            blurRows(SkMask::AlphaIter<SkMask::kBW_Format>(bwStart, 0),
+                     SkMask::AlphaIter<SkMask::kBW_Format>(bwStart + (srcW / 8), srcW % 8));
         } break;
         case SkMask::kA8_Format: {
             const uint8_t* a8Start = src.fImage;
-            auto start = SkMask::AlphaIter<SkMask::kA8_Format>(a8Start);
-            auto end = SkMask::AlphaIter<SkMask::kA8_Format>(a8Start + srcW);
-            for (int y = 0; y < srcH; ++y, start >>= src.fRowBytes, end >>= src.fRowBytes) {
-                auto tmpStart = &tmp[y];
-                scanW.blur(start, end, tmpStart, tmpW, tmpStart + tmpW * tmpH);
-            }
+            blurRows(SkMask::AlphaIter<SkMask::kA8_Format>(a8Start),
+                     SkMask::AlphaIter<SkMask::kA8_Format>(a8Start + srcW));
         } break;
         case SkMask::kARGB32_Format: {
             const uint32_t* argbStart = reinterpret_cast<const uint32_t*>(src.fImage);
-            auto start = SkMask::AlphaIter<SkMask::kARGB32_Format>(argbStart);
-            auto end = SkMask::AlphaIter<SkMask::kARGB32_Format>(argbStart + srcW);
-            for (int y = 0; y < srcH; ++y, start >>= src.fRowBytes, end >>= src.fRowBytes) {
-                auto tmpStart = &tmp[y];
-                scanW.blur(start, end, tmpStart, tmpW, tmpStart + tmpW * tmpH);
-            }
+            blurRows(SkMask::AlphaIter<SkMask::kARGB32_Format>(argbStart),
+                     SkMask::AlphaIter<SkMask::kARGB32_Format>(argbStart + srcW));
         } break;
         case SkMask::kLCD16_Format: {
             const uint16_t* lcdStart = reinterpret_cast<const uint16_t*>(src.fImage);
-            auto start = SkMask::AlphaIter<SkMask::kLCD16_Format>(lcdStart);
-            auto end = SkMask::AlphaIter<SkMask::kLCD16_Format>(lcdStart + srcW);
-            for (int y = 0; y < srcH; ++y, start >>= src.fRowBytes, end >>= src.fRowBytes) {
-                auto tmpStart = &tmp[y];
-                scanW.blur(start, end, tmpStart, tmpW, tmpStart + tmpW * tmpH);
-            }
+            blurRows(SkMask::AlphaIter<SkMask::kLCD16_Format>(lcdStart),
+                     SkMask::AlphaIter<SkMask::kLCD16_Format>(lcdStart + srcW));
         } break;
         default:
             SK_ABORT("Unhandled format.");
@@ -1052,7 +1132,20 @@ SkIPoint SkMaskBlurFilter::blur(const SkMask& src, SkMaskBuilder* dst) const {
     // Blur vertically (scan in memory order because of the transposition),
     // and transpose back to the original orientation.
     const PlanGauss::Scan& scanH = planH.makeBlurScan(tmpW, buffer);
-    for (int y = 0; y < tmpH; y++) {
+    int y = 0;
+    for (; useLanes && y + kLanes <= tmpH; y += kLanes) {
+        for (int lane = 0; lane < kLanes; ++lane) {
+            const uint8_t* tmpRow = &tmp[(y + lane) * tmpW];
+            for (int x = 0; x < tmpW; ++x) {
+                lanes[x * kLanes + lane] = tmpRow[x];
+            }
+        }
+        scanH.blurLanes<kLanes>(tmpW, dstH, laneBuffer, loadLanes,
+                                [&](int x, const skvx::Vec<kLanes, uint8_t>& v) {
+            v.store(&dst->image()[x * dst->fRowBytes + y]);
+        });
+    }
+    for (; y < tmpH; y++) {
         auto tmpStart = &tmp[y * tmpW];
         auto dstStart = &dst->image()[y];
 
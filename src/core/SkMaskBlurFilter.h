@@ -15,6 +15,10 @@
 #include "include/core/SkTypes.h"
 #include "src/core/SkMask.h"
 
+// For testing, blur every row on its own rather than several at once in the lanes of a vector.
+// This affects every thread, so tests that set it must be serial.
+extern bool gSkForceScalarMaskBlur;
+
 // Implement a single channel Gaussian blur. The specifics for implementation are taken from:
 // https://drafts.fxtf.org/filters/#feGaussianBlurElement
 class SkMaskBlurFilter {
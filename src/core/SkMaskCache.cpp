@@ -7,17 +7,26 @@
 
 #include "src/core/SkMaskCache.h"
 
+#include "include/core/SkPath.h"
+#include "include/core/SkPoint.h"
 #include "include/core/SkRRect.h"
 #include "include/core/SkRect.h"
 #include "include/core/SkSize.h"
+#include "include/private/base/SkAlign.h"
 #include "include/private/base/SkAssert.h"
+#include "include/private/base/SkFloatingPoint.h"
 #include "src/base/SkTLazy.h"
 #include "src/core/SkCachedData.h"
 #include "src/core/SkMask.h"
+#include "src/core/SkPathPriv.h"
 #include "src/core/SkResourceCache.h"
 
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
 
 class SkDiscardableMemory;
 enum SkBlurStyle : int;
@@ -198,3 +207,146 @@ void SkMaskCache::Add(SkScalar sigma,
     RectsBlurKey key(sigma, style, rects);
     return CHECK_LOCAL(localCache, add, Add, new RectsBlurRec(key, mask, data));
 }
+
+//////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+static unsigned gPathBlurKeyNamespaceLabel;
+
+std::atomic<uint64_t> gPathBlurHits{0};
+std::atomic<uint64_t> gPathBlurMisses{0};
+
+// Path keys don't have a fixed size: after the SkResourceCache::Key come the sigma, style, fill
+// type and counts, then the verbs (zero padded to a multiple of 4 bytes), the points relative to
+// fOrigin in 1/kSubpixelSteps of a pixel, and the conic weights.
+class PathBlurKey {
+public:
+    static constexpr float kSubpixelSteps = 256;
+
+    PathBlurKey(SkScalar sigma, SkBlurStyle style, const SkPath& path) {
+        const SkRect& bounds = path.getBounds();
+        fOrigin = {sk_float_floor2int(bounds.fLeft), sk_float_floor2int(bounds.fTop)};
+
+        const int verbCount = path.countVerbs();
+        const int pointCount = path.countPoints();
+        const int weightCount = SkPathPriv::ConicWeightCnt(path);
+        const size_t verbBytes = SkAlign4(verbCount);
+        const size_t dataBytes = 6 * sizeof(uint32_t) + verbBytes +
+                                 pointCount * 2 * sizeof(int32_t) + weightCount * sizeof(float);
+
+        fStorage.reset(new uint8_t[sizeof(SkResourceCache::Key) + dataBytes]());
+        SkResourceCache::Key* key = new (fStorage.get()) SkResourceCache::Key();
+        uint8_t* data = fStorage.get() + sizeof(SkResourceCache::Key);
+        auto write32 = [&data](auto value) {
+            static_assert(sizeof(value) == 4);
+            memcpy(data, &value, 4);
+            data += 4;
+        };
+
+        write32(sigma);
+        write32(static_cast<int32_t>(style));
+        write32(static_cast<int32_t>(path.getFillType()));
+        write32(verbCount);
+        write32(pointCount);
+        write32(weightCount);
+        memcpy(data, SkPathPriv::VerbData(path), verbCount);
+        data += verbBytes;
+        const SkPoint* points = SkPathPriv::PointData(path);
+        for (int i = 0; i < pointCount; ++i) {
+            write32(sk_float_round2int((points[i].fX - fOrigin.fX) * kSubpixelSteps));
+            write32(sk_float_round2int((points[i].fY - fOrigin.fY) * kSubpixelSteps));
+        }
+        memcpy(data, SkPathPriv::ConicWeightData(path), weightCount * sizeof(float));
+
+        key->init(&gPathBlurKeyNamespaceLabel, 0, dataBytes);
+    }
+
+    const SkResourceCache::Key& key() const {
+        return *reinterpret_cast<const SkResourceCache::Key*>(fStorage.get());
+    }
+    SkIPoint origin() const { return fOrigin; }
+
+private:
+    std::unique_ptr<uint8_t[]> fStorage;
+    SkIPoint fOrigin;
+};
+
+struct PathBlurRec : public SkResourceCache::Rec {
+    // The mask's bounds are relative to the key's origin.
+    PathBlurRec(const SkResourceCache::Key& key, const SkMask& mask, SkCachedData* data)
+        : fKey(new uint8_t[key.size()])
+        , fValue({{nullptr, mask.fBounds, mask.fRowBytes, mask.fFormat}, data})
+    {
+        memcpy(fKey.get(), &key, key.size());
+        fValue.fData->attachToCacheAndRef();
+    }
+    ~PathBlurRec() override {
+        fValue.fData->detachFromCacheAndUnref();
+    }
+
+    std::unique_ptr<uint8_t[]> fKey;
+    MaskValue                  fValue;
+
+    const Key& getKey() const override { return *reinterpret_cast<const Key*>(fKey.get()); }
+    size_t bytesUsed() const override {
+        return sizeof(*this) + this->getKey().size() + fValue.fData->size();
+    }
+    const char* getCategory() const override { return "path-blur"; }
+    SkDiscardableMemory* diagnostic_only_getDiscardable() const override {
+        return fValue.fData->diagnostic_only_getDiscardable();
+    }
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextData) {
+        const PathBlurRec& rec = static_cast<const PathBlurRec&>(baseRec);
+        SkTLazy<MaskValue>* result = static_cast<SkTLazy<MaskValue>*>(contextData);
+
+        SkCachedData* tmpData = rec.fValue.fData;
+        tmpData->ref();
+        if (nullptr == tmpData->data()) {
+            tmpData->unref();
+            return false;
+        }
+        result->init(rec.fValue);
+        return true;
+    }
+};
+} // namespace
+
+SkCachedData* SkMaskCache::FindAndRef(SkScalar sigma,
+                                      SkBlurStyle style,
+                                      const SkPath& path,
+                                      SkTLazy<SkMask>* mask,
+                                      SkResourceCache* localCache) {
+    SkTLazy<MaskValue> result;
+    PathBlurKey key(sigma, style, path);
+    if (!CHECK_LOCAL(localCache, find, Find, key.key(), PathBlurRec::Visitor, &result)) {
+        gPathBlurMisses.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    gPathBlurHits.fetch_add(1, std::memory_order_relaxed);
+
+    mask->init(static_cast<const uint8_t*>(result->fData->data()),
+               result->fMask.fBounds.makeOffset(key.origin()),
+               result->fMask.fRowBytes,
+               result->fMask.fFormat);
+    return result->fData;
+}
+
+void SkMaskCache::Add(SkScalar sigma,
+                      SkBlurStyle style,
+                      const SkPath& path,
+                      const SkMask& mask,
+                      SkCachedData* data,
+                      SkResourceCache* localCache) {
+    PathBlurKey key(sigma, style, path);
+    const SkMask relativeMask(nullptr,
+                              mask.fBounds.makeOffset(-key.origin().fX, -key.origin().fY),
+                              mask.fRowBytes,
+                              mask.fFormat);
+    return CHECK_LOCAL(localCache, add, Add, new PathBlurRec(key.key(), relativeMask, data));
+}
+
+SkMaskCache::PathStats SkMaskCache::GetPathStats() {
+    return {gPathBlurHits.load(std::memory_order_relaxed),
+            gPathBlurMisses.load(std::memory_order_relaxed)};
+}
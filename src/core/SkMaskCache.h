@@ -11,7 +11,10 @@
 #include "include/core/SkScalar.h"
 #include "include/core/SkSpan.h"
 
+#include <cstdint>
+
 class SkCachedData;
+class SkPath;
 class SkRRect;
 class SkResourceCache;
 enum SkBlurStyle : int;
@@ -48,6 +51,34 @@ public:
                     const SkMask& mask,
                     SkCachedData* data,
                     SkResourceCache* localCache = nullptr);
+
+    /**
+     * Paths are keyed on their geometry relative to the pixel at the top left of their bounds,
+     * with points quantized to 1/256 of a pixel. So the mask added for a path is found again for
+     * the same path translated by whole pixels, with its bounds offset to match.
+     */
+    static SkCachedData* FindAndRef(SkScalar sigma,
+                                    SkBlurStyle style,
+                                    const SkPath& path,
+                                    SkTLazy<SkMask>* mask,
+                                    SkResourceCache* localCache = nullptr);
+    static void Add(SkScalar sigma,
+                    SkBlurStyle style,
+                    const SkPath& path,
+                    const SkMask& mask,
+                    SkCachedData* data,
+                    SkResourceCache* localCache = nullptr);
+
+    struct PathStats {
+        uint64_t fHits = 0;
+        uint64_t fMisses = 0;
+    };
+
+    /**
+     * How many times FindAndRef() found a path's mask, and didn't, since the process started.
+     * These count lookups from every thread, so tests that check them must be serial.
+     */
+    static PathStats GetPathStats();
 };
 
 #endif
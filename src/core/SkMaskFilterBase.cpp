@@ -17,6 +17,7 @@
 #include "include/core/SkTypes.h"
 #include "include/private/base/SkTemplates.h"
 #include "src/base/SkAutoMalloc.h"
+#include "src/base/SkTLazy.h"
 #include "src/core/SkBlitter.h"
 #include "src/core/SkCachedData.h"
 #include "src/core/SkDraw.h"
@@ -201,6 +202,24 @@ static void draw_nine(const SkMask& mask, const SkIRect& outerR, const SkIPoint&
     }
 }
 
+static void blit_mask_through_clip(SkBlitter* blitter,
+                                   const SkMask& mask,
+                                   const SkRasterClip& clip) {
+    // we need to (possibly) resolve the clip and blitter
+    SkAAClipBlitterWrapper wrapper(clip, blitter);
+    blitter = wrapper.getBlitter();
+
+    SkRegion::Cliperator clipper(wrapper.getRgn(), mask.fBounds);
+
+    if (!clipper.done()) {
+        const SkIRect& cr = clipper.rect();
+        do {
+            blitter->blitMask(mask, cr);
+            clipper.next();
+        } while (!clipper.done());
+    }
+}
+
 static int countNestedRects(const SkPath& path, SkRect rects[2]) {
     if (SkPathPriv::IsNestedFillRects(path, rects)) {
         return 2;
@@ -251,13 +270,23 @@ bool SkMaskFilterBase::filterPath(const SkPath& devPath, const SkMatrix& matrix,
         }
     }
 
-    SkMaskBuilder srcM, dstM;
-
 #if defined(SK_BUILD_FOR_FUZZER)
     if (devPath.countVerbs() > 1000 || devPath.countPoints() > 1000) {
         return false;
     }
 #endif
+
+    if (SkStrokeRec::kFill_InitStyle == style) {
+        SkTLazy<SkMask> cachedMask;
+        if (SkCachedData* cache = this->filterPathToCachedMask(devPath, matrix, clip.getBounds(),
+                                                                 &cachedMask)) {
+            blit_mask_through_clip(blitter, *cachedMask, clip);
+            cache->unref();
+            return true;
+        }
+    }
+
+    SkMaskBuilder srcM, dstM;
     if (!SkDraw::DrawToMask(devPath, clip.getBounds(), this, &matrix, &srcM,
                             SkMaskBuilder::kComputeBoundsAndRenderImage_CreateMode,
                             style)) {
@@ -270,20 +299,7 @@ bool SkMaskFilterBase::filterPath(const SkPath& devPath, const SkMatrix& matrix,
     }
     SkAutoMaskFreeImage autoDst(dstM.image());
 
-    // if we get here, we need to (possibly) resolve the clip and blitter
-    SkAAClipBlitterWrapper wrapper(clip, blitter);
-    blitter = wrapper.getBlitter();
-
-    SkRegion::Cliperator clipper(wrapper.getRgn(), dstM.fBounds);
-
-    if (!clipper.done()) {
-        const SkIRect& cr = clipper.rect();
-        do {
-            blitter->blitMask(dstM, cr);
-            clipper.next();
-        } while (!clipper.done());
-    }
-
+    blit_mask_through_clip(blitter, dstM, clip);
     return true;
 }
 
@@ -292,6 +308,13 @@ std::optional<SkMaskFilterBase::NinePatch> SkMaskFilterBase::filterRRectToNine(
     return std::nullopt;
 }
 
+SkCachedData* SkMaskFilterBase::filterPathToCachedMask(const SkPath&,
+                                                       const SkMatrix&,
+                                                       const SkIRect&,
+                                                       SkTLazy<SkMask>*) const {
+    return nullptr;
+}
+
 SkMaskFilterBase::FilterReturn SkMaskFilterBase::filterRectsToNine(
         SkSpan<const SkRect>,
         const SkMatrix&,
@@ -29,6 +29,7 @@ class SkPath;
 class SkRRect;
 class SkRasterClip;
 enum SkBlurStyle : int;
+template <typename T> class SkTLazy;
 
 class SkMaskFilterBase : public SkMaskFilter {
 public:
@@ -154,6 +155,18 @@ protected:
                                                        const SkMatrix&,
                                                        const SkIRect& clipBounds) const;
 
+    /**
+     *  Override if your subclass can filter a filled path into a mask that is kept in a cache,
+     *  so that later draws of the same path (even translated by whole pixels) can reuse it. The
+     *  mask covers the whole path, though only the part within clipBounds is drawn this time. On
+     *  success, init mask and return the SkCachedData holding its pixels, which the caller must
+     *  unref. Return nullptr (the default) to have the path rasterized and filterMask() called.
+     */
+    virtual SkCachedData* filterPathToCachedMask(const SkPath& devPath,
+                                                 const SkMatrix&,
+                                                 const SkIRect& clipBounds,
+                                                 SkTLazy<SkMask>* mask) const;
+
 private:
     friend class SkDraw;
     friend class SkDrawBase;
@@ -9,12 +9,15 @@
 #include "include/core/SkBitmap.h"
 #include "include/core/SkColorSpace.h"
 #include "include/core/SkColorType.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkTypes.h"
 #include "include/private/base/SkTo.h"
 #include "src/base/SkMathPriv.h"
 #include "src/core/SkImageInfoPriv.h"
 #include "src/core/SkMipmapBuilder.h"
+#include "src/core/SkTaskGroup.h"
 
+#include <algorithm>
 #include <new>
 
 //
@@ -42,8 +45,24 @@ size_t SkMipmap::AllocLevelsSize(int levelCount, size_t pixelSize) {
     return SkTo<int32_t>(size);
 }
 
+void SkMipmapDownSampler::buildLevel(const SkPixmap& dst, const SkPixmap& src,
+                                     SkExecutor* executor) {
+    // Below this many pixels per band, the cost of dispatch outweighs the benefit.
+    static constexpr int kMinPixelsPerBand = 64 * 1024;
+
+    const int rowsPerBand = std::max(1, kMinPixelsPerBand / dst.width());
+    if (!executor || dst.height() <= rowsPerBand) {
+        this->buildRows(dst, src, 0, dst.height());
+        return;
+    }
+    SkTaskGroup(*executor).parallelFor(dst.height(), rowsPerBand,
+                                       [&](int top, int bottom, SkArenaAlloc*) {
+        this->buildRows(dst, src, top, bottom);
+    });
+}
+
 SkMipmap* SkMipmap::Build(const SkPixmap& src, SkDiscardableFactoryProc fact,
-                          bool computeContents) {
+                          bool computeContents, SkExecutor* executor) {
     if (src.width() <= 1 && src.height() <= 1) {
         return nullptr;
     }
@@ -120,7 +139,7 @@ SkMipmap* SkMipmap::Build(const SkPixmap& src, SkDiscardableFactoryProc fact,
 
         const SkPixmap& dstPM = levels[i].fPixmap;
         if (downsampler) {
-            downsampler->buildLevel(dstPM, srcPM);
+            downsampler->buildLevel(dstPM, srcPM, executor);
         }
         srcPM = dstPM;
         addr += height * rowBytes;
@@ -265,12 +284,13 @@ bool SkMipmap::validForRootLevel(const SkImageInfo& root) const {
 
 // Helper which extracts a pixmap from the src bitmap
 //
-SkMipmap* SkMipmap::Build(const SkBitmap& src, SkDiscardableFactoryProc fact) {
+SkMipmap* SkMipmap::Build(const SkBitmap& src, SkDiscardableFactoryProc fact,
+                          SkExecutor* executor) {
     SkPixmap srcPixmap;
     if (!src.peekPixels(&srcPixmap)) {
         return nullptr;
     }
-    return Build(srcPixmap, fact);
+    return Build(srcPixmap, fact, /*computeContents=*/true, executor);
 }
 
 int SkMipmap::countLevels() const {
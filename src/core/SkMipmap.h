@@ -19,6 +19,7 @@
 class SkBitmap;
 class SkData;
 class SkDiscardableMemory;
+class SkExecutor;
 class SkMipmapBuilder;
 
 typedef SkDiscardableMemory* (*SkDiscardableFactoryProc)(size_t bytes);
@@ -26,7 +27,12 @@ typedef SkDiscardableMemory* (*SkDiscardableFactoryProc)(size_t bytes);
 struct SkMipmapDownSampler {
     virtual ~SkMipmapDownSampler() {}
 
-    virtual void buildLevel(const SkPixmap& dst, const SkPixmap& src) = 0;
+    // Fills rows [top, bottom) of dst, the level below src. Calls for disjoint rows of the same
+    // level may run concurrently.
+    virtual void buildRows(const SkPixmap& dst, const SkPixmap& src, int top, int bottom) = 0;
+
+    // Fills all of dst. If an executor is passed, a large level is built in row bands on it.
+    void buildLevel(const SkPixmap& dst, const SkPixmap& src, SkExecutor* = nullptr);
 };
 
 /*
@@ -41,10 +47,11 @@ public:
     ~SkMipmap() override;
     // Allocate and fill-in a mipmap. If computeContents is false, we just allocated
     // and compute the sizes/rowbytes, but leave the pixel-data uninitialized.
+    // If an executor is passed, large levels are built in row bands on it.
     static SkMipmap* Build(const SkPixmap& src, SkDiscardableFactoryProc,
-                           bool computeContents = true);
+                           bool computeContents = true, SkExecutor* = nullptr);
 
-    static SkMipmap* Build(const SkBitmap& src, SkDiscardableFactoryProc);
+    static SkMipmap* Build(const SkBitmap& src, SkDiscardableFactoryProc, SkExecutor* = nullptr);
 
     // Determines how many levels a SkMipmap will have without creating that mipmap.
     // This does not include the base mipmap level that the user provided when
@@ -15,20 +15,18 @@
 #include "include/private/base/SkFloatingPoint.h"
 #include "src/base/SkArenaAlloc.h"
 #include "src/core/SkBitmapCache.h"
+#include "src/core/SkCachedData.h"
 #include "src/core/SkMipmap.h"
 #include "src/image/SkImage_Base.h"
 
 class SkImage;
 
-// Try to load from the base image, or from the cache
+// Try to load from the base image, or find a full mipmap in the cache
 static sk_sp<const SkMipmap> try_load_mips(const SkImage_Base* image) {
     sk_sp<const SkMipmap> mips = image->refMips();
     if (!mips) {
         mips.reset(SkMipmapCache::FindAndRef(SkBitmapCacheDesc::Make(image)));
     }
-    if (!mips) {
-        mips.reset(SkMipmapCache::AddAndRef(image));
-    }
     return mips;
 }
 
@@ -75,33 +73,37 @@ SkMipmapAccessor::SkMipmapAccessor(const SkImage_Base* image, const SkMatrix& in
     if (levelNum == 0) {
         load_upper_from_base();
     }
-    // load fCurrMip if needed
+    // load the levels we need, if any
     if (levelNum > 0 || (resolvedMode == SkMipmapMode::kLinear && lowerWeight > 0)) {
+        // Without a full mipmap to use, just the levels we sample are built (and cached).
         fCurrMip = try_load_mips(image);
-        if (!fCurrMip) {
-            load_upper_from_base();
-            resolvedMode = SkMipmapMode::kNone;
-        } else {
-            SkMipmap::Level levelRec;
-
-            SkASSERT(resolvedMode != SkMipmapMode::kNone);
-            if (levelNum > 0) {
-                if (fCurrMip->getLevel(levelNum - 1, &levelRec)) {
-                    fUpper = levelRec.fPixmap;
-                } else {
-                    load_upper_from_base();
-                    resolvedMode = SkMipmapMode::kNone;
+        auto get_level = [&](int index, SkPixmap* pixmap, sk_sp<SkCachedData>* storage) {
+            if (fCurrMip) {
+                SkMipmap::Level levelRec;
+                if (!fCurrMip->getLevel(index, &levelRec)) {
+                    return false;
                 }
+                *pixmap = levelRec.fPixmap;
+                return true;
             }
+            storage->reset(SkMipmapCache::FindOrBuildLevelAndRef(image, index, pixmap));
+            return *storage != nullptr;
+        };
 
-            if (resolvedMode == SkMipmapMode::kLinear) {
-                if (fCurrMip->getLevel(levelNum, &levelRec)) {
-                    fLower = levelRec.fPixmap;
-                    fLowerWeight = lowerWeight;
-                    fLowerInv = scale(fLower);
-                } else {
-                    resolvedMode = SkMipmapMode::kNearest;
-                }
+        SkASSERT(resolvedMode != SkMipmapMode::kNone);
+        if (levelNum > 0) {
+            if (!get_level(levelNum - 1, &fUpper, &fUpperLevel)) {
+                load_upper_from_base();
+                resolvedMode = SkMipmapMode::kNone;
+            }
+        }
+
+        if (resolvedMode == SkMipmapMode::kLinear) {
+            if (get_level(levelNum, &fLower, &fLowerLevel)) {
+                fLowerWeight = lowerWeight;
+                fLowerInv = scale(fLower);
+            } else {
+                resolvedMode = SkMipmapMode::kNearest;
             }
         }
     }
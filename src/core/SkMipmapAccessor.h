@@ -14,6 +14,7 @@
 #include "include/core/SkRefCnt.h"
 #include "include/private/base/SkAssert.h"
 #include "include/private/base/SkNoncopyable.h"
+#include "src/core/SkCachedData.h"
 #include "src/core/SkMipmap.h"
 
 #include <utility>
@@ -51,6 +52,8 @@ private:
     // these manage lifetime for the buffers
     SkBitmap              fBaseStorage;
     sk_sp<const SkMipmap> fCurrMip;
+    sk_sp<SkCachedData>   fUpperLevel,  // levels built on their own, when there's no fCurrMip
+                          fLowerLevel;
 
 public:
     // Don't call publicly -- this is only public for SkArenaAlloc to access it inside Make()
@@ -14,6 +14,7 @@
 #include "include/core/SkMatrix.h"
 #include "include/core/SkPaint.h"
 #include "include/core/SkPixmap.h"
+#include "include/core/SkRect.h"
 #include "include/core/SkSamplingOptions.h"
 #include "include/core/SkScalar.h"
 #include "src/core/SkDraw.h"
@@ -32,7 +33,7 @@ struct DrawDownSampler : SkMipmapDownSampler {
         fPaint.setBlendMode(SkBlendMode::kSrc);
     }
 
-    void buildLevel(const SkPixmap& dst, const SkPixmap& src) override;
+    void buildRows(const SkPixmap& dst, const SkPixmap& src, int top, int bottom) override;
 };
 
 static SkSamplingOptions choose_options(const SkPixmap& dst, const SkPixmap& src) {
@@ -45,8 +46,9 @@ static SkSamplingOptions choose_options(const SkPixmap& dst, const SkPixmap& src
     return SkSamplingOptions(cubic);
 }
 
-void DrawDownSampler::buildLevel(const SkPixmap& dst, const SkPixmap& src) {
-    const SkRasterClip rclip(dst.bounds());
+void DrawDownSampler::buildRows(const SkPixmap& dst, const SkPixmap& src, int top, int bottom) {
+    // Sampling doesn't depend on the clip, so a band draws exactly what the whole level would.
+    const SkRasterClip rclip(SkIRect::MakeLTRB(0, top, dst.width(), bottom));
     const SkMatrix mx = SkMatrix::Scale(SkIntToScalar(dst.width())  / src.width(),
                                         SkIntToScalar(dst.height()) / src.height());
     const auto sampling = choose_options(dst, src);
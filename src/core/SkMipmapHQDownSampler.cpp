@@ -10,10 +10,13 @@
 #ifndef SK_USE_DRAWING_MIPMAP_DOWNSAMPLER
 
 #include "src/base/SkHalf.h"
+#include "src/base/SkUtils.h"
 #include "src/base/SkVx.h"
 #include "src/core/SkColorData.h"
 #include "src/core/SkMipmap.h"
 
+#include <utility>
+
 namespace {
 
 struct ColorTypeFilter_8888 {
@@ -140,17 +143,54 @@ struct ColorTypeFilter_16 {
 
 struct ColorTypeFilter_1010102 {
     typedef uint32_t Type;
-    static uint64_t Expand(uint64_t x) {
-        return (((x      ) & 0x3ff)      ) |
-        (((x >> 10) & 0x3ff) << 20) |
-        (((x >> 20) & 0x3ff) << 40) |
-        (((x >> 30) & 0x3  ) << 60);
-    }
-    static uint32_t Compact(uint64_t x) {
-        return (((x      ) & 0x3ff)      ) |
-        (((x >> 20) & 0x3ff) << 10) |
-        (((x >> 40) & 0x3ff) << 20) |
-        (((x >> 60) & 0x3  ) << 30);
+    // Each channel gets its own 16-bit lane, so that even the alpha sums of the 3x3 filter (which
+    // need 6 bits) can't overflow.
+    static skvx::Vec<4, uint16_t> Expand(uint32_t x) {
+        return skvx::Vec<4, uint16_t>{(uint16_t)((x      ) & 0x3ff),
+                                      (uint16_t)((x >> 10) & 0x3ff),
+                                      (uint16_t)((x >> 20) & 0x3ff),
+                                      (uint16_t)((x >> 30)        )};
+    }
+    static uint32_t Compact(const skvx::Vec<4, uint16_t>& x) {
+        return ((uint32_t)x[0]      ) |
+               ((uint32_t)x[1] << 10) |
+               ((uint32_t)x[2] << 20) |
+               ((uint32_t)x[3] << 30);
+    }
+};
+
+//
+//  The WideFilters expand and compact N pixels at once, for the downsample_*_wide procs below.
+//  Their arithmetic matches the ColorTypeFilter they name, lane for lane, so both produce exactly
+//  the same levels.
+//
+
+template <int kN> struct WideFilter_8888 {
+    using Scalar = ColorTypeFilter_8888;
+    using Type = uint32_t;
+    static constexpr int N = kN;
+    static skvx::Vec<4*N, uint16_t> Expand(const skvx::Vec<N, uint32_t>& x) {
+        return skvx::cast<uint16_t>(sk_bit_cast<skvx::Vec<4*N, uint8_t>>(x));
+    }
+    static skvx::Vec<N, uint32_t> Compact(const skvx::Vec<4*N, uint16_t>& x) {
+        return sk_bit_cast<skvx::Vec<N, uint32_t>>(skvx::cast<uint8_t>(x));
+    }
+};
+
+template <int kN> struct WideFilter_1010102 {
+    using Scalar = ColorTypeFilter_1010102;
+    using Type = uint32_t;
+    static constexpr int N = kN;
+    // Lanes hold all the reds, then all the greens, blues and alphas.
+    static skvx::Vec<4*N, uint16_t> Expand(const skvx::Vec<N, uint32_t>& x) {
+        return skvx::cast<uint16_t>(join(join((x      ) & 0x3ff, (x >> 10) & 0x3ff),
+                                         join((x >> 20) & 0x3ff, (x >> 30)        )));
+    }
+    static skvx::Vec<N, uint32_t> Compact(const skvx::Vec<4*N, uint16_t>& x) {
+        return (skvx::cast<uint32_t>(x.lo.lo)      ) |
+               (skvx::cast<uint32_t>(x.lo.hi) << 10) |
+               (skvx::cast<uint32_t>(x.hi.lo) << 20) |
+               (skvx::cast<uint32_t>(x.hi.hi) << 30);
     }
 };
 
@@ -374,6 +414,147 @@ template <typename F> void downsample_3_3(void* dst, const void* src, size_t src
     }
 }
 
+//
+//  The wide procs filter the interior of each row W::N dst pixels at a time, deinterleaving the
+//  even and odd src columns with shuffles, and finish the row with the scalar proc.
+//
+//  F16 sticks to the scalar procs: each of its pixels already fills a float4, and the half<->float
+//  conversions, not the filter, dominate.
+//
+
+template <int Offset, typename T, size_t... I>
+skvx::Vec<sizeof...(I), T> every_other(const T* p, std::index_sequence<I...>) {
+    constexpr int N = sizeof...(I);
+    return skvx::shuffle<(int)(2*I + Offset)...>(skvx::Vec<2*N, T>::Load(p));
+}
+
+// Returns p[0], p[2], ... p[2N-2].
+template <int N, typename T> skvx::Vec<N, T> load_even(const T* p) {
+    return every_other<0>(p, std::make_index_sequence<N>());
+}
+
+// Returns p[1], p[3], ... p[2N-1].
+template <int N, typename T> skvx::Vec<N, T> load_odd(const T* p) {
+    return every_other<1>(p, std::make_index_sequence<N>());
+}
+
+template <typename W> void downsample_2_2_wide(void* dst, const void* src, size_t srcRB,
+                                               int count) {
+    SkASSERT(count > 0);
+    constexpr int N = W::N;
+    auto p0 = static_cast<const typename W::Type*>(src);
+    auto p1 = (const typename W::Type*)((const char*)p0 + srcRB);
+    auto d = static_cast<typename W::Type*>(dst);
+
+    int i = 0;
+    for (; i + N <= count; i += N) {
+        auto c00 = W::Expand(load_even<N>(p0));
+        auto c01 = W::Expand(load_odd <N>(p0));
+        auto c10 = W::Expand(load_even<N>(p1));
+        auto c11 = W::Expand(load_odd <N>(p1));
+
+        auto c = c00 + c10 + c01 + c11;
+        W::Compact(shift_right(c, 2)).store(d + i);
+        p0 += 2*N;
+        p1 += 2*N;
+    }
+    if (i < count) {
+        downsample_2_2<typename W::Scalar>(d + i, p0, srcRB, count - i);
+    }
+}
+
+template <typename W> void downsample_2_3_wide(void* dst, const void* src, size_t srcRB,
+                                               int count) {
+    SkASSERT(count > 0);
+    constexpr int N = W::N;
+    auto p0 = static_cast<const typename W::Type*>(src);
+    auto p1 = (const typename W::Type*)((const char*)p0 + srcRB);
+    auto p2 = (const typename W::Type*)((const char*)p1 + srcRB);
+    auto d = static_cast<typename W::Type*>(dst);
+
+    int i = 0;
+    for (; i + N <= count; i += N) {
+        auto c00 = W::Expand(load_even<N>(p0));
+        auto c01 = W::Expand(load_odd <N>(p0));
+        auto c10 = W::Expand(load_even<N>(p1));
+        auto c11 = W::Expand(load_odd <N>(p1));
+        auto c20 = W::Expand(load_even<N>(p2));
+        auto c21 = W::Expand(load_odd <N>(p2));
+
+        auto c = add_121(c00, c10, c20) + add_121(c01, c11, c21);
+        W::Compact(shift_right(c, 3)).store(d + i);
+        p0 += 2*N;
+        p1 += 2*N;
+        p2 += 2*N;
+    }
+    if (i < count) {
+        downsample_2_3<typename W::Scalar>(d + i, p0, srcRB, count - i);
+    }
+}
+
+// The 3-wide procs also need column 2N of the src, which load_odd(p + 1) reaches without reading
+// past it. Odd src widths always have that column.
+template <typename W> void downsample_3_2_wide(void* dst, const void* src, size_t srcRB,
+                                               int count) {
+    SkASSERT(count > 0);
+    constexpr int N = W::N;
+    auto p0 = static_cast<const typename W::Type*>(src);
+    auto p1 = (const typename W::Type*)((const char*)p0 + srcRB);
+    auto d = static_cast<typename W::Type*>(dst);
+
+    int i = 0;
+    for (; i + N <= count; i += N) {
+        auto a = W::Expand(load_even<N>(p0)) + W::Expand(load_even<N>(p1));
+
+        auto b0 = W::Expand(load_odd<N>(p0));
+        auto b1 = W::Expand(load_odd<N>(p1));
+        auto b = b0 + b0 + b1 + b1;
+
+        auto c = W::Expand(load_odd<N>(p0 + 1)) + W::Expand(load_odd<N>(p1 + 1));
+
+        auto sum = a + b + c;
+        W::Compact(shift_right(sum, 3)).store(d + i);
+        p0 += 2*N;
+        p1 += 2*N;
+    }
+    if (i < count) {
+        downsample_3_2<typename W::Scalar>(d + i, p0, srcRB, count - i);
+    }
+}
+
+template <typename W> void downsample_3_3_wide(void* dst, const void* src, size_t srcRB,
+                                               int count) {
+    SkASSERT(count > 0);
+    constexpr int N = W::N;
+    auto p0 = static_cast<const typename W::Type*>(src);
+    auto p1 = (const typename W::Type*)((const char*)p0 + srcRB);
+    auto p2 = (const typename W::Type*)((const char*)p1 + srcRB);
+    auto d = static_cast<typename W::Type*>(dst);
+
+    int i = 0;
+    for (; i + N <= count; i += N) {
+        auto a = add_121(W::Expand(load_even<N>(p0)),
+                         W::Expand(load_even<N>(p1)),
+                         W::Expand(load_even<N>(p2)));
+
+        auto b = shift_left(add_121(W::Expand(load_odd<N>(p0)),
+                                    W::Expand(load_odd<N>(p1)),
+                                    W::Expand(load_odd<N>(p2))), 1);
+
+        auto c = add_121(W::Expand(load_odd<N>(p0 + 1)),
+                         W::Expand(load_odd<N>(p1 + 1)),
+                         W::Expand(load_odd<N>(p2 + 1)));
+
+        auto sum = a + b + c;
+        W::Compact(shift_right(sum, 4)).store(d + i);
+        p0 += 2*N;
+        p1 += 2*N;
+        p2 += 2*N;
+    }
+    if (i < count) {
+        downsample_3_3<typename W::Scalar>(d + i, p0, srcRB, count - i);
+    }
+}
 
 typedef void FilterProc(void*, const void* srcPtr, size_t srcRB, int count);
 
@@ -387,10 +568,10 @@ struct HQDownSampler : SkMipmapDownSampler {
     FilterProc* proc_3_2 = nullptr;
     FilterProc* proc_3_3 = nullptr;
 
-    void buildLevel(const SkPixmap& dst, const SkPixmap& src) override;
+    void buildRows(const SkPixmap& dst, const SkPixmap& src, int top, int bottom) override;
 };
 
-void HQDownSampler::buildLevel(const SkPixmap& dst, const SkPixmap& src) {
+void HQDownSampler::buildRows(const SkPixmap& dst, const SkPixmap& src, int top, int bottom) {
     const int width = src.width();
     const int height = src.height();
 
@@ -425,11 +606,11 @@ void HQDownSampler::buildLevel(const SkPixmap& dst, const SkPixmap& src) {
         }
     }
 
-    const void* srcBasePtr = src.addr();
     const size_t srcRB = src.rowBytes();
-    void* dstBasePtr = dst.writable_addr();
+    const void* srcBasePtr = src.addr(0, 2 * top);
+    void* dstBasePtr = dst.writable_addr(0, top);
 
-    for (int y = 0; y < dst.height(); y++) {
+    for (int y = top; y < bottom; y++) {
         proc(dstBasePtr, srcBasePtr, srcRB, dst.width());
         srcBasePtr = (const char*)srcBasePtr + srcRB * 2; // jump two rows
         dstBasePtr = (      char*)dstBasePtr + dst.rowBytes();
@@ -454,11 +635,11 @@ std::unique_ptr<SkMipmapDownSampler> SkMipmap::MakeDownSampler(const SkPixmap& r
             proc_1_2 = downsample_1_2<ColorTypeFilter_8888>;
             proc_1_3 = downsample_1_3<ColorTypeFilter_8888>;
             proc_2_1 = downsample_2_1<ColorTypeFilter_8888>;
-            proc_2_2 = downsample_2_2<ColorTypeFilter_8888>;
-            proc_2_3 = downsample_2_3<ColorTypeFilter_8888>;
+            proc_2_2 = downsample_2_2_wide<WideFilter_8888<4>>;
+            proc_2_3 = downsample_2_3_wide<WideFilter_8888<4>>;
             proc_3_1 = downsample_3_1<ColorTypeFilter_8888>;
-            proc_3_2 = downsample_3_2<ColorTypeFilter_8888>;
-            proc_3_3 = downsample_3_3<ColorTypeFilter_8888>;
+            proc_3_2 = downsample_3_2_wide<WideFilter_8888<4>>;
+            proc_3_3 = downsample_3_3_wide<WideFilter_8888<4>>;
             break;
         case kRGB_565_SkColorType:
             proc_1_2 = downsample_1_2<ColorTypeFilter_565>;
@@ -538,11 +719,11 @@ std::unique_ptr<SkMipmapDownSampler> SkMipmap::MakeDownSampler(const SkPixmap& r
             proc_1_2 = downsample_1_2<ColorTypeFilter_1010102>;
             proc_1_3 = downsample_1_3<ColorTypeFilter_1010102>;
             proc_2_1 = downsample_2_1<ColorTypeFilter_1010102>;
-            proc_2_2 = downsample_2_2<ColorTypeFilter_1010102>;
-            proc_2_3 = downsample_2_3<ColorTypeFilter_1010102>;
+            proc_2_2 = downsample_2_2_wide<WideFilter_1010102<4>>;
+            proc_2_3 = downsample_2_3_wide<WideFilter_1010102<4>>;
             proc_3_1 = downsample_3_1<ColorTypeFilter_1010102>;
-            proc_3_2 = downsample_3_2<ColorTypeFilter_1010102>;
-            proc_3_3 = downsample_3_3<ColorTypeFilter_1010102>;
+            proc_3_2 = downsample_3_2_wide<WideFilter_1010102<4>>;
+            proc_3_3 = downsample_3_3_wide<WideFilter_1010102<4>>;
             break;
         case kA16_float_SkColorType:
             proc_1_2 = downsample_1_2<ColorTypeFilter_Alpha_F16>;
@@ -7,26 +7,37 @@
 
 #include "include/core/SkPicture.h"
 
+#include "include/core/SkBBHFactory.h"
+#include "include/core/SkCanvas.h"
 #include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkMatrix.h"
 #include "include/core/SkPictureRecorder.h"
+#include "include/core/SkPixmap.h"
 #include "include/core/SkSerialProcs.h"
 #include "include/core/SkStream.h"
 #include "include/private/base/SkTFitsIn.h"
 #include "include/private/base/SkTo.h"
 #include "src/base/SkMathPriv.h"
+#include "src/core/SkBigPicture.h"
 #include "src/core/SkCanvasPriv.h"
 #include "src/core/SkPictureData.h"
 #include "src/core/SkPicturePlayback.h"
 #include "src/core/SkPicturePriv.h"
 #include "src/core/SkPictureRecord.h"
 #include "src/core/SkReadBuffer.h"
+#include "src/core/SkRecord.h"
+#include "src/core/SkRecordDraw.h"
 #include "src/core/SkResourceCache.h"
 #include "src/core/SkStreamPriv.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/core/SkWriteBuffer.h"
 
+#include <algorithm>
 #include <atomic>
 #include <cstring>
 #include <memory>
+#include <vector>
 
 // When we read/write the SkPictInfo via a stream, we have a sentinel byte right after the info.
 // Note: in the read/write buffer versions, we have a slightly different convention:
@@ -55,6 +66,80 @@ SkPicture::~SkPicture() {
     }
 }
 
+bool SkPicture::playbackParallel(const SkPixmap& dst, SkExecutor* executor,
+                                 const SkMatrix* matrix, const SkSurfaceProps* props) const {
+    // Check once that we can draw into dst at all; each tile makes its own canvas below.
+    if (!SkCanvas::MakeRasterDirect(dst.info(), dst.writable_addr(), dst.rowBytes(), props)) {
+        return false;
+    }
+    const SkMatrix ctm = matrix ? *matrix : SkMatrix::I();
+    SkMatrix inverse;
+    if (!ctm.invert(&inverse)) {
+        return true;
+    }
+
+    // With a BBH we can skip tiles that nothing draws into, and weigh the others by op count.
+    // Its picture's cull rect is also known to bound everything drawn; without one, playback()
+    // doesn't clip to the cull rect, and neither can we.
+    const SkBigPicture* big = this->asSkBigPicture();
+    const SkBBoxHierarchy* bbh = big ? big->bbh() : nullptr;
+    const SkIRect bounds = dst.bounds();
+
+    struct Tile {
+        SkIRect fBounds;
+        size_t  fOpCount;
+    };
+    static constexpr int kTileSize = 256;
+    std::vector<Tile> tiles;
+    std::vector<int> ops;
+    for (int y = bounds.fTop; y < bounds.fBottom; y += kTileSize) {
+        for (int x = bounds.fLeft; x < bounds.fRight; x += kTileSize) {
+            SkIRect tile = SkIRect::MakeXYWH(x, y, kTileSize, kTileSize);
+            SkAssertResult(tile.intersect(bounds));
+            size_t opCount = 1;
+            if (bbh) {
+                // Outset by a pixel to catch anti-aliased edges, like the local clip bounds that
+                // SkBigPicture::playback() queries with.
+                ops.clear();
+                bbh->search(inverse.mapRect(SkRect::Make(tile.makeOutset(1, 1))), &ops);
+                if (ops.empty()) {
+                    continue;
+                }
+                opCount = ops.size();
+            }
+            tiles.push_back({tile, opCount});
+        }
+    }
+    // Start the busiest tiles first, so that no thread is left drawing a big one at the end.
+    std::stable_sort(tiles.begin(), tiles.end(), [](const Tile& a, const Tile& b) {
+        return a.fOpCount > b.fOpCount;
+    });
+
+    auto drawTile = [&](int i) {
+        const SkIRect& tile = tiles[i].fBounds;
+        SkPixmap subset;
+        SkAssertResult(dst.extractSubset(&subset, tile));
+        std::unique_ptr<SkCanvas> canvas = SkCanvas::MakeRasterDirect(
+                subset.info(), subset.writable_addr(), subset.rowBytes(), props);
+        canvas->translate(-tile.fLeft, -tile.fTop);
+        canvas->concat(ctm);
+        this->playback(canvas.get());
+    };
+
+    // Pictures with ops that escape the tile clip are drawn as one tile.
+    if (tiles.size() > 1 && SkRecordEscapesTileClip(*big->record(), big->record()->count())) {
+        tiles.assign(1, {bounds, 1});
+    }
+    if (tiles.size() == 1) {
+        drawTile(0);
+        return true;
+    }
+    SkTaskGroup tg(executor ? *executor : SkExecutor::GetDefault());
+    tg.batch(SkToInt(tiles.size()), drawTile);
+    tg.wait();
+    return true;
+}
+
 static const char kMagic[] = { 's', 'k', 'i', 'a', 'p', 'i', 'c', 't' };
 
 SkPictInfo SkPicture::createHeader() const {
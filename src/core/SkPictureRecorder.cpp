@@ -33,7 +33,8 @@ SkPictureRecorder::SkPictureRecorder() {
 SkPictureRecorder::~SkPictureRecorder() {}
 
 SkCanvas* SkPictureRecorder::beginRecording(const SkRect& userCullRect,
-                                            sk_sp<SkBBoxHierarchy> bbh) {
+                                            sk_sp<SkBBoxHierarchy> bbh,
+                                            uint32_t recordFlags) {
     const SkRect cullRect = userCullRect.isEmpty() ? SkRect::MakeEmpty() : userCullRect;
 
     fCullRect = cullRect;
@@ -43,12 +44,14 @@ SkCanvas* SkPictureRecorder::beginRecording(const SkRect& userCullRect,
         fRecord.reset(new SkRecord);
     }
     fRecorder->reset(fRecord.get(), cullRect);
+    fRecorder->setInternPayloads(recordFlags & kInternPayloads_RecordFlag);
     fActivelyRecording = true;
     return this->getRecordingCanvas();
 }
 
-SkCanvas* SkPictureRecorder::beginRecording(const SkRect& bounds, SkBBHFactory* factory) {
-    return this->beginRecording(bounds, factory ? (*factory)() : nullptr);
+SkCanvas* SkPictureRecorder::beginRecording(const SkRect& bounds, SkBBHFactory* factory,
+                                            uint32_t recordFlags) {
+    return this->beginRecording(bounds, factory ? (*factory)() : nullptr, recordFlags);
 }
 
 SkCanvas* SkPictureRecorder::getRecordingCanvas() {
@@ -8,6 +8,7 @@
 #include "src/core/SkRasterPipeline.h"
 
 #include "include/core/SkColorType.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkMatrix.h"
 #include "include/private/base/SkDebug.h"
@@ -18,8 +19,10 @@
 #include "src/core/SkOpts.h"
 #include "src/core/SkRasterPipelineOpContexts.h"
 #include "src/core/SkRasterPipelineOpList.h"
+#include "src/core/SkTaskGroup.h"
 
 #include <algorithm>
+#include <climits>
 #include <cstring>
 #include <vector>
 
@@ -640,6 +643,88 @@ void SkRasterPipeline::run(size_t x, size_t y, size_t w, size_t h) const {
                    fTailPointer);
 }
 
+bool SkRasterPipeline::canRunInParallel() const {
+    // Stack rewinding and the shared tail value are per-run state.
+    if (fRewindCtx || fTailPointer) {
+        return false;
+    }
+    for (const StageList* st = fStages; st; st = st->prev) {
+        if (!st->ctx) {
+            continue;
+        }
+        // Load/store contexts are patched while running tails, but runParallel() copies them.
+        if (std::any_of(fMemoryCtxInfos.begin(), fMemoryCtxInfos.end(),
+                        [&](const SkRasterPipeline_MemoryCtxInfo& info) {
+                            return info.context == st->ctx;
+                        })) {
+            continue;
+        }
+        // These stages only ever read their contexts. Many others (samplers, decal, gradients
+        // with masks, SkSL, callbacks...) write to theirs as they go.
+        switch (st->stage) {
+            case Op::swizzle:
+            case Op::set_rgb:               case Op::unbounded_set_rgb:
+            case Op::uniform_color:         case Op::unbounded_uniform_color:
+            case Op::uniform_color_dst:
+            case Op::scale_1_float:         case Op::lerp_1_float:
+            case Op::dither:
+            case Op::byte_tables:
+            case Op::parametric:            case Op::gamma_:
+            case Op::PQish:                 case Op::HLGish:            case Op::HLGinvish:
+            case Op::matrix_3x3:            case Op::matrix_3x4:
+            case Op::matrix_4x3:            case Op::matrix_4x5:
+            case Op::matrix_translate:      case Op::matrix_scale_translate:
+            case Op::matrix_2x3:            case Op::matrix_perspective:
+                continue;
+            default:
+                return false;
+        }
+    }
+    return true;
+}
+
+void SkRasterPipeline::runParallel(size_t x, size_t y, size_t w, size_t h,
+                                   SkExecutor& executor) const {
+    // Below this many pixels per band, the cost of dispatch outweighs the benefit.
+    static constexpr size_t kMinPixelsPerBand = 64 * 1024;
+
+    const size_t rowsPerBand = std::max<size_t>(1, kMinPixelsPerBand / std::max<size_t>(w, 1));
+    if (h <= rowsPerBand || h > INT_MAX || !this->canRunInParallel()) {
+        this->run(x, y, w, h);
+        return;
+    }
+
+    const int stagesNeeded = this->stagesNeeded();
+    const int numMemoryCtxs = fMemoryCtxInfos.size();
+
+    SkTaskGroup tg(executor);
+    tg.parallelFor((int)h, (int)rowsPerBand, [&](int start, int end, SkArenaAlloc* alloc) {
+        SkRasterPipelineStage* program = alloc->makeArray<SkRasterPipelineStage>(stagesNeeded);
+        auto start_pipeline = this->buildPipeline(program + stagesNeeded);
+
+        // Point this band's program at its own copies of the load/store contexts, so that tail
+        // patching in one band can't be seen by another.
+        auto* ctxs = alloc->makeArray<SkRasterPipeline_MemoryCtx>(numMemoryCtxs);
+        auto* patches = alloc->makeArray<SkRasterPipeline_MemoryCtxPatch>(numMemoryCtxs);
+        for (int i = 0; i < numMemoryCtxs; ++i) {
+            ctxs[i] = *fMemoryCtxInfos[i].context;
+            patches[i].info = fMemoryCtxInfos[i];
+            patches[i].info.context = &ctxs[i];
+            patches[i].backup = nullptr;
+            memset(patches[i].scratch, 0, sizeof(patches[i].scratch));
+            for (int s = 0; s < stagesNeeded; ++s) {
+                if (program[s].ctx == fMemoryCtxInfos[i].context) {
+                    program[s].ctx = &ctxs[i];
+                }
+            }
+        }
+
+        start_pipeline(x, y + start, x + w, y + end, program,
+                       SkSpan{patches, numMemoryCtxs},
+                       /*tailPointer=*/nullptr);
+    });
+}
+
 std::function<void(size_t, size_t, size_t, size_t)> SkRasterPipeline::compile() const {
     if (this->empty()) {
         return [](size_t, size_t, size_t, size_t) {};
@@ -667,6 +752,45 @@ std::function<void(size_t, size_t, size_t, size_t)> SkRasterPipeline::compile()
     };
 }
 
+bool SkRasterPipeline::compileProgram(Program* program) const {
+    if (this->empty() || fRewindCtx || fTailPointer) {
+        return false;
+    }
+
+    const int stagesNeeded = this->stagesNeeded();
+    program->stages.resize(stagesNeeded);
+    program->start = this->buildPipeline(program->stages.data() + stagesNeeded);
+    program->memoryCtxs.reset(fMemoryCtxInfos.data(), fMemoryCtxInfos.size());
+    return true;
+}
+
+std::function<void(size_t, size_t, size_t, size_t)> SkRasterPipeline::Bind(
+        const Program& program, SkArenaAlloc* alloc, const std::function<void*(void*)>& remap) {
+    const int numStages = program.stages.size();
+    SkRasterPipelineStage* stages = alloc->makeArray<SkRasterPipelineStage>(numStages);
+    for (int i = 0; i < numStages; ++i) {
+        void* ctx = program.stages[i].ctx;
+        stages[i] = {program.stages[i].fn, ctx ? remap(ctx) : nullptr};
+    }
+
+    const int numMemoryCtxs = program.memoryCtxs.size();
+    SkRasterPipeline_MemoryCtxPatch* patches =
+            alloc->makeArray<SkRasterPipeline_MemoryCtxPatch>(numMemoryCtxs);
+    for (int i = 0; i < numMemoryCtxs; ++i) {
+        patches[i].info = program.memoryCtxs[i];
+        patches[i].info.context = (SkRasterPipeline_MemoryCtx*)remap(patches[i].info.context);
+        patches[i].backup = nullptr;
+        memset(patches[i].scratch, 0, sizeof(patches[i].scratch));
+    }
+
+    StartPipelineFn start_pipeline = program.start;
+    return [=](size_t x, size_t y, size_t w, size_t h) {
+        start_pipeline(x, y, x + w, y + h, stages,
+                       SkSpan{patches, numMemoryCtxs},
+                       /*tailPointer=*/nullptr);
+    };
+}
+
 void SkRasterPipeline::addMemoryContext(SkRasterPipeline_MemoryCtx* ctx,
                                         int bytesPerPixel,
                                         bool load,
@@ -20,6 +20,7 @@
 #include <cstdint>
 #include <functional>
 
+class SkExecutor;
 class SkMatrix;
 enum class SkRasterPipelineOp;
 enum SkColorType : int;
@@ -90,9 +91,38 @@ public:
     // Runs the pipeline in 2d from (x,y) inclusive to (x+w,y+h) exclusive.
     void run(size_t x, size_t y, size_t w, size_t h) const;
 
+    // Like run(), but splits the rows into bands that run concurrently on the executor. Each band
+    // gets its own copy of the program and of the load/store contexts; every other context is
+    // shared, read-only. Falls back to run() when the area is too small to be worth splitting, or
+    // when a stage's context isn't known to be read-only.
+    void runParallel(size_t x, size_t y, size_t w, size_t h, SkExecutor&) const;
+
     // Allocates a thunk which amortizes run() setup cost in alloc.
     std::function<void(size_t, size_t, size_t, size_t)> compile() const;
 
+    using StartPipelineFn = void (*)(size_t, size_t, size_t, size_t,
+                                     SkRasterPipelineStage* program,
+                                     SkSpan<SkRasterPipeline_MemoryCtxPatch>,
+                                     uint8_t*);
+
+    // A compiled program that owns its storage, so it can outlive this pipeline and its arena
+    // (e.g. in a cache). Its contexts are still the ones this pipeline was built with.
+    struct Program {
+        StartPipelineFn                                          start = nullptr;
+        skia_private::TArray<SkRasterPipelineStage>              stages;
+        skia_private::STArray<2, SkRasterPipeline_MemoryCtxInfo> memoryCtxs;
+    };
+
+    // Compiles this pipeline into `program`. Returns false if the pipeline is empty or has
+    // per-run state (stack rewinding, or a shared tail value), which only run() and compile()
+    // know how to set up.
+    bool compileProgram(Program* program) const;
+
+    // Like compile(), but for a Program, with each non-null context `ctx` (including those of
+    // the load/store contexts) replaced by remap(ctx). The copy of the program is made in alloc.
+    static std::function<void(size_t, size_t, size_t, size_t)> Bind(
+            const Program&, SkArenaAlloc*, const std::function<void*(void*)>& remap);
+
     // Callers can inspect the stage list for debugging purposes.
     struct StageList {
         StageList*          prev;
@@ -142,14 +172,11 @@ private:
     bool buildLowpPipeline(SkRasterPipelineStage* ip) const;
     void buildHighpPipeline(SkRasterPipelineStage* ip) const;
 
-    using StartPipelineFn = void (*)(size_t, size_t, size_t, size_t,
-                                     SkRasterPipelineStage* program,
-                                     SkSpan<SkRasterPipeline_MemoryCtxPatch>,
-                                     uint8_t*);
     StartPipelineFn buildPipeline(SkRasterPipelineStage*) const;
 
     void uncheckedAppend(SkRasterPipelineOp, void*);
     int stagesNeeded() const;
+    bool canRunInParallel() const;
 
     void addMemoryContext(SkRasterPipeline_MemoryCtx*, int bytesPerPixel, bool load, bool store);
     uint8_t* tailPointer();
@@ -19,6 +19,7 @@
 #include "include/core/SkSurfaceProps.h"
 #include "include/private/base/SkAssert.h"
 #include "include/private/base/SkCPUTypes.h"
+#include "include/private/base/SkMutex.h"
 #include "include/private/base/SkTemplates.h"
 #include "src/base/SkArenaAlloc.h"
 #include "src/core/SkBlendModePriv.h"
@@ -27,6 +28,7 @@
 #include "src/core/SkColorSpacePriv.h"
 #include "src/core/SkColorSpaceXformSteps.h"
 #include "src/core/SkEffectPriv.h"
+#include "src/core/SkLRUCache.h"
 #include "src/core/SkMask.h"
 #include "src/core/SkMemset.h"
 #include "src/core/SkRasterPipeline.h"
@@ -44,6 +46,70 @@
 class SkColorSpace;
 class SkShader;
 
+extern bool gForceHighPrecisionRasterPipeline;
+
+namespace {
+
+enum class BlitType : uint8_t { kRect, kAntiH, kMaskA8, kMaskLCD16, kMask3D };
+
+// Once a paint has been collapsed to a constant color and its blender is a blend mode, nothing else
+// about it affects the blit pipelines. Blitters that agree on this key build identical programs
+// that differ only in their contexts, so those programs can be shared.
+SK_BEGIN_REQUIRE_DENSE
+struct BlitProgramKey {
+    uint8_t  fColorType;
+    uint8_t  fAlphaType;
+    uint8_t  fHasColorSpace;
+    uint8_t  fBlendMode;
+    uint16_t fConstantColorOp;
+    BlitType fBlitType;
+    uint8_t  fForceHighp;
+
+    bool operator==(const BlitProgramKey& that) const {
+        return 0 == memcmp(this, &that, sizeof(*this));
+    }
+};
+SK_END_REQUIRE_DENSE
+
+// A bounded, thread-safe cache of blit programs. The cached programs don't point at any blitter;
+// their contexts are tokens that SkRasterPipelineBlitter knows how to map back to its own state.
+class BlitProgramCache {
+public:
+    static BlitProgramCache* Get() {
+        static BlitProgramCache* gCache = new BlitProgramCache;
+        return gCache;
+    }
+
+    bool bind(const BlitProgramKey& key,
+              SkArenaAlloc* alloc,
+              const std::function<void*(void*)>& remap,
+              std::function<void(size_t, size_t, size_t, size_t)>* blit) {
+        SkAutoMutexExclusive lock(fMutex);
+        const SkRasterPipeline::Program* program = fPrograms.find(key);
+        if (!program) {
+            return false;
+        }
+        *blit = SkRasterPipeline::Bind(*program, alloc, remap);
+        return true;
+    }
+
+    void insert(const BlitProgramKey& key, SkRasterPipeline::Program program) {
+        SkAutoMutexExclusive lock(fMutex);
+        fPrograms.insert_or_update(key, std::move(program));
+    }
+
+private:
+    // Clients tend to draw into a few color types with a few blend modes, so this is plenty.
+    static constexpr int kMaxPrograms = 256;
+
+    BlitProgramCache() : fPrograms(kMaxPrograms) {}
+
+    SkMutex fMutex;
+    SkLRUCache<BlitProgramKey, SkRasterPipeline::Program> fPrograms SK_GUARDED_BY(fMutex);
+};
+
+}  // namespace
+
 class SkRasterPipelineBlitter final : public SkBlitter {
 public:
     // This is our common entrypoint for creating the blitter once we've sorted out shaders.
@@ -74,6 +140,15 @@ public:
 
 private:
     void blitRectWithTrace(int x, int y, int w, int h, bool trace);
+
+    // Looks for a program for this type of blit in the shared cache, binding it to this blitter.
+    bool bindCachedProgram(BlitType, std::function<void(size_t, size_t, size_t, size_t)>*);
+    // Compiles p, adding the program to the shared cache if this blitter can share its programs.
+    std::function<void(size_t, size_t, size_t, size_t)> compileAndCache(BlitType,
+                                                                        const SkRasterPipeline& p);
+    BlitProgramKey programKey(BlitType) const;
+    void* encodeContext(void*) const;
+    void* decodeContext(void*) const;
     void appendLoadDst      (SkRasterPipeline*) const;
     void appendStore        (SkRasterPipeline*) const;
 
@@ -90,6 +165,11 @@ private:
     // set to pipeline storage (for alpha) if we have a clipShader
     void*                  fClipShaderBuffer = nullptr; // "native" : float or U16
 
+    // Set when the paint collapsed to a constant color and a blend mode; see BlitProgramKey.
+    bool                   fCanShareProgram = false;
+    SkRasterPipelineOp     fConstantColorOp  = SkRasterPipelineOp::black_color;
+    void*                  fConstantColorCtx = nullptr;  // May be null (e.g. black_color)
+
     SkRasterPipeline_MemoryCtx
         fDstPtr       = {nullptr,0},  // Always points to the top-left of fDst.
         fMaskPtr      = {nullptr,0};  // Updated each call to blitMask().
@@ -287,6 +367,8 @@ SkBlitter* SkRasterPipelineBlitter::Create(const SkPixmap& dst,
         colorPipeline->run(0,0,1,1);
         colorPipeline->reset();
         colorPipeline->appendConstantColor(alloc, constantColor);
+        blitter->fConstantColorOp  = colorPipeline->getStageList()->stage;
+        blitter->fConstantColorCtx = colorPipeline->getStageList()->ctx;
 
         is_opaque = constantColor.fA == 1.0f;
     }
@@ -350,6 +432,7 @@ SkBlitter* SkRasterPipelineBlitter::Create(const SkPixmap& dst,
         }
         blitter->fBlendMode = as_BB(blender)->asBlendMode();
     }
+    blitter->fCanShareProgram = is_constant && blitter->fBlendMode.has_value();
 
     blitter->fDstPtr = SkRasterPipeline_MemoryCtx{
         blitter->fDst.writable_addr(),
@@ -385,6 +468,80 @@ void SkRasterPipelineBlitter::appendClipLerp(SkRasterPipeline* p) const {
     }
 }
 
+BlitProgramKey SkRasterPipelineBlitter::programKey(BlitType type) const {
+    SkASSERT(fCanShareProgram);
+    return {
+        (uint8_t)fDst.colorType(),
+        (uint8_t)fDst.alphaType(),
+        fDst.colorSpace() != nullptr,
+        (uint8_t)*fBlendMode,
+        (uint16_t)fConstantColorOp,
+        type,
+        gForceHighPrecisionRasterPipeline,
+    };
+}
+
+// Shared programs can only refer to this blitter's own fields (dst, mask, coverage...) and to the
+// constant color. Those are stored as tokens: 1 + the field's offset into the blitter, or
+// kConstantColorToken.
+static constexpr uintptr_t kConstantColorToken = sizeof(SkRasterPipelineBlitter) + 1;
+
+void* SkRasterPipelineBlitter::encodeContext(void* ctx) const {
+    if (ctx == fConstantColorCtx) {
+        return (void*)kConstantColorToken;
+    }
+    const uintptr_t offset = (uintptr_t)ctx - (uintptr_t)this;
+    if ((uintptr_t)ctx >= (uintptr_t)this && offset < sizeof(*this)) {
+        return (void*)(offset + 1);
+    }
+    return nullptr;  // Some other object, which we can't find from another blitter.
+}
+
+void* SkRasterPipelineBlitter::decodeContext(void* token) const {
+    const uintptr_t t = (uintptr_t)token;
+    SkASSERT(0 < t && t <= kConstantColorToken);
+    if (t == kConstantColorToken) {
+        return fConstantColorCtx;
+    }
+    return SkTAddOffset<void>(const_cast<SkRasterPipelineBlitter*>(this), t - 1);
+}
+
+bool SkRasterPipelineBlitter::bindCachedProgram(
+        BlitType type, std::function<void(size_t, size_t, size_t, size_t)>* blit) {
+    if (!fCanShareProgram) {
+        return false;
+    }
+    return BlitProgramCache::Get()->bind(this->programKey(type), fAlloc,
+                                         [this](void* token) {
+                                             return this->decodeContext(token);
+                                         },
+                                         blit);
+}
+
+std::function<void(size_t, size_t, size_t, size_t)> SkRasterPipelineBlitter::compileAndCache(
+        BlitType type, const SkRasterPipeline& p) {
+    SkRasterPipeline::Program program;
+    if (!fCanShareProgram || !p.compileProgram(&program)) {
+        return p.compile();
+    }
+    for (SkRasterPipelineStage& stage : program.stages) {
+        if (stage.ctx && !(stage.ctx = this->encodeContext(stage.ctx))) {
+            return p.compile();
+        }
+    }
+    for (SkRasterPipeline_MemoryCtxInfo& info : program.memoryCtxs) {
+        if (!(info.context = (SkRasterPipeline_MemoryCtx*)this->encodeContext(info.context))) {
+            return p.compile();
+        }
+    }
+
+    auto blit = SkRasterPipeline::Bind(program, fAlloc, [this](void* token) {
+        return this->decodeContext(token);
+    });
+    BlitProgramCache::Get()->insert(this->programKey(type), std::move(program));
+    return blit;
+}
+
 void SkRasterPipelineBlitter::blitH(int x, int y, int w) {
     this->blitRect(x,y,w,1);
 }
@@ -399,7 +556,7 @@ void SkRasterPipelineBlitter::blitRectWithTrace(int x, int y, int w, int h, bool
         return;
     }
 
-    if (!fBlitRect) {
+    if (!fBlitRect && !this->bindCachedProgram(BlitType::kRect, &fBlitRect)) {
         SkRasterPipeline p(fAlloc);
         p.extend(fColorPipeline);
         p.appendClampIfNormalized(fDst.info());
@@ -425,14 +582,14 @@ void SkRasterPipelineBlitter::blitRectWithTrace(int x, int y, int w, int h, bool
             }
             this->appendStore(&p);
         }
-        fBlitRect = p.compile();
+        fBlitRect = this->compileAndCache(BlitType::kRect, p);
     }
 
     fBlitRect(x,y,w,h);
 }
 
 void SkRasterPipelineBlitter::blitAntiH(int x, int y, const SkAlpha aa[], const int16_t runs[]) {
-    if (!fBlitAntiH) {
+    if (!fBlitAntiH && !this->bindCachedProgram(BlitType::kAntiH, &fBlitAntiH)) {
         SkRasterPipeline p(fAlloc);
         p.extend(fColorPipeline);
         p.appendClampIfNormalized(fDst.info());
@@ -450,7 +607,7 @@ void SkRasterPipelineBlitter::blitAntiH(int x, int y, const SkAlpha aa[], const
         }
 
         this->appendStore(&p);
-        fBlitAntiH = p.compile();
+        fBlitAntiH = this->compileAndCache(BlitType::kAntiH, p);
     }
 
     for (int16_t run = *runs; run > 0; run = *runs) {
@@ -524,7 +681,8 @@ void SkRasterPipelineBlitter::blitMask(const SkMask& mask, const SkIRect& clip)
     }
 
     // Lazily build whichever pipeline we need, specialized for each mask format.
-    if (mask.fFormat == SkMask::kA8_Format && !fBlitMaskA8) {
+    if (mask.fFormat == SkMask::kA8_Format && !fBlitMaskA8 &&
+        !this->bindCachedProgram(BlitType::kMaskA8, &fBlitMaskA8)) {
         SkRasterPipeline p(fAlloc);
         p.extend(fColorPipeline);
         p.appendClampIfNormalized(fDst.info());
@@ -541,9 +699,10 @@ void SkRasterPipelineBlitter::blitMask(const SkMask& mask, const SkIRect& clip)
             this->appendClipLerp(&p);
         }
         this->appendStore(&p);
-        fBlitMaskA8 = p.compile();
+        fBlitMaskA8 = this->compileAndCache(BlitType::kMaskA8, p);
     }
-    if (mask.fFormat == SkMask::kLCD16_Format && !fBlitMaskLCD16) {
+    if (mask.fFormat == SkMask::kLCD16_Format && !fBlitMaskLCD16 &&
+        !this->bindCachedProgram(BlitType::kMaskLCD16, &fBlitMaskLCD16)) {
         SkRasterPipeline p(fAlloc);
         p.extend(fColorPipeline);
         p.appendClampIfNormalized(fDst.info());
@@ -561,9 +720,10 @@ void SkRasterPipelineBlitter::blitMask(const SkMask& mask, const SkIRect& clip)
             this->appendClipLerp(&p);
         }
         this->appendStore(&p);
-        fBlitMaskLCD16 = p.compile();
+        fBlitMaskLCD16 = this->compileAndCache(BlitType::kMaskLCD16, p);
     }
-    if (mask.fFormat == SkMask::k3D_Format && !fBlitMask3D) {
+    if (mask.fFormat == SkMask::k3D_Format && !fBlitMask3D &&
+        !this->bindCachedProgram(BlitType::kMask3D, &fBlitMask3D)) {
         SkRasterPipeline p(fAlloc);
         p.extend(fColorPipeline);
         // This bit is where we differ from kA8_Format:
@@ -583,7 +743,7 @@ void SkRasterPipelineBlitter::blitMask(const SkMask& mask, const SkIRect& clip)
             this->appendClipLerp(&p);
         }
         this->appendStore(&p);
-        fBlitMask3D = p.compile();
+        fBlitMask3D = this->compileAndCache(BlitType::kMask3D, p);
     }
 
     std::function<void(size_t,size_t,size_t,size_t)>* blitter = nullptr;
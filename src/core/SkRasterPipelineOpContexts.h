@@ -17,8 +17,8 @@ namespace SkSL { class TraceHook; }
 // The largest number of pixels we handle at a time. We have a separate value for the largest number
 // of pixels we handle in the highp pipeline. Many of the context structs in this file are only used
 // by stages that have no lowp implementation. They can therefore use the (smaller) highp value to
-// save memory in the arena.
-inline static constexpr int SkRasterPipeline_kMaxStride = 16;
+// save memory in the arena. (Lowp runs 32 pixels at a time with AVX-512; highp runs 16.)
+inline static constexpr int SkRasterPipeline_kMaxStride = 32;
 inline static constexpr int SkRasterPipeline_kMaxStride_highp = 16;
 
 // How much space to allocate for each MemoryCtx scratch buffer, as part of tail-pixel handling.
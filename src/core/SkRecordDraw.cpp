@@ -28,9 +28,11 @@
 #include "include/private/base/SkTDArray.h"
 #include "include/private/base/SkTemplates.h"
 #include "include/private/chromium/Slug.h"
+#include "src/core/SkBigPicture.h"
 #include "src/core/SkCanvasPriv.h"
 #include "src/core/SkDrawShadowInfo.h"
 #include "src/core/SkImageFilter_Base.h"
+#include "src/core/SkPicturePriv.h"
 #include "src/core/SkRecord.h"
 #include "src/core/SkRecords.h"
 #include "src/effects/colorfilters/SkColorFilterBase.h"
@@ -592,3 +594,28 @@ void SkRecordFillBounds(const SkRect& cullRect, const SkRecord& record,
         }
     }
 }
+
+namespace {
+struct EscapesTileClip {
+    template <typename T> bool operator()(const T&) { return false; }
+
+    bool operator()(const SkRecords::SaveLayer& op) { return op.backdrop != nullptr; }
+    bool operator()(const SkRecords::ResetClip&)    { return true; }
+    bool operator()(const SkRecords::DrawPicture& op) {
+        // Only big pictures can hold layers and clips.
+        const SkBigPicture* picture = SkPicturePriv::AsSkBigPicture(op.picture);
+        return picture && SkRecordEscapesTileClip(*picture->record(), picture->record()->count());
+    }
+    bool operator()(const SkRecords::DrawDrawable&) { return true; }
+};
+}  // namespace
+
+bool SkRecordEscapesTileClip(const SkRecord& record, int stop) {
+    SkASSERT(stop <= record.count());
+    for (int i = 0; i < stop; i++) {
+        if (record.visit(i, EscapesTileClip())) {
+            return true;
+        }
+    }
+    return false;
+}
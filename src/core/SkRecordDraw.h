@@ -22,6 +22,12 @@ struct SkRect;
 void SkRecordFillBounds(const SkRect& cullRect, const SkRecord&,
                         SkRect bounds[], SkBBoxHierarchy::Metadata[]);
 
+// Whether any of the first stop ops in the record, or in any picture they draw, escapes a clip
+// that restricts drawing to one tile of the target: backdrop filters read pixels outside the clip
+// (which other tiles may be writing), and resetClip() drops the clip altogether. Drawables can't
+// be seen into, so they count as escaping.
+bool SkRecordEscapesTileClip(const SkRecord&, int stop);
+
 // Draw an SkRecord into an SkCanvas.  A convenience wrapper around SkRecords::Draw.
 void SkRecordDraw(const SkRecord&, SkCanvas*, SkPicture const* const drawablePicts[],
                   SkDrawable* const drawables[], int drawableCount,
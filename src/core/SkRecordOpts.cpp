@@ -10,35 +10,44 @@
 #include "include/core/SkBlendMode.h"
 #include "include/core/SkCanvas.h"
 #include "include/core/SkColor.h"
+#include "include/core/SkImage.h"
 #include "include/core/SkPaint.h"
+#include "include/core/SkRect.h"
 #include "include/core/SkRefCnt.h"
+#include "include/core/SkSamplingOptions.h"
 #include "include/private/base/SkMath.h"
 #include "include/private/base/SkTemplates.h"
+#include "include/private/base/SkTo.h"
+#include "src/core/SkPaintPriv.h"
 #include "src/core/SkRecord.h"
 #include "src/core/SkRecordPattern.h"
 #include "src/core/SkRecords.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <optional>
+#include <utility>
+#include <vector>
 
 using namespace SkRecords;
+using namespace skia_private;
 
 // Most of the optimizations in this file are pattern-based.  These are all defined as structs with:
 //   - a Match typedef
 //   - a bool onMatch(SkRceord*, Match*, int begin, int end) method,
 //     which returns true if it made changes and false if not.
 
-// Run a pattern-based optimization once across the SkRecord, returning true if it made any changes.
+// Run a pattern-based optimization once across the SkRecord, returning how many matches it changed.
 // It looks for spans which match Pass::Match, and when found calls onMatch() with that pattern,
 // record, and [begin,end) span of the commands that matched.
 template <typename Pass>
-static bool apply(Pass* pass, SkRecord* record) {
+static int apply(Pass* pass, SkRecord* record) {
     typename Pass::Match match;
-    bool changed = false;
+    int changed = 0;
     int begin, end = 0;
 
     while (match.search(record, &begin, &end)) {
-        changed |= pass->onMatch(record, &match, begin, end);
+        changed += pass->onMatch(record, &match, begin, end) ? 1 : 0;
     }
     return changed;
 }
@@ -133,12 +142,20 @@ struct SaveNoDrawsRestoreNooper {
         return true;
     }
 };
-void SkRecordNoopSaveRestores(SkRecord* record) {
+int SkRecordNoopSaveRestores(SkRecord* record) {
     SaveOnlyDrawsRestoreNooper onlyDraws;
     SaveNoDrawsRestoreNooper noDraws;
 
     // Run until they stop changing things.
-    while (apply(&onlyDraws, record) || apply(&noDraws, record));
+    int removed = 0, changed;
+    do {
+        changed = apply(&onlyDraws, record);
+        if (!changed) {
+            changed = apply(&noDraws, record);
+        }
+        removed += changed;
+    } while (changed);
+    return removed;
 }
 
 #ifndef SK_BUILD_FOR_ANDROID_FRAMEWORK
@@ -198,9 +215,9 @@ struct SaveLayerDrawRestoreNooper {
         return true;
     }
 };
-void SkRecordNoopSaveLayerDrawRestores(SkRecord* record) {
+int SkRecordNoopSaveLayerDrawRestores(SkRecord* record) {
     SaveLayerDrawRestoreNooper pass;
-    apply(&pass, record);
+    return apply(&pass, record);
 }
 #endif
 
@@ -259,14 +276,290 @@ struct SvgOpacityAndFilterLayerMergePass {
     }
 };
 
-void SkRecordMergeSvgOpacityAndFilterLayers(SkRecord* record) {
+int SkRecordMergeSvgOpacityAndFilterLayers(SkRecord* record) {
     SvgOpacityAndFilterLayerMergePass pass;
+    return apply(&pass, record);
+}
+
+// Turns Clip-[non-drawing command]*-Restore into NoOp*-Restore: nothing ever sees those clips.
+struct UnusedClipNooper {
+    using IsClip = Or<Is<ClipPath>, Is<ClipRRect>, Is<ClipRect>, Is<ClipRegion>, Is<ClipShader>,
+                      Is<ResetClip>>;
+    // Besides draws, SaveLayer and SaveBehind size themselves from the clip, and annotations are
+    // clipped. Nested saves are excluded so that we only ever match the clip's own Restore.
+    typedef Pattern<IsClip,
+                    Greedy<Not<Or<Is<Save>,
+                                  Is<SaveLayer>,
+                                  Is<SaveBehind>,
+                                  Is<Restore>,
+                                  Is<DrawAnnotation>,
+                                  IsDraw>>>,
+                    Is<Restore>>
+        Match;
+
+    bool onMatch(SkRecord* record, Match*, int begin, int end) {
+        // Matrix changes in the span are just as dead, but they're cheap to play back.
+        for (int i = begin; i < end - 1; i++) {
+            if (record->mutate(i, IsClip())) {
+                record->replace<NoOp>(i);
+                fClipsRemoved++;
+            }
+        }
+        return true;
+    }
+
+    int fClipsRemoved = 0;
+};
+
+int SkRecordNoopUnusedClips(SkRecord* record) {
+    UnusedClipNooper pass;
     apply(&pass, record);
+    return pass.fClipsRemoved;
+}
+
+static DrawImageRect* as_image_rect(SkRecord* record, int i) {
+    Is<DrawImageRect> isImageRect;
+    return record->mutate(i, isImageRect) ? isImageRect.get() : nullptr;
+}
+
+// Images past this size may be tiled by the device, which it only does for single images.
+static constexpr int kMaxBatchedImageDimension = 2048;
+
+// Would this DrawImageRect draw the same as an entry in a DrawEdgeAAImageSet with its paint?
+static bool can_batch_image_rect(const DrawImageRect& op) {
+    if (op.image->width() > kMaxBatchedImageDimension ||
+        op.image->height() > kMaxBatchedImageDimension) {
+        return false;
+    }
+    if (op.image->isAlphaOnly()) {
+        // Alpha-only images are colored by the paint, which backends only do for single images.
+        return false;
+    }
+    // An image filter or mask filter would apply to the whole set instead of to each image.
+    return !op.paint || (!op.paint->getImageFilter() && !op.paint->getMaskFilter());
+}
+
+static bool can_batch_image_rects(const DrawImageRect& a, const DrawImageRect& b) {
+    const bool samePaint = a.paint ? b.paint && *a.paint == *b.paint : !b.paint;
+    return samePaint && a.sampling == b.sampling && a.constraint == b.constraint;
+}
+
+// Replaces the DrawImageRects at indices with one DrawEdgeAAImageSet, in place of the first.
+static void batch_image_rects(SkRecord* record, const std::vector<int>& indices) {
+    const int count = SkToInt(indices.size());
+    const DrawImageRect* first = as_image_rect(record, indices[0]);
+
+    // Each entry is drawn with the set's paint, anti-aliased if all its edges are.
+    const unsigned aaFlags = first->paint && first->paint->isAntiAlias()
+                                     ? SkCanvas::kAll_QuadAAFlags
+                                     : SkCanvas::kNone_QuadAAFlags;
+    AutoTArray<SkCanvas::ImageSetEntry> set(count);
+    for (int i = 0; i < count; i++) {
+        const DrawImageRect* op = as_image_rect(record, indices[i]);
+        set[i] = SkCanvas::ImageSetEntry(op->image, op->src, op->dst, /*matrixIndex=*/-1,
+                                         /*alpha=*/1.f, aaFlags, /*hasClip=*/false);
+    }
+
+    SkPaint* paint = first->paint ? new (record->alloc<SkPaint>()) SkPaint(*first->paint)
+                                  : nullptr;
+    const SkSamplingOptions sampling = first->sampling;
+    const SkCanvas::SrcRectConstraint constraint = first->constraint;
+
+    for (int i = 1; i < count; i++) {
+        record->replace<NoOp>(indices[i]);
+    }
+    new (record->replace<DrawEdgeAAImageSet>(indices[0])) DrawEdgeAAImageSet{
+            paint, std::move(set), count, nullptr, nullptr, sampling, constraint};
+}
+
+int SkRecordBatchImageRects(SkRecord* record) {
+    int batched = 0;
+    std::vector<int> run;
+    auto flush = [&] {
+        if (run.size() > 1) {
+            batch_image_rects(record, run);
+            batched += SkToInt(run.size()) - 1;
+        }
+        run.clear();
+    };
+
+    for (int i = 0; i < record->count(); i++) {
+        if (const DrawImageRect* op = as_image_rect(record, i); op && can_batch_image_rect(*op)) {
+            if (!run.empty() && !can_batch_image_rects(*as_image_rect(record, run[0]), *op)) {
+                flush();
+            }
+            run.push_back(i);
+        } else if (!record->mutate(i, Is<NoOp>())) {
+            flush();
+        }
+    }
+    flush();
+    return batched;
+}
+
+// Walks the record, remembering the draws made since the matrix or clip last changed, and no-ops
+// those a later draw is known to paint over completely.
+class OccludedDrawNooper {
+public:
+    explicit OccludedDrawNooper(SkRecord* record) : fRecord(record) {
+        fAAClip.push_back(false);
+    }
+
+    int run() {
+        for (fIndex = 0; fIndex < fRecord->count(); fIndex++) {
+            fRecord->mutate(fIndex, *this);
+        }
+        return fRemoved;
+    }
+
+    void operator()(NoOp*) {}
+
+    void operator()(Save*)      { this->save(); }
+    void operator()(SaveLayer*) { this->save(); }
+    void operator()(Restore*) {
+        if (fAAClip.size() > 1) {
+            fAAClip.pop_back();
+        }
+        fDraws.clear();
+    }
+
+    void operator()(ClipPath*   op) { this->clip(op->opAA.aa()); }
+    void operator()(ClipRRect*  op) { this->clip(op->opAA.aa()); }
+    void operator()(ClipRect*   op) { this->clip(op->opAA.aa()); }
+    void operator()(ClipRegion*)    { this->clip(false); }
+    void operator()(ClipShader*)    { this->clip(true); }
+    void operator()(ResetClip*) {
+        fAAClip.back() = false;
+        fDraws.clear();
+    }
+
+    // A draw paints over the whole clip regardless of the matrix, but its pixel rect is stale.
+    void operator()(SetMatrix*) { this->forgetRects(); }
+    void operator()(SetM44*)    { this->forgetRects(); }
+    void operator()(Concat*)    { this->forgetRects(); }
+    void operator()(Concat44*)  { this->forgetRects(); }
+    void operator()(Translate*) { this->forgetRects(); }
+    void operator()(Scale*)     { this->forgetRects(); }
+
+    template <typename T>
+    void operator()(T* op) {
+        if constexpr ((T::kTags & kDraw_Tag) != 0) {
+            this->draw(CanDrop(*op), PixelRect(*op), Covers(*op));
+        } else {
+            // SaveBehind, DrawAnnotation, ... : be conservative and start over.
+            fDraws.clear();
+        }
+    }
+
+private:
+    struct Draw {
+        int    fIndex;
+        bool   fCanDrop;
+        SkRect fPixelRect;  // Touches only pixels with their centers in this rect, if not empty.
+    };
+
+    enum class Cover { kNothing, kPixelRect, kClip };
+
+    void save() {
+        fAAClip.push_back(fAAClip.back());
+        fDraws.clear();
+    }
+
+    void clip(bool aa) {
+        fAAClip.back() = fAAClip.back() || aa;
+        fDraws.clear();
+    }
+
+    void forgetRects() {
+        for (Draw& draw : fDraws) {
+            draw.fPixelRect.setEmpty();
+        }
+    }
+
+    void draw(bool canDrop, const SkRect& pixelRect, Cover cover) {
+        // Partially covered pixels on the edge of an anti-aliased clip blend with what's below.
+        if (cover != Cover::kNothing && !fAAClip.back()) {
+            auto isCovered = [&](const Draw& draw) {
+                if (!draw.fCanDrop) {
+                    return false;
+                }
+                return cover == Cover::kClip ||
+                       (!draw.fPixelRect.isEmpty() && pixelRect.contains(draw.fPixelRect));
+            };
+            for (const Draw& draw : fDraws) {
+                if (isCovered(draw)) {
+                    fRecord->replace<NoOp>(draw.fIndex);
+                    fRemoved++;
+                }
+            }
+            fDraws.erase(std::remove_if(fDraws.begin(), fDraws.end(), isCovered), fDraws.end());
+        }
+        fDraws.push_back({fIndex, canDrop, pixelRect});
+    }
+
+    // Pictures may hold annotations, drawables may draw differently next time, and DrawBehind
+    // draws under the layer rather than over what came before.
+    template <typename T> static bool CanDrop(const T&) { return true; }
+    static bool CanDrop(const DrawPicture&)  { return false; }
+    static bool CanDrop(const DrawDrawable&) { return false; }
+    static bool CanDrop(const DrawBehind&)   { return false; }
+
+    // Does the paint replace whatever is below, wherever its geometry covers a pixel completely?
+    static bool Overwrites(const SkPaint& paint) {
+        return !paint.getMaskFilter() && !paint.getImageFilter() &&
+               SkPaintPriv::Overwrites(&paint, SkPaintPriv::kNone_ShaderOverrideOpacity);
+    }
+
+    // Aliased, unfiltered rect fills touch exactly the pixels with their centers in the rect.
+    static bool IsAliasedRectFill(const SkPaint& paint) {
+        return !paint.isAntiAlias() && paint.getStyle() == SkPaint::kFill_Style &&
+               !paint.getPathEffect() && !paint.getMaskFilter() && !paint.getImageFilter();
+    }
+    static bool IsAliasedRectFill(const DrawEdgeAAQuad& op) {
+        return op.aa == SkCanvas::kNone_QuadAAFlags && !op.clip;
+    }
+
+    template <typename T> static SkRect PixelRect(const T&) { return SkRect::MakeEmpty(); }
+    static SkRect PixelRect(const DrawRect& op) {
+        return IsAliasedRectFill(op.paint) ? op.rect.makeSorted() : SkRect::MakeEmpty();
+    }
+    static SkRect PixelRect(const DrawEdgeAAQuad& op) {
+        return IsAliasedRectFill(op) ? op.rect.makeSorted() : SkRect::MakeEmpty();
+    }
+
+    template <typename T> static Cover Covers(const T&) { return Cover::kNothing; }
+    static Cover Covers(const DrawPaint& op) {
+        return Overwrites(op.paint) ? Cover::kClip : Cover::kNothing;
+    }
+    static Cover Covers(const DrawRect& op) {
+        return IsAliasedRectFill(op.paint) && Overwrites(op.paint) ? Cover::kPixelRect
+                                                                   : Cover::kNothing;
+    }
+    static Cover Covers(const DrawEdgeAAQuad& op) {
+        const bool overwrites = op.mode == SkBlendMode::kSrc ||
+                                (op.mode == SkBlendMode::kSrcOver && op.color.isOpaque());
+        return IsAliasedRectFill(op) && overwrites ? Cover::kPixelRect : Cover::kNothing;
+    }
+
+    SkRecord*         fRecord;
+    int               fIndex = 0;
+    int               fRemoved = 0;
+    std::vector<bool> fAAClip;  // Is an anti-aliased clip in effect, per save level?
+    std::vector<Draw> fDraws;
+};
+
+int SkRecordNoopOccludedDraws(SkRecord* record) {
+    return OccludedDrawNooper(record).run();
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
-void SkRecordOptimize(SkRecord* record) {
+void SkRecordOptimize(SkRecord* record, SkRecordOptimizeStats* stats) {
+    SkRecordOptimizeStats unused;
+    if (!stats) {
+        stats = &unused;
+    }
+
     // This might be useful  as a first pass in the future if we want to weed
     // out junk for other optimization passes.  Right now, nothing needs it,
     // and the bounding box hierarchy will do the work of skipping no-op
@@ -280,9 +573,10 @@ void SkRecordOptimize(SkRecord* record) {
     // because it makes the following Android CTS test fail:
     // android.uirendering.cts.testclasses.LayerTests#testSaveLayerClippedWithAlpha
 #ifndef SK_BUILD_FOR_ANDROID_FRAMEWORK
-    SkRecordNoopSaveLayerDrawRestores(record);
+    stats->noopSaveLayerDrawRestores += SkRecordNoopSaveLayerDrawRestores(record);
 #endif
-    SkRecordMergeSvgOpacityAndFilterLayers(record);
+    stats->mergedSvgOpacityAndFilterLayers += SkRecordMergeSvgOpacityAndFilterLayers(record);
+    stats->noopUnusedClips += SkRecordNoopUnusedClips(record);
 
     record->defrag();
 }
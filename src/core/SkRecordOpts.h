@@ -10,20 +10,45 @@
 
 class SkRecord;
 
-// Run all optimizations in recommended order.
-void SkRecordOptimize(SkRecord*);
+// How often each pass fired during an SkRecordOptimize() call.
+struct SkRecordOptimizeStats {
+    int noopSaveLayerDrawRestores       = 0;  // SaveLayer/Restore pairs folded into their draw.
+    int mergedSvgOpacityAndFilterLayers = 0;  // Opacity layers folded into an SVG filter layer.
+    int noopUnusedClips                 = 0;  // Clip commands removed.
+};
+
+// Run all optimizations in recommended order, optionally counting what each one did.
+void SkRecordOptimize(SkRecord*, SkRecordOptimizeStats* = nullptr);
 
 // Turns logical no-op Save-[non-drawing command]*-Restore patterns into actual no-ops.
-void SkRecordNoopSaveRestores(SkRecord*);
+// Returns the number of Save/Restore pairs removed.
+int SkRecordNoopSaveRestores(SkRecord*);
 
 #ifndef SK_BUILD_FOR_ANDROID_FRAMEWORK
 // For some SaveLayer-[drawing command]-Restore patterns, merge the SaveLayer's alpha into the
-// draw, and no-op the SaveLayer and Restore.
-void SkRecordNoopSaveLayerDrawRestores(SkRecord*);
+// draw, and no-op the SaveLayer and Restore. Returns the number of layers removed.
+int SkRecordNoopSaveLayerDrawRestores(SkRecord*);
 #endif
 
 // For SVG generated SaveLayer-Save-ClipRect-SaveLayer-3xRestore patterns, merge
-// the alpha of the first SaveLayer to the second SaveLayer.
-void SkRecordMergeSvgOpacityAndFilterLayers(SkRecord*);
+// the alpha of the first SaveLayer to the second SaveLayer. Returns the number of layers removed.
+int SkRecordMergeSvgOpacityAndFilterLayers(SkRecord*);
+
+// No-ops clips that no draw sees, i.e. Clip-[non-drawing command]*-Restore.
+// Returns the number of clips removed.
+int SkRecordNoopUnusedClips(SkRecord*);
+
+// Folds runs of DrawImageRects that share a paint, sampling and constraint into one
+// DrawEdgeAAImageSet, which GPU backends can draw as a single batch. Images big enough that a
+// device might tile them are left alone. This isn't part of SkRecordOptimize(): a set skips the
+// per-image quick reject and the check for draws that overwrite the whole surface.
+// Returns the number of DrawImageRects folded away.
+int SkRecordBatchImageRects(SkRecord*);
+
+// No-ops draws whose every pixel is overwritten by a later opaque draw under the same matrix and
+// clip. This isn't part of SkRecordOptimize(): it's exact only if the record is played back
+// without an anti-aliased clip, since partially covered pixels still show what was drawn first.
+// Returns the number of draws removed.
+int SkRecordNoopOccludedDraws(SkRecord*);
 
 #endif//SkRecordOpts_DEFINED
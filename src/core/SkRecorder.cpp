@@ -7,22 +7,29 @@
 
 #include "src/core/SkRecorder.h"
 
+#include "include/core/SkBlender.h"
 #include "include/core/SkCanvas.h"
+#include "include/core/SkColorFilter.h"
 #include "include/core/SkData.h"
 #include "include/core/SkDrawable.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkImageFilter.h"
 #include "include/core/SkImageInfo.h"
+#include "include/core/SkMaskFilter.h"
 #include "include/core/SkMatrix.h"
 #include "include/core/SkPaint.h"
+#include "include/core/SkPath.h"
+#include "include/core/SkPathEffect.h"
 #include "include/core/SkPicture.h"
 #include "include/core/SkPoint.h"
 #include "include/core/SkRSXform.h"
 #include "include/core/SkRect.h"
+#include "include/core/SkSerialProcs.h"
 #include "include/core/SkShader.h"
 #include "include/core/SkString.h"
 #include "include/core/SkSurface.h"
 #include "include/core/SkTextBlob.h"
+#include "include/core/SkTypeface.h"
 #include "include/core/SkVertices.h"
 #include "include/private/base/SkFloatingPoint.h"
 #include "include/private/base/SkTemplates.h"
@@ -30,8 +37,10 @@
 #include "include/private/chromium/Slug.h"
 #include "src/core/SkBigPicture.h"
 #include "src/core/SkCanvasPriv.h"
+#include "src/core/SkChecksum.h"
 #include "src/core/SkRecord.h"
 #include "src/core/SkRecords.h"
+#include "src/core/SkTHash.h"
 #include "src/text/GlyphRun.h"
 #include "src/utils/SkPatchUtils.h"
 
@@ -40,9 +49,7 @@
 #include <memory>
 #include <new>
 
-class SkBlender;
 class SkMesh;
-class SkPath;
 class SkRRect;
 class SkRegion;
 class SkSurfaceProps;
@@ -77,6 +84,158 @@ void SkDrawableList::append(SkDrawable* drawable) {
 
 ///////////////////////////////////////////////////////////////////////////////////////////////
 
+static size_t path_bytes(const SkPath& path) {
+    // The SkPath itself lives in the record; its SkPathRef is on the heap.
+    return path.approximateBytesUsed() - sizeof(SkPath);
+}
+
+static size_t blob_bytes(const SkTextBlob& blob) {
+    // Assumes every glyph is fully positioned, which is the common case.
+    size_t bytes = sizeof(SkTextBlob);
+    SkTextBlob::Iter::Run run;
+    for (SkTextBlob::Iter it(blob); it.next(&run);) {
+        bytes += run.fGlyphCount * (sizeof(SkGlyphID) + sizeof(SkPoint));
+    }
+    return bytes;
+}
+
+// Maps each payload to the first one recorded with the same contents. Payloads are keyed by their
+// serialized bytes, with images, pictures and typefaces written as their unique IDs, so those
+// still compare by identity. Each payload we've seen is also remembered by identity, so drawing
+// the same one again doesn't serialize it again. Adds the heap bytes of each payload replaced by
+// an earlier one to `saved`.
+class SkRecorder::Interner {
+public:
+    Interner() {
+        fProcs.fImageProc = [](SkImage* image, void*) {
+            return unique_id_data(image->uniqueID());
+        };
+        fProcs.fPictureProc = [](SkPicture* picture, void*) {
+            return unique_id_data(picture->uniqueID());
+        };
+        fProcs.fTypefaceProc = [](SkTypeface* typeface, void*) {
+            return unique_id_data(typeface->uniqueID());
+        };
+    }
+
+    const SkPath& path(const SkPath& path, size_t* saved) {
+        if (path.isVolatile()) {
+            return path;  // Volatile paths are expected to change, so never shared.
+        }
+        // A recording without interning shares the same path by reference too, so hits by
+        // identity save nothing; only replacing a different path with matching contents does.
+        const uint32_t id = path.getGenerationID();
+        if (const SkPath* interned = fPathsByID.find(id)) {
+            return *interned;
+        }
+        const Key key = MakeKey(path.serialize());
+        const SkPath* interned = fPaths.find(key);
+        if (!interned) {
+            interned = fPaths.set(key, path);
+        } else {
+            *saved += path_bytes(path);
+        }
+        return *fPathsByID.set(id, *interned);
+    }
+
+    sk_sp<const SkTextBlob> blob(const SkTextBlob* blob, size_t* saved) {
+        if (sk_sp<const SkTextBlob>* interned = fBlobsByID.find(blob->uniqueID())) {
+            return *interned;
+        }
+        sk_sp<SkData> data = blob->serialize(fProcs);
+        if (!data) {
+            return sk_ref_sp(blob);
+        }
+        const Key key = MakeKey(std::move(data));
+        sk_sp<const SkTextBlob>* interned = fBlobs.find(key);
+        if (!interned) {
+            interned = fBlobs.set(key, sk_ref_sp(blob));
+        } else {
+            *saved += blob_bytes(*blob);
+        }
+        return *fBlobsByID.set(blob->uniqueID(), *interned);
+    }
+
+    // Returns paint with each of its effects replaced by its interned equivalent.
+    const SkPaint& paint(const SkPaint& paint) {
+        if (!paint.getShader() && !paint.getColorFilter() && !paint.getMaskFilter() &&
+            !paint.getPathEffect() && !paint.getImageFilter() && !paint.getBlender()) {
+            return paint;
+        }
+        fPaint = paint;
+        fPaint.setShader(this->effect(paint.refShader()));
+        fPaint.setColorFilter(this->effect(paint.refColorFilter()));
+        fPaint.setMaskFilter(this->effect(paint.refMaskFilter()));
+        fPaint.setPathEffect(this->effect(paint.refPathEffect()));
+        fPaint.setImageFilter(this->effect(paint.refImageFilter()));
+        fPaint.setBlender(this->effect(paint.refBlender()));
+        return fPaint;
+    }
+
+private:
+    struct Key {
+        sk_sp<SkData> fData;
+        uint32_t      fHash;
+
+        bool operator==(const Key& that) const {
+            return fHash == that.fHash && fData->equals(that.fData.get());
+        }
+        struct Hash {
+            uint32_t operator()(const Key& key) const { return key.fHash; }
+        };
+    };
+
+    static Key MakeKey(sk_sp<SkData> data) {
+        const uint32_t hash = SkChecksum::Hash32(data->data(), data->size());
+        return {std::move(data), hash};
+    }
+
+    static sk_sp<SkData> unique_id_data(uint32_t id) {
+        return SkData::MakeWithCopy(&id, sizeof(id));
+    }
+
+    template <typename T>
+    sk_sp<T> effect(sk_sp<T> effect) {
+        if (!effect) {
+            return nullptr;
+        }
+        // Keyed by address, so hold a ref to keep the address from being reused.
+        if (const Seen* seen = fEffectsByPtr.find(effect.get())) {
+            return sk_ref_sp(static_cast<T*>(seen->fInterned.get()));
+        }
+        // Keys start with the effect's factory name, so equal keys mean equal types.
+        sk_sp<SkData> data = effect->serialize(&fProcs);
+        if (!data) {
+            return effect;
+        }
+        const Key key = MakeKey(std::move(data));
+        sk_sp<SkFlattenable>* interned = fEffects.find(key);
+        if (!interned) {
+            interned = fEffects.set(key, effect);
+        }
+        fEffectsByPtr.set(effect.get(), {effect, *interned});
+        return sk_ref_sp(static_cast<T*>(interned->get()));
+    }
+
+    struct Seen {
+        sk_sp<SkFlattenable> fOriginal;
+        sk_sp<SkFlattenable> fInterned;
+    };
+
+    SkSerialProcs fProcs;
+
+    skia_private::THashMap<Key, SkPath, Key::Hash>                  fPaths;
+    skia_private::THashMap<uint32_t, SkPath>                        fPathsByID;
+    skia_private::THashMap<Key, sk_sp<const SkTextBlob>, Key::Hash> fBlobs;
+    skia_private::THashMap<uint32_t, sk_sp<const SkTextBlob>>       fBlobsByID;
+    skia_private::THashMap<Key, sk_sp<SkFlattenable>, Key::Hash>    fEffects;
+    skia_private::THashMap<const SkFlattenable*, Seen>              fEffectsByPtr;
+
+    SkPaint fPaint;  // Scratch space for paint()'s result.
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+
 static SkIRect safe_picture_bounds(const SkRect& bounds) {
     SkIRect picBounds = bounds.roundOut();
     // roundOut() saturates the float edges to +/-SK_MaxS32FitsInFloat (~2billion), but this is
@@ -94,6 +253,7 @@ static SkIRect safe_picture_bounds(const SkRect& bounds) {
 SkRecorder::SkRecorder(SkRecord* record, int width, int height)
         : SkCanvasVirtualEnforcer<SkNoDrawCanvas>(width, height)
         , fApproxBytesUsedBySubPictures(0)
+        , fApproxBytesSavedByInterning(0)
         , fRecord(record) {
     SkASSERT(this->imageInfo().width() >= 0 && this->imageInfo().height() >= 0);
 }
@@ -101,10 +261,13 @@ SkRecorder::SkRecorder(SkRecord* record, int width, int height)
 SkRecorder::SkRecorder(SkRecord* record, const SkRect& bounds)
         : SkCanvasVirtualEnforcer<SkNoDrawCanvas>(safe_picture_bounds(bounds))
         , fApproxBytesUsedBySubPictures(0)
+        , fApproxBytesSavedByInterning(0)
         , fRecord(record) {
     SkASSERT(this->imageInfo().width() >= 0 && this->imageInfo().height() >= 0);
 }
 
+SkRecorder::~SkRecorder() = default;
+
 void SkRecorder::reset(SkRecord* record, const SkRect& bounds) {
     this->forgetRecord();
     fRecord = record;
@@ -115,9 +278,37 @@ void SkRecorder::reset(SkRecord* record, const SkRect& bounds) {
 void SkRecorder::forgetRecord() {
     fDrawableList.reset(nullptr);
     fApproxBytesUsedBySubPictures = 0;
+    fApproxBytesSavedByInterning = 0;
+    fInterner.reset();
     fRecord = nullptr;
 }
 
+void SkRecorder::setInternPayloads(bool intern) {
+    if (!intern) {
+        fInterner.reset();
+    } else if (!fInterner) {
+        fInterner = std::make_unique<Interner>();
+    }
+}
+
+const SkPaint& SkRecorder::intern(const SkPaint& paint) {
+    return fInterner ? fInterner->paint(paint) : paint;
+}
+
+const SkPaint* SkRecorder::intern(const SkPaint* paint) {
+    return fInterner && paint ? &fInterner->paint(*paint) : paint;
+}
+
+const SkPath& SkRecorder::intern(const SkPath& path) {
+    return fInterner ? fInterner->path(path, &fApproxBytesSavedByInterning)
+                     : path;
+}
+
+sk_sp<const SkTextBlob> SkRecorder::intern(const SkTextBlob* blob) {
+    return fInterner ? fInterner->blob(blob, &fApproxBytesSavedByInterning)
+                     : sk_ref_sp(blob);
+}
+
 // To make appending to fRecord a little less verbose.
 template<typename T, typename... Args>
 void SkRecorder::append(Args&&... args) {
@@ -171,43 +362,44 @@ char* SkRecorder::copy(const char* src) {
 }
 
 void SkRecorder::onDrawPaint(const SkPaint& paint) {
-    this->append<SkRecords::DrawPaint>(paint);
+    this->append<SkRecords::DrawPaint>(this->intern(paint));
 }
 
 void SkRecorder::onDrawBehind(const SkPaint& paint) {
-    this->append<SkRecords::DrawBehind>(paint);
+    this->append<SkRecords::DrawBehind>(this->intern(paint));
 }
 
 void SkRecorder::onDrawPoints(PointMode mode,
                               size_t count,
                               const SkPoint pts[],
                               const SkPaint& paint) {
-    this->append<SkRecords::DrawPoints>(paint, mode, SkToUInt(count), this->copy(pts, count));
+    this->append<SkRecords::DrawPoints>(this->intern(paint), mode, SkToUInt(count),
+                                        this->copy(pts, count));
 }
 
 void SkRecorder::onDrawRect(const SkRect& rect, const SkPaint& paint) {
-    this->append<SkRecords::DrawRect>(paint, rect);
+    this->append<SkRecords::DrawRect>(this->intern(paint), rect);
 }
 
 void SkRecorder::onDrawRegion(const SkRegion& region, const SkPaint& paint) {
-    this->append<SkRecords::DrawRegion>(paint, region);
+    this->append<SkRecords::DrawRegion>(this->intern(paint), region);
 }
 
 void SkRecorder::onDrawOval(const SkRect& oval, const SkPaint& paint) {
-    this->append<SkRecords::DrawOval>(paint, oval);
+    this->append<SkRecords::DrawOval>(this->intern(paint), oval);
 }
 
 void SkRecorder::onDrawArc(const SkRect& oval, SkScalar startAngle, SkScalar sweepAngle,
                            bool useCenter, const SkPaint& paint) {
-    this->append<SkRecords::DrawArc>(paint, oval, startAngle, sweepAngle, useCenter);
+    this->append<SkRecords::DrawArc>(this->intern(paint), oval, startAngle, sweepAngle, useCenter);
 }
 
 void SkRecorder::onDrawRRect(const SkRRect& rrect, const SkPaint& paint) {
-    this->append<SkRecords::DrawRRect>(paint, rrect);
+    this->append<SkRecords::DrawRRect>(this->intern(paint), rrect);
 }
 
 void SkRecorder::onDrawDRRect(const SkRRect& outer, const SkRRect& inner, const SkPaint& paint) {
-    this->append<SkRecords::DrawDRRect>(paint, outer, inner);
+    this->append<SkRecords::DrawDRRect>(this->intern(paint), outer, inner);
 }
 
 void SkRecorder::onDrawDrawable(SkDrawable* drawable, const SkMatrix* matrix) {
@@ -219,26 +411,27 @@ void SkRecorder::onDrawDrawable(SkDrawable* drawable, const SkMatrix* matrix) {
 }
 
 void SkRecorder::onDrawPath(const SkPath& path, const SkPaint& paint) {
-    this->append<SkRecords::DrawPath>(paint, path);
+    this->append<SkRecords::DrawPath>(this->intern(paint), this->intern(path));
 }
 
 void SkRecorder::onDrawImage2(const SkImage* image, SkScalar x, SkScalar y,
                               const SkSamplingOptions& sampling, const SkPaint* paint) {
-    this->append<SkRecords::DrawImage>(this->copy(paint), sk_ref_sp(image), x, y, sampling);
+    this->append<SkRecords::DrawImage>(this->copy(this->intern(paint)), sk_ref_sp(image), x, y,
+                                       sampling);
 }
 
 void SkRecorder::onDrawImageRect2(const SkImage* image, const SkRect& src, const SkRect& dst,
                                   const SkSamplingOptions& sampling, const SkPaint* paint,
                                   SrcRectConstraint constraint) {
-    this->append<SkRecords::DrawImageRect>(this->copy(paint), sk_ref_sp(image), src, dst,
-                                           sampling, constraint);
+    this->append<SkRecords::DrawImageRect>(this->copy(this->intern(paint)), sk_ref_sp(image),
+                                           src, dst, sampling, constraint);
 }
 
 void SkRecorder::onDrawImageLattice2(const SkImage* image, const Lattice& lattice, const SkRect& dst,
                                      SkFilterMode filter, const SkPaint* paint) {
     int flagCount = lattice.fRectTypes ? (lattice.fXCount + 1) * (lattice.fYCount + 1) : 0;
     SkASSERT(lattice.fBounds);
-    this->append<SkRecords::DrawImageLattice>(this->copy(paint), sk_ref_sp(image),
+    this->append<SkRecords::DrawImageLattice>(this->copy(this->intern(paint)), sk_ref_sp(image),
            lattice.fXCount, this->copy(lattice.fXDivs, lattice.fXCount),
            lattice.fYCount, this->copy(lattice.fYDivs, lattice.fYCount),
            flagCount, this->copy(lattice.fRectTypes, flagCount),
@@ -247,11 +440,11 @@ void SkRecorder::onDrawImageLattice2(const SkImage* image, const Lattice& lattic
 
 void SkRecorder::onDrawTextBlob(const SkTextBlob* blob, SkScalar x, SkScalar y,
                                 const SkPaint& paint) {
-    this->append<SkRecords::DrawTextBlob>(paint, sk_ref_sp(blob), x, y);
+    this->append<SkRecords::DrawTextBlob>(this->intern(paint), this->intern(blob), x, y);
 }
 
 void SkRecorder::onDrawSlug(const sktext::gpu::Slug* slug, const SkPaint& paint) {
-    this->append<SkRecords::DrawSlug>(paint, sk_ref_sp(slug));
+    this->append<SkRecords::DrawSlug>(this->intern(paint), sk_ref_sp(slug));
 }
 
 void SkRecorder::onDrawGlyphRunList(
@@ -266,24 +459,25 @@ void SkRecorder::onDrawGlyphRunList(
 
 void SkRecorder::onDrawPicture(const SkPicture* pic, const SkMatrix* matrix, const SkPaint* paint) {
     fApproxBytesUsedBySubPictures += pic->approximateBytesUsed();
-    this->append<SkRecords::DrawPicture>(this->copy(paint), sk_ref_sp(pic), matrix ? *matrix : SkMatrix::I());
+    this->append<SkRecords::DrawPicture>(this->copy(this->intern(paint)), sk_ref_sp(pic),
+                                         matrix ? *matrix : SkMatrix::I());
 }
 
 void SkRecorder::onDrawVerticesObject(const SkVertices* vertices, SkBlendMode bmode,
                                       const SkPaint& paint) {
-    this->append<SkRecords::DrawVertices>(paint,
+    this->append<SkRecords::DrawVertices>(this->intern(paint),
                                           sk_ref_sp(const_cast<SkVertices*>(vertices)),
                                           bmode);
 }
 
 void SkRecorder::onDrawMesh(const SkMesh& mesh, sk_sp<SkBlender> blender, const SkPaint& paint) {
-    this->append<SkRecords::DrawMesh>(paint, mesh, std::move(blender));
+    this->append<SkRecords::DrawMesh>(this->intern(paint), mesh, std::move(blender));
 }
 
 void SkRecorder::onDrawPatch(const SkPoint cubics[12], const SkColor colors[4],
                              const SkPoint texCoords[4], SkBlendMode bmode,
                              const SkPaint& paint) {
-    this->append<SkRecords::DrawPatch>(paint,
+    this->append<SkRecords::DrawPatch>(this->intern(paint),
            cubics ? this->copy(cubics, SkPatchUtils::kNumCtrlPts) : nullptr,
            colors ? this->copy(colors, SkPatchUtils::kNumCorners) : nullptr,
            texCoords ? this->copy(texCoords, SkPatchUtils::kNumCorners) : nullptr,
@@ -294,7 +488,7 @@ void SkRecorder::onDrawAtlas2(const SkImage* atlas, const SkRSXform xform[], con
                               const SkColor colors[], int count, SkBlendMode mode,
                               const SkSamplingOptions& sampling, const SkRect* cull,
                               const SkPaint* paint) {
-    this->append<SkRecords::DrawAtlas>(this->copy(paint),
+    this->append<SkRecords::DrawAtlas>(this->copy(this->intern(paint)),
            sk_ref_sp(atlas),
            this->copy(xform, count),
            this->copy(tex, count),
@@ -306,7 +500,7 @@ void SkRecorder::onDrawAtlas2(const SkImage* atlas, const SkRSXform xform[], con
 }
 
 void SkRecorder::onDrawShadowRec(const SkPath& path, const SkDrawShadowRec& rec) {
-    this->append<SkRecords::DrawShadowRec>(path, rec);
+    this->append<SkRecords::DrawShadowRec>(this->intern(path), rec);
 }
 
 void SkRecorder::onDrawAnnotation(const SkRect& rect, const char key[], SkData* value) {
@@ -331,8 +525,8 @@ void SkRecorder::onDrawEdgeAAImageSet2(const ImageSetEntry set[], int count,
         setCopy[i] = set[i];
     }
 
-    this->append<SkRecords::DrawEdgeAAImageSet>(this->copy(paint), std::move(setCopy), count,
-            this->copy(dstClips, totalDstClipCount),
+    this->append<SkRecords::DrawEdgeAAImageSet>(this->copy(this->intern(paint)),
+            std::move(setCopy), count, this->copy(dstClips, totalDstClipCount),
             this->copy(preViewMatrices, totalMatrixCount), sampling, constraint);
 }
 
@@ -347,7 +541,7 @@ SkCanvas::SaveLayerStrategy SkRecorder::getSaveLayerStrategy(const SaveLayerRec&
     }
 
     this->append<SkRecords::SaveLayer>(this->copy(rec.fBounds),
-                                       this->copy(rec.fPaint),
+                                       this->copy(this->intern(rec.fPaint)),
                                        sk_ref_sp(rec.fBackdrop),
                                        rec.fSaveLayerFlags,
                                        SkCanvasPriv::GetBackdropScaleFactor(rec),
@@ -396,7 +590,7 @@ void SkRecorder::onClipRRect(const SkRRect& rrect, SkClipOp op, ClipEdgeStyle ed
 void SkRecorder::onClipPath(const SkPath& path, SkClipOp op, ClipEdgeStyle edgeStyle) {
     INHERITED(onClipPath, path, op, edgeStyle);
     SkRecords::ClipOpAndAA opAA(op, kSoft_ClipEdgeStyle == edgeStyle);
-    this->append<SkRecords::ClipPath>(path, opAA);
+    this->append<SkRecords::ClipPath>(this->intern(path), opAA);
 }
 
 void SkRecorder::onClipShader(sk_sp<SkShader> cs, SkClipOp op) {
@@ -79,10 +79,21 @@ public:
     // Does not take ownership of the SkRecord.
     SkRecorder(SkRecord*, int width, int height);   // TODO: remove
     SkRecorder(SkRecord*, const SkRect& bounds);
+    ~SkRecorder() override;
 
     void reset(SkRecord*, const SkRect& bounds);
 
     size_t approxBytesUsedBySubPictures() const { return fApproxBytesUsedBySubPictures; }
+    // Approximate heap bytes of the paths and text blobs that interning replaced with earlier ones
+    // with matching contents. Pictures' approximateBytesUsed() doesn't count paths or text blobs
+    // either way, so this is the only measure of what interning saves.
+    size_t approxBytesSavedByInterning() const { return fApproxBytesSavedByInterning; }
+
+    // When enabled, paths, text blobs and paint effects (shaders, filters, etc.) are interned by
+    // content: every op that records one equal to one already recorded shares the first one's
+    // storage, even if the caller built them separately. This hashes every payload, so it's off
+    // by default. Reset by reset() and forgetRecord().
+    void setInternPayloads(bool);
 
     SkDrawableList* getDrawableList() const { return fDrawableList.get(); }
     std::unique_ptr<SkDrawableList> detachDrawableList() { return std::move(fDrawableList); }
@@ -159,6 +170,8 @@ public:
     sk_sp<SkSurface> onNewSurface(const SkImageInfo&, const SkSurfaceProps&) override;
 
 private:
+    class Interner;
+
     template <typename T>
     T* copy(const T*);
 
@@ -168,7 +181,16 @@ private:
     template<typename T, typename... Args>
     void append(Args&&...);
 
+    // These return their argument, or an interned equivalent when setInternPayloads() is on,
+    // counting the bytes of any payload that was replaced.
+    const SkPaint& intern(const SkPaint&);
+    const SkPaint* intern(const SkPaint*);
+    const SkPath& intern(const SkPath&);
+    sk_sp<const SkTextBlob> intern(const SkTextBlob*);
+
     size_t fApproxBytesUsedBySubPictures;
+    size_t fApproxBytesSavedByInterning;
+    std::unique_ptr<Interner> fInterner;
     SkRecord* fRecord;
     std::unique_ptr<SkDrawableList> fDrawableList;
 };
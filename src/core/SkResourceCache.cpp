@@ -29,6 +29,8 @@
 #endif
 
 #include <algorithm>
+#include <atomic>
+#include <memory>
 
 using namespace skia_private;
 
@@ -463,93 +465,307 @@ void SkResourceCache::checkMessages() {
 
 ///////////////////////////////////////////////////////////////////////////////
 
-static SkMutex& resource_cache_mutex() {
-    static SkMutex& mutex = *(new SkMutex);
-    return mutex;
+struct SkShardedResourceCache::Shard {
+    SkMutex                          fMutex;
+    std::unique_ptr<SkResourceCache> fCache SK_GUARDED_BY(fMutex);
+
+    // Read without fMutex by add() and reconcile().
+    std::atomic<size_t> fBytesUsed{0};   // Mirrors fCache->getTotalBytesUsed().
+    std::atomic<size_t> fByteLimit{0};   // Set by reconcile(); fCache catches up in add().
+    std::atomic<size_t> fBytesAdded{0};  // Demand since the last reconcile().
+    std::atomic<int>    fAddsOverBudget{0};
+};
+
+// While the cache is filling, i.e. more than 1/kFillingFraction of its budget is unused, a shard
+// that runs out of room reconciles at once. After that, it reconciles every so many evictions.
+static constexpr int kFillingFraction = 8;
+static constexpr int kAddsOverBudgetPerReconcile = 256;
+
+SkShardedResourceCache::SkShardedResourceCache(int shardCount,
+                                               SkResourceCache::DiscardableFactory factory)
+        : fShardCount(std::max(shardCount, 1))
+        , fShards(new Shard[fShardCount])
+        , fDiscardableFactory(factory)
+        , fTotalByteLimit(0) {
+    for (int i = 0; i < fShardCount; ++i) {
+        SkAutoMutexExclusive lock(fShards[i].fMutex);
+        fShards[i].fCache = std::make_unique<SkResourceCache>(factory);
+    }
+}
+
+SkShardedResourceCache::SkShardedResourceCache(int shardCount, size_t byteLimit)
+        : fShardCount(std::max(shardCount, 1))
+        , fShards(new Shard[fShardCount])
+        , fDiscardableFactory(nullptr)
+        , fTotalByteLimit(byteLimit) {
+    for (int i = 0; i < fShardCount; ++i) {
+        // Until there's some demand to go by, split the budget evenly.
+        const size_t limit = byteLimit / fShardCount + (i == 0 ? byteLimit % fShardCount : 0);
+        SkAutoMutexExclusive lock(fShards[i].fMutex);
+        fShards[i].fCache = std::make_unique<SkResourceCache>(limit);
+        fShards[i].fByteLimit.store(limit, std::memory_order_relaxed);
+    }
+}
+
+SkShardedResourceCache::~SkShardedResourceCache() = default;
+
+SkShardedResourceCache::Shard& SkShardedResourceCache::shardFor(uint32_t hash) const {
+    // Use the high bits of the hash: each shard's hash table indexes with the low ones.
+    return fShards[((uint64_t)hash * (uint64_t)fShardCount) >> 32];
+}
+
+void SkShardedResourceCache::updateBytesUsed(Shard& shard) {
+    shard.fMutex.assertHeld();
+    const size_t used = shard.fCache->getTotalBytesUsed();
+    const size_t prev = shard.fBytesUsed.load(std::memory_order_relaxed);
+    if (used != prev) {
+        shard.fBytesUsed.store(used, std::memory_order_relaxed);
+        // Unsigned wrap-around makes this work when usage went down, too.
+        fTotalBytesUsed.fetch_add(used - prev, std::memory_order_relaxed);
+    }
+}
+
+bool SkShardedResourceCache::find(const Key& key, SkResourceCache::FindVisitor visitor,
+                                  void* context) {
+    Shard& shard = this->shardFor(key.hash());
+    SkAutoMutexExclusive lock(shard.fMutex);
+    const bool found = shard.fCache->find(key, visitor, context);
+    this->updateBytesUsed(shard);  // Stale and purged Recs may have been removed.
+    return found;
+}
+
+void SkShardedResourceCache::add(Rec* rec, void* payload) {
+    Shard& shard = this->shardFor(rec->getHash());
+
+    if (!fDiscardableFactory) {
+        const size_t bytes = rec->bytesUsed();
+        shard.fBytesAdded.fetch_add(bytes, std::memory_order_relaxed);
+        // Like SkResourceCache::purgeAsNeeded(), count reaching the limit as over it.
+        if (shard.fBytesUsed.load(std::memory_order_relaxed) + bytes >=
+            shard.fByteLimit.load(std::memory_order_relaxed)) {
+            // This add would evict. Borrow spare budget if the cache is still filling, and
+            // otherwise rebalance now and then, in case the demand has shifted between shards.
+            const size_t limit = this->getTotalByteLimit();
+            const bool filling = this->getTotalBytesUsed() + limit / kFillingFraction < limit;
+            if (filling || shard.fAddsOverBudget.fetch_add(1, std::memory_order_relaxed) + 1 >=
+                           kAddsOverBudgetPerReconcile) {
+                this->reconcile(/*purge=*/true);
+            }
+        }
+    }
+
+    SkAutoMutexExclusive lock(shard.fMutex);
+    if (!fDiscardableFactory) {
+        const size_t limit = shard.fByteLimit.load(std::memory_order_relaxed);
+        if (shard.fCache->getTotalByteLimit() != limit) {
+            shard.fCache->setTotalByteLimit(limit);
+        }
+    }
+    shard.fCache->add(rec, payload);
+    this->updateBytesUsed(shard);
+}
+
+void SkShardedResourceCache::reconcile(bool purge) {
+    SkAutoMutexExclusive reconcileLock(fReconcileMutex);
+    if (fDiscardableFactory) {
+        return;  // Discardable shards have no byte budget.
+    }
+
+    const int n = fShardCount;
+    AutoTArray<size_t> used(n), added(n);
+    size_t totalUsed = 0, totalAdded = 0;
+    for (int i = 0; i < n; ++i) {
+        used[i]  = fShards[i].fBytesUsed.load(std::memory_order_relaxed);
+        added[i] = fShards[i].fBytesAdded.exchange(0, std::memory_order_relaxed);
+        fShards[i].fAddsOverBudget.store(0, std::memory_order_relaxed);
+        totalUsed  += used[i];
+        totalAdded += added[i];
+    }
+
+    // Splits bytes among the shards in proportion to their recent demand, or their usage.
+    auto byDemand = [&](size_t bytes, int i) -> size_t {
+        return totalAdded ? (size_t)(bytes * ((double)added[i] / totalAdded)) : bytes / n;
+    };
+    auto byUsage = [&](size_t bytes, int i) -> size_t {
+        return totalUsed ? (size_t)(bytes * ((double)used[i] / totalUsed)) : bytes / n;
+    };
+
+    // Every shard keeps a small floor, so that an idle shard can still cache something.
+    const size_t limit = fTotalByteLimit.load(std::memory_order_relaxed);
+    const size_t floor = limit / (4 * n);
+    size_t kept = 0;
+    for (int i = 0; i < n; ++i) {
+        kept += std::max(used[i], floor);
+    }
+    // While filling, every shard keeps what it holds and the spare bytes are shared out, half
+    // evenly and half by demand. Once full, the budget follows the shards' usage, moved a quarter
+    // of the way towards their demand: demand is noisy over one reconcile, and shards busy
+    // finding rather than adding shouldn't be emptied by a burst of adds elsewhere.
+    const bool filling = kept + limit / kFillingFraction < limit;
+
+    for (int i = 0; i < n; ++i) {
+        Shard& shard = fShards[i];
+        size_t budget;
+        if (filling) {
+            const size_t spare = limit - kept;
+            budget = std::max(used[i], floor) + spare / 2 / n + byDemand(spare - spare / 2, i);
+        } else {
+            const size_t rest = limit - floor * n;
+            budget = floor + byUsage(rest - rest / 4, i) + byDemand(rest / 4, i);
+        }
+        shard.fByteLimit.store(budget, std::memory_order_relaxed);
+
+        if (purge && used[i] > budget) {
+            SkAutoMutexExclusive lock(shard.fMutex);
+            shard.fCache->setTotalByteLimit(budget);
+            this->updateBytesUsed(shard);
+        }
+    }
+}
+
+void SkShardedResourceCache::visitAll(SkResourceCache::Visitor visitor, void* context) {
+    for (int i = 0; i < fShardCount; ++i) {
+        SkAutoMutexExclusive lock(fShards[i].fMutex);
+        fShards[i].fCache->visitAll(visitor, context);
+    }
 }
 
-/** Must hold resource_cache_mutex() when calling. */
-static SkResourceCache* get_cache() {
-    // resource_cache_mutex() is always held when this is called, so we don't need to be fancy in here.
-    resource_cache_mutex().assertHeld();
-    static SkResourceCache* gResourceCache = nullptr;
-    if (nullptr == gResourceCache) {
+size_t SkShardedResourceCache::setTotalByteLimit(size_t newLimit) {
+    size_t prevLimit = fTotalByteLimit.exchange(newLimit, std::memory_order_relaxed);
+    this->reconcile(/*purge=*/newLimit < prevLimit);
+    return prevLimit;
+}
+
+size_t SkShardedResourceCache::setSingleAllocationByteLimit(size_t newLimit) {
+    return fSingleAllocationByteLimit.exchange(newLimit, std::memory_order_relaxed);
+}
+
+size_t SkShardedResourceCache::getSingleAllocationByteLimit() const {
+    return fSingleAllocationByteLimit.load(std::memory_order_relaxed);
+}
+
+size_t SkShardedResourceCache::getEffectiveSingleAllocationByteLimit() const {
+    // Like SkResourceCache, cap the single-allocation limit to the budget when not discardable.
+    size_t limit = this->getSingleAllocationByteLimit();
+    if (nullptr == fDiscardableFactory) {
+        const size_t totalLimit = this->getTotalByteLimit();
+        limit = 0 == limit ? totalLimit : std::min(limit, totalLimit);
+    }
+    return limit;
+}
+
+void SkShardedResourceCache::purgeAll() {
+    for (int i = 0; i < fShardCount; ++i) {
+        SkAutoMutexExclusive lock(fShards[i].fMutex);
+        fShards[i].fCache->purgeAll();
+        this->updateBytesUsed(fShards[i]);
+    }
+}
+
+void SkShardedResourceCache::checkMessages() {
+    for (int i = 0; i < fShardCount; ++i) {
+        SkAutoMutexExclusive lock(fShards[i].fMutex);
+        fShards[i].fCache->checkMessages();
+        this->updateBytesUsed(fShards[i]);
+    }
+}
+
+SkCachedData* SkShardedResourceCache::newCachedData(size_t bytes) {
+    // The shards poll for purge messages whenever they're used, so there's no need to here.
+    if (fDiscardableFactory) {
+        SkDiscardableMemory* dm = fDiscardableFactory(bytes);
+        return dm ? new SkCachedData(bytes, dm) : nullptr;
+    } else {
+        return new SkCachedData(sk_malloc_throw(bytes), bytes);
+    }
+}
+
+size_t SkShardedResourceCache::shardByteLimit(int shard) const {
+    SkASSERT(0 <= shard && shard < fShardCount);
+    return fShards[shard].fByteLimit.load(std::memory_order_relaxed);
+}
+
+void SkShardedResourceCache::dump() const {
+    SkDebugf("SkShardedResourceCache: shards=%d bytes=%zu limit=%zu %s\n",
+             fShardCount, this->getTotalBytesUsed(), this->getTotalByteLimit(),
+             fDiscardableFactory ? "discardable" : "malloc");
+    for (int i = 0; i < fShardCount; ++i) {
+        SkAutoMutexExclusive lock(fShards[i].fMutex);
+        fShards[i].fCache->dump();
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef SK_RESOURCE_CACHE_SHARD_COUNT
+    #define SK_RESOURCE_CACHE_SHARD_COUNT    1
+#endif
+
+static SkShardedResourceCache* get_cache() {
+    static SkShardedResourceCache* gResourceCache =
 #if defined(SK_USE_DISCARDABLE_SCALEDIMAGECACHE)
-        gResourceCache = new SkResourceCache(SkDiscardableMemory::Create);
+            new SkShardedResourceCache(SK_RESOURCE_CACHE_SHARD_COUNT,
+                                       SkDiscardableMemory::Create);
 #else
-        gResourceCache = new SkResourceCache(SK_DEFAULT_IMAGE_CACHE_LIMIT);
+            new SkShardedResourceCache(SK_RESOURCE_CACHE_SHARD_COUNT,
+                                       SK_DEFAULT_IMAGE_CACHE_LIMIT);
 #endif
-    }
     return gResourceCache;
 }
 
 size_t SkResourceCache::GetTotalBytesUsed() {
-    SkAutoMutexExclusive am(resource_cache_mutex());
     return get_cache()->getTotalBytesUsed();
 }
 
 size_t SkResourceCache::GetTotalByteLimit() {
-    SkAutoMutexExclusive am(resource_cache_mutex());
     return get_cache()->getTotalByteLimit();
 }
 
 size_t SkResourceCache::SetTotalByteLimit(size_t newLimit) {
-    SkAutoMutexExclusive am(resource_cache_mutex());
     return get_cache()->setTotalByteLimit(newLimit);
 }
 
 SkResourceCache::DiscardableFactory SkResourceCache::GetDiscardableFactory() {
-    SkAutoMutexExclusive am(resource_cache_mutex());
     return get_cache()->discardableFactory();
 }
 
 SkCachedData* SkResourceCache::NewCachedData(size_t bytes) {
-    SkAutoMutexExclusive am(resource_cache_mutex());
     return get_cache()->newCachedData(bytes);
 }
 
 void SkResourceCache::Dump() {
-    SkAutoMutexExclusive am(resource_cache_mutex());
     get_cache()->dump();
 }
 
 size_t SkResourceCache::SetSingleAllocationByteLimit(size_t size) {
-    SkAutoMutexExclusive am(resource_cache_mutex());
     return get_cache()->setSingleAllocationByteLimit(size);
 }
 
 size_t SkResourceCache::GetSingleAllocationByteLimit() {
-    SkAutoMutexExclusive am(resource_cache_mutex());
     return get_cache()->getSingleAllocationByteLimit();
 }
 
 size_t SkResourceCache::GetEffectiveSingleAllocationByteLimit() {
-    SkAutoMutexExclusive am(resource_cache_mutex());
     return get_cache()->getEffectiveSingleAllocationByteLimit();
 }
 
 void SkResourceCache::PurgeAll() {
-    SkAutoMutexExclusive am(resource_cache_mutex());
     return get_cache()->purgeAll();
 }
 
 void SkResourceCache::CheckMessages() {
-    SkAutoMutexExclusive am(resource_cache_mutex());
     return get_cache()->checkMessages();
 }
 
 bool SkResourceCache::Find(const Key& key, FindVisitor visitor, void* context) {
-    SkAutoMutexExclusive am(resource_cache_mutex());
     return get_cache()->find(key, visitor, context);
 }
 
 void SkResourceCache::Add(Rec* rec, void* payload) {
-    SkAutoMutexExclusive am(resource_cache_mutex());
     get_cache()->add(rec, payload);
 }
 
 void SkResourceCache::VisitAll(Visitor visitor, void* context) {
-    SkAutoMutexExclusive am(resource_cache_mutex());
     get_cache()->visitAll(visitor, context);
 }
 
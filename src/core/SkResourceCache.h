@@ -9,10 +9,13 @@
 #define SkResourceCache_DEFINED
 
 #include "include/private/base/SkDebug.h"
+#include "include/private/base/SkMutex.h"
 #include "src/core/SkMessageBus.h"
 
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <memory>
 
 class SkCachedData;
 class SkDiscardableMemory;
@@ -286,10 +289,80 @@ private:
 
     void init();    // called by constructors
 
+    friend class SkShardedResourceCache;  // For checkMessages().
+
 #ifdef SK_DEBUG
     void validate() const;
 #else
     void validate() const {}
 #endif
 };
+
+/**
+ *  A thread-safe cache made of independent SkResourceCache shards, each an LRU with its own lock
+ *  and its own share of the byte budget. A Rec lives in the shard picked by its key's hash, so
+ *  threads looking up different keys rarely wait on each other.
+ *
+ *  The shards' budgets always add up to the total limit. When a shard runs out of room while the
+ *  cache as a whole still has some, or every so often once the cache is full, the budget is
+ *  reconciled: spare bytes go to the shards that have been adding the most, and shards that lose
+ *  budget purge down to their new limit. Eviction is LRU within each shard only.
+ *
+ *  The global SkResourceCache::Find(), Add(), etc. use one of these, with
+ *  SK_RESOURCE_CACHE_SHARD_COUNT shards.
+ */
+class SkShardedResourceCache {
+public:
+    using Key = SkResourceCache::Key;
+    using Rec = SkResourceCache::Rec;
+
+    SkShardedResourceCache(int shardCount, SkResourceCache::DiscardableFactory);
+    SkShardedResourceCache(int shardCount, size_t byteLimit);
+    ~SkShardedResourceCache();
+
+    // These behave like their SkResourceCache counterparts, but may be called from any thread.
+    bool find(const Key&, SkResourceCache::FindVisitor, void* context);
+    void add(Rec*, void* payload = nullptr);
+    // Visits each shard in turn, holding only that shard's lock.
+    void visitAll(SkResourceCache::Visitor, void* context);
+
+    size_t getTotalBytesUsed() const { return fTotalBytesUsed.load(std::memory_order_relaxed); }
+    size_t getTotalByteLimit() const { return fTotalByteLimit.load(std::memory_order_relaxed); }
+    size_t setTotalByteLimit(size_t newLimit);
+
+    size_t setSingleAllocationByteLimit(size_t maximumAllocationSize);
+    size_t getSingleAllocationByteLimit() const;
+    size_t getEffectiveSingleAllocationByteLimit() const;
+
+    void purgeAll();
+    void checkMessages();
+
+    SkResourceCache::DiscardableFactory discardableFactory() const { return fDiscardableFactory; }
+    SkCachedData* newCachedData(size_t bytes);
+
+    int shardCount() const { return fShardCount; }
+    // The current byte budget of one shard. Only public for tests.
+    size_t shardByteLimit(int shard) const;
+
+    void dump() const;
+
+private:
+    struct Shard;
+
+    Shard& shardFor(uint32_t hash) const;
+    // Call with the shard's lock held, after anything that might have changed its usage.
+    void updateBytesUsed(Shard&);
+    // Redistributes the byte budget among the shards. If purge is true, shards left over their
+    // new budget purge down to it now; otherwise they will on their next add.
+    void reconcile(bool purge);
+
+    const int                                 fShardCount;
+    std::unique_ptr<Shard[]>                  fShards;
+    const SkResourceCache::DiscardableFactory fDiscardableFactory;
+
+    SkMutex              fReconcileMutex;  // Serializes changes to the shards' budgets.
+    std::atomic<size_t>  fTotalByteLimit;
+    std::atomic<size_t>  fTotalBytesUsed{0};
+    std::atomic<size_t>  fSingleAllocationByteLimit{0};
+};
 #endif
@@ -14,6 +14,7 @@
 #include "include/private/base/SkFixed.h"
 
 class SkBlitter;
+class SkExecutor;
 class SkPath;
 class SkRasterClip;
 class SkRegion;
@@ -23,6 +24,22 @@ class SkRegion;
 */
 typedef SkIRect SkXRect;
 
+// For testing and benchmarking, make SkScan::AntiFillPath() always use one rasterizer for paths it
+// could draw with either, rather than choosing for each path. These affect every thread, so tests
+// that set them must be serial.
+extern bool gSkForceAnalyticAA;
+extern bool gSkForceSparseTileAA;
+
+// Set by SkGraphics::SetPathBandExecutor(), possibly while other threads are drawing.
+struct SkPathBandSettings {
+    SkExecutor* executor = nullptr;  // Rasterize every path on the drawing thread when null.
+    int threads = 1;                 // How many threads the executor runs.
+    int minEdges = 0;
+};
+void SkSetPathBandSettings(const SkPathBandSettings&);
+// Returns the settings from one call to SkSetPathBandSettings(), never parts of two.
+SkPathBandSettings SkGetPathBandSettings();
+
 class SkScan {
 public:
     /*
@@ -89,6 +106,17 @@ private:
     static void AntiHairLineRgn(const SkPoint[], int count, const SkRegion*, SkBlitter*);
     static void AAAFillPath(const SkPath& path, SkBlitter* blitter, const SkIRect& pathIR,
                             const SkIRect& clipBounds, bool forceRLE);
+    // Anti-aliases a path with many edges by accumulating coverage in the sparse set of small
+    // tiles the edges pass through. Blits rows in order, so it's fine for RLE blitters too.
+    static void SparseTileFillPath(const SkPath& path, SkBlitter* blitter, const SkIRect& pathIR,
+                                   const SkIRect& clipBounds);
+    // Anti-aliases a (non-inverse) path in horizontal bands, capturing the coverage of each band
+    // concurrently on the executor, which runs the given number of threads, then blitting it in
+    // order on this thread. Returns false, having drawn nothing, if the path's clipped bounds are
+    // too short to split.
+    static bool BandedAntiFillPath(const SkPath& path, SkBlitter* blitter, const SkIRect& pathIR,
+                                   const SkIRect& clipBounds, bool sparseTiles, SkExecutor&,
+                                   int threads);
 };
 
 /** Assign an SkXRect from a SkIRect, by promoting the src rect's coordinates
@@ -11,14 +11,55 @@
 #include "include/core/SkRegion.h"
 #include "include/private/base/SkAssert.h"
 #include "include/private/base/SkMath.h"
+#include "include/private/base/SkThreadAnnotations.h"
+#include "src/base/SkSpinlock.h"
 #include "src/core/SkAAClip.h"
 #include "src/core/SkBlitter.h"
 #include "src/core/SkRasterClip.h"
 #include "src/core/SkScan.h"
 #include "src/core/SkScanPriv.h"
 
+#include <atomic>
 #include <cstdint>
 
+bool gSkForceAnalyticAA{false};
+bool gSkForceSparseTileAA{false};
+
+static SkSpinlock gPathBandLock;
+static SkPathBandSettings gPathBandSettings SK_GUARDED_BY(gPathBandLock);
+// Lets paths skip the lock while there's no executor, which is the usual case.
+static std::atomic<bool> gPathBandEnabled{false};
+
+void SkSetPathBandSettings(const SkPathBandSettings& settings) {
+    SkAutoSpinlock lock(gPathBandLock);
+    gPathBandSettings = settings;
+    gPathBandEnabled.store(settings.executor != nullptr, std::memory_order_relaxed);
+}
+
+SkPathBandSettings SkGetPathBandSettings() {
+    if (!gPathBandEnabled.load(std::memory_order_relaxed)) {
+        return {};
+    }
+    SkAutoSpinlock lock(gPathBandLock);
+    return gPathBandSettings;
+}
+
+// Analytic AA keeps every edge that crosses a scanline in a sorted list, so its cost grows with the
+// edges per scanline. Sparse tiles cost about the same per edge however they're arranged, plus a
+// fixed cost to sort them into tiles, which pays off once a path has enough edges. Sparse tiles
+// already win with a few hundred, but the threshold stays higher so that ordinary paths keep the
+// (very slightly different) coverage they've always had.
+static bool should_use_sparse_tiles(const SkPath& path) {
+    if (path.isInverseFillType()) {
+        return false;
+    }
+    if (gSkForceSparseTileAA || gSkForceAnalyticAA) {
+        return gSkForceSparseTileAA;
+    }
+    static constexpr int kMinSparseTilePoints = 1024;
+    return path.countPoints() >= kMinSparseTilePoints && !path.isConvex();
+}
+
 static SkIRect safeRoundOut(const SkRect& src) {
     // roundOut will pin huge floats to max/min int
     SkIRect dst = src.roundOut();
@@ -126,7 +167,18 @@ void SkScan::AntiFillPath(const SkPath& path, const SkRegion& origClip,
         sk_blit_above(blitter, ir, *clipRgn);
     }
 
-    SkScan::AAAFillPath(path, blitter, ir, clipRgn->getBounds(), forceRLE);
+    const bool sparseTiles = should_use_sparse_tiles(path);
+    const SkPathBandSettings bands = SkGetPathBandSettings();
+    if (bands.executor && !isInverse && path.countPoints() >= bands.minEdges &&
+        SkScan::BandedAntiFillPath(path, blitter, ir, clipRgn->getBounds(), sparseTiles,
+                                   *bands.executor, bands.threads)) {
+        return;
+    }
+    if (sparseTiles) {
+        SkScan::SparseTileFillPath(path, blitter, ir, clipRgn->getBounds());
+    } else {
+        SkScan::AAAFillPath(path, blitter, ir, clipRgn->getBounds(), forceRLE);
+    }
 
     if (isInverse) {
         sk_blit_below(blitter, ir, *clipRgn);
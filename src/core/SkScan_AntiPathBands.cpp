@@ -0,0 +1,197 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkExecutor.h"
+#include "include/core/SkPath.h"
+#include "include/core/SkRect.h"
+#include "include/private/base/SkAssert.h"
+#include "include/private/base/SkTo.h"
+#include "src/core/SkBlitter.h"
+#include "src/core/SkMask.h"
+#include "src/core/SkScan.h"
+#include "src/core/SkTaskGroup.h"
+#include "src/core/SkTraceEvent.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+/*
+  Anti-aliases one path on several threads by splitting its clipped bounds into horizontal bands.
+
+  Blitters aren't thread safe, so the bands don't blit directly. Each band task runs the usual
+  rasterizer with the band as its clip, which builds an edge list of just the edges clipped to the
+  band, and captures the coverage it blits in an A8 buffer. Then the calling thread blits each
+  band's coverage, in order, one run-length encoded row at a time.
+*/
+
+namespace {
+
+// Bands are at least this tall, so the edges each band has to clip and skip stay affordable.
+constexpr int kMinBandRows = 16;
+// And at most this big, so the coverage buffers of the bands in flight stay small.
+constexpr size_t kMaxBandBytes = 1 << 20;
+
+// Captures the coverage blitted within a band, which all blits must be within, remembering which
+// part of each row was touched. Then blits it to another blitter, leaving the buffer clear again
+// for the next band.
+class CoverageBlitter final : public SkBlitter {
+public:
+    CoverageBlitter(int width, int maxRows)
+            : fCoverage(SkToSizeT(width) * maxRows), fLeft(maxRows, width), fRight(maxRows, 0) {}
+
+    void setBand(const SkIRect& band) { fBand = band; }
+
+    void blitH(int x, int y, int width) override {
+        memset(this->addr(x, y, width), 0xFF, width);
+    }
+
+    void blitAntiH(int x, int y, const SkAlpha alpha[], const int16_t runs[]) override {
+        int width = 0;
+        for (const int16_t* run = runs; *run > 0; run += *run) {
+            width += *run;
+        }
+        uint8_t* dst = this->addr(x, y, width);
+        for (int count = *runs; count > 0; count = *runs) {
+            memset(dst, *alpha, count);
+            dst += count;
+            runs += count;
+            alpha += count;
+        }
+    }
+
+    void blitV(int x, int y, int height, SkAlpha alpha) override {
+        while (height-- > 0) {
+            *this->addr(x, y++, 1) = alpha;
+        }
+    }
+
+    void blitRect(int x, int y, int width, int height) override {
+        while (height-- > 0) {
+            this->blitH(x, y++, width);
+        }
+    }
+
+    void blitMask(const SkMask& mask, const SkIRect& clip) override {
+        if (mask.fFormat != SkMask::kA8_Format) {
+            this->SkBlitter::blitMask(mask, clip);
+            return;
+        }
+        for (int y = clip.fTop; y < clip.fBottom; ++y) {
+            memcpy(this->addr(clip.fLeft, y, clip.width()),
+                   mask.getAddr8(clip.fLeft, y),
+                   clip.width());
+        }
+    }
+
+    // Blits each row with one blitAntiH(), over the part of it that was touched, merging equal
+    // neighbors into runs.
+    void blitTo(SkBlitter* blitter, SkAlpha* alpha, int16_t* runs) {
+        const int width = fBand.width();
+        for (int row = 0; row < fBand.height(); ++row) {
+            const int left = fLeft[row], right = fRight[row];
+            if (left >= right) {
+                continue;
+            }
+            uint8_t* coverage = fCoverage.data() + SkToSizeT(row) * width;
+            for (int x = left; x < right;) {
+                int end = x + 1;
+                while (end < right && coverage[end] == coverage[x]) {
+                    ++end;
+                }
+                alpha[x - left] = coverage[x];
+                runs[x - left] = SkToS16(end - x);
+                x = end;
+            }
+            runs[right - left] = 0;
+            blitter->blitAntiH(fBand.fLeft + left, fBand.fTop + row, alpha, runs);
+
+            memset(coverage + left, 0, right - left);
+            fLeft[row] = width;
+            fRight[row] = 0;
+        }
+    }
+
+private:
+    uint8_t* addr(int x, int y, int width) {
+        SkASSERT(fBand.contains(SkIRect::MakeXYWH(x, y, width, 1)));
+        const int row = y - fBand.fTop;
+        x -= fBand.fLeft;
+        fLeft[row] = std::min(fLeft[row], x);
+        fRight[row] = std::max(fRight[row], x + width);
+        return fCoverage.data() + SkToSizeT(row) * fBand.width() + x;
+    }
+
+    SkIRect fBand = SkIRect::MakeEmpty();
+    std::vector<uint8_t> fCoverage;
+    std::vector<int> fLeft, fRight;
+};
+
+}  // namespace
+
+bool SkScan::BandedAntiFillPath(const SkPath& path,
+                                SkBlitter* blitter,
+                                const SkIRect& ir,
+                                const SkIRect& clipBounds,
+                                bool sparseTiles,
+                                SkExecutor& executor,
+                                int threads) {
+    SkASSERT(!path.isInverseFillType());
+    SkIRect bounds;
+    if (!bounds.intersect(ir, clipBounds)) {
+        return true;
+    }
+
+    // About two bands per thread, so a band with more edges than the rest doesn't hold up the
+    // others for long.
+    SkASSERT(threads > 0);
+    const size_t width = SkToSizeT(bounds.width());
+    int bandRows = std::max(kMinBandRows, (bounds.height() + 2 * threads - 1) / (2 * threads));
+    bandRows = std::min(bandRows, std::max(kMinBandRows, SkToInt(kMaxBandBytes / width)));
+    const int bands = (bounds.height() + bandRows - 1) / bandRows;
+    if (bands < 2) {
+        return false;
+    }
+    TRACE_EVENT1("skia", TRACE_FUNC, "bands", bands);
+
+    // The path computes and caches its convexity lazily; do that before sharing it.
+    (void)path.isConvex();
+
+    const int bandsInFlight = std::min(bands, 2 * threads);
+    std::vector<std::unique_ptr<CoverageBlitter>> coverage(bandsInFlight);
+    for (auto& band : coverage) {
+        band = std::make_unique<CoverageBlitter>(bounds.width(), bandRows);
+    }
+    std::vector<SkAlpha> alpha(width + 1);
+    std::vector<int16_t> runs(width + 1);
+
+    SkTaskGroup tasks(executor);
+    for (int first = 0; first < bands; first += bandsInFlight) {
+        const int count = std::min(bandsInFlight, bands - first);
+        tasks.batch(count, [&](int i) {
+            const int top = bounds.fTop + (first + i) * bandRows;
+            const SkIRect band = SkIRect::MakeLTRB(bounds.fLeft, top, bounds.fRight,
+                                                   std::min(top + bandRows, bounds.fBottom));
+            coverage[i]->setBand(band);
+            SkRectClipBlitter clipped;
+            clipped.init(coverage[i].get(), band);
+            if (sparseTiles) {
+                SkScan::SparseTileFillPath(path, &clipped, ir, band);
+            } else {
+                SkScan::AAAFillPath(path, &clipped, ir, band, /*forceRLE=*/true);
+            }
+        });
+        tasks.wait();
+
+        for (int i = 0; i < count; ++i) {
+            coverage[i]->blitTo(blitter, alpha.data(), runs.data());
+        }
+    }
+    return true;
+}
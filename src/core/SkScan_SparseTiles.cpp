@@ -0,0 +1,371 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkPath.h"
+#include "include/core/SkPathTypes.h"
+#include "include/core/SkPoint.h"
+#include "include/core/SkRect.h"
+#include "include/private/base/SkAssert.h"
+#include "include/private/base/SkTemplates.h"
+#include "include/private/base/SkTo.h"
+#include "src/base/SkVx.h"
+#include "src/core/SkBlitter.h"
+#include "src/core/SkEdgeClipper.h"
+#include "src/core/SkGeometry.h"
+#include "src/core/SkScan.h"
+#include "src/core/SkTraceEvent.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+/*
+  A rasterizer for paths with so many edges that walking them all down every scanline (as
+  SkScan_AAAPath does) costs more than the pixels they cover.
+
+  The path is flattened to lines, and each line is cut into pieces along a grid of small tiles.
+  Only the tiles a line passes through get a piece, so a huge path touches a sparse set of tiles
+  however many edges it has. The pieces are sorted by tile, and then each row of tiles is swept
+  from left to right: the pieces in a tile add their signed area to an accumulation buffer, whose
+  running sum across the row is the winding number at each pixel (like font-rs or stb_truetype).
+  What's left of that sum past the last piece in a tile is the winding number of every pixel up to
+  the next tile, so the spans between tiles are blitted whole.
+
+  Because the signed areas are summed before the fill rule sees them, a pixel where parts of the
+  path overlap (or self-intersect) is approximated: opposite windings within the pixel cancel, and
+  overlapping parts add up before being clamped to full coverage. Elsewhere the coverage is exact.
+*/
+
+namespace {
+
+// Each tile row is swept as one float4 of sums, one lane per row of pixels.
+constexpr int kTileWidth = 16;
+constexpr int kTileHeight = 4;
+using Rows = skvx::Vec<kTileHeight, float>;
+
+// How far a flattened curve may stray from the true one, in pixels.
+constexpr float kFlattenTolerance = 0.125f;
+constexpr int kMaxFlattenedLines = 256;
+
+// A line clipped to one tile, in coordinates relative to the tile's top left.
+struct Piece {
+    uint32_t fTile;  // tile row << 16 | tile column, so sorting by it sorts by row, then column
+    float fX0, fY0, fX1, fY1;
+};
+
+class TileBinner {
+public:
+    TileBinner(int width, int height)
+            : fWidth(width)
+            , fHeight(height)
+            , fColumns((width + kTileWidth - 1) / kTileWidth) {}
+
+    std::vector<Piece>& pieces() { return fPieces; }
+
+    void addLine(SkPoint p0, SkPoint p1) {
+        // The edge clipper leaves lines inside the bounds, give or take rounding.
+        float x0 = std::clamp(p0.fX, 0.0f, (float)fWidth),
+              y0 = std::clamp(p0.fY, 0.0f, (float)fHeight),
+              x1 = std::clamp(p1.fX, 0.0f, (float)fWidth),
+              y1 = std::clamp(p1.fY, 0.0f, (float)fHeight);
+        if (y0 == y1) {
+            return;  // Horizontal lines don't change the winding of anything.
+        }
+        const float dxdy = (x1 - x0) / (y1 - y0);
+        const int firstRow = (int)(std::min(y0, y1) / kTileHeight),
+                  endRow = (int)std::ceil(std::max(y0, y1) / kTileHeight);
+        for (int row = firstRow; row < endRow; ++row) {
+            const float top = (float)(row * kTileHeight),
+                        bottom = top + kTileHeight;
+            const float ya = std::clamp(y0, top, bottom),
+                        yb = std::clamp(y1, top, bottom);
+            if (ya == yb) {
+                continue;
+            }
+            const float xa = ya == y0 ? x0 : x0 + (ya - y0) * dxdy,
+                        xb = yb == y1 ? x1 : x0 + (yb - y0) * dxdy;
+            this->addRowPiece(row, xa, ya - top, xb, yb - top);
+        }
+    }
+
+    void addQuad(const SkPoint pts[3]) {
+        const SkVector dd = (pts[0] - pts[1]) + (pts[2] - pts[1]);
+        const int n = lines_for(dd.length() / (4 * kFlattenTolerance));
+        SkQuadCoeff quad(pts);
+        SkPoint prev = pts[0];
+        for (int i = 1; i < n; ++i) {
+            const SkPoint next = to_point(quad.eval(skvx::float2((float)i / n)));
+            this->addLine(prev, next);
+            prev = next;
+        }
+        this->addLine(prev, pts[2]);
+    }
+
+    void addCubic(const SkPoint pts[4]) {
+        const SkVector dd0 = (pts[0] - pts[1]) + (pts[2] - pts[1]),
+                       dd1 = (pts[1] - pts[2]) + (pts[3] - pts[2]);
+        const float dd = std::max(dd0.length(), dd1.length());
+        const int n = lines_for(3 * dd / (4 * kFlattenTolerance));
+        SkCubicCoeff cubic(pts);
+        SkPoint prev = pts[0];
+        for (int i = 1; i < n; ++i) {
+            const SkPoint next = to_point(cubic.eval(skvx::float2((float)i / n)));
+            this->addLine(prev, next);
+            prev = next;
+        }
+        this->addLine(prev, pts[3]);
+    }
+
+private:
+    // The number of lines that keep a curve within tolerance, when the square of that number
+    // is at least `squared`.
+    static int lines_for(float squared) {
+        return std::clamp((int)std::ceil(std::sqrt(squared)), 1, kMaxFlattenedLines);
+    }
+
+    // Splits a line already clipped to a row of tiles into the tiles it passes through.
+    void addRowPiece(int row, float xa, float ya, float xb, float yb) {
+        const float left = std::min(xa, xb),
+                    right = std::max(xa, xb);
+        const int firstColumn = (int)(left / kTileWidth),
+                  lastColumn = std::min((int)(right / kTileWidth), fColumns - 1);
+        if (firstColumn > lastColumn) {
+            return;  // On the right edge, where it can't affect any pixel.
+        }
+        if (firstColumn == lastColumn) {
+            const float tileLeft = (float)(firstColumn * kTileWidth);
+            this->push(row, firstColumn, xa - tileLeft, ya, xb - tileLeft, yb);
+            return;
+        }
+        const float dydx = (yb - ya) / (xb - xa);
+        auto y_at = [&](float x) {
+            return std::clamp(ya + (x - xa) * dydx, std::min(ya, yb), std::max(ya, yb));
+        };
+        for (int column = firstColumn; column <= lastColumn; ++column) {
+            const float tileLeft = (float)(column * kTileWidth);
+            const float l = std::max(left, tileLeft),
+                        r = std::min(right, tileLeft + kTileWidth);
+            // Keep the line's direction, which is the sign of its winding.
+            const float x0 = xa < xb ? l : r,
+                        x1 = xa < xb ? r : l;
+            this->push(row, column, x0 - tileLeft, y_at(x0), x1 - tileLeft, y_at(x1));
+        }
+    }
+
+    void push(int row, int column, float x0, float y0, float x1, float y1) {
+        if (y0 != y1) {
+            fPieces.push_back({SkToU32(row) << 16 | SkToU32(column), x0, y0, x1, y1});
+        }
+    }
+
+    const int fWidth;
+    const int fHeight;
+    const int fColumns;
+    std::vector<Piece> fPieces;
+};
+
+// Adds the signed area of a piece of line to each pixel it touches, and the rest of its winding
+// (what's right of the line) to the pixel after that, so that the running sum along a row of the
+// accumulation buffer is the coverage. Two columns past the tile's right edge catch what carries
+// beyond it.
+void accumulate(const Piece& piece, float acc[kTileWidth + 2][kTileHeight]) {
+    float x0 = piece.fX0, y0 = piece.fY0, x1 = piece.fX1, y1 = piece.fY1;
+    float direction = 1;
+    if (y0 > y1) {
+        std::swap(x0, x1);
+        std::swap(y0, y1);
+        direction = -1;
+    }
+    const float dxdy = (x1 - x0) / (y1 - y0);
+    float x = x0;
+    const int firstY = (int)y0,
+              endY = std::min((int)std::ceil(y1), kTileHeight);
+    for (int y = firstY; y < endY; ++y) {
+        const float dy = std::min((float)(y + 1), y1) - std::max((float)y, y0);
+        const float xNext = x + dxdy * dy;
+        const float d = dy * direction;
+        const float xa = std::clamp(std::min(x, xNext), 0.0f, (float)kTileWidth),
+                    xb = std::clamp(std::max(x, xNext), 0.0f, (float)kTileWidth);
+        const int xai = (int)xa,
+                  xbi = (int)std::ceil(xb);
+        if (xbi <= xai + 1) {
+            // Within one pixel: split by the line's average position in it.
+            const float xMid = 0.5f * (xa + xb) - xai;
+            acc[xai][y] += d - d * xMid;
+            acc[xai + 1][y] += d * xMid;
+        } else {
+            // Across several: a triangle in the first and last, trapezoids between.
+            const float s = 1 / (xb - xa);
+            const float xaFrac = xa - xai;
+            const float a0 = 0.5f * s * (1 - xaFrac) * (1 - xaFrac);
+            const float xbFrac = xb - xbi + 1;
+            const float aLast = 0.5f * s * xbFrac * xbFrac;
+            acc[xai][y] += d * a0;
+            if (xbi == xai + 2) {
+                acc[xai + 1][y] += d * (1 - a0 - aLast);
+            } else {
+                const float a1 = s * (1.5f - xaFrac);
+                acc[xai + 1][y] += d * (a1 - a0);
+                for (int xi = xai + 2; xi < xbi - 1; ++xi) {
+                    acc[xi][y] += d * s;
+                }
+                const float a2 = a1 + (xbi - xai - 3) * s;
+                acc[xbi - 1][y] += d * (1 - a2 - aLast);
+            }
+            acc[xbi][y] += d * aLast;
+        }
+        x = xNext;
+    }
+}
+
+// Collects a row of pixels' coverage as runs for SkBlitter::blitAntiH(), merging equal neighbors.
+class RowRuns {
+public:
+    void reset(SkAlpha* alpha, int16_t* runs) {
+        fAlpha = alpha;
+        fRuns = runs;
+        fFirst = fLast = -1;
+    }
+
+    void add(int x, int count, SkAlpha alpha) {
+        if (fLast >= 0 && fAlpha[fLast] == alpha) {
+            fRuns[fLast] += SkToS16(count);
+        } else if (fLast >= 0 || alpha) {
+            fRuns[x] = SkToS16(count);
+            fAlpha[x] = alpha;
+            fLast = x;
+            fFirst = fFirst < 0 ? x : fFirst;
+        }
+    }
+
+    void blit(SkBlitter* blitter, int left, int y) {
+        if (fLast < 0) {
+            return;
+        }
+        // Trailing transparent pixels needn't be blitted.
+        const int end = fAlpha[fLast] ? fLast + fRuns[fLast] : fLast;
+        if (end <= fFirst) {
+            return;
+        }
+        fRuns[end] = 0;
+        blitter->blitAntiH(left + fFirst, y, fAlpha + fFirst, fRuns + fFirst);
+    }
+
+private:
+    SkAlpha* fAlpha = nullptr;
+    int16_t* fRuns = nullptr;
+    int fFirst = -1;
+    int fLast = -1;
+};
+
+Rows coverage(Rows winding, bool evenOdd) {
+    if (evenOdd) {
+        // Distance to the nearest even number.
+        winding = winding - 2 * skvx::floor(0.5f * winding + 0.5f);
+    }
+    return skvx::min(skvx::abs(winding), 1.0f);
+}
+
+}  // namespace
+
+void SkScan::SparseTileFillPath(const SkPath& path,
+                                SkBlitter* blitter,
+                                const SkIRect& ir,
+                                const SkIRect& clipBounds) {
+    TRACE_EVENT0("skia", TRACE_FUNC);
+    SkASSERT(!path.isInverseFillType());
+
+    SkIRect bounds;
+    if (!bounds.intersect(ir, clipBounds)) {
+        return;
+    }
+    const int width = bounds.width(),
+              height = bounds.height();
+
+    // Clip and flatten the path into tiles, in coordinates relative to the bounds.
+    struct Context {
+        TileBinner fBinner;
+        SkVector fOffset;
+    } ctx = {TileBinner(width, height), SkVector::Make(bounds.fLeft, bounds.fTop)};
+    SkEdgeClipper::ClipPath(path, SkRect::Make(bounds), /*canCullToTheRight=*/true,
+                            [](SkEdgeClipper* clipper, bool, void* ctxPtr) {
+        auto ctx = static_cast<Context*>(ctxPtr);
+        SkPoint pts[4] = {};
+        SkPath::Verb verb;
+        while ((verb = clipper->next(pts)) != SkPath::kDone_Verb) {
+            for (SkPoint& p : pts) {
+                p -= ctx->fOffset;
+            }
+            switch (verb) {
+                case SkPath::kLine_Verb:  ctx->fBinner.addLine(pts[0], pts[1]); break;
+                case SkPath::kQuad_Verb:  ctx->fBinner.addQuad(pts);            break;
+                case SkPath::kCubic_Verb: ctx->fBinner.addCubic(pts);           break;
+                default: SkUNREACHABLE;
+            }
+        }
+    }, &ctx);
+
+    std::vector<Piece>& pieces = ctx.fBinner.pieces();
+    std::sort(pieces.begin(), pieces.end(), [](const Piece& a, const Piece& b) {
+        return a.fTile < b.fTile;
+    });
+
+    const bool evenOdd = path.getFillType() == SkPathFillType::kEvenOdd;
+    skia_private::AutoTMalloc<SkAlpha> alphaStorage(kTileHeight * width);
+    skia_private::AutoTMalloc<int16_t> runStorage(kTileHeight * (width + 1));
+    RowRuns rows[kTileHeight];
+    float acc[kTileWidth + 2][kTileHeight];
+
+    for (size_t i = 0; i < pieces.size();) {
+        const int tileRow = pieces[i].fTile >> 16;
+        for (int r = 0; r < kTileHeight; ++r) {
+            rows[r].reset(alphaStorage.get() + r * width, runStorage.get() + r * (width + 1));
+        }
+        auto add_span = [&](int x, int count, Rows winding) {
+            if (count > 0) {
+                const auto alpha = skvx::cast<uint8_t>(coverage(winding, evenOdd) * 255 + 0.5f);
+                for (int r = 0; r < kTileHeight; ++r) {
+                    rows[r].add(x, count, alpha[r]);
+                }
+            }
+        };
+
+        // Sweep the tiles in this row, carrying the winding from one to the next.
+        Rows winding = 0;
+        int x = 0;
+        for (; i < pieces.size() && (int)(pieces[i].fTile >> 16) == tileRow;) {
+            const uint32_t tile = pieces[i].fTile;
+            const int tileLeft = (int)(tile & 0xFFFF) * kTileWidth;
+            add_span(x, tileLeft - x, winding);
+
+            memset(acc, 0, sizeof(acc));
+            for (; i < pieces.size() && pieces[i].fTile == tile; ++i) {
+                accumulate(pieces[i], acc);
+            }
+            const int tileWidth = std::min(kTileWidth, width - tileLeft);
+            for (int column = 0; column < tileWidth; ++column) {
+                winding += Rows::Load(acc[column]);
+                add_span(tileLeft + column, 1, winding);
+            }
+            for (int column = tileWidth; column < kTileWidth + 2; ++column) {
+                winding += Rows::Load(acc[column]);
+            }
+            x = tileLeft + tileWidth;
+        }
+        // Past the last tile the winding is back to zero, unless the path was culled to the right
+        // of the clip.
+        add_span(x, width - x, winding);
+
+        const int top = bounds.fTop + tileRow * kTileHeight;
+        const int rowCount = std::min(kTileHeight, height - tileRow * kTileHeight);
+        for (int r = 0; r < rowCount; ++r) {
+            rows[r].blit(blitter, bounds.fLeft, top + r);
+        }
+    }
+}
@@ -29,7 +29,20 @@ namespace SkOpts {
                            RGB_to_BGR1,     // i.e. swap RB and insert an opaque alpha
                            gray_to_RGB1,    // i.e. expand to color channels + an opaque alpha
                            grayA_to_RGBA,   // i.e. expand to color channels
-                           grayA_to_rgbA;   // i.e. expand to color channels and premultiply
+                           grayA_to_rgbA,   // i.e. expand to color channels and premultiply
+                           RGB16_to_RGB1,   // i.e. keep the top byte of big-endian 16-bit
+                           RGB16_to_BGR1,   //      components, then as above
+                           RGBA16_to_RGBA,
+                           RGBA16_to_BGRA,
+                           RGBA16_to_rgbA,
+                           RGBA16_to_bgrA;
+
+    using Swizzle_8_u8 = void (*)(uint8_t*, const uint8_t*, int);
+    extern Swizzle_8_u8 grayA_to_A8;        // i.e. keep just the alpha
+
+    // Look up 8-bit indices in a 256 entry table of 8888 pixels.
+    using Swizzle_8888_index = void (*)(uint32_t*, const uint8_t*, int, const uint32_t*);
+    extern Swizzle_8888_index index_to_8888;
 
     void Init_Swizzler();
 }  // namespace SkOpts
@@ -7,7 +7,10 @@
 #include "src/core/SkTaskGroup.h"
 
 #include "include/core/SkExecutor.h"
+#include "src/base/SkArenaAlloc.h"
 
+#include <algorithm>
+#include <thread>
 #include <type_traits>
 #include <utility>
 
@@ -32,6 +35,36 @@ void SkTaskGroup::batch(int N, std::function<void(int)> fn) {
     }
 }
 
+void SkTaskGroup::parallelFor(int N, int grain,
+                              const std::function<void(int, int, SkArenaAlloc*)>& fn) {
+    if (N <= 0) {
+        this->wait();
+        return;
+    }
+    grain = std::max(grain, 1);
+    const int ranges = N / grain + (N % grain != 0);
+
+    // Everything the tasks share lives on our stack; the wait() below keeps it alive long enough.
+    std::atomic<int> nextRange{0};
+    auto work = [&] {
+        SkSTArenaAllocWithReset<4096> scratch;
+        for (int r; (r = nextRange.fetch_add(1, std::memory_order_relaxed)) < ranges;) {
+            const int start = r * grain;
+            fn(start, start + std::min(grain, N - start), &scratch);
+            scratch.reset();
+        }
+    };
+
+    // There's no point in more tasks than cores, and we're one of them.
+    const int cores = std::max<int>(std::thread::hardware_concurrency(), 1);
+    const int helpers = std::min(ranges, cores) - 1;
+    for (int i = 0; i < helpers; i++) {
+        this->add(work);
+    }
+    work();
+    this->wait();
+}
+
 bool SkTaskGroup::done() const {
     return fPending.load(std::memory_order_acquire) == 0;
 }
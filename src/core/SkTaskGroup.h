@@ -17,6 +17,8 @@
 #include <functional>
 #include <memory>
 
+class SkArenaAlloc;
+
 class SkTaskGroup : SkNoncopyable {
 public:
     // Tasks added to this SkTaskGroup will run on its executor.
@@ -29,6 +31,14 @@ public:
     // Add a batch of N tasks, all calling fn with different arguments.
     void batch(int N, std::function<void(int)> fn);
 
+    // Split [0, N) into consecutive ranges of at most grain items and call fn(start, end, scratch)
+    // once for each range, in parallel, returning once done(). The calling thread works on ranges
+    // too. Unlike batch(), only a few tasks are added to the executor however many ranges there
+    // are: each task keeps claiming ranges until none are left. Each task owns the scratch arena,
+    // which is reset after every range, so fn can take temporary buffers from it without any
+    // per-range heap allocation in the common case.
+    void parallelFor(int N, int grain, const std::function<void(int, int, SkArenaAlloc*)>& fn);
+
     // Returns true if all Tasks previously add()ed to this SkTaskGroup have run.
     // It is safe to reuse this SkTaskGroup once done().
     bool done() const;
@@ -14,6 +14,7 @@
 #include "include/core/SkColorType.h"
 #include "include/core/SkData.h"
 #include "include/core/SkDataTable.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkPixmap.h"
 #include "include/core/SkRefCnt.h"
@@ -32,6 +33,8 @@
 #include "src/encode/SkImageEncoderFns.h"
 #include "src/encode/SkImageEncoderPriv.h"
 #include "src/encode/SkPngEncoderBase.h"
+#include "src/encode/SkPngFilter.h"
+#include "src/encode/SkPngParallelDeflate.h"
 #include "src/image/SkImage_Base.h"
 
 #include <algorithm>
@@ -87,6 +90,8 @@ public:
     bool setColorSpace(const SkImageInfo& info, const SkPngEncoder::Options& options);
     bool setV0Gainmap(const SkPngEncoder::Options& options);
     bool writeInfo(const SkImageInfo& srcInfo);
+    // Writes a chunk directly, bypassing libpng's own bookkeeping.
+    bool writeChunk(const char* name, SkSpan<const uint8_t> data);
 
     png_structp pngPtr() { return fPngPtr; }
     png_infop infoPtr() { return fInfoPtr; }
@@ -391,18 +396,59 @@ bool SkPngEncoderMgr::writeInfo(const SkImageInfo& srcInfo) {
     return true;
 }
 
+bool SkPngEncoderMgr::writeChunk(const char* name, SkSpan<const uint8_t> data) {
+    if (setjmp(png_jmpbuf(fPngPtr))) {
+        return false;
+    }
+
+    png_write_chunk(fPngPtr, reinterpret_cast<png_const_bytep>(name), data.data(), data.size());
+    return true;
+}
+
 SkPngEncoderImpl::SkPngEncoderImpl(TargetInfo targetInfo,
                                    std::unique_ptr<SkPngEncoderMgr> encoderMgr,
-                                   const SkPixmap& src)
-        : SkPngEncoderBase(std::move(targetInfo), src), fEncoderMgr(std::move(encoderMgr)) {}
+                                   std::unique_ptr<SkPngParallelDeflate> parallelDeflate,
+                                   const SkPixmap& src,
+                                   int bytesPerPixel,
+                                   int filters,
+                                   SkPngEncoder::FilterSelection filterSelection)
+        : SkPngEncoderBase(std::move(targetInfo), src)
+        , fEncoderMgr(std::move(encoderMgr))
+        , fParallelDeflate(std::move(parallelDeflate))
+        , fBytesPerPixel(bytesPerPixel)
+        , fFilters(!fParallelDeflate && SkPngFilter::HasChoice(filters) ? filters : 0)
+        , fFilterSelection(filterSelection) {}
 
 SkPngEncoderImpl::~SkPngEncoderImpl() {}
 
 bool SkPngEncoderImpl::onEncodeRow(SkSpan<const uint8_t> row) {
+    if (fParallelDeflate) {
+        return fParallelDeflate->addRow(row);
+    }
+
     if (setjmp(png_jmpbuf(fEncoderMgr->pngPtr()))) {
         return false;
     }
 
+    if (fFilters) {
+        if (fCurrRow == 0) {
+            fPriorRow.assign(row.size(), 0);
+        }
+        if (fFilterSelection == SkPngEncoder::FilterSelection::kPerRow ||
+            fCurrRow % SkPngFilter::kSampleInterval == 0) {
+            fFilterType = SkPngFilter::Choose(
+                    fFilters, row.data(), fPriorRow.data(), row.size(), fBytesPerPixel);
+        }
+        // libpng makes the same choice for the first row, and only allocates its copy of the
+        // previous row (needed by Up, Avg and Paeth) if it starts out with those filters allowed.
+        if (fCurrRow > 0) {
+            png_set_filter(fEncoderMgr->pngPtr(),
+                           PNG_FILTER_TYPE_BASE,
+                           SkPngFilter::Flag(fFilterType));
+        }
+        memcpy(fPriorRow.data(), row.data(), row.size());
+    }
+
     // `png_bytep` is `uint8_t*` rather than `const uint8_t*`.
     png_bytep rowPtr = const_cast<png_bytep>(row.data());
 
@@ -411,6 +457,12 @@ bool SkPngEncoderImpl::onEncodeRow(SkSpan<const uint8_t> row) {
 }
 
 bool SkPngEncoderImpl::onFinishEncoding() {
+    if (fParallelDeflate) {
+        // libpng never saw the IDAT chunks, so png_write_end() would fail. Nothing is written
+        // after them but IEND.
+        return fEncoderMgr->writeChunk("IEND", {});
+    }
+
     if (setjmp(png_jmpbuf(fEncoderMgr->pngPtr()))) {
         return false;
     }
@@ -452,7 +504,35 @@ std::unique_ptr<SkEncoder> Make(SkWStream* dst, const SkPixmap& src, const Optio
         return nullptr;
     }
 
-    return std::make_unique<SkPngEncoderImpl>(std::move(*targetInfo), std::move(encoderMgr), src);
+    const int bytesPerPixel = std::max(targetInfo->fDstInfo.bitsPerPixel() / 8, 1);
+    int filters = (int)options.fFilterFlags;
+    if (src.width() == 1) {
+        // Like libpng, don't bother predicting from the left in a single column.
+        filters &= ~(int)(SkPngEncoder::FilterFlag::kSub | SkPngEncoder::FilterFlag::kAvg |
+                          SkPngEncoder::FilterFlag::kPaeth);
+    }
+
+    std::unique_ptr<SkPngParallelDeflate> parallelDeflate;
+    if (options.fExecutor) {
+        SkPngEncoderMgr* mgr = encoderMgr.get();
+        parallelDeflate = SkPngParallelDeflate::Make(
+                *options.fExecutor,
+                targetInfo->fDstRowSize,
+                bytesPerPixel,
+                src.height(),
+                filters,
+                options.fFilterSelection,
+                std::clamp(options.fZLibLevel, 0, 9),
+                [mgr](SkSpan<const uint8_t> idat) { return mgr->writeChunk("IDAT", idat); });
+    }
+
+    return std::make_unique<SkPngEncoderImpl>(std::move(*targetInfo),
+                                              std::move(encoderMgr),
+                                              std::move(parallelDeflate),
+                                              src,
+                                              bytesPerPixel,
+                                              filters,
+                                              options.fFilterSelection);
 }
 
 bool Encode(SkWStream* dst, const SkPixmap& src, const Options& options) {
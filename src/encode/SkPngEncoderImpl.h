@@ -10,19 +10,29 @@
 
 #include <cstdint>
 
+#include "include/encode/SkPngEncoder.h"
 #include "src/encode/SkPngEncoderBase.h"
+#include "src/encode/SkPngFilter.h"
 
 #include <memory>
+#include <vector>
 
 class SkPixmap;
 class SkPngEncoderMgr;
+class SkPngParallelDeflate;
 template <typename T> class SkSpan;
 
 class SkPngEncoderImpl final : public SkPngEncoderBase {
 public:
     // public so it can be called from SkPngEncoder namespace. It should only be made
     // via SkPngEncoder::Make
-    SkPngEncoderImpl(TargetInfo targetInfo, std::unique_ptr<SkPngEncoderMgr>, const SkPixmap& src);
+    SkPngEncoderImpl(TargetInfo targetInfo,
+                     std::unique_ptr<SkPngEncoderMgr>,
+                     std::unique_ptr<SkPngParallelDeflate>,
+                     const SkPixmap& src,
+                     int bytesPerPixel,
+                     int filters,
+                     SkPngEncoder::FilterSelection);
     ~SkPngEncoderImpl() override;
 
 protected:
@@ -30,5 +40,16 @@ protected:
     bool onFinishEncoding() override;
 
     std::unique_ptr<SkPngEncoderMgr> fEncoderMgr;
+    // If set, compresses the image data in place of libpng.
+    std::unique_ptr<SkPngParallelDeflate> fParallelDeflate;
+
+    // When there are filters to choose between, they're chosen here rather than by libpng, which
+    // is told which one to apply to each row. Otherwise fFilters is zero.
+    const int                           fBytesPerPixel;
+    const int                           fFilters;
+    const SkPngEncoder::FilterSelection fFilterSelection;
+    SkPngFilter::Type                   fFilterType = SkPngFilter::kNone;
+    // The previous unfiltered row, which the Up, Avg and Paeth filters predict from.
+    std::vector<uint8_t>                fPriorRow;
 };
 #endif
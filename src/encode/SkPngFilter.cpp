@@ -0,0 +1,248 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/encode/SkPngFilter.h"
+
+#include "include/private/base/SkAssert.h"
+#include "include/private/base/SkFeatures.h"
+#include "include/private/base/SkTo.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+    #include <emmintrin.h>
+#elif defined(SK_ARM_HAS_NEON)
+    #include <arm_neon.h>
+#endif
+
+namespace SkPngFilter {
+namespace {
+
+// Every predictor works on unsigned bytes, with a the byte to the left, b the one above and c the
+// one above and to the left (zero past the left edge).
+
+uint8_t sub(uint8_t x, uint8_t y) { return x - y; }
+
+uint8_t avg_predictor(uint8_t a, uint8_t b) { return (a + b) >> 1; }
+
+uint8_t paeth_predictor(int a, int b, int c) {
+    const int p = a + b - c,
+              pa = std::abs(p - a),
+              pb = std::abs(p - b),
+              pc = std::abs(p - c);
+    return (pa <= pb && pa <= pc) ? a : (pb <= pc ? b : c);
+}
+
+// libpng's cost of a filtered byte: its magnitude as a signed value.
+int cost(uint8_t filtered) { return filtered < 128 ? filtered : 256 - filtered; }
+
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2 || defined(SK_ARM_HAS_NEON)
+    #define SK_PNG_FILTER_SIMD
+
+    // The few operations on 16 unsigned bytes that the filters and their costs need.
+    #if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+        using V = __m128i;
+
+        V load(const uint8_t* p) { return _mm_loadu_si128((const __m128i*)p); }
+        void store(uint8_t* p, V v) { _mm_storeu_si128((__m128i*)p, v); }
+
+        V sub(V x, V y) { return _mm_sub_epi8(x, y); }
+        V saturated_add(V x, V y) { return _mm_adds_epu8(x, y); }
+        V abs_diff(V x, V y) { return _mm_or_si128(_mm_subs_epu8(x, y), _mm_subs_epu8(y, x)); }
+        V min(V x, V y) { return _mm_min_epu8(x, y); }
+        // (x + y) / 2, rounded down; _mm_avg_epu8() rounds up.
+        V halving_add(V x, V y) {
+            return sub(_mm_avg_epu8(x, y), _mm_and_si128(_mm_xor_si128(x, y), _mm_set1_epi8(1)));
+        }
+
+        // Masks are all ones or all zeros in each lane.
+        V less_or_equal(V x, V y) { return _mm_cmpeq_epi8(_mm_min_epu8(x, y), x); }
+        V equal(V x, V y) { return _mm_cmpeq_epi8(x, y); }
+        V select(V mask, V t, V e) {
+            return _mm_or_si128(_mm_and_si128(mask, t), _mm_andnot_si128(mask, e));
+        }
+
+        // Sums bytes into 64-bit lanes, which can't overflow.
+        class Sum {
+        public:
+            void add(V bytes) {
+                fSum = _mm_add_epi64(fSum, _mm_sad_epu8(bytes, _mm_setzero_si128()));
+            }
+            uint64_t total() const {
+                uint64_t lanes[2];
+                _mm_storeu_si128((__m128i*)lanes, fSum);
+                return lanes[0] + lanes[1];
+            }
+        private:
+            __m128i fSum = _mm_setzero_si128();
+        };
+    #else
+        using V = uint8x16_t;
+
+        V load(const uint8_t* p) { return vld1q_u8(p); }
+        void store(uint8_t* p, V v) { vst1q_u8(p, v); }
+
+        V sub(V x, V y) { return vsubq_u8(x, y); }
+        V saturated_add(V x, V y) { return vqaddq_u8(x, y); }
+        V abs_diff(V x, V y) { return vabdq_u8(x, y); }
+        V min(V x, V y) { return vminq_u8(x, y); }
+        V halving_add(V x, V y) { return vhaddq_u8(x, y); }
+
+        V less_or_equal(V x, V y) { return vcleq_u8(x, y); }
+        V equal(V x, V y) { return vceqq_u8(x, y); }
+        V select(V mask, V t, V e) { return vbslq_u8(mask, t, e); }
+
+        // Sums bytes pairwise into 32-bit lanes, which would take a 64MB row to overflow.
+        class Sum {
+        public:
+            void add(V bytes) { fSum = vpadalq_u16(fSum, vpaddlq_u8(bytes)); }
+            uint64_t total() const {
+                const uint64x2_t lanes = vpaddlq_u32(fSum);
+                return vgetq_lane_u64(lanes, 0) + vgetq_lane_u64(lanes, 1);
+            }
+        private:
+            uint32x4_t fSum = vdupq_n_u32(0);
+        };
+    #endif
+
+    constexpr size_t kLanes = 16;
+
+    V avg_predictor(V a, V b) { return halving_add(a, b); }
+
+    V paeth_predictor(V a, V b, V c) {
+        // pa = |b - c| and pb = |a - c| fit in a byte. pc = |(b - c) + (a - c)| is their sum when
+        // those have the same sign, and otherwise their difference. Saturating the sum doesn't
+        // change any comparison: pc is still at least pa and pb.
+        const V pa = abs_diff(b, c),
+                pb = abs_diff(a, c),
+                sameSign = equal(less_or_equal(c, b), less_or_equal(c, a)),
+                pc = select(sameSign, saturated_add(pa, pb), abs_diff(pa, pb));
+        return select(equal(min(min(pa, pb), pc), pa), a,
+                      select(less_or_equal(pb, pc), b, c));
+    }
+
+    V cost(V filtered) {
+        return min(filtered, sub(sub(filtered, filtered), filtered));
+    }
+#endif
+
+template <Type kType, typename T>
+T filter(T x, T a, T b, T c) {
+    switch (kType) {
+        case kNone:  return x;
+        case kSub:   return sub(x, a);
+        case kUp:    return sub(x, b);
+        case kAvg:   return sub(x, avg_predictor(a, b));
+        case kPaeth: return sub(x, paeth_predictor(a, b, c));
+    }
+    SkUNREACHABLE;
+}
+
+template <Type kType>
+void apply(const uint8_t* row, const uint8_t* prior, size_t rowBytes, int bpp, uint8_t* dst) {
+    const size_t left = std::min(SkToSizeT(bpp), rowBytes);
+    size_t i = 0;
+    for (; i < left; i++) {
+        dst[i] = filter<kType, uint8_t>(row[i], 0, prior[i], 0);
+    }
+#if defined(SK_PNG_FILTER_SIMD)
+    for (; i + kLanes <= rowBytes; i += kLanes) {
+        store(dst + i, filter<kType>(load(row + i), load(row + i - bpp),
+                                     load(prior + i), load(prior + i - bpp)));
+    }
+#endif
+    for (; i < rowBytes; i++) {
+        dst[i] = filter<kType, uint8_t>(row[i], row[i - bpp], prior[i], prior[i - bpp]);
+    }
+}
+
+}  // namespace
+
+void Apply(Type type, const uint8_t* row, const uint8_t* prior, size_t rowBytes, int bpp,
+           uint8_t* dst) {
+    SkASSERT(bpp >= 1);
+    switch (type) {
+        case kNone:  memcpy(dst, row, rowBytes);                    return;
+        case kSub:   apply<kSub>  (row, prior, rowBytes, bpp, dst); return;
+        case kUp:    apply<kUp>   (row, prior, rowBytes, bpp, dst); return;
+        case kAvg:   apply<kAvg>  (row, prior, rowBytes, bpp, dst); return;
+        case kPaeth: apply<kPaeth>(row, prior, rowBytes, bpp, dst); return;
+    }
+    SkUNREACHABLE;
+}
+
+void SumCosts(const uint8_t* row, const uint8_t* prior, size_t rowBytes, int bpp,
+              uint64_t costs[kTypeCount]) {
+    SkASSERT(bpp >= 1);
+    std::fill(costs, costs + kTypeCount, 0);
+    auto add_byte = [&](uint8_t x, uint8_t a, uint8_t b, uint8_t c) {
+        costs[kNone]  += cost(filter<kNone>(x, a, b, c));
+        costs[kSub]   += cost(filter<kSub>(x, a, b, c));
+        costs[kUp]    += cost(filter<kUp>(x, a, b, c));
+        costs[kAvg]   += cost(filter<kAvg>(x, a, b, c));
+        costs[kPaeth] += cost(filter<kPaeth>(x, a, b, c));
+    };
+
+    const size_t left = std::min(SkToSizeT(bpp), rowBytes);
+    size_t i = 0;
+    for (; i < left; i++) {
+        add_byte(row[i], 0, prior[i], 0);
+    }
+
+#if defined(SK_PNG_FILTER_SIMD)
+    Sum noneSum, subSum, upSum, avgSum, paethSum;
+    for (; i + kLanes <= rowBytes; i += kLanes) {
+        const V x = load(row + i),
+                a = load(row + i - bpp),
+                b = load(prior + i),
+                c = load(prior + i - bpp);
+        noneSum .add(cost(filter<kNone> (x, a, b, c)));
+        subSum  .add(cost(filter<kSub>  (x, a, b, c)));
+        upSum   .add(cost(filter<kUp>   (x, a, b, c)));
+        avgSum  .add(cost(filter<kAvg>  (x, a, b, c)));
+        paethSum.add(cost(filter<kPaeth>(x, a, b, c)));
+    }
+    costs[kNone]  += noneSum.total();
+    costs[kSub]   += subSum.total();
+    costs[kUp]    += upSum.total();
+    costs[kAvg]   += avgSum.total();
+    costs[kPaeth] += paethSum.total();
+#endif
+
+    for (; i < rowBytes; i++) {
+        add_byte(row[i], row[i - bpp], prior[i], prior[i - bpp]);
+    }
+}
+
+Type Choose(int filters, const uint8_t* row, const uint8_t* prior, size_t rowBytes, int bpp) {
+    int allowed = 0;
+    Type type = kNone;
+    for (int t = 0; t < kTypeCount; t++) {
+        if (filters & Flag(t)) {
+            allowed++;
+            type = (Type)t;
+        }
+    }
+    if (allowed <= 1) {
+        return allowed ? type : kNone;
+    }
+
+    uint64_t costs[kTypeCount];
+    SumCosts(row, prior, rowBytes, bpp, costs);
+    uint64_t bestCost = UINT64_MAX;
+    for (int t = 0; t < kTypeCount; t++) {
+        if ((filters & Flag(t)) && costs[t] < bestCost) {
+            bestCost = costs[t];
+            type = (Type)t;
+        }
+    }
+    return type;
+}
+
+}  // namespace SkPngFilter
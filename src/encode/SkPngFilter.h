@@ -0,0 +1,50 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkPngFilter_DEFINED
+#define SkPngFilter_DEFINED
+
+#include <cstddef>
+#include <cstdint>
+
+// PNG's row filters (https://www.w3.org/TR/png-3/#9Filters), and a vectorized version of
+// libpng's heuristic for choosing between them.
+//
+// In all of these, `prior` is the unfiltered row above `row` (all zeros for the first row of the
+// image), and `bpp` is the distance in bytes to the corresponding byte of the pixel to the left,
+// at least 1.
+namespace SkPngFilter {
+
+enum Type : uint8_t { kNone, kSub, kUp, kAvg, kPaeth };
+inline constexpr int kTypeCount = 5;
+
+// The SkPngEncoder::FilterFlag (and libpng PNG_FILTER_*) bit for each filter type.
+constexpr int Flag(int type) { return 0x08 << type; }
+
+// Whether `filters` (SkPngEncoder::FilterFlag bits) allows more than one filter type.
+constexpr bool HasChoice(int filters) { return (filters & (filters - 1)) != 0; }
+
+// With SkPngEncoder::FilterSelection::kSampled, each row whose index is a multiple of this
+// chooses the filter for itself and the rows after it.
+inline constexpr int kSampleInterval = 8;
+
+// Writes `row` filtered with `type` to dst (without the filter type byte).
+void Apply(Type, const uint8_t* row, const uint8_t* prior, size_t rowBytes, int bpp,
+           uint8_t* dst);
+
+// Sums libpng's estimate of how well the row will compress with each filter type, the magnitude
+// of every filtered byte as a signed value, in a single pass over the row.
+void SumCosts(const uint8_t* row, const uint8_t* prior, size_t rowBytes, int bpp,
+              uint64_t costs[kTypeCount]);
+
+// Chooses the allowed filter (SkPngEncoder::FilterFlag bits) with the lowest cost, breaking ties
+// in favor of the lower type, exactly like libpng does. No filters at all means kNone.
+Type Choose(int filters, const uint8_t* row, const uint8_t* prior, size_t rowBytes, int bpp);
+
+}  // namespace SkPngFilter
+
+#endif  // SkPngFilter_DEFINED
@@ -0,0 +1,286 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/encode/SkPngParallelDeflate.h"
+
+#include "include/core/SkExecutor.h"
+#include "include/private/base/SkAssert.h"
+#include "include/private/base/SkTFitsIn.h"
+#include "include/private/base/SkTo.h"
+#include "src/core/SkTraceEvent.h"
+#include "src/encode/SkPngFilter.h"
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <thread>
+#include <utility>
+
+#include "zlib.h"  // NO_G3_REWRITE
+
+namespace {
+
+// Input per band: big enough that the sync flush and priming between bands cost little, small
+// enough to spread a modest image over several threads. (pigz uses 128KB.)
+constexpr size_t kBandBytes = 256 << 10;
+
+// Deflate's window: each band is primed with this much of the filtered data before it.
+constexpr size_t kWindowBytes = 32 << 10;
+
+// The two byte zlib stream header, for a 32KB window and compression level hint as zlib writes.
+void write_zlib_header(int zlibLevel, uint8_t* dst) {
+    const int levelFlags = zlibLevel < 2 ? 0 : zlibLevel < 6 ? 1 : zlibLevel == 6 ? 2 : 3;
+    const int cmf = 0x78;
+    int flg = levelFlags << 6;
+    flg += 31 - ((cmf << 8) + flg) % 31;
+    dst[0] = cmf;
+    dst[1] = SkToU8(flg);
+}
+
+}  // namespace
+
+struct SkPngParallelDeflate::Band {
+    // Unfiltered rows: fContextRows rows from before the band, then its own.
+    std::vector<uint8_t> fRows;
+    int fContextRows = 0;
+    // The index in the image of the first of fRows.
+    int fFirstRow = 0;
+    bool fFirst = false;
+    bool fLast = false;
+
+    // Written by the band's task.
+    std::vector<uint8_t> fOutput;
+    uint32_t fAdler = 1;
+    size_t fFilteredBytes = 0;
+    bool fSucceeded = false;
+    std::atomic<bool> fDone{false};
+
+    bool compress(size_t rowBytes,
+                  int bpp,
+                  int filters,
+                  SkPngEncoder::FilterSelection,
+                  int zlibLevel);
+};
+
+std::unique_ptr<SkPngParallelDeflate> SkPngParallelDeflate::Make(SkExecutor& executor,
+                                                                 size_t rowBytes,
+                                                                 int bytesPerPixel,
+                                                                 int height,
+                                                                 int filters,
+                                                                 FilterSelection filterSelection,
+                                                                 int zlibLevel,
+                                                                 WriteProc write) {
+    if (rowBytes == 0 || bytesPerPixel <= 0 || !SkTFitsIn<uInt>(rowBytes + 1)) {
+        return nullptr;
+    }
+    const size_t rowsPerBand = std::max<size_t>(kBandBytes / rowBytes, 1);
+    if (height <= 0 || SkToSizeT(height) <= rowsPerBand) {
+        return nullptr;
+    }
+    return std::unique_ptr<SkPngParallelDeflate>(new SkPngParallelDeflate(executor,
+                                                                         rowBytes,
+                                                                         bytesPerPixel,
+                                                                         height,
+                                                                         SkToInt(rowsPerBand),
+                                                                         filters,
+                                                                         filterSelection,
+                                                                         zlibLevel,
+                                                                         std::move(write)));
+}
+
+SkPngParallelDeflate::SkPngParallelDeflate(SkExecutor& executor,
+                                           size_t rowBytes,
+                                           int bytesPerPixel,
+                                           int height,
+                                           int rowsPerBand,
+                                           int filters,
+                                           FilterSelection filterSelection,
+                                           int zlibLevel,
+                                           WriteProc write)
+        : fExecutor(executor)
+        , fRowBytes(rowBytes)
+        , fBytesPerPixel(bytesPerPixel)
+        , fHeight(height)
+        , fRowsPerBand(rowsPerBand)
+        // Enough filtered rows to fill the window, and the rows before them that their filters
+        // may be chosen from (including the row above the sampled one).
+        , fContextRows(SkToInt((kWindowBytes + rowBytes) / (rowBytes + 1)) +
+                       SkPngFilter::kSampleInterval)
+        , fFilters(filters)
+        , fFilterSelection(filterSelection)
+        , fZLibLevel(zlibLevel)
+        , fWrite(std::move(write))
+        // Enough bands to keep every core busy while the oldest is waited on and written.
+        , fMaxBandsInFlight(2 * std::max<int>(std::thread::hardware_concurrency(), 1))
+        , fAdler(adler32(0, nullptr, 0))
+        , fTaskGroup(executor) {}
+
+SkPngParallelDeflate::~SkPngParallelDeflate() = default;
+
+bool SkPngParallelDeflate::addRow(SkSpan<const uint8_t> row) {
+    SkASSERT(row.size() == fRowBytes);
+    if (fFailed || fRowsAdded == fHeight) {
+        return false;
+    }
+
+    if (!fCurrentBand) {
+        fCurrentBand = std::make_unique<Band>();
+        Band* band = fCurrentBand.get();
+        band->fRows = fContext;
+        band->fRows.reserve(fContext.size() + fRowsPerBand * fRowBytes);
+        band->fContextRows = SkToInt(fContext.size() / fRowBytes);
+        band->fFirstRow = fRowsAdded - band->fContextRows;
+        band->fFirst = fRowsAdded == 0;
+    }
+    fCurrentBand->fRows.insert(fCurrentBand->fRows.end(), row.begin(), row.end());
+    fRowsAdded++;
+
+    const size_t rows = fCurrentBand->fRows.size() / fRowBytes;
+    if (SkToInt(rows) - fCurrentBand->fContextRows == fRowsPerBand || fRowsAdded == fHeight) {
+        this->submit();
+    }
+
+    if (fRowsAdded == fHeight) {
+        while (!fFailed && !fBandsInFlight.empty()) {
+            fFailed = !this->writeOldestBand();
+        }
+    }
+    return !fFailed;
+}
+
+void SkPngParallelDeflate::submit() {
+    std::unique_ptr<Band> band = std::move(fCurrentBand);
+    band->fLast = fRowsAdded == fHeight;
+
+    // The next band starts with the last few of this band's rows.
+    const size_t contextBytes = std::min(fContextRows * fRowBytes, band->fRows.size());
+    fContext.assign(band->fRows.end() - contextBytes, band->fRows.end());
+
+    Band* task = band.get();
+    fBandsInFlight.push_back(std::move(band));
+    fTaskGroup.add([task, rowBytes = fRowBytes, bpp = fBytesPerPixel, filters = fFilters,
+                    filterSelection = fFilterSelection, zlibLevel = fZLibLevel] {
+        task->fSucceeded = task->compress(rowBytes, bpp, filters, filterSelection, zlibLevel);
+        task->fDone.store(true, std::memory_order_release);
+    });
+
+    while (!fFailed && SkToInt(fBandsInFlight.size()) > fMaxBandsInFlight) {
+        fFailed = !this->writeOldestBand();
+    }
+}
+
+bool SkPngParallelDeflate::writeOldestBand() {
+    SkASSERT(!fBandsInFlight.empty());
+    std::unique_ptr<Band> band = std::move(fBandsInFlight.front());
+    fBandsInFlight.pop_front();
+
+    // Like SkTaskGroup::wait(), help out rather than block. But only this band's task will do,
+    // so don't spin while it holds the core we're on.
+    while (!band->fDone.load(std::memory_order_acquire)) {
+        fExecutor.borrow();
+        std::this_thread::yield();
+    }
+    if (!band->fSucceeded) {
+        return false;
+    }
+
+    fAdler = adler32_combine(fAdler, band->fAdler, band->fFilteredBytes);
+    if (band->fLast) {
+        const uint8_t trailer[4] = {SkToU8(fAdler >> 24), SkToU8((fAdler >> 16) & 0xFF),
+                                    SkToU8((fAdler >> 8) & 0xFF), SkToU8(fAdler & 0xFF)};
+        band->fOutput.insert(band->fOutput.end(), trailer, trailer + 4);
+    }
+    return fWrite(band->fOutput);
+}
+
+bool SkPngParallelDeflate::Band::compress(size_t rowBytes,
+                                          int bpp,
+                                          int filters,
+                                          SkPngEncoder::FilterSelection filterSelection,
+                                          int zlibLevel) {
+    TRACE_EVENT0("skia", TRACE_FUNC);
+    const int rows = SkToInt(fRows.size() / rowBytes);
+    const size_t filteredRowBytes = rowBytes + 1;
+
+    // Only the context rows that end up in the dictionary need filtering, and each needs the row
+    // above it (zeros above the top of the image).
+    const int windowRows = SkToInt((kWindowBytes + rowBytes) / filteredRowBytes);
+    const int firstRow = std::max(fContextRows - windowRows, fFirstRow == 0 ? 0 : 1);
+    std::vector<uint8_t> zeros(fFirstRow == 0 ? rowBytes : 0);
+    auto row = [&](int y) { return fRows.data() + y * rowBytes; };
+    auto prior = [&](int y) { return y > 0 ? row(y - 1) : zeros.data(); };
+
+    std::vector<uint8_t> filtered(rows * filteredRowBytes);
+    SkPngFilter::Type type = SkPngFilter::kNone;
+    for (int y = firstRow; y < rows; y++) {
+        // With kSampled, the rows between samples reuse the last sample's choice, which may be
+        // from before firstRow.
+        const int sinceSample = (fFirstRow + y) % SkPngFilter::kSampleInterval;
+        if (filterSelection == SkPngEncoder::FilterSelection::kPerRow) {
+            type = SkPngFilter::Choose(filters, row(y), prior(y), rowBytes, bpp);
+        } else if (y == firstRow || sinceSample == 0) {
+            const int sample = y - sinceSample;
+            SkASSERT(sample >= 1 || fFirstRow + sample == 0);
+            type = SkPngFilter::Choose(filters, row(sample), prior(sample), rowBytes, bpp);
+        }
+        uint8_t* dst = filtered.data() + y * filteredRowBytes;
+        dst[0] = type;
+        SkPngFilter::Apply(type, row(y), prior(y), rowBytes, bpp, dst + 1);
+    }
+
+    const size_t contextBytes = fContextRows * filteredRowBytes;
+    const uint8_t* input = filtered.data() + contextBytes;
+    const size_t inputBytes = filtered.size() - contextBytes;
+    if (!SkTFitsIn<uInt>(inputBytes)) {
+        return false;
+    }
+    fFilteredBytes = inputBytes;
+    fAdler = adler32(fAdler, input, SkToUInt(inputBytes));
+
+    // Raw deflate, to be joined into one zlib stream, using libpng's strategy for filtered data.
+    z_stream stream = {};
+    const int strategy =
+            (filters & ~SkPngFilter::Flag(SkPngFilter::kNone)) ? Z_FILTERED : Z_DEFAULT_STRATEGY;
+    if (Z_OK != deflateInit2(&stream, zlibLevel, Z_DEFLATED, -15, 8, strategy)) {
+        return false;
+    }
+    const size_t dictionaryStart = SkToSizeT(firstRow) * filteredRowBytes;
+    if (contextBytes > dictionaryStart) {
+        const size_t dictionaryBytes = std::min(contextBytes - dictionaryStart, kWindowBytes);
+        deflateSetDictionary(&stream, input - dictionaryBytes, SkToUInt(dictionaryBytes));
+    }
+
+    const size_t headerBytes = fFirst ? 2 : 0;
+    // Room for everything, including the sync flush's empty stored block.
+    fOutput.resize(headerBytes + deflateBound(&stream, static_cast<uLong>(inputBytes)) + 16);
+    if (fFirst) {
+        write_zlib_header(zlibLevel, fOutput.data());
+    }
+
+    stream.next_in = const_cast<uint8_t*>(input);
+    stream.avail_in = SkToUInt(inputBytes);
+    size_t written = headerBytes;
+    const int flush = fLast ? Z_FINISH : Z_SYNC_FLUSH;
+    bool succeeded = true;
+    for (;;) {
+        stream.next_out = fOutput.data() + written;
+        stream.avail_out = SkToUInt(std::min<size_t>(fOutput.size() - written, UINT_MAX));
+        const int result = deflate(&stream, flush);
+        written = stream.next_out - fOutput.data();
+        if (result == Z_STREAM_ERROR) {
+            succeeded = false;
+            break;
+        }
+        if (fLast ? result == Z_STREAM_END : stream.avail_out != 0) {
+            break;
+        }
+        fOutput.resize(fOutput.size() + fOutput.size() / 2);
+    }
+    deflateEnd(&stream);
+    fOutput.resize(written);
+    return succeeded;
+}
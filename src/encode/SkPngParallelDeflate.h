@@ -0,0 +1,105 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkPngParallelDeflate_DEFINED
+#define SkPngParallelDeflate_DEFINED
+
+#include "include/core/SkSpan.h"
+#include "include/encode/SkPngEncoder.h"
+#include "src/core/SkTaskGroup.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <vector>
+
+class SkExecutor;
+
+/**
+ *  Filters and compresses PNG image data on an SkExecutor, like pigz does for gzip: rows are cut
+ *  into bands of about 256KB, and each band is filtered and deflated on its own, primed with the
+ *  last 32KB of filtered data before it. Every band but the last ends with a sync flush, so the
+ *  compressed bands concatenate into a single zlib stream, whose adler32 is combined from the
+ *  bands' own.
+ *
+ *  Bands are handed back in order as they finish, so the stream is written while later bands are
+ *  still being compressed, and only a bounded number of bands are held in memory at once.
+ */
+class SkPngParallelDeflate {
+public:
+    // Called in order with each piece of the zlib stream, which should become an IDAT chunk.
+    using WriteProc = std::function<bool(SkSpan<const uint8_t>)>;
+    using FilterSelection = SkPngEncoder::FilterSelection;
+
+    /**
+     *  Returns nullptr if an image of this size would not be split into at least two bands.
+     *
+     *  @param rowBytes      Size of a row of unfiltered image data.
+     *  @param bytesPerPixel Distance to the corresponding byte of the pixel to the left, as used
+     *                       by the Sub, Avg and Paeth filters.
+     *  @param filters       SkPngEncoder::FilterFlag bits to choose between, as in libpng.
+     *  @param filterSelection How often to choose between them.
+     */
+    static std::unique_ptr<SkPngParallelDeflate> Make(SkExecutor&,
+                                                      size_t rowBytes,
+                                                      int bytesPerPixel,
+                                                      int height,
+                                                      int filters,
+                                                      FilterSelection filterSelection,
+                                                      int zlibLevel,
+                                                      WriteProc);
+
+    ~SkPngParallelDeflate();
+
+    // Queues the next row (rowBytes of unfiltered data) to be compressed. Once the last row has
+    // been added, this waits for the rest of the stream to be written.
+    bool addRow(SkSpan<const uint8_t> row);
+
+private:
+    struct Band;
+
+    SkPngParallelDeflate(SkExecutor&,
+                         size_t rowBytes,
+                         int bytesPerPixel,
+                         int height,
+                         int rowsPerBand,
+                         int filters,
+                         FilterSelection,
+                         int zlibLevel,
+                         WriteProc);
+
+    void submit();
+    bool writeOldestBand();
+
+    SkExecutor&           fExecutor;
+    const size_t          fRowBytes;
+    const int             fBytesPerPixel;
+    const int             fHeight;
+    const int             fRowsPerBand;
+    const int             fContextRows;
+    const int             fFilters;
+    const FilterSelection fFilterSelection;
+    const int             fZLibLevel;
+    WriteProc             fWrite;
+    const int             fMaxBandsInFlight;
+
+    int                   fRowsAdded = 0;
+    std::unique_ptr<Band> fCurrentBand;
+    // Unfiltered rows from the end of the last band submitted, to start the next one with.
+    std::vector<uint8_t>  fContext;
+
+    std::deque<std::unique_ptr<Band>> fBandsInFlight;
+    uint32_t                          fAdler;
+    bool                              fFailed = false;
+
+    // Declared last, so that its destructor waits for the bands' tasks before they're freed.
+    SkTaskGroup fTaskGroup;
+};
+
+#endif  // SkPngParallelDeflate_DEFINED
@@ -14,13 +14,18 @@
 #include "include/core/SkPixmap.h"
 #include "include/core/SkSize.h"
 #include "include/core/SkSurface.h"
+#include "include/core/SkTraceMemoryDump.h"
 #include "include/core/SkYUVAInfo.h"
+#include "include/private/base/SkSemaphore.h"
+#include "src/base/SkScopeExit.h"
+#include "src/base/SkTime.h"
 #include "src/core/SkBitmapCache.h"
 #include "src/core/SkCachedData.h"
 #include "src/core/SkNextID.h"
 #include "src/core/SkResourceCache.h"
 #include "src/core/SkYUVPlanesCache.h"
 
+#include <atomic>
 #include <utility>
 
 class SkSurfaceProps;
@@ -40,6 +45,44 @@ const SkImageInfo& SharedGenerator::getInfo() const { return fGenerator->getInfo
 
 bool SharedGenerator::isTextureGenerator() { return fGenerator->isTextureGenerator(); }
 
+class SharedGenerator::PendingDecode : public SkNVRefCnt<PendingDecode> {
+public:
+    SkSemaphore fDone;
+    int         fWaiters = 0;  // Guarded by SharedGenerator::fPendingMutex.
+};
+
+namespace {
+struct AtomicDecodeStats {
+    std::atomic<int64_t> fCacheHits{0},
+                         fCacheMisses{0},
+                         fDecodes{0},
+                         fSubsetDecodes{0},
+                         fSharedDecodes{0},
+                         fWaitNanos{0};
+};
+AtomicDecodeStats gDecodeStats;
+}  // namespace
+
+SkImage_Lazy::DecodeStats SkImage_Lazy::GetDecodeStats() {
+    return {gDecodeStats.fCacheHits.load(std::memory_order_relaxed),
+            gDecodeStats.fCacheMisses.load(std::memory_order_relaxed),
+            gDecodeStats.fDecodes.load(std::memory_order_relaxed),
+            gDecodeStats.fSubsetDecodes.load(std::memory_order_relaxed),
+            gDecodeStats.fSharedDecodes.load(std::memory_order_relaxed),
+            gDecodeStats.fWaitNanos.load(std::memory_order_relaxed)};
+}
+
+void SkImage_Lazy::DumpMemoryStatistics(SkTraceMemoryDump* dump) {
+    static constexpr char kDumpName[] = "skia/lazy_image_decodes";
+    const DecodeStats stats = GetDecodeStats();
+    dump->dumpNumericValue(kDumpName, "cache_hits", "objects", stats.fCacheHits);
+    dump->dumpNumericValue(kDumpName, "cache_misses", "objects", stats.fCacheMisses);
+    dump->dumpNumericValue(kDumpName, "decodes", "objects", stats.fDecodes);
+    dump->dumpNumericValue(kDumpName, "subset_decodes", "objects", stats.fSubsetDecodes);
+    dump->dumpNumericValue(kDumpName, "shared_decodes", "objects", stats.fSharedDecodes);
+    dump->dumpNumericValue(kDumpName, "wait_time", "nanoseconds", stats.fWaitNanos);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 SkImage_Lazy::Validator::Validator(sk_sp<SharedGenerator> gen, const SkColorType* colorType,
@@ -117,11 +160,54 @@ bool SkImage_Lazy::getROPixels(GrDirectContext* ctx, SkBitmap* bitmap,
 
     auto desc = SkBitmapCacheDesc::Make(this);
     if (SkBitmapCache::Find(desc, bitmap)) {
+        gDecodeStats.fCacheHits.fetch_add(1, std::memory_order_relaxed);
         check_output_bitmap();
         return true;
     }
+    gDecodeStats.fCacheMisses.fetch_add(1, std::memory_order_relaxed);
 
     if (SkImage::kAllow_CachingHint == chint) {
+        // If another thread is already decoding these pixels, wait for it to add them to the
+        // cache. Otherwise, register this decode, so that other threads can wait for it.
+        sk_sp<SharedGenerator::PendingDecode> pending;
+        bool decoding = true;
+        {
+            SkAutoMutexExclusive lock(fSharedGenerator->fPendingMutex);
+            if (SharedGenerator::PendingDecode** found =
+                        fSharedGenerator->fPendingDecodes.find(this->uniqueID())) {
+                pending = sk_ref_sp(*found);
+                pending->fWaiters++;
+                decoding = false;
+            } else {
+                pending = sk_make_sp<SharedGenerator::PendingDecode>();
+                fSharedGenerator->fPendingDecodes.set(this->uniqueID(), pending.get());
+            }
+        }
+        if (!decoding) {
+            const double start = SkTime::GetNSecs();
+            pending->fDone.wait();
+            gDecodeStats.fWaitNanos.fetch_add((int64_t)(SkTime::GetNSecs() - start),
+                                              std::memory_order_relaxed);
+            if (SkBitmapCache::Find(desc, bitmap)) {
+                gDecodeStats.fSharedDecodes.fetch_add(1, std::memory_order_relaxed);
+                check_output_bitmap();
+                return true;
+            }
+            // The other decode failed, or its pixels were purged already. Try again ourselves.
+            pending = nullptr;
+        }
+        SkScopeExit wakeWaiters([&] {
+            if (pending) {
+                int waiters;
+                {
+                    SkAutoMutexExclusive lock(fSharedGenerator->fPendingMutex);
+                    fSharedGenerator->fPendingDecodes.remove(this->uniqueID());
+                    waiters = pending->fWaiters;
+                }
+                pending->fDone.signal(waiters);
+            }
+        });
+
         SkPixmap pmap;
         SkBitmapCache::RecPtr cacheRec = SkBitmapCache::Alloc(desc, this->imageInfo(), &pmap);
         if (!cacheRec) {
@@ -131,6 +217,7 @@ bool SkImage_Lazy::getROPixels(GrDirectContext* ctx, SkBitmap* bitmap,
         {   // make sure ScopedGenerator goes out of scope before we try readPixelsProxy
             success = ScopedGenerator(fSharedGenerator)->getPixels(pmap);
         }
+        gDecodeStats.fDecodes.fetch_add(1, std::memory_order_relaxed);
         if (!success && !this->readPixelsProxy(ctx, pmap)) {
             return false;
         }
@@ -144,6 +231,7 @@ bool SkImage_Lazy::getROPixels(GrDirectContext* ctx, SkBitmap* bitmap,
         {   // make sure ScopedGenerator goes out of scope before we try readPixelsProxy
             success = ScopedGenerator(fSharedGenerator)->getPixels(bitmap->pixmap());
         }
+        gDecodeStats.fDecodes.fetch_add(1, std::memory_order_relaxed);
         if (!success && !this->readPixelsProxy(ctx, bitmap->pixmap())) {
             return false;
         }
@@ -192,6 +280,20 @@ bool SkImage_Lazy::isValid(GrRecordingContext* context) const {
 
 
 sk_sp<SkImage> SkImage_Lazy::onMakeSubset(GrDirectContext*, const SkIRect& subset) const {
+    // Generators that can decode just the subset do so without taking the generator's lock, so
+    // threads that want different parts of one image decode them in parallel. That's only worth
+    // it if the whole image isn't in the cache already, and if this isn't a color type/space
+    // variant of the generator's image.
+    SkBitmap bitmap;
+    if (fSharedGenerator->fGenerator->uniqueID() == this->uniqueID() &&
+        !SkBitmapCache::Find(SkBitmapCacheDesc::Make(this), &bitmap) &&
+        bitmap.tryAllocPixels(this->imageInfo().makeDimensions(subset.size())) &&
+        fSharedGenerator->fGenerator->getSubsetPixels(bitmap.pixmap(), subset)) {
+        gDecodeStats.fSubsetDecodes.fetch_add(1, std::memory_order_relaxed);
+        bitmap.setImmutable();
+        return bitmap.asImage();
+    }
+
     // neither picture-backed nor codec-backed lazy images need the context to do readbacks.
     // The subclass for cross-context images *does* use the direct context.
     auto pixels = this->makeRasterImage(nullptr);
@@ -17,6 +17,8 @@
 #include "include/core/SkYUVAPixmaps.h"
 #include "include/private/SkIDChangeListener.h"
 #include "include/private/base/SkMutex.h"
+#include "include/private/base/SkThreadAnnotations.h"
+#include "src/core/SkTHash.h"
 #include "src/image/SkImage_Base.h"
 
 #include <cstddef>
@@ -31,6 +33,7 @@ class SkCachedData;
 class SkData;
 class SkPixmap;
 class SkSurface;
+class SkTraceMemoryDump;
 enum SkColorType : int;
 struct SkIRect;
 
@@ -86,6 +89,19 @@ public:
     // Be careful with this. You need to acquire the mutex, as the generator might be shared
     // among several images.
     sk_sp<SharedGenerator> generator() const;
+
+    // Process-wide counts of how raster decodes of lazy images went.
+    struct DecodeStats {
+        int64_t fCacheHits;      // getROPixels() found the pixels already in the cache.
+        int64_t fCacheMisses;    // ... or didn't.
+        int64_t fDecodes;        // Whole images decoded.
+        int64_t fSubsetDecodes;  // Subsets decoded on their own, by onMakeSubset().
+        int64_t fSharedDecodes;  // Misses that waited for another thread's decode, and used it.
+        int64_t fWaitNanos;      // Time spent waiting for other threads' decodes.
+    };
+    static DecodeStats GetDecodeStats();
+    // Reports the DecodeStats, under "skia/lazy_image_decodes".
+    static void DumpMemoryStatistics(SkTraceMemoryDump*);
 protected:
     virtual bool readPixelsProxy(GrDirectContext*, const SkPixmap&) const { return false; }
 
@@ -120,6 +136,13 @@ public:
     std::unique_ptr<SkImageGenerator> fGenerator;
     SkMutex                           fMutex;
 
+    // The decodes into the raster cache in progress, by image unique ID. A second thread that
+    // wants the same pixels waits for the first one's decode, instead of repeating it.
+    class PendingDecode;
+    SkMutex                                           fPendingMutex;
+    skia_private::THashMap<uint32_t, PendingDecode*>  fPendingDecodes
+            SK_GUARDED_BY(fPendingMutex);
+
 private:
     explicit SharedGenerator(std::unique_ptr<SkImageGenerator> gen);
 };
@@ -9,6 +9,7 @@
 #define SkImage_Raster_DEFINED
 
 #include "include/core/SkBitmap.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkPixelRef.h"
 #include "include/core/SkRefCnt.h"
@@ -92,7 +93,9 @@ public:
         if (mips) {
             imgRaster->fBitmap.fMips = std::move(mips);
         } else {
-            imgRaster->fBitmap.fMips.reset(SkMipmap::Build(fBitmap.pixmap(), nullptr));
+            imgRaster->fBitmap.fMips.reset(SkMipmap::Build(fBitmap.pixmap(), nullptr,
+                                                           /*computeContents=*/true,
+                                                           &SkExecutor::GetDefault()));
         }
         return img;
     }
@@ -0,0 +1,510 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/image/SkSurface_RasterTiled.h"
+
+#include "include/core/SkBBHFactory.h"
+#include "include/core/SkBitmap.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkCapabilities.h"
+#include "include/core/SkDrawable.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkImageInfo.h"
+#include "include/core/SkMallocPixelRef.h"
+#include "include/core/SkPixelRef.h"
+#include "include/core/SkRect.h"
+#include "include/core/SkRefCnt.h"
+#include "include/core/SkSurface.h"
+#include "include/core/SkSurfaceProps.h"
+#include "include/private/base/SkAssert.h"
+#include "include/private/base/SkTemplates.h"
+#include "include/utils/SkNWayCanvas.h"
+#include "src/core/SkCanvasPriv.h"
+#include "src/core/SkImagePriv.h"
+#include "src/core/SkRecord.h"
+#include "src/core/SkRecordDraw.h"
+#include "src/core/SkRecordOpts.h"
+#include "src/core/SkRecorder.h"
+#include "src/core/SkRecords.h"
+#include "src/core/SkSurfacePriv.h"
+#include "src/core/SkTaskGroup.h"
+
+#include <cstring>
+#include <utility>
+#include <vector>
+
+using namespace skia_private;
+
+namespace {
+
+// Returns the index of the outermost SaveLayer (or SaveBehind) that has not been restored yet,
+// or record.count() if there is none. Everything before that index can be drawn to the pixels
+// right away; the contents of an open layer can't, since the layer hasn't been composited yet.
+class FindOpenLayer {
+public:
+    static int Find(const SkRecord& record) {
+        FindOpenLayer visitor;
+        for (visitor.fIndex = 0; visitor.fIndex < record.count(); ++visitor.fIndex) {
+            record.visit(visitor.fIndex, visitor);
+        }
+        for (int start : visitor.fStack) {
+            if (start >= 0) {
+                return start;
+            }
+        }
+        return record.count();
+    }
+
+    template <typename T> void operator()(const T&) {}
+    void operator()(const SkRecords::Save&)       { fStack.push_back(-1); }
+    void operator()(const SkRecords::SaveLayer&)  { fStack.push_back(fIndex); }
+    void operator()(const SkRecords::SaveBehind&) { fStack.push_back(fIndex); }
+    void operator()(const SkRecords::Restore&) {
+        if (!fStack.empty()) {
+            fStack.pop_back();
+        }
+    }
+
+private:
+    std::vector<int> fStack;  // Op index of each open layer, -1 for plain saves.
+    int fIndex = 0;
+};
+
+// Once an op has been drawn to the pixels, it only needs to stay in the record if later draws
+// depend on it: saves, restores, matrix and clip changes. Closed layers turn into plain saves.
+enum class Retire { kKeep, kMakeSave, kMakeNoOp };
+
+struct RetireOp {
+    template <typename T> Retire operator()(const T&) { return Retire::kMakeNoOp; }
+
+    Retire operator()(const SkRecords::NoOp&)       { return Retire::kKeep; }
+    Retire operator()(const SkRecords::Restore&)    { return Retire::kKeep; }
+    Retire operator()(const SkRecords::Save&)       { return Retire::kKeep; }
+    Retire operator()(const SkRecords::SetMatrix&)  { return Retire::kKeep; }
+    Retire operator()(const SkRecords::SetM44&)     { return Retire::kKeep; }
+    Retire operator()(const SkRecords::Translate&)  { return Retire::kKeep; }
+    Retire operator()(const SkRecords::Scale&)      { return Retire::kKeep; }
+    Retire operator()(const SkRecords::Concat&)     { return Retire::kKeep; }
+    Retire operator()(const SkRecords::Concat44&)   { return Retire::kKeep; }
+    Retire operator()(const SkRecords::ClipPath&)   { return Retire::kKeep; }
+    Retire operator()(const SkRecords::ClipRRect&)  { return Retire::kKeep; }
+    Retire operator()(const SkRecords::ClipRect&)   { return Retire::kKeep; }
+    Retire operator()(const SkRecords::ClipRegion&) { return Retire::kKeep; }
+    Retire operator()(const SkRecords::ClipShader&) { return Retire::kKeep; }
+    Retire operator()(const SkRecords::ResetClip&)  { return Retire::kKeep; }
+
+    Retire operator()(const SkRecords::SaveLayer&)  { return Retire::kMakeSave; }
+    Retire operator()(const SkRecords::SaveBehind&) { return Retire::kMakeSave; }
+};
+
+}  // namespace
+
+// SkTiledRecordingCanvas forwards everything to an SkRecorder. flush() plays the recorded ops
+// back into the target bitmap, one tile per task, and then drops the ops that have hit the
+// pixels from the record.
+class SkTiledRecordingCanvas final : public SkNWayCanvas {
+public:
+    SkTiledRecordingCanvas(const SkBitmap& target, SkExecutor* executor,
+                           const SkSurfaceProps& props)
+            : SkNWayCanvas(target.width(), target.height())
+            , fTarget(target)
+            , fExecutor(executor)
+            , fProps(props)
+            , fRecord(sk_make_sp<SkRecord>())
+            , fRecorder(fRecord.get(), SkRect::Make(target.bounds())) {
+        this->addCanvas(&fRecorder);
+    }
+
+    ~SkTiledRecordingCanvas() override { this->removeAll(); }
+
+    void setTarget(const SkBitmap& target) {
+        SkASSERT(target.dimensions() == fTarget.dimensions());
+        fTarget = target;
+    }
+
+    void flush() {
+        if (!fHasPendingDraws) {
+            return;
+        }
+        const int count = fRecord->count(),
+                  stop  = FindOpenLayer::Find(*fRecord);
+        if (stop > 0) {
+            this->playback(stop);
+            this->retire(stop);
+        }
+        // Draws inside an open layer stay pending until that layer is restored.
+        fHasPendingDraws = stop < count;
+    }
+
+protected:
+    // Anything that may change pixels has to let the surface know first, so that it can
+    // copy-on-write away from any outstanding snapshot and bump its generation ID.
+    void willDraw() {
+        fHasPendingDraws = true;
+        if (SkSurface* surface = this->getSurface()) {
+            surface->notifyContentWillChange(SkSurface::kRetain_ContentChangeMode);
+        }
+    }
+
+    SaveLayerStrategy getSaveLayerStrategy(const SaveLayerRec& rec) override {
+        this->willDraw();
+        return this->INHERITED::getSaveLayerStrategy(rec);
+    }
+    bool onDoSaveBehind(const SkRect* bounds) override {
+        this->willDraw();
+        return this->INHERITED::onDoSaveBehind(bounds);
+    }
+    void willRestore() override {
+        // Restoring a layer composites it.
+        if (SkSurface* surface = this->getSurface()) {
+            surface->notifyContentWillChange(SkSurface::kRetain_ContentChangeMode);
+        }
+        this->INHERITED::willRestore();
+    }
+
+    void onDrawPaint(const SkPaint& paint) override {
+        this->willDraw();
+        this->INHERITED::onDrawPaint(paint);
+    }
+    void onDrawBehind(const SkPaint& paint) override {
+        this->willDraw();
+        this->INHERITED::onDrawBehind(paint);
+    }
+    void onDrawPoints(PointMode mode, size_t count, const SkPoint pts[],
+                      const SkPaint& paint) override {
+        this->willDraw();
+        this->INHERITED::onDrawPoints(mode, count, pts, paint);
+    }
+    void onDrawRect(const SkRect& rect, const SkPaint& paint) override {
+        this->willDraw();
+        this->INHERITED::onDrawRect(rect, paint);
+    }
+    void onDrawRegion(const SkRegion& region, const SkPaint& paint) override {
+        this->willDraw();
+        this->INHERITED::onDrawRegion(region, paint);
+    }
+    void onDrawOval(const SkRect& rect, const SkPaint& paint) override {
+        this->willDraw();
+        this->INHERITED::onDrawOval(rect, paint);
+    }
+    void onDrawArc(const SkRect& rect, SkScalar startAngle, SkScalar sweepAngle, bool useCenter,
+                   const SkPaint& paint) override {
+        this->willDraw();
+        this->INHERITED::onDrawArc(rect, startAngle, sweepAngle, useCenter, paint);
+    }
+    void onDrawRRect(const SkRRect& rrect, const SkPaint& paint) override {
+        this->willDraw();
+        this->INHERITED::onDrawRRect(rrect, paint);
+    }
+    void onDrawDRRect(const SkRRect& outer, const SkRRect& inner, const SkPaint& paint) override {
+        this->willDraw();
+        this->INHERITED::onDrawDRRect(outer, inner, paint);
+    }
+    void onDrawPath(const SkPath& path, const SkPaint& paint) override {
+        this->willDraw();
+        this->INHERITED::onDrawPath(path, paint);
+    }
+    void onDrawImage2(const SkImage* image, SkScalar x, SkScalar y,
+                      const SkSamplingOptions& sampling, const SkPaint* paint) override {
+        this->willDraw();
+        this->INHERITED::onDrawImage2(image, x, y, sampling, paint);
+    }
+    void onDrawImageRect2(const SkImage* image, const SkRect& src, const SkRect& dst,
+                          const SkSamplingOptions& sampling, const SkPaint* paint,
+                          SrcRectConstraint constraint) override {
+        this->willDraw();
+        this->INHERITED::onDrawImageRect2(image, src, dst, sampling, paint, constraint);
+    }
+    void onDrawImageLattice2(const SkImage* image, const Lattice& lattice, const SkRect& dst,
+                             SkFilterMode filter, const SkPaint* paint) override {
+        this->willDraw();
+        this->INHERITED::onDrawImageLattice2(image, lattice, dst, filter, paint);
+    }
+    void onDrawAtlas2(const SkImage* image, const SkRSXform xform[], const SkRect tex[],
+                      const SkColor colors[], int count, SkBlendMode mode,
+                      const SkSamplingOptions& sampling, const SkRect* cull,
+                      const SkPaint* paint) override {
+        this->willDraw();
+        this->INHERITED::onDrawAtlas2(image, xform, tex, colors, count, mode, sampling, cull,
+                                      paint);
+    }
+    void onDrawGlyphRunList(const sktext::GlyphRunList& list, const SkPaint& paint) override {
+        this->willDraw();
+        this->INHERITED::onDrawGlyphRunList(list, paint);
+    }
+    void onDrawTextBlob(const SkTextBlob* blob, SkScalar x, SkScalar y,
+                        const SkPaint& paint) override {
+        this->willDraw();
+        this->INHERITED::onDrawTextBlob(blob, x, y, paint);
+    }
+    void onDrawSlug(const sktext::gpu::Slug* slug, const SkPaint& paint) override {
+        this->willDraw();
+        this->INHERITED::onDrawSlug(slug, paint);
+    }
+    void onDrawPatch(const SkPoint cubics[12], const SkColor colors[4],
+                     const SkPoint texCoords[4], SkBlendMode mode,
+                     const SkPaint& paint) override {
+        this->willDraw();
+        this->INHERITED::onDrawPatch(cubics, colors, texCoords, mode, paint);
+    }
+    void onDrawVerticesObject(const SkVertices* vertices, SkBlendMode mode,
+                              const SkPaint& paint) override {
+        this->willDraw();
+        this->INHERITED::onDrawVerticesObject(vertices, mode, paint);
+    }
+    void onDrawMesh(const SkMesh& mesh, sk_sp<SkBlender> blender, const SkPaint& paint) override {
+        // SkNWayCanvas doesn't forward meshes.
+        this->willDraw();
+        fRecorder.drawMesh(mesh, std::move(blender), paint);
+    }
+    void onDrawShadowRec(const SkPath& path, const SkDrawShadowRec& rec) override {
+        this->willDraw();
+        this->INHERITED::onDrawShadowRec(path, rec);
+    }
+    void onDrawPicture(const SkPicture* picture, const SkMatrix* matrix,
+                       const SkPaint* paint) override {
+        this->willDraw();
+        this->INHERITED::onDrawPicture(picture, matrix, paint);
+    }
+    void onDrawDrawable(SkDrawable* drawable, const SkMatrix* matrix) override {
+        // Drawables may change by the time we flush, so draw their current contents now.
+        drawable->draw(this, matrix);
+    }
+    void onDrawEdgeAAQuad(const SkRect& rect, const SkPoint clip[4], QuadAAFlags aa,
+                          const SkColor4f& color, SkBlendMode mode) override {
+        this->willDraw();
+        this->INHERITED::onDrawEdgeAAQuad(rect, clip, aa, color, mode);
+    }
+    void onDrawEdgeAAImageSet2(const ImageSetEntry set[], int count, const SkPoint dstClips[],
+                               const SkMatrix preViewMatrices[], const SkSamplingOptions& sampling,
+                               const SkPaint* paint, SrcRectConstraint constraint) override {
+        this->willDraw();
+        this->INHERITED::onDrawEdgeAAImageSet2(set, count, dstClips, preViewMatrices, sampling,
+                                               paint, constraint);
+    }
+
+    SkImageInfo onImageInfo() const override { return fTarget.info(); }
+
+    bool onGetProps(SkSurfaceProps* props, bool top) const override {
+        if (props) {
+            *props = fProps;
+        }
+        return true;
+    }
+
+    bool onPeekPixels(SkPixmap* pixmap) override {
+        this->flush();
+        return fTarget.peekPixels(pixmap);
+    }
+
+    bool onAccessTopLayerPixels(SkPixmap* pixmap) override {
+        // The top layer is only backed by real pixels when there are no open layers.
+        this->flush();
+        return !fHasPendingDraws && fTarget.peekPixels(pixmap);
+    }
+
+    sk_sp<SkSurface> onNewSurface(const SkImageInfo& info, const SkSurfaceProps& props) override {
+        return SkSurfaces::Raster(info, &props);
+    }
+
+private:
+    void playback(int stop) {
+        constexpr int kTile = SkSurface_RasterTiled::kTileSize;
+        const SkIRect bounds = fTarget.bounds();
+        int tilesX = (bounds.width()  + kTile - 1) / kTile,
+            tilesY = (bounds.height() + kTile - 1) / kTile;
+
+        // Ops that escape the tile clip have to be drawn as one tile.
+        if (SkRecordEscapesTileClip(*fRecord, stop)) {
+            tilesX = tilesY = 1;
+        }
+
+        // Like SkBigPicture, use an R-tree to skip ops that can't touch a given tile.
+        sk_sp<SkBBoxHierarchy> bbh;
+        if (tilesX * tilesY > 1) {
+            const int count = fRecord->count();
+            AutoTArray<SkRect> opBounds(count);
+            AutoTMalloc<SkBBoxHierarchy::Metadata> meta(count);
+            SkRecordFillBounds(SkRect::Make(bounds), *fRecord, opBounds.data(), meta);
+            bbh = SkRTreeFactory()();
+            bbh->insert(opBounds.data(), meta, count);
+        }
+
+        auto drawTile = [&](int index) {
+            SkIRect tile = SkIRect::MakeXYWH((index % tilesX) * kTile,
+                                             (index / tilesX) * kTile,
+                                             kTile, kTile);
+            if (tilesX * tilesY == 1 || !tile.intersect(bounds)) {
+                tile = bounds;
+            }
+            // Each tile gets its own device over the whole target, so that every op sees the same
+            // device coordinates (and so rounds and dithers the same) as when drawn serially.
+            SkCanvas canvas(fTarget, fProps);
+            canvas.clipIRect(tile);
+
+            SkRecords::Draw draw(&canvas, nullptr, nullptr, 0);
+            if (bbh) {
+                std::vector<int> ops;
+                bbh->search(SkRect::Make(tile), &ops);
+                for (int op : ops) {
+                    if (op < stop) {
+                        fRecord->visit(op, draw);
+                    }
+                }
+            } else {
+                for (int op = 0; op < stop; op++) {
+                    fRecord->visit(op, draw);
+                }
+            }
+        };
+
+        if (tilesX * tilesY == 1) {
+            drawTile(0);
+            return;
+        }
+        SkTaskGroup tg(fExecutor ? *fExecutor : SkExecutor::GetDefault());
+        tg.batch(tilesX * tilesY, drawTile);
+        tg.wait();
+    }
+
+    void retire(int stop) {
+        for (int i = 0; i < stop; i++) {
+            switch (fRecord->visit(i, RetireOp())) {
+                case Retire::kKeep:     break;
+                case Retire::kMakeSave: fRecord->replace<SkRecords::Save>(i); break;
+                case Retire::kMakeNoOp: fRecord->replace<SkRecords::NoOp>(i); break;
+            }
+        }
+        SkRecordNoopSaveRestores(fRecord.get());
+
+        // Re-record what's left into a fresh SkRecord, so that the memory used by the ops we
+        // just drew is released rather than accumulating across flushes.
+        sk_sp<SkRecord> old = std::exchange(fRecord, sk_make_sp<SkRecord>());
+        fRecorder.reset(fRecord.get(), SkRect::Make(fTarget.bounds()));
+        SkRecords::Draw draw(&fRecorder, nullptr, nullptr, 0);
+        for (int i = 0; i < old->count(); i++) {
+            old->visit(i, draw);
+        }
+    }
+
+    SkBitmap              fTarget;
+    SkExecutor*           fExecutor;
+    const SkSurfaceProps  fProps;
+    sk_sp<SkRecord>       fRecord;
+    SkRecorder            fRecorder;
+    bool                  fHasPendingDraws = false;
+
+    using INHERITED = SkNWayCanvas;
+};
+
+SkSurface_RasterTiled::SkSurface_RasterTiled(const SkImageInfo& info, sk_sp<SkPixelRef> pr,
+                                             SkExecutor* executor, const SkSurfaceProps* props)
+        : INHERITED(pr->width(), pr->height(), props), fExecutor(executor) {
+    fBitmap.setInfo(info, pr->rowBytes());
+    fBitmap.setPixelRef(std::move(pr), 0, 0);
+}
+
+SkCanvas* SkSurface_RasterTiled::onNewCanvas() {
+    return new SkTiledRecordingCanvas(fBitmap, fExecutor, this->props());
+}
+
+SkTiledRecordingCanvas* SkSurface_RasterTiled::tiledCanvas() {
+    return static_cast<SkTiledRecordingCanvas*>(this->getCachedCanvas());
+}
+
+void SkSurface_RasterTiled::flushPendingDraws() {
+    this->tiledCanvas()->flush();
+}
+
+sk_sp<SkSurface> SkSurface_RasterTiled::onNewSurface(const SkImageInfo& info) {
+    return SkSurfaces::RasterMultiThreaded(info, fExecutor, &this->props());
+}
+
+sk_sp<SkImage> SkSurface_RasterTiled::onNewImageSnapshot(const SkIRect* subset) {
+    this->flushPendingDraws();
+
+    if (subset) {
+        SkASSERT(SkIRect::MakeWH(fBitmap.width(), fBitmap.height()).contains(*subset));
+        SkBitmap dst;
+        dst.allocPixels(fBitmap.info().makeDimensions(subset->size()));
+        SkAssertResult(fBitmap.readPixels(dst.pixmap(), subset->left(), subset->top()));
+        dst.setImmutable(); // key, so MakeFromBitmap doesn't make a copy of the buffer
+        return dst.asImage();
+    }
+
+    // SkImage_raster requires these pixels are immutable for its full lifetime.
+    // We'll undo this via onRestoreBackingMutability() if we can avoid the COW.
+    if (SkPixelRef* pr = fBitmap.pixelRef()) {
+        pr->setTemporarilyImmutable();
+    }
+    return SkMakeImageFromRasterBitmap(fBitmap, kIfMutable_SkCopyPixelsMode);
+}
+
+void SkSurface_RasterTiled::onWritePixels(const SkPixmap& src, int x, int y) {
+    this->flushPendingDraws();
+    fBitmap.writePixels(src, x, y);
+}
+
+bool SkSurface_RasterTiled::onReadPixels(const SkPixmap& dst, int x, int y) {
+    this->flushPendingDraws();
+    return fBitmap.readPixels(dst, x, y);
+}
+
+void SkSurface_RasterTiled::onRestoreBackingMutability() {
+    SkASSERT(!this->hasCachedImage());  // Shouldn't be any snapshots out there.
+    if (SkPixelRef* pr = fBitmap.pixelRef()) {
+        pr->restoreMutability();
+    }
+}
+
+bool SkSurface_RasterTiled::onCopyOnWrite(ContentChangeMode mode) {
+    // are we sharing pixelrefs with the image?
+    sk_sp<SkImage> cached(this->refCachedImage());
+    SkASSERT(cached);
+    if (SkBitmapImageGetPixelRef(cached.get()) == fBitmap.pixelRef()) {
+        if (kDiscard_ContentChangeMode == mode) {
+            if (!fBitmap.tryAllocPixels()) {
+                return false;
+            }
+        } else {
+            SkBitmap prev(fBitmap);
+            if (!fBitmap.tryAllocPixels()) {
+                return false;
+            }
+            SkASSERT(prev.info() == fBitmap.info());
+            SkASSERT(prev.rowBytes() == fBitmap.rowBytes());
+            memcpy(fBitmap.getPixels(), prev.getPixels(), fBitmap.computeByteSize());
+        }
+
+        // Any draws recorded from now on are played back into the new pixels.
+        this->tiledCanvas()->setTarget(fBitmap);
+    }
+    return true;
+}
+
+sk_sp<const SkCapabilities> SkSurface_RasterTiled::onCapabilities() {
+    return SkCapabilities::RasterBackend();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+namespace SkSurfaces {
+
+sk_sp<SkSurface> RasterMultiThreaded(const SkImageInfo& info,
+                                     SkExecutor* executor,
+                                     const SkSurfaceProps* props) {
+    if (!SkSurfaceValidateRasterInfo(info)) {
+        return nullptr;
+    }
+
+    sk_sp<SkPixelRef> pr = SkMallocPixelRef::MakeAllocate(info, 0);
+    if (!pr) {
+        return nullptr;
+    }
+    return sk_make_sp<SkSurface_RasterTiled>(info, std::move(pr), executor, props);
+}
+
+}  // namespace SkSurfaces
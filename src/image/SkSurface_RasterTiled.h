@@ -0,0 +1,68 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkSurface_RasterTiled_DEFINED
+#define SkSurface_RasterTiled_DEFINED
+
+#include "include/core/SkBitmap.h"
+#include "include/core/SkImageInfo.h"
+#include "include/core/SkRefCnt.h"
+#include "include/core/SkSamplingOptions.h"
+#include "include/core/SkScalar.h"
+#include "src/image/SkSurface_Base.h"
+
+class SkCanvas;
+class SkCapabilities;
+class SkExecutor;
+class SkImage;
+class SkPaint;
+class SkPixelRef;
+class SkPixmap;
+class SkSurface;
+class SkSurfaceProps;
+class SkTiledRecordingCanvas;
+struct SkIRect;
+
+// A raster surface whose canvas records draws instead of executing them. The recorded draws are
+// replayed in parallel, one tile of the surface per task, whenever the pixels are needed
+// (snapshots, peekPixels(), readPixels(), writePixels(), drawing the surface elsewhere).
+class SkSurface_RasterTiled : public SkSurface_Base {
+public:
+    // Tiles are square, with this edge length in pixels (except at the right and bottom edges).
+    static constexpr int kTileSize = 256;
+
+    SkSurface_RasterTiled(const SkImageInfo&, sk_sp<SkPixelRef>, SkExecutor*,
+                          const SkSurfaceProps*);
+
+    // From SkSurface.h
+    SkImageInfo imageInfo() const override { return fBitmap.info(); }
+
+    // From SkSurface_Base.h
+    SkSurface_Base::Type type() const override { return SkSurface_Base::Type::kRaster; }
+
+    SkCanvas* onNewCanvas() override;
+    sk_sp<SkSurface> onNewSurface(const SkImageInfo&) override;
+    sk_sp<SkImage> onNewImageSnapshot(const SkIRect* subset) override;
+    void onWritePixels(const SkPixmap&, int x, int y) override;
+    bool onReadPixels(const SkPixmap&, int x, int y) override;
+    bool onCopyOnWrite(ContentChangeMode) override;
+    void onRestoreBackingMutability() override;
+    sk_sp<const SkCapabilities> onCapabilities() override;
+
+    // Replays any recorded draws into the backing pixels.
+    void flushPendingDraws();
+
+private:
+    SkTiledRecordingCanvas* tiledCanvas();
+
+    SkBitmap     fBitmap;
+    SkExecutor*  fExecutor;
+
+    using INHERITED = SkSurface_Base;
+};
+
+#endif
@@ -1419,6 +1419,25 @@ SI U16 to_half(F f) {
 #endif
 }
 
+// Copies the tail pixels of a row into or out of a MemoryCtx scratch buffer.
+SI void copy_tail_bytes(void* dst, const void* src, size_t bytes) {
+#if defined(SKRP_CPU_SKX)
+    // AVX-512 loads and stores can be masked byte-by-byte, and masked-off bytes never fault. So
+    // a whole tail (at most SkRasterPipeline_MaxScratchPerPatch bytes) is a few masked moves.
+    auto d = (char*)dst;
+    auto s = (const char*)src;
+    for (; bytes >= 64; bytes -= 64, d += 64, s += 64) {
+        _mm512_storeu_si512(d, _mm512_loadu_si512(s));
+    }
+    if (bytes) {
+        const __mmask64 mask = ~0ULL >> (64 - bytes);
+        _mm512_mask_storeu_epi8(d, mask, _mm512_maskz_loadu_epi8(mask, s));
+    }
+#else
+    memcpy(dst, src, bytes);
+#endif
+}
+
 static void patch_memory_contexts(SkSpan<SkRasterPipeline_MemoryCtxPatch> memoryCtxPatches,
                                   size_t dx, size_t dy, size_t tail) {
     for (SkRasterPipeline_MemoryCtxPatch& patch : memoryCtxPatches) {
@@ -1427,7 +1446,7 @@ static void patch_memory_contexts(SkSpan<SkRasterPipeline_MemoryCtxPatch> memory
         const ptrdiff_t offset = patch.info.bytesPerPixel * (dy * ctx->stride + dx);
         if (patch.info.load) {
             void* ctxData = SkTAddOffset<void>(ctx->pixels, offset);
-            memcpy(patch.scratch, ctxData, patch.info.bytesPerPixel * tail);
+            copy_tail_bytes(patch.scratch, ctxData, patch.info.bytesPerPixel * tail);
         }
 
         SkASSERT(patch.backup == nullptr);
@@ -1449,7 +1468,7 @@ static void restore_memory_contexts(SkSpan<SkRasterPipeline_MemoryCtxPatch> memo
         const ptrdiff_t offset = patch.info.bytesPerPixel * (dy * ctx->stride + dx);
         if (patch.info.store) {
             void* ctxData = SkTAddOffset<void>(ctx->pixels, offset);
-            memcpy(ctxData, patch.scratch, patch.info.bytesPerPixel * tail);
+            copy_tail_bytes(ctxData, patch.scratch, patch.info.bytesPerPixel * tail);
         }
     }
 }
@@ -3378,7 +3397,24 @@ STAGE(matrix_perspective, const float* m) {
 SI void gradient_lookup(const SkRasterPipeline_GradientCtx* c, U32 idx, F t,
                         F* r, F* g, F* b, F* a) {
     F fr, br, fg, bg, fb, bb, fa, ba;
-#if defined(SKRP_CPU_HSW)
+#if defined(SKRP_CPU_SKX)
+    if (c->stopCount <= 8) {
+        // The stop arrays always have room for at least 8 floats, and idx is always < 8 here, so
+        // the undefined upper half of each widened register is never read.
+        auto lookup = [&](const float* stops) -> F {
+            return _mm512_permutexvar_ps((__m512i)idx,
+                                         _mm512_castps256_ps512(_mm256_loadu_ps(stops)));
+        };
+        fr = lookup(c->fs[0]);
+        br = lookup(c->bs[0]);
+        fg = lookup(c->fs[1]);
+        bg = lookup(c->bs[1]);
+        fb = lookup(c->fs[2]);
+        bb = lookup(c->bs[2]);
+        fa = lookup(c->fs[3]);
+        ba = lookup(c->bs[3]);
+    } else
+#elif defined(SKRP_CPU_HSW)
     if (c->stopCount <=8) {
         fr = _mm256_permutevar8x32_ps(_mm256_loadu_ps(c->fs[0]), (__m256i)idx);
         br = _mm256_permutevar8x32_ps(_mm256_loadu_ps(c->bs[0]), (__m256i)idx);
@@ -5084,7 +5120,9 @@ namespace lowp {
 
 #else  // We are compiling vector code with Clang... let's make some lowp stages!
 
-#if defined(SKRP_CPU_SKX) || defined(SKRP_CPU_HSW) || defined(SKRP_CPU_LASX)
+#if defined(SKRP_CPU_SKX)
+    template <typename T> using V = Vec<32, T>;
+#elif defined(SKRP_CPU_HSW) || defined(SKRP_CPU_LASX)
     template <typename T> using V = Vec<16, T>;
 #else
     template <typename T> using V = Vec<8, T>;
@@ -5419,8 +5457,9 @@ SI U32 trunc_(F x) { return (U32)cast<I32>(x); }
 // Use approximate instructions and one Newton-Raphson step to calculate 1/x.
 SI F rcp_precise(F x) {
 #if defined(SKRP_CPU_SKX)
-    F e = _mm512_rcp14_ps(x);
-    return _mm512_fnmadd_ps(x, e, _mm512_set1_ps(2.0f)) * e;
+    __m512 lo,hi;
+    split(x, &lo,&hi);
+    return join<F>(SK_OPTS_NS::rcp_precise(lo), SK_OPTS_NS::rcp_precise(hi));
 #elif defined(SKRP_CPU_HSW)
     __m256 lo,hi;
     split(x, &lo,&hi);
@@ -5447,7 +5486,9 @@ SI F rcp_precise(F x) {
 }
 SI F sqrt_(F x) {
 #if defined(SKRP_CPU_SKX)
-    return _mm512_sqrt_ps(x);
+    __m512 lo,hi;
+    split(x, &lo,&hi);
+    return join<F>(_mm512_sqrt_ps(lo), _mm512_sqrt_ps(hi));
 #elif defined(SKRP_CPU_HSW)
     __m256 lo,hi;
     split(x, &lo,&hi);
@@ -5492,7 +5533,9 @@ SI F floor_(F x) {
     split(x, &lo,&hi);
     return join<F>(vrndmq_f32(lo), vrndmq_f32(hi));
 #elif defined(SKRP_CPU_SKX)
-    return _mm512_floor_ps(x);
+    __m512 lo,hi;
+    split(x, &lo,&hi);
+    return join<F>(_mm512_floor_ps(lo), _mm512_floor_ps(hi));
 #elif defined(SKRP_CPU_HSW)
     __m256 lo,hi;
     split(x, &lo,&hi);
@@ -5522,7 +5565,7 @@ SI F floor_(F x) {
 // Note: on neon this is a saturating multiply while the others are not.
 SI I16 scaled_mult(I16 a, I16 b) {
 #if defined(SKRP_CPU_SKX)
-    return (I16)_mm256_mulhrs_epi16((__m256i)a, (__m256i)b);
+    return (I16)_mm512_mulhrs_epi16((__m512i)a, (__m512i)b);
 #elif defined(SKRP_CPU_HSW)
     return (I16)_mm256_mulhrs_epi16((__m256i)a, (__m256i)b);
 #elif defined(SKRP_CPU_SSE41) || defined(SKRP_CPU_AVX)
@@ -5587,6 +5630,8 @@ STAGE_GG(seed_shader, NoCtx) {
     static constexpr float iota[] = {
         0.5f, 1.5f, 2.5f, 3.5f, 4.5f, 5.5f, 6.5f, 7.5f,
         8.5f, 9.5f,10.5f,11.5f,12.5f,13.5f,14.5f,15.5f,
+       16.5f,17.5f,18.5f,19.5f,20.5f,21.5f,22.5f,23.5f,
+       24.5f,25.5f,26.5f,27.5f,28.5f,29.5f,30.5f,31.5f,
     };
     static_assert(std::size(iota) >= SkRasterPipeline_kMaxStride);
 
@@ -5833,17 +5878,29 @@ SI void store(T* ptr, V v) {
         return V{ ptr[ix[ 0]], ptr[ix[ 1]], ptr[ix[ 2]], ptr[ix[ 3]],
                   ptr[ix[ 4]], ptr[ix[ 5]], ptr[ix[ 6]], ptr[ix[ 7]],
                   ptr[ix[ 8]], ptr[ix[ 9]], ptr[ix[10]], ptr[ix[11]],
-                  ptr[ix[12]], ptr[ix[13]], ptr[ix[14]], ptr[ix[15]], };
+                  ptr[ix[12]], ptr[ix[13]], ptr[ix[14]], ptr[ix[15]],
+                  ptr[ix[16]], ptr[ix[17]], ptr[ix[18]], ptr[ix[19]],
+                  ptr[ix[20]], ptr[ix[21]], ptr[ix[22]], ptr[ix[23]],
+                  ptr[ix[24]], ptr[ix[25]], ptr[ix[26]], ptr[ix[27]],
+                  ptr[ix[28]], ptr[ix[29]], ptr[ix[30]], ptr[ix[31]], };
     }
 
     template<>
     F gather(const float* ptr, U32 ix) {
-        return _mm512_i32gather_ps((__m512i)ix, ptr, 4);
+        __m512i lo, hi;
+        split(ix, &lo, &hi);
+
+        return join<F>(_mm512_i32gather_ps(lo, ptr, 4),
+                       _mm512_i32gather_ps(hi, ptr, 4));
     }
 
     template<>
     U32 gather(const uint32_t* ptr, U32 ix) {
-        return (U32)_mm512_i32gather_epi32((__m512i)ix, ptr, 4);
+        __m512i lo, hi;
+        split(ix, &lo, &hi);
+
+        return join<U32>(_mm512_i32gather_epi32(lo, ptr, 4),
+                         _mm512_i32gather_epi32(hi, ptr, 4));
     }
 
 #elif defined(SKRP_CPU_HSW)
@@ -5893,10 +5950,20 @@ SI void store(T* ptr, V v) {
 
 SI void from_8888(U32 rgba, U16* r, U16* g, U16* b, U16* a) {
 #if defined(SKRP_CPU_SKX)
-    rgba = (U32)_mm512_permutexvar_epi64(_mm512_setr_epi64(0,1,4,5,2,3,6,7), (__m512i)rgba);
+    // _mm512_packus_epi32() interleaves its arguments 128 bits at a time, so deal the 128-bit
+    // lanes (4 pixels each) out evenly and oddly to make cast_U16() come out in order.
+    __m512i _0123,_4567;
+    split(rgba, &_0123, &_4567);
+    __m512i _0246 = _mm512_permutex2var_epi64(_0123, _mm512_setr_epi64(0,1, 4,5, 8, 9,12,13),
+                                              _4567),
+            _1357 = _mm512_permutex2var_epi64(_0123, _mm512_setr_epi64(2,3, 6,7,10,11,14,15),
+                                              _4567);
+    rgba = join<U32>(_0246, _1357);
+
     auto cast_U16 = [](U32 v) -> U16 {
-        return (U16)_mm256_packus_epi32(_mm512_castsi512_si256((__m512i)v),
-                    _mm512_extracti64x4_epi64((__m512i)v, 1));
+        __m512i _0246,_1357;
+        split(v, &_0246,&_1357);
+        return (U16)_mm512_packus_epi32(_0246,_1357);
     };
 #elif defined(SKRP_CPU_HSW)
     // Swap the middle 128-bit lanes to make _mm256_packus_epi32() in cast_U16() work out nicely.
@@ -6394,7 +6461,26 @@ SI void gradient_lookup(const SkRasterPipeline_GradientCtx* c, U32 idx, F t,
                         U16* r, U16* g, U16* b, U16* a) {
 
     F fr, fg, fb, fa, br, bg, bb, ba;
-#if defined(SKRP_CPU_HSW)
+#if defined(SKRP_CPU_SKX)
+    if (c->stopCount <= 8) {
+        // The stop arrays always have room for at least 8 floats, and idx is always < 8 here, so
+        // the undefined upper half of each widened register is never read.
+        __m512i lo, hi;
+        split(idx, &lo, &hi);
+        auto lookup = [&](const float* stops) {
+            __m512 v = _mm512_castps256_ps512(_mm256_loadu_ps(stops));
+            return join<F>(_mm512_permutexvar_ps(lo, v), _mm512_permutexvar_ps(hi, v));
+        };
+        fr = lookup(c->fs[0]);
+        br = lookup(c->bs[0]);
+        fg = lookup(c->fs[1]);
+        bg = lookup(c->bs[1]);
+        fb = lookup(c->fs[2]);
+        bb = lookup(c->bs[2]);
+        fa = lookup(c->fs[3]);
+        ba = lookup(c->bs[3]);
+    } else
+#elif defined(SKRP_CPU_HSW)
     if (c->stopCount <=8) {
         __m256i lo, hi;
         split(idx, &lo, &hi);
@@ -16,7 +16,6 @@
 #include "include/core/SkColorSpace.h"
 #include "include/core/SkColorType.h"
 #include "include/core/SkData.h"
-#include "include/core/SkExecutor.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkPixmap.h"
@@ -26,7 +25,6 @@
 #include "include/encode/SkICC.h"
 #include "include/private/SkEncodedInfo.h"
 #include "include/private/base/SkAssert.h"
-#include "include/private/base/SkMutex.h"
 #include "include/private/base/SkTo.h"
 #include "modules/skcms/skcms.h"
 #include "src/codec/SkCodecPriv.h"
@@ -121,15 +119,30 @@ void emit_image_stream(SkPDFDocument* doc,
     doc->emitStream(pdfDict, std::move(writeStream), ref);
 }
 
-void do_deflated_alpha(const SkPixmap& pm, SkPDFDocument* doc, SkPDFIndirectReference ref) {
-    SkPDF::Metadata::CompressionLevel compressionLevel = doc->metadata().fCompressionLevel;
-    SkPDFStreamFormat format = compressionLevel == SkPDF::Metadata::CompressionLevel::None
+// An image's encoded streams, made without touching the document so any thread can make them.
+struct ImageStreams {
+    SkISize fSize;
+    SkPDFStreamFormat fFormat;
+    sk_sp<SkData> fData;
+    int fChannels;
+    // If set, the color space is this ICC profile rather than device RGB or gray.
+    sk_sp<SkData> fICCProfile;
+    // The soft mask, deflated like fData, if the image isn't opaque.
+    sk_sp<SkData> fAlpha;
+};
+
+SkPDFStreamFormat deflated_format(SkPDF::Metadata::CompressionLevel compressionLevel) {
+    return compressionLevel == SkPDF::Metadata::CompressionLevel::None
                              ? SkPDFStreamFormat::Uncompressed
                              : SkPDFStreamFormat::Flate;
+}
+
+sk_sp<SkData> deflate_alpha(const SkPixmap& pm,
+                            SkPDF::Metadata::CompressionLevel compressionLevel) {
     SkDynamicMemoryWStream buffer;
     SkWStream* stream = &buffer;
     std::optional<SkDeflateWStream> deflateWStream;
-    if (format == SkPDFStreamFormat::Flate) {
+    if (deflated_format(compressionLevel) == SkPDFStreamFormat::Flate) {
         deflateWStream.emplace(&buffer, SkToInt(compressionLevel));
         stream = &*deflateWStream;
     }
@@ -158,28 +171,19 @@ void do_deflated_alpha(const SkPixmap& pm, SkPDFDocument* doc, SkPDFIndirectRefe
     if (deflateWStream) {
         deflateWStream->finalize();
     }
-
-    int length = SkToInt(buffer.bytesWritten());
-    emit_image_stream(doc, ref, [&buffer](SkWStream* stream) { buffer.writeToAndReset(stream); },
-                      pm.info().dimensions(), SkPDFUnion::Name("DeviceGray"),
-                      SkPDFIndirectReference(), length, format);
+    return buffer.detachAsData();
 }
 
 SkPDFUnion write_icc_profile(SkPDFDocument* doc, sk_sp<SkData>&& icc, int channels) {
     SkPDFIndirectReference iccStreamRef;
-    {
-        static SkMutex iccProfileMapMutex;
-        SkAutoMutexExclusive lock(iccProfileMapMutex);
-
-        SkPDFIndirectReference* ref = doc->fICCProfileMap.find(SkPDFIccProfileKey{icc, channels});
-        if (ref) {
-            iccStreamRef = *ref;
-        } else {
-            std::unique_ptr<SkPDFDict> iccStreamDict = SkPDFMakeDict();
-            iccStreamDict->insertInt("N", channels);
-            iccStreamRef = SkPDFStreamOut(std::move(iccStreamDict), SkMemoryStream::Make(icc), doc);
-            doc->fICCProfileMap.set(SkPDFIccProfileKey{icc, channels}, iccStreamRef);
-        }
+    SkPDFIndirectReference* ref = doc->fICCProfileMap.find(SkPDFIccProfileKey{icc, channels});
+    if (ref) {
+        iccStreamRef = *ref;
+    } else {
+        std::unique_ptr<SkPDFDict> iccStreamDict = SkPDFMakeDict();
+        iccStreamDict->insertInt("N", channels);
+        iccStreamRef = SkPDFStreamOut(std::move(iccStreamDict), SkMemoryStream::Make(icc), doc);
+        doc->fICCProfileMap.set(SkPDFIccProfileKey{icc, channels}, iccStreamRef);
     }
 
     std::unique_ptr<SkPDFArray> iccPDF = SkPDFMakeArray();
@@ -196,41 +200,32 @@ bool icc_channel_mismatch(const skcms_ICCProfile* iccProfile, int expectedChanne
     return 0 < iccChannels && expectedChannels != iccChannels;
 }
 
-void do_deflated_image(const SkPixmap& pm,
-                       SkPDFDocument* doc,
-                       bool isOpaque,
-                       SkPDFIndirectReference ref) {
-    SkPDFIndirectReference sMask;
-    if (!isOpaque) {
-        sMask = doc->reserveRef();
-    }
-    SkPDF::Metadata::CompressionLevel compressionLevel = doc->metadata().fCompressionLevel;
-    SkPDFStreamFormat format = compressionLevel == SkPDF::Metadata::CompressionLevel::None
-                             ? SkPDFStreamFormat::Uncompressed
-                             : SkPDFStreamFormat::Flate;
+ImageStreams make_deflated_image(const SkPixmap& pm,
+                                 bool isOpaque,
+                                 SkPDF::Metadata::CompressionLevel compressionLevel) {
+    ImageStreams streams;
+    streams.fSize = pm.info().dimensions();
+    streams.fFormat = deflated_format(compressionLevel);
     SkDynamicMemoryWStream buffer;
     SkWStream* stream = &buffer;
     std::optional<SkDeflateWStream> deflateWStream;
-    if (format == SkPDFStreamFormat::Flate) {
+    if (streams.fFormat == SkPDFStreamFormat::Flate) {
         deflateWStream.emplace(&buffer, SkToInt(compressionLevel));
         stream = &*deflateWStream;
     }
-    SkPDFUnion colorSpace = SkPDFUnion::Name("DeviceGray");
-    int channels;
     switch (pm.colorType()) {
         case kAlpha_8_SkColorType:
-            channels = 1;
+            streams.fChannels = 1;
             fill_stream(stream, '\x00', pm.width() * pm.height());
             break;
         case kGray_8_SkColorType:
-            channels = 1;
-            SkASSERT(sMask.fValue = -1);
+            streams.fChannels = 1;
+            SkASSERT(isOpaque);
             SkASSERT(pm.rowBytes() == (size_t)pm.width());
             stream->write(pm.addr8(), pm.width() * pm.height());
             break;
         default:
-            colorSpace = SkPDFUnion::Name("DeviceRGB");
-            channels = 3;
+            streams.fChannels = 3;
             SkASSERT(pm.alphaType() == kUnpremul_SkAlphaType);
             SkASSERT(pm.colorType() == kBGRA_8888_SkColorType);
             SkASSERT(pm.rowBytes() == (size_t)pm.width() * 4);
@@ -259,33 +254,32 @@ void do_deflated_image(const SkPixmap& pm,
     if (deflateWStream) {
         deflateWStream->finalize();
     }
+    streams.fData = buffer.detachAsData();
 
     if (pm.colorSpace()) {
         skcms_ICCProfile iccProfile;
         pm.colorSpace()->toProfile(&iccProfile);
-        if (!icc_channel_mismatch(&iccProfile, channels)) {
-            sk_sp<SkData> iccData = SkWriteICCProfile(&iccProfile, "");
-            colorSpace = write_icc_profile(doc, std::move(iccData), channels);
+        if (!icc_channel_mismatch(&iccProfile, streams.fChannels)) {
+            streams.fICCProfile = SkWriteICCProfile(&iccProfile, "");
         }
     }
 
-    int length = SkToInt(buffer.bytesWritten());
-    emit_image_stream(doc, ref, [&buffer](SkWStream* stream) { buffer.writeToAndReset(stream); },
-                      pm.info().dimensions(), std::move(colorSpace), sMask, length, format);
     if (!isOpaque) {
-        do_deflated_alpha(pm, doc, sMask);
+        streams.fAlpha = deflate_alpha(pm, compressionLevel);
     }
+    return streams;
 }
 
-bool do_jpeg(sk_sp<SkData> data, SkColorSpace* imageColorSpace, SkPDFDocument* doc, SkISize size,
-             SkPDFIndirectReference ref) {
-    SkPDF::DecodeJpegCallback decodeJPEG = doc->metadata().jpegDecoder;
+std::optional<ImageStreams> make_jpeg(sk_sp<SkData> data,
+                                      SkColorSpace* imageColorSpace,
+                                      const SkPDF::DecodeJpegCallback& decodeJPEG,
+                                      SkISize size) {
     if (!decodeJPEG) {
-        return false;
+        return std::nullopt;
     }
     std::unique_ptr<SkCodec> codec = decodeJPEG(data);
     if (!codec) {
-        return false;
+        return std::nullopt;
     }
 
     SkISize jpegSize = codec->dimensions();
@@ -298,35 +292,32 @@ bool do_jpeg(sk_sp<SkData> data, SkColorSpace* imageColorSpace, SkPDFDocument* d
     if (jpegSize != size  // Safety check.
             || !goodColorType
             || kTopLeft_SkEncodedOrigin != exifOrientation) {
-        return false;
+        return std::nullopt;
     }
 
-    int channels = yuv ? 3 : 1;
-    SkPDFUnion colorSpace = yuv ? SkPDFUnion::Name("DeviceRGB") : SkPDFUnion::Name("DeviceGray");
+    ImageStreams streams;
+    streams.fSize = jpegSize;
+    streams.fFormat = SkPDFStreamFormat::DCT;
+    streams.fChannels = yuv ? 3 : 1;
 
     if (sk_sp<SkData> encodedIccProfileData = encodedInfo.profileData();
-        encodedIccProfileData && !icc_channel_mismatch(encodedInfo.profile(), channels))
+        encodedIccProfileData && !icc_channel_mismatch(encodedInfo.profile(), streams.fChannels))
     {
-        colorSpace = write_icc_profile(doc, std::move(encodedIccProfileData), channels);
+        streams.fICCProfile = std::move(encodedIccProfileData);
     } else if (const skcms_ICCProfile* codecIccProfile = codec->getICCProfile();
-               codecIccProfile && !icc_channel_mismatch(codecIccProfile, channels))
+               codecIccProfile && !icc_channel_mismatch(codecIccProfile, streams.fChannels))
     {
-        sk_sp<SkData> codecIccData = SkWriteICCProfile(codecIccProfile, "");
-        colorSpace = write_icc_profile(doc, std::move(codecIccData), channels);
+        streams.fICCProfile = SkWriteICCProfile(codecIccProfile, "");
     } else if (imageColorSpace) {
         skcms_ICCProfile imageIccProfile;
         imageColorSpace->toProfile(&imageIccProfile);
-        if (!icc_channel_mismatch(&imageIccProfile, channels)) {
-            sk_sp<SkData> imageIccData = SkWriteICCProfile(&imageIccProfile, "");
-            colorSpace = write_icc_profile(doc, std::move(imageIccData), channels);
+        if (!icc_channel_mismatch(&imageIccProfile, streams.fChannels)) {
+            streams.fICCProfile = SkWriteICCProfile(&imageIccProfile, "");
         }
     }
 
-    emit_image_stream(doc, ref,
-                      [&data](SkWStream* dst) { dst->write(data->data(), data->size()); },
-                      jpegSize, std::move(colorSpace),
-                      SkPDFIndirectReference(), SkToInt(data->size()), SkPDFStreamFormat::DCT);
-    return true;
+    streams.fData = std::move(data);
+    return streams;
 }
 
 SkBitmap to_pixels(const SkImage* image) {
@@ -354,34 +345,55 @@ SkBitmap to_pixels(const SkImage* image) {
     return bm;
 }
 
-void serialize_image(const SkImage* img,
-                     int encodingQuality,
-                     SkPDFDocument* doc,
-                     SkPDFIndirectReference ref) {
+ImageStreams make_image_streams(const SkImage* img,
+                                int encodingQuality,
+                                const SkPDF::Metadata& metadata) {
     SkASSERT(img);
-    SkASSERT(doc);
     SkASSERT(encodingQuality >= 0);
     SkISize dimensions = img->dimensions();
 
     if (sk_sp<SkData> data = img->refEncodedData()) {
-        if (do_jpeg(std::move(data), img->colorSpace(), doc, dimensions, ref)) {
-            return;
+        if (auto streams = make_jpeg(std::move(data), img->colorSpace(), metadata.jpegDecoder,
+                                     dimensions)) {
+            return std::move(*streams);
         }
     }
     SkBitmap bm = to_pixels(img);
     const SkPixmap& pm = bm.pixmap();
-    SkPDF::EncodeJpegCallback encodeJPEG = doc->metadata().jpegEncoder;
+    SkPDF::EncodeJpegCallback encodeJPEG = metadata.jpegEncoder;
 
     bool isOpaque = pm.isOpaque() || pm.computeIsOpaque();
     if (encodeJPEG && encodingQuality <= 100 && isOpaque) {
         SkDynamicMemoryWStream stream;
         if (encodeJPEG(&stream, pm, encodingQuality)) {
-            if (do_jpeg(stream.detachAsData(), pm.colorSpace(), doc, dimensions, ref)) {
-                return;
+            if (auto streams = make_jpeg(stream.detachAsData(), pm.colorSpace(),
+                                         metadata.jpegDecoder, dimensions)) {
+                return std::move(*streams);
             }
         }
     }
-    do_deflated_image(pm, doc, isOpaque, ref);
+    return make_deflated_image(pm, isOpaque, metadata.fCompressionLevel);
+}
+
+void emit_image(SkPDFDocument* doc, SkPDFIndirectReference ref, ImageStreams* streams) {
+    SkPDFIndirectReference sMask;
+    if (streams->fAlpha) {
+        sMask = doc->reserveRef();
+    }
+    SkPDFUnion colorSpace = streams->fICCProfile
+            ? write_icc_profile(doc, std::move(streams->fICCProfile), streams->fChannels)
+            : SkPDFUnion::Name(streams->fChannels == 3 ? "DeviceRGB" : "DeviceGray");
+
+    const SkData* data = streams->fData.get();
+    emit_image_stream(doc, ref, [data](SkWStream* dst) { dst->write(data->data(), data->size()); },
+                      streams->fSize, std::move(colorSpace), sMask, SkToInt(data->size()),
+                      streams->fFormat);
+    if (const SkData* alpha = streams->fAlpha.get()) {
+        emit_image_stream(doc, sMask,
+                          [alpha](SkWStream* dst) { dst->write(alpha->data(), alpha->size()); },
+                          streams->fSize, SkPDFUnion::Name("DeviceGray"),
+                          SkPDFIndirectReference(), SkToInt(alpha->size()), streams->fFormat);
+    }
 }
 
 } // namespace
@@ -392,16 +404,11 @@ SkPDFIndirectReference SkPDFSerializeImage(const SkImage* img,
     SkASSERT(img);
     SkASSERT(doc);
     SkPDFIndirectReference ref = doc->reserveRef();
-    if (SkExecutor* executor = doc->executor()) {
-        SkRef(img);
-        doc->incrementJobCount();
-        executor->add([img, encodingQuality, doc, ref]() {
-            serialize_image(img, encodingQuality, doc, ref);
-            SkSafeUnref(img);
-            doc->signalJobComplete();
-        });
-        return ref;
-    }
-    serialize_image(img, encodingQuality, doc, ref);
+    auto streams = std::make_shared<ImageStreams>();
+    doc->queueJob(
+            [streams, img = sk_ref_sp(img), encodingQuality, &metadata = doc->metadata()] {
+                *streams = make_image_streams(img.get(), encodingQuality, metadata);
+            },
+            [streams, doc, ref] { emit_image(doc, ref, streams.get()); });
     return ref;
 }
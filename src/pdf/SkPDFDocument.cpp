@@ -9,6 +9,7 @@
 
 #include "include/core/SkCanvas.h"
 #include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkMatrix.h"
 #include "include/core/SkRect.h"
@@ -42,6 +43,9 @@
 #include <algorithm>
 #include <atomic>
 #include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
 #include <new>
 #include <utility>
 
@@ -400,10 +404,13 @@ void SkPDFDocument::onEndPage() {
 
     fPages.emplace_back(std::move(page));
     fPageDevice = nullptr;
+
+    // Leave the jobs from this page running while the next is drawn.
+    this->emitJobs(fPages.size() - 1);
 }
 
 void SkPDFDocument::onAbort() {
-    this->waitForJobs();
+    this->abandonJobs();
 }
 
 static sk_sp<SkData> SkSrgbIcm() {
@@ -612,7 +619,7 @@ SkString SkPDFDocument::nextFontSubsetTag() {
 void SkPDFDocument::onClose(SkWStream* stream) {
     SkASSERT(fCanvas.imageInfo().dimensions().isZero());
     if (fPages.empty()) {
-        this->waitForJobs();
+        this->abandonJobs();
         return;
     }
     auto docCatalog = SkPDFMakeDict("Catalog");
@@ -665,23 +672,44 @@ void SkPDFDocument::onClose(SkWStream* stream) {
         f->emitSubset(this);
     }
 
-    this->waitForJobs();
+    this->emitJobs(SIZE_MAX);
     {
         SkAutoMutexExclusive autoMutexAcquire(fMutex);
         serialize_footer(fOffsetMap, this->getStream(), fInfoDict, docCatalogRef, fUUID);
     }
 }
 
-void SkPDFDocument::incrementJobCount() { fJobCount++; }
+void SkPDFDocument::queueJob(std::function<void()> work, std::function<void()> emit) {
+    auto job = std::make_unique<Job>();
+    job->fEmit = std::move(emit);
+    job->fPagesEnded = fPages.size();
+    if (fExecutor) {
+        fExecutor->add([work = std::move(work), job = job.get()] {
+            work();
+            job->fWorkDone.signal();
+        });
+    } else {
+        work();
+        job->fWorkDone.signal();
+    }
+    fJobs.push_back(std::move(job));
+}
 
-void SkPDFDocument::signalJobComplete() { fSemaphore.signal(); }
+void SkPDFDocument::emitJobs(size_t pagesEnded) {
+    // Emitting a job may queue more (like an image's ICC profile), which join the back.
+    while (!fJobs.empty() && fJobs.front()->fPagesEnded < pagesEnded) {
+        std::unique_ptr<Job> job = std::move(fJobs.front());
+        fJobs.pop_front();
+        job->fWorkDone.wait();
+        job->fEmit();
+    }
+}
 
-void SkPDFDocument::waitForJobs() {
-     // fJobCount can increase while we wait.
-     while (fJobCount > 0) {
-         fSemaphore.wait();
-         --fJobCount;
-     }
+void SkPDFDocument::abandonJobs() {
+    for (const std::unique_ptr<Job>& job : fJobs) {
+        job->fWorkDone.wait();
+    }
+    fJobs.clear();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -34,6 +34,8 @@
 #include <cstddef>
 #include <cstdint>
 #include <atomic>
+#include <deque>
+#include <functional>
 #include <vector>
 #include <memory>
 
@@ -154,8 +156,17 @@ public:
     SkString nextFontSubsetTag();
 
     SkExecutor* executor() const { return fExecutor; }
-    void incrementJobCount();
-    void signalJobComplete();
+
+    /**
+       Runs `work` on the executor (or right away, without one), and then `emit` on this thread
+       to write out what it made. Jobs are emitted in the order they were queued, once the page
+       after the one they were queued during has ended, or when the document is closed.
+
+       Since when a job is emitted depends on neither the executor nor timing, objects are
+       numbered and written in the same order with or without an executor: `emit` is where
+       any other objects the job needs should be reserved and emitted, never `work`.
+     */
+    void queueJob(std::function<void()> work, std::function<void()> emit);
     size_t currentPageIndex() { return fPages.size(); }
     size_t pageCount() { return fPageRefs.size(); }
 
@@ -198,7 +209,6 @@ private:
 
     sk_sp<SkPDFDevice> fPageDevice;
     std::atomic<int> fNextObjectNumber = {1};
-    std::atomic<int> fJobCount = {0};
     uint32_t fNextFontSubsetTag = {0};
     SkUUID fUUID;
     SkPDFIndirectReference fInfoDict;
@@ -212,9 +222,20 @@ private:
     SkPDFStructTree fStructTree;
 
     SkMutex fMutex;
-    SkSemaphore fSemaphore;
 
-    void waitForJobs();
+    struct Job {
+        std::function<void()> fEmit;
+        // The number of pages that had ended when the job was queued.
+        size_t fPagesEnded;
+        SkSemaphore fWorkDone;
+    };
+    std::deque<std::unique_ptr<Job>> fJobs;
+
+    // Emits, in order, the jobs queued before `pagesEnded` pages had ended, waiting for their work
+    // as needed. SIZE_MAX emits them all, including any queued by the emits themselves.
+    void emitJobs(size_t pagesEnded);
+    // Waits for every job's work, without emitting any of them.
+    void abandonJobs();
     SkWStream* beginObject(SkPDFIndirectReference);
     void endObject();
 };
@@ -465,22 +465,28 @@ static void emit_subset_type0(const SkPDFFont& font, SkPDFDocument* doc) {
                  "empty stream (%p) when identified as kType1CID_Font "
                  "or kTrueType_Font.\n", &typeface, fontAsset.get());
     } else if (type == SkAdvancedTypefaceMetrics::kTrueType_Font) {
-        sk_sp<SkData> subsetFontData;
-        if (can_subset(metrics)) {
-            SkASSERT(font.firstGlyphID() == 1);
-            subsetFontData = SkPDFSubsetFont(typeface, font.glyphUsage());
-        }
-        std::unique_ptr<SkStreamAsset> subsetFontAsset;
-        if (subsetFontData) {
-            subsetFontAsset = SkMemoryStream::Make(std::move(subsetFontData));
-        } else {
-            // If subsetting fails, fall back to original font data.
-            subsetFontAsset = std::move(fontAsset);
-        }
-        std::unique_ptr<SkPDFDict> streamDict = SkPDFMakeDict();
-        streamDict->insertInt("Length1", subsetFontAsset->getLength());
+        // Subsetting is slow, so it's done along with compressing the font, on the executor if
+        // there is one.
+        const bool canSubset = can_subset(metrics);
+        SkASSERT(!canSubset || font.firstGlyphID() == 1);
+        auto fontHolder = std::make_shared<std::unique_ptr<SkStreamAsset>>(std::move(fontAsset));
+        auto makeFontFile = [&typeface, &font, canSubset, fontHolder](SkPDFDict* streamDict) {
+            sk_sp<SkData> subsetFontData;
+            if (canSubset) {
+                subsetFontData = SkPDFSubsetFont(typeface, font.glyphUsage());
+            }
+            std::unique_ptr<SkStreamAsset> subsetFontAsset;
+            if (subsetFontData) {
+                subsetFontAsset = SkMemoryStream::Make(std::move(subsetFontData));
+            } else {
+                // If subsetting fails, fall back to original font data.
+                subsetFontAsset = std::move(*fontHolder);
+            }
+            streamDict->insertInt("Length1", subsetFontAsset->getLength());
+            return subsetFontAsset;
+        };
         descriptor->insertRef("FontFile2",
-                              SkPDFStreamOut(std::move(streamDict), std::move(subsetFontAsset),
+                              SkPDFStreamOut(nullptr, std::move(makeFontFile),
                                              doc, SkPDFSteamCompressionEnabled::Yes));
     } else if (type == SkAdvancedTypefaceMetrics::kType1CID_Font) {
         std::unique_ptr<SkPDFDict> streamDict = SkPDFMakeDict();
@@ -7,7 +7,6 @@
 
 #include "src/pdf/SkPDFTypes.h"
 
-#include "include/core/SkExecutor.h"
 #include "include/core/SkStream.h"
 #include "include/core/SkString.h"
 #include "include/docs/SkPDFDocument.h"
@@ -23,6 +22,7 @@
 
 #include <cstring>
 #include <functional>
+#include <memory>
 #include <new>
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -549,60 +549,72 @@ void SkPDFDict::insertUnion(const char key[], SkPDFUnion&& value) {
 
 
 
-static void serialize_stream(SkPDFDict* origDict,
-                             SkStreamAsset* stream,
-                             SkPDFSteamCompressionEnabled compress,
-                             SkPDFDocument* doc,
-                             SkPDFIndirectReference ref) {
+namespace {
+struct StreamJob {
+    std::unique_ptr<SkPDFDict> fDict;
+    std::unique_ptr<SkStreamAsset> fStream;
+};
+}  // namespace
+
+// Compresses the stream if that saves space, and fills in the dict to match.
+static void compress_stream(StreamJob* job,
+                            SkPDFSteamCompressionEnabled compress,
+                            SkPDF::Metadata::CompressionLevel compressionLevel) {
     // Code assumes that the stream starts at the beginning.
-    SkASSERT(stream && stream->hasLength());
+    SkASSERT(job->fStream && job->fStream->hasLength());
 
-    std::unique_ptr<SkStreamAsset> tmp;
-    SkPDFDict tmpDict;
-    SkPDFDict& dict = origDict ? *origDict : tmpDict;
     static const size_t kMinimumSavings = strlen("/Filter_/FlateDecode_");
-    if (doc->metadata().fCompressionLevel != SkPDF::Metadata::CompressionLevel::None &&
+    if (compressionLevel != SkPDF::Metadata::CompressionLevel::None &&
         compress == SkPDFSteamCompressionEnabled::Yes &&
-        stream->getLength() > kMinimumSavings)
+        job->fStream->getLength() > kMinimumSavings)
     {
         SkDynamicMemoryWStream compressedData;
-        SkDeflateWStream deflateWStream(&compressedData,SkToInt(doc->metadata().fCompressionLevel));
-        SkStreamCopy(&deflateWStream, stream);
+        SkDeflateWStream deflateWStream(&compressedData, SkToInt(compressionLevel));
+        SkStreamCopy(&deflateWStream, job->fStream.get());
         deflateWStream.finalize();
-        if (stream->getLength() > compressedData.bytesWritten() + kMinimumSavings) {
-            tmp = compressedData.detachAsStream();
-            stream = tmp.get();
-            dict.insertName("Filter", "FlateDecode");
+        if (job->fStream->getLength() > compressedData.bytesWritten() + kMinimumSavings) {
+            job->fStream = compressedData.detachAsStream();
+            job->fDict->insertName("Filter", "FlateDecode");
         } else {
-            SkAssertResult(stream->rewind());
+            SkAssertResult(job->fStream->rewind());
         }
 
     }
-    dict.insertInt("Length", stream->getLength());
-    doc->emitStream(dict,
-                    [stream](SkWStream* dst) { dst->writeStream(stream, stream->getLength()); },
-                    ref);
+    job->fDict->insertInt("Length", job->fStream->getLength());
+}
+
+SkPDFIndirectReference SkPDFStreamOut(
+        std::unique_ptr<SkPDFDict> dict,
+        std::function<std::unique_ptr<SkStreamAsset>(SkPDFDict*)> makeStream,
+        SkPDFDocument* doc,
+        SkPDFSteamCompressionEnabled compress) {
+    SkPDFIndirectReference ref = doc->reserveRef();
+    auto job = std::make_shared<StreamJob>();
+    job->fDict = dict ? std::move(dict) : std::make_unique<SkPDFDict>();
+    doc->queueJob(
+            [job, makeStream = std::move(makeStream), compress,
+             compressionLevel = doc->metadata().fCompressionLevel] {
+                job->fStream = makeStream(job->fDict.get());
+                compress_stream(job.get(), compress, compressionLevel);
+            },
+            [job, doc, ref] {
+                SkStreamAsset* stream = job->fStream.get();
+                doc->emitStream(*job->fDict,
+                                [stream](SkWStream* dst) {
+                                    dst->writeStream(stream, stream->getLength());
+                                },
+                                ref);
+            });
+    return ref;
 }
 
 SkPDFIndirectReference SkPDFStreamOut(std::unique_ptr<SkPDFDict> dict,
                                       std::unique_ptr<SkStreamAsset> content,
                                       SkPDFDocument* doc,
                                       SkPDFSteamCompressionEnabled compress) {
-    SkPDFIndirectReference ref = doc->reserveRef();
-    if (SkExecutor* executor = doc->executor()) {
-        SkPDFDict* dictPtr = dict.release();
-        SkStreamAsset* contentPtr = content.release();
-        // Pass ownership of both pointers into a std::function, which should
-        // only be executed once.
-        doc->incrementJobCount();
-        executor->add([dictPtr, contentPtr, compress, doc, ref]() {
-            serialize_stream(dictPtr, contentPtr, compress, doc, ref);
-            delete dictPtr;
-            delete contentPtr;
-            doc->signalJobComplete();
-        });
-        return ref;
-    }
-    serialize_stream(dict.get(), content.get(), compress, doc, ref);
-    return ref;
+    // std::function needs to be copyable.
+    auto contentHolder = std::make_shared<std::unique_ptr<SkStreamAsset>>(std::move(content));
+    return SkPDFStreamOut(std::move(dict),
+                          [contentHolder](SkPDFDict*) { return std::move(*contentHolder); },
+                          doc, compress);
 }
@@ -15,6 +15,7 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -224,4 +225,12 @@ SkPDFIndirectReference SkPDFStreamOut(
     std::unique_ptr<SkStreamAsset> stream,
     SkPDFDocument* doc,
     SkPDFSteamCompressionEnabled compress = SkPDFSteamCompressionEnabled::Yes);
+
+// Like the above, but the stream is made by `makeStream`, which may also add to the dict. It runs
+// on the document's executor, if it has one, so it must not touch the document.
+SkPDFIndirectReference SkPDFStreamOut(
+    std::unique_ptr<SkPDFDict> dict,
+    std::function<std::unique_ptr<SkStreamAsset>(SkPDFDict*)> makeStream,
+    SkPDFDocument* doc,
+    SkPDFSteamCompressionEnabled compress = SkPDFSteamCompressionEnabled::Yes);
 #endif
@@ -12,6 +12,8 @@
 #include "include/core/SkColor.h"
 #include "include/core/SkColorPriv.h"
 #include "include/core/SkColorType.h"
+#include "include/core/SkImage.h"
+#include "include/core/SkImageFilter.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkMaskFilter.h"
 #include "include/core/SkPaint.h"
@@ -22,10 +24,14 @@
 #include "include/core/SkRRect.h"
 #include "include/core/SkRect.h"
 #include "include/core/SkRefCnt.h"
+#include "include/core/SkSamplingOptions.h"
 #include "include/core/SkScalar.h"
 #include "include/core/SkSize.h"
 #include "include/core/SkSurface.h"
+#include "include/core/SkSurfaceProps.h"
+#include "include/core/SkTileMode.h"
 #include "include/core/SkTypes.h"
+#include "include/effects/SkImageFilters.h"
 #include "include/effects/SkPerlinNoiseShader.h"
 #include "include/gpu/GpuTypes.h"
 #include "include/gpu/ganesh/GrDirectContext.h"
@@ -33,9 +39,11 @@
 #include "include/private/base/SkTPin.h"
 #include "src/base/SkFloatBits.h"
 #include "src/base/SkMathPriv.h"
+#include "src/core/SkBlurEngine.h"
 #include "src/core/SkBlurMask.h"
 #include "src/core/SkMask.h"
 #include "src/core/SkMaskFilterBase.h"
+#include "src/core/SkSpecialImage.h"
 #include "src/effects/SkEmbossMaskFilter.h"
 #include "src/gpu/ganesh/GrBlurUtils.h"
 #include "tests/CtsEnforcement.h"
@@ -44,9 +52,11 @@
 
 #include <math.h>
 #include <string.h>
+#include <algorithm>
 #include <array>
 #include <cstddef>
 #include <cstdint>
+#include <cstdlib>
 #include <initializer_list>
 
 struct GrContextOptions;
@@ -587,3 +597,75 @@ DEF_TEST(zero_blur, reporter) {
     SkIPoint offset;
     bitmap.extractAlpha(&alpha, &paint, nullptr, &offset);
 }
+
+// Past gSkRasterBlurDownscaleSigma the raster blur engine blurs a downscaled copy of the image.
+// The algorithm itself never downscales, so calling it directly gives the full resolution blur
+// to measure the downscaled one against.
+DEF_TEST(BlurImageFilter_RasterDownscaleError, reporter) {
+    constexpr int kSize = 256;
+    SkBitmap shapes;
+    shapes.allocN32Pixels(kSize, kSize);
+    shapes.eraseColor(SK_ColorTRANSPARENT);
+    {
+        SkCanvas canvas(shapes);
+        SkPaint paint;
+        paint.setColor(SK_ColorWHITE);
+        canvas.drawRect(SkRect::MakeXYWH(30, 30, 80, 190), paint);
+        paint.setColor(SK_ColorRED);
+        canvas.drawCircle(180, 80, 50, paint);
+        paint.setColor(SK_ColorGREEN);
+        canvas.drawRect(SkRect::MakeXYWH(120, 160, 100, 12), paint);
+    }
+    const SkIRect bounds = SkIRect::MakeSize(shapes.dimensions());
+
+    for (float sigma : {16.f, 24.f, 32.f, 48.f, 64.f, 100.f}) {
+        SkBitmap full;
+        full.allocN32Pixels(kSize, kSize);
+        full.eraseColor(SK_ColorTRANSPARENT);
+        {
+            const SkBlurEngine::Algorithm* algorithm =
+                    SkBlurEngine::GetRasterBlurEngine()->findAlgorithm({sigma, sigma},
+                                                                       shapes.colorType());
+            sk_sp<SkSpecialImage> blurred = algorithm->blur(
+                    {sigma, sigma},
+                    SkSpecialImages::MakeFromRaster(bounds, shapes, SkSurfaceProps()),
+                    bounds, SkTileMode::kDecal, bounds);
+            SkCanvas canvas(full);
+            blurred->draw(&canvas, 0, 0);
+        }
+
+        SkBitmap downscaled;
+        downscaled.allocN32Pixels(kSize, kSize);
+        downscaled.eraseColor(SK_ColorTRANSPARENT);
+        {
+            SkCanvas canvas(downscaled);
+            SkPaint paint;
+            paint.setImageFilter(SkImageFilters::Blur(sigma, sigma, nullptr));
+            canvas.drawImage(shapes.asImage(), 0, 0, SkSamplingOptions(), &paint);
+        }
+
+        int maxError = 0;
+        double totalError = 0;
+        for (int y = 0; y < kSize; ++y) {
+            for (int x = 0; x < kSize; ++x) {
+                uint32_t a = *full.getAddr32(x, y),
+                         b = *downscaled.getAddr32(x, y);
+                for (int shift = 0; shift < 32; shift += 8) {
+                    int error = std::abs(int((a >> shift) & 0xFF) - int((b >> shift) & 0xFF));
+                    maxError = std::max(maxError, error);
+                    totalError += error;
+                }
+            }
+        }
+        const double meanError = totalError / (kSize * kSize * 4);
+
+        if (sigma <= gSkRasterBlurDownscaleSigma) {
+            // Below the threshold nothing is downscaled.
+            REPORTER_ASSERT(reporter, maxError == 0, "sigma %g: max error %d", sigma, maxError);
+        } else {
+            REPORTER_ASSERT(reporter, maxError <= 4, "sigma %g: max error %d", sigma, maxError);
+            REPORTER_ASSERT(reporter, meanError <= 1.0,
+                            "sigma %g: mean error %g", sigma, meanError);
+        }
+    }
+}
@@ -16,6 +16,7 @@
 #include "include/core/SkColorType.h"
 #include "include/core/SkData.h"
 #include "include/core/SkDataTable.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkPixmap.h"
@@ -49,6 +50,7 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <cstring>
 #include <initializer_list>
 #include <memory>
 #include <string>
@@ -543,6 +545,119 @@ DEF_TEST(Encode_PngOptions, r) {
     REPORTER_ASSERT(r, almost_equals(bm0, bm2, 0));
 }
 
+#if defined(SK_CODEC_DECODES_PNG_WITH_LIBPNG)
+static SkBitmap decode_png(sk_sp<SkData> data, SkColorType colorType) {
+    SkBitmap bitmap;
+    std::unique_ptr<SkCodec> codec = SkPngDecoder::Decode(std::move(data), nullptr);
+    if (codec) {
+        bitmap.allocPixels(codec->getInfo().makeColorType(colorType));
+        if (SkCodec::kSuccess != codec->getPixels(bitmap.pixmap())) {
+            bitmap.reset();
+        }
+    }
+    return bitmap;
+}
+
+// Encoding in parallel bands makes a PNG (with a valid zlib stream, which libpng checks) that
+// decodes to the same pixels, and is not much bigger.
+DEF_TEST(Encode_PngParallel, r) {
+    SkBitmap mandrill;
+    if (!ToolUtils::GetResourceAsBitmap("images/mandrill_512.png", &mandrill)) {
+        return;
+    }
+    SkBitmap mandrillF16;
+    mandrillF16.allocPixels(mandrill.info().makeColorType(kRGBA_F16_SkColorType));
+    mandrill.readPixels(mandrillF16.pixmap());
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    for (const SkBitmap& src : {mandrill, mandrillF16}) {
+        const SkColorType decodedType = src.colorType() == kRGBA_F16_SkColorType
+                                                ? kRGBA_F16_SkColorType
+                                                : kN32_SkColorType;
+        for (SkPngEncoder::FilterFlag filters : {SkPngEncoder::FilterFlag::kAll,
+                                                 SkPngEncoder::FilterFlag::kNone,
+                                                 SkPngEncoder::FilterFlag::kPaeth,
+                                                 SkPngEncoder::FilterFlag::kSub |
+                                                         SkPngEncoder::FilterFlag::kAvg}) {
+            for (int zlibLevel : {0, 1, 6, 9}) {
+                SkPngEncoder::Options options;
+                options.fFilterFlags = filters;
+                options.fZLibLevel = zlibLevel;
+                SkDynamicMemoryWStream serial, parallel;
+                REPORTER_ASSERT(r, SkPngEncoder::Encode(&serial, src.pixmap(), options));
+
+                // Rows are handed over a few at a time, not all at once.
+                options.fExecutor = executor.get();
+                std::unique_ptr<SkEncoder> encoder =
+                        SkPngEncoder::Make(&parallel, src.pixmap(), options);
+                REPORTER_ASSERT(r, encoder);
+                for (int y = 0; encoder && y < src.height(); y += 7) {
+                    REPORTER_ASSERT(r, encoder->encodeRows(std::min(7, src.height() - y)));
+                }
+
+                sk_sp<SkData> serialData = serial.detachAsData(),
+                              parallelData = parallel.detachAsData();
+                const SkBitmap expected = decode_png(serialData, decodedType),
+                               actual = decode_png(parallelData, decodedType);
+                REPORTER_ASSERT(r, !actual.drawsNothing(),
+                                "filters 0x%x, level %d", (int)filters, zlibLevel);
+                REPORTER_ASSERT(r, !actual.drawsNothing() &&
+                                   0 == memcmp(expected.getPixels(), actual.getPixels(),
+                                               expected.computeByteSize()));
+                REPORTER_ASSERT(r, parallelData->size() <= serialData->size() * 51 / 50,
+                                "filters 0x%x, level %d: %zu vs %zu bytes", (int)filters,
+                                zlibLevel, parallelData->size(), serialData->size());
+            }
+        }
+    }
+}
+
+// Choosing filters on a sample of the rows, serially or in parallel, makes the same image, at most
+// a little bigger than choosing on every row.
+DEF_TEST(Encode_PngFilterSelection, r) {
+    SkBitmap mandrill;
+    if (!ToolUtils::GetResourceAsBitmap("images/mandrill_512.png", &mandrill)) {
+        return;
+    }
+    SkBitmap mandrillF16;
+    mandrillF16.allocPixels(mandrill.info().makeColorType(kRGBA_F16_SkColorType));
+    mandrill.readPixels(mandrillF16.pixmap());
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    for (const SkBitmap& src : {mandrill, mandrillF16}) {
+        const SkColorType decodedType = src.colorType() == kRGBA_F16_SkColorType
+                                                ? kRGBA_F16_SkColorType
+                                                : kN32_SkColorType;
+        for (SkPngEncoder::FilterFlag filters : {SkPngEncoder::FilterFlag::kAll,
+                                                 SkPngEncoder::FilterFlag::kSub |
+                                                         SkPngEncoder::FilterFlag::kAvg |
+                                                         SkPngEncoder::FilterFlag::kPaeth}) {
+            for (SkExecutor* exec : {(SkExecutor*)nullptr, executor.get()}) {
+                SkPngEncoder::Options options;
+                options.fFilterFlags = filters;
+                options.fExecutor = exec;
+                SkDynamicMemoryWStream perRow, sampled;
+                REPORTER_ASSERT(r, SkPngEncoder::Encode(&perRow, src.pixmap(), options));
+                options.fFilterSelection = SkPngEncoder::FilterSelection::kSampled;
+                REPORTER_ASSERT(r, SkPngEncoder::Encode(&sampled, src.pixmap(), options));
+
+                sk_sp<SkData> perRowData = perRow.detachAsData(),
+                              sampledData = sampled.detachAsData();
+                const SkBitmap expected = decode_png(perRowData, decodedType),
+                               actual = decode_png(sampledData, decodedType);
+                REPORTER_ASSERT(r, !actual.drawsNothing() &&
+                                   0 == memcmp(expected.getPixels(), actual.getPixels(),
+                                               expected.computeByteSize()));
+                REPORTER_ASSERT(r, sampledData->size() <= perRowData->size() * 21 / 20,
+                                "filters 0x%x, %s: %zu vs %zu bytes", (int)filters,
+                                exec ? "parallel" : "serial", sampledData->size(),
+                                perRowData->size());
+            }
+        }
+    }
+}
+#endif
+
 #ifndef SK_BUILD_FOR_GOOGLE3
 DEF_TEST(Encode_WebpQuality, r) {
     SkBitmap bm;
@@ -0,0 +1,74 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkExecutor.h"
+#include "src/base/SkArenaAlloc.h"
+#include "src/core/SkTaskGroup.h"
+#include "tests/Test.h"
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+static void test_executor(skiatest::Reporter* reporter,
+                          const std::function<std::unique_ptr<SkExecutor>(int)>& make) {
+    for (int threads : {1, 3, 8}) {
+        std::unique_ptr<SkExecutor> executor = make(threads);
+
+        // Every task runs exactly once.
+        std::atomic<int> sum{0};
+        SkTaskGroup tg(*executor);
+        tg.batch(1000, [&](int i) { sum.fetch_add(i, std::memory_order_relaxed); });
+        tg.wait();
+        REPORTER_ASSERT(reporter, sum.load() == 999 * 1000 / 2);
+
+        // Tasks can add more work to the same executor and wait on it.
+        std::atomic<int> count{0};
+        tg.batch(16, [&](int) {
+            SkTaskGroup inner(*executor);
+            inner.batch(16, [&](int) { count.fetch_add(1, std::memory_order_relaxed); });
+            inner.wait();
+        });
+        tg.wait();
+        REPORTER_ASSERT(reporter, count.load() == 16 * 16);
+
+        // parallelFor() covers every item exactly once, in ranges no bigger than the grain.
+        for (int grain : {1, 7, 64, 5000}) {
+            std::vector<int> hits(1000);
+            tg.parallelFor(1000, grain, [&](int start, int end, SkArenaAlloc* scratch) {
+                REPORTER_ASSERT(reporter, 0 <= start && start < end && end <= 1000);
+                REPORTER_ASSERT(reporter, end - start <= grain);
+                int* tmp = scratch->makeArray<int>(end - start);
+                for (int i = start; i < end; i++) {
+                    tmp[i - start] = i;
+                }
+                for (int i = start; i < end; i++) {
+                    hits[tmp[i - start]]++;
+                }
+            });
+            REPORTER_ASSERT(reporter, tg.done());
+            REPORTER_ASSERT(reporter, std::all_of(hits.begin(), hits.end(),
+                                                  [](int h) { return h == 1; }));
+        }
+    }
+}
+
+DEF_TEST(Executor_FIFO, reporter) {
+    test_executor(reporter, [](int threads) { return SkExecutor::MakeFIFOThreadPool(threads); });
+}
+
+DEF_TEST(Executor_LIFO, reporter) {
+    test_executor(reporter, [](int threads) { return SkExecutor::MakeLIFOThreadPool(threads); });
+}
+
+DEF_TEST(Executor_WorkStealing, reporter) {
+    test_executor(reporter, [](int threads) {
+        return SkExecutor::MakeWorkStealingThreadPool(threads);
+    });
+}
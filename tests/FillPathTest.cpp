@@ -5,17 +5,33 @@
  * found in the LICENSE file.
  */
 
+#include "include/core/SkBitmap.h"
+#include "include/core/SkCanvas.h"
 #include "include/core/SkColor.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkGraphics.h"
+#include "include/core/SkImageInfo.h"
+#include "include/core/SkPaint.h"
 #include "include/core/SkPath.h"
 #include "include/core/SkPathTypes.h"
 #include "include/core/SkRect.h"
 #include "include/core/SkScalar.h"
 #include "include/core/SkTypes.h"
+#include "include/private/base/SkTo.h"
+#include "src/base/SkRandom.h"
 #include "src/core/SkBlitter.h"
 #include "src/core/SkScan.h"
 #include "tests/Test.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
 #include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <utility>
 
 struct FakeBlitter : public SkBlitter {
     FakeBlitter()
@@ -52,3 +68,253 @@ DEF_TEST(FillPathInverse, reporter) {
 
     REPORTER_ASSERT(reporter, blitter.m_blitCount == expected_lines);
 }
+
+static SkBitmap draw_a8(int width, int height, const std::function<void(SkCanvas*)>& draw) {
+    SkBitmap bitmap;
+    bitmap.allocPixels(SkImageInfo::MakeA8(width, height));
+    bitmap.eraseColor(SK_ColorTRANSPARENT);
+    SkCanvas canvas(bitmap);
+    draw(&canvas);
+    return bitmap;
+}
+
+// Checks that sparse tiles' coverage is within `maxPercent` of `expected` overall, allowing single
+// pixels to differ by up to `maxDiff` (where edges cross within a pixel, coverage is approximated).
+static void check_sparse_tiles(skiatest::Reporter* r, const char* name, const SkBitmap& expected,
+                               int maxDiff, int maxPercent,
+                               const std::function<void(SkCanvas*)>& draw) {
+    gSkForceSparseTileAA = true;
+    SkBitmap sparse = draw_a8(expected.width(), expected.height(), draw);
+    gSkForceSparseTileAA = false;
+
+    int worstDiff = 0;
+    int64_t totalDiff = 0, total = 0;
+    for (int y = 0; y < expected.height(); ++y) {
+        for (int x = 0; x < expected.width(); ++x) {
+            const int e = *expected.getAddr8(x, y),
+                      s = *sparse.getAddr8(x, y);
+            worstDiff = std::max(worstDiff, std::abs(e - s));
+            totalDiff += std::abs(e - s);
+            total += e;
+        }
+    }
+    REPORTER_ASSERT(r, total > 0, "%s drew nothing", name);
+    REPORTER_ASSERT(r, worstDiff <= maxDiff, "%s: max difference %d", name, worstDiff);
+    REPORTER_ASSERT(r, totalDiff * 100 <= total * maxPercent, "%s: total difference %lld of %lld",
+                    name, (long long)totalDiff, (long long)total);
+}
+
+static SkPath make_star() {
+    SkPath star;
+    for (int i = 0; i < 5; ++i) {
+        const float angle = i * 4 * SK_ScalarPI / 5;
+        const SkPoint p = {150 + 90 * std::sin(angle), 100 - 90 * std::cos(angle)};
+        i == 0 ? star.moveTo(p) : star.lineTo(p);
+    }
+    return star.close();
+}
+
+// Many small hexagons, overlapping each other and hanging off every side.
+static SkPath make_polygons() {
+    SkRandom random;
+    SkPath polygons;
+    for (int i = 0; i < 400; ++i) {
+        const SkPoint c = {random.nextRangeF(-20, 320), random.nextRangeF(-20, 220)};
+        for (int j = 0; j < 6; ++j) {
+            const float angle = (j + random.nextRangeF(0, 0.8f)) * SK_ScalarPI / 3;
+            const float radius = random.nextRangeF(3, 9);
+            const SkPoint v = c + SkPoint{radius * std::cos(angle), radius * std::sin(angle)};
+            j == 0 ? polygons.moveTo(v) : polygons.lineTo(v);
+        }
+        polygons.close();
+    }
+    return polygons;
+}
+
+DEF_SERIAL_TEST(FillPath_SparseTilesCoverage, r) {
+    // Compare with the average of 16x16 samples per pixel, drawn without anti-aliasing.
+    constexpr int kScale = 16;
+    auto supersample = [&](const SkPath& path) {
+        SkBitmap big = draw_a8(300 * kScale, 200 * kScale, [&](SkCanvas* canvas) {
+            canvas->scale(kScale, kScale);
+            canvas->drawPath(path, SkPaint());
+        });
+        SkBitmap small;
+        small.allocPixels(SkImageInfo::MakeA8(300, 200));
+        for (int y = 0; y < 200; ++y) {
+            for (int x = 0; x < 300; ++x) {
+                int sum = 0;
+                for (int sy = 0; sy < kScale; ++sy) {
+                    for (int sx = 0; sx < kScale; ++sx) {
+                        sum += *big.getAddr8(x * kScale + sx, y * kScale + sy);
+                    }
+                }
+                *small.getAddr8(x, y) = SkToU8((sum + kScale * kScale / 2) / (kScale * kScale));
+            }
+        }
+        return small;
+    };
+    SkPaint paint;
+    paint.setAntiAlias(true);
+
+    SkPath triangle = SkPath::Polygon({{10.3f, 5.2f}, {250.7f, 20.1f}, {20.2f, 190.9f}}, true);
+    check_sparse_tiles(r, "triangle", supersample(triangle), 8, 1, [&](SkCanvas* canvas) {
+        canvas->drawPath(triangle, paint);
+    });
+
+    // Parts of paths to the right of the clip are culled, so the winding isn't back to zero past
+    // the last tile this crosses.
+    SkPath offRight =
+            SkPath::Polygon({{250.5f, 10.5f}, {400, 40}, {400, 120}, {240.25f, 150}}, true);
+    check_sparse_tiles(r, "off right", supersample(offRight), 8, 1, [&](SkCanvas* canvas) {
+        canvas->drawPath(offRight, paint);
+    });
+
+    // The pixels where a star's edges cross are covered twice in part, and approximated.
+    SkPath star = make_star();
+    check_sparse_tiles(r, "star winding", supersample(star), 128, 1, [&](SkCanvas* canvas) {
+        canvas->drawPath(star, paint);
+    });
+    star.setFillType(SkPathFillType::kEvenOdd);
+    check_sparse_tiles(r, "star even-odd", supersample(star), 128, 1, [&](SkCanvas* canvas) {
+        canvas->drawPath(star, paint);
+    });
+
+    // Curves, overlapping in opposite directions.
+    SkPath curves;
+    curves.addCircle(150, 100, 120);
+    curves.addOval({-40, 30, 120, 170}, SkPathDirection::kCCW);
+    curves.moveTo(200, -50).cubicTo(400, 50, 100, 150, 320, 260).lineTo(180, 260).close();
+    check_sparse_tiles(r, "curves", supersample(curves), 128, 1, [&](SkCanvas* canvas) {
+        canvas->drawPath(curves, paint);
+    });
+
+    SkPath polygons = make_polygons();
+    check_sparse_tiles(r, "polygons", supersample(polygons), 128, 1, [&](SkCanvas* canvas) {
+        canvas->drawPath(polygons, paint);
+    });
+}
+
+DEF_SERIAL_TEST(FillPath_SparseTilesClipped, r) {
+    // Sparse tiles with clips, against analytic AA. That slightly overestimates the coverage of
+    // pixels crossed by slanted edges, and there are a lot of those here.
+    SkPath polygons = make_polygons();
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    auto check_clipped = [&](const char* name, const std::function<void(SkCanvas*)>& draw) {
+        gSkForceAnalyticAA = true;
+        SkBitmap analytic = draw_a8(300, 200, draw);
+        gSkForceAnalyticAA = false;
+        check_sparse_tiles(r, name, analytic, 128, 2, draw);
+    };
+    check_clipped("rect clip", [&](SkCanvas* canvas) {
+        canvas->clipRect({30.5f, 20.25f, 250, 170});
+        canvas->drawPath(polygons, paint);
+    });
+    check_clipped("path clip", [&](SkCanvas* canvas) {
+        canvas->clipPath(SkPath::Circle(150, 100, 80), /*doAntiAlias=*/false);
+        canvas->drawPath(polygons, paint);
+    });
+    check_clipped("aa path clip", [&](SkCanvas* canvas) {
+        canvas->clipPath(SkPath::Circle(150, 100, 80), /*doAntiAlias=*/true);
+        canvas->drawPath(polygons, paint);
+    });
+    // An anti-aliased clip is built by an RLE blitter.
+    check_clipped("aa clip to path", [&](SkCanvas* canvas) {
+        canvas->clipPath(polygons, /*doAntiAlias=*/true);
+        canvas->drawColor(SK_ColorBLACK);
+    });
+}
+
+DEF_SERIAL_TEST(FillPath_Bands, r) {
+    // Rasterizing in bands clips the edges at each band's top and bottom, which may move coverage
+    // a little between the rows on either side, but no more than any other clip would.
+    // Analytic AA approximates coverage across several rows at a time, so a band clip, like any
+    // other horizontal clip, can move a pixel near it by much more. The bands are sized by the
+    // thread count, so check a few.
+    SkPath polygons = make_polygons();
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    auto check_bands = [&](const char* name, const std::function<void(SkCanvas*)>& draw) {
+        for (auto [threads, sparseTiles] : {std::pair{2, false}, {4, false}, {16, false},
+                                            {2, true},  {4, true},  {16, true}}) {
+            std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(threads);
+            gSkForceAnalyticAA = !sparseTiles;
+            gSkForceSparseTileAA = sparseTiles;
+            SkBitmap expected = draw_a8(300, 200, draw);
+            SkGraphics::SetPathBandExecutor(executor.get(), threads, 0);
+            SkBitmap banded = draw_a8(300, 200, draw);
+            SkGraphics::SetPathBandExecutor(nullptr, 0, 0);
+            gSkForceAnalyticAA = gSkForceSparseTileAA = false;
+
+            int worstDiff = 0;
+            int64_t totalDiff = 0, total = 0;
+            for (int y = 0; y < 200; ++y) {
+                for (int x = 0; x < 300; ++x) {
+                    const int e = *expected.getAddr8(x, y),
+                              b = *banded.getAddr8(x, y);
+                    worstDiff = std::max(worstDiff, std::abs(e - b));
+                    totalDiff += std::abs(e - b);
+                    total += e;
+                }
+            }
+            REPORTER_ASSERT(r, total > 0, "%s drew nothing", name);
+            REPORTER_ASSERT(r, worstDiff <= (sparseTiles ? 32 : 96),
+                            "%s (%d threads, sparse tiles %d): max difference %d",
+                            name, threads, sparseTiles, worstDiff);
+            REPORTER_ASSERT(r, totalDiff * 100 <= total,
+                            "%s (%d threads, sparse tiles %d): total %lld of %lld",
+                            name, threads, sparseTiles, (long long)totalDiff, (long long)total);
+        }
+    };
+    check_bands("polygons", [&](SkCanvas* canvas) {
+        canvas->drawPath(polygons, paint);
+    });
+    check_bands("even-odd", [&](SkCanvas* canvas) {
+        SkPath evenOdd = polygons;
+        evenOdd.setFillType(SkPathFillType::kEvenOdd);
+        canvas->drawPath(evenOdd, paint);
+    });
+    check_bands("rect clip", [&](SkCanvas* canvas) {
+        canvas->clipRect({30.5f, 20.25f, 250, 170});
+        canvas->drawPath(polygons, paint);
+    });
+    check_bands("aa path clip", [&](SkCanvas* canvas) {
+        canvas->clipPath(SkPath::Circle(150, 100, 80), /*doAntiAlias=*/true);
+        canvas->drawPath(polygons, paint);
+    });
+    check_bands("aa clip to path", [&](SkCanvas* canvas) {
+        canvas->clipPath(polygons, /*doAntiAlias=*/true);
+        canvas->drawColor(SK_ColorBLACK);
+    });
+}
+
+DEF_SERIAL_TEST(FillPath_BandSettings, r) {
+    // Paths drawn while the settings change must see all of one call's settings.
+    std::unique_ptr<SkExecutor> a = SkExecutor::MakeFIFOThreadPool(1),
+                                b = SkExecutor::MakeFIFOThreadPool(2);
+    std::atomic<bool> done{false};
+    std::thread setter([&] {
+        for (int i = 0; i < 10000; i++) {
+            SkGraphics::SetPathBandExecutor(a.get(), 1, 100);
+            SkGraphics::SetPathBandExecutor(b.get(), 2, 200);
+        }
+        done = true;
+    });
+    int mixed = 0;
+    while (!done) {
+        const SkPathBandSettings s = SkGetPathBandSettings();
+        const bool isA = s.executor == a.get() && s.threads == 1 && s.minEdges == 100,
+                   isB = s.executor == b.get() && s.threads == 2 && s.minEdges == 200;
+        if (s.executor && !isA && !isB) {
+            mixed++;
+        }
+    }
+    setter.join();
+    REPORTER_ASSERT(r, mixed == 0, "%d mixed settings", mixed);
+
+    SkGraphics::SetPathBandExecutor(a.get(), 0, 0);
+    REPORTER_ASSERT(r, SkGetPathBandSettings().threads > 0);
+    SkGraphics::SetPathBandExecutor(nullptr, 0, 0);
+    REPORTER_ASSERT(r, !SkGetPathBandSettings().executor);
+}
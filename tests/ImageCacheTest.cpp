@@ -9,6 +9,7 @@
 #include "include/core/SkTypes.h"
 #include "include/private/chromium/SkDiscardableMemory.h"
 #include "src/core/SkResourceCache.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/lazy/SkDiscardableMemoryPool.h"
 #include "tests/Test.h"
 
@@ -154,3 +155,52 @@ DEF_TEST(ImageCache_doubleAdd, r) {
     REPORTER_ASSERT(r, cache.find(key, TestingRec::Visitor, &value));
     REPORTER_ASSERT(r, 2 == value || 3 == value);
 }
+
+DEF_TEST(ImageCache_sharded, r) {
+    static constexpr int kShards = 4;
+    const size_t recBytes = TestingRec(TestingKey(0), 0).bytesUsed();
+    const size_t limit = 200 * recBytes;
+    SkShardedResourceCache cache(kShards, limit);
+
+    // Add and find from several threads at once.
+    SkTaskGroup().batch(8, [&](int thread) {
+        for (int i = 0; i < 100; ++i) {
+            TestingKey key(thread * 100 + i);
+            cache.add(new TestingRec(key, thread * 100 + i));
+            intptr_t value = -1;
+            if (cache.find(key, TestingRec::Visitor, &value)) {
+                REPORTER_ASSERT(r, value == thread * 100 + i);
+            }
+        }
+    });
+
+    size_t budgets = 0;
+    for (int i = 0; i < kShards; ++i) {
+        budgets += cache.shardByteLimit(i);
+    }
+    REPORTER_ASSERT(r, budgets <= limit);
+    REPORTER_ASSERT(r, cache.getTotalBytesUsed() <= limit);
+
+    size_t visited = 0;
+    cache.visitAll([](const SkResourceCache::Rec& rec, void* ctx) {
+        *static_cast<size_t*>(ctx) += rec.bytesUsed();
+    }, &visited);
+    REPORTER_ASSERT(r, visited == cache.getTotalBytesUsed());
+
+    // Keep adding to the first shard only: it should take over most of the budget.
+    auto shard_of = [](const TestingKey& key) {
+        return (int)(((uint64_t)key.hash() * kShards) >> 32);
+    };
+    for (int value = 1000000, added = 0; added < 1000; ++value) {
+        TestingKey key(value);
+        if (shard_of(key) == 0) {
+            cache.add(new TestingRec(key, value));
+            added++;
+        }
+    }
+    REPORTER_ASSERT(r, cache.shardByteLimit(0) > limit / 2);
+    REPORTER_ASSERT(r, cache.getTotalBytesUsed() <= limit);
+
+    cache.purgeAll();
+    REPORTER_ASSERT(r, 0 == cache.getTotalBytesUsed());
+}
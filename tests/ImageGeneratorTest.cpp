@@ -6,6 +6,7 @@
  */
 
 #include "include/core/SkAlphaType.h"
+#include "include/core/SkBitmap.h"
 #include "include/core/SkCanvas.h"
 #include "include/core/SkColor.h"
 #include "include/core/SkColorSpace.h"
@@ -17,14 +18,23 @@
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkPicture.h"
 #include "include/core/SkPictureRecorder.h"
+#include "include/core/SkPixmap.h"
+#include "include/core/SkRect.h"
 #include "include/core/SkRefCnt.h"
+#include "include/core/SkString.h"
+#include "include/core/SkTraceMemoryDump.h"
 #include "include/core/SkYUVAInfo.h"
 #include "include/core/SkYUVAPixmaps.h"
 #include "src/base/SkAutoMalloc.h"
 #include "src/image/SkImageGeneratorPriv.h"
+#include "src/image/SkImage_Lazy.h"
 #include "tests/Test.h"
 
+#include <atomic>
+#include <chrono>
 #include <memory>
+#include <thread>
+#include <vector>
 
 #if defined(SK_BUILD_FOR_MAC) || defined(SK_BUILD_FOR_IOS)
     #include "include/ports/SkImageGeneratorCG.h"
@@ -133,3 +143,125 @@ DEF_TEST(PictureImageGenerator, reporter) {
     }
 }
 
+
+// Counts its decodes, and takes a while over whole images, so that concurrent requests overlap.
+class CountingImageGenerator : public SkImageGenerator {
+public:
+    explicit CountingImageGenerator(bool decodesSubsets)
+            : SkImageGenerator(SkImageInfo::MakeN32Premul(64, 64))
+            , fDecodesSubsets(decodesSubsets) {}
+
+    std::atomic<int> fDecodes{0},
+                     fSubsetDecodes{0};
+
+protected:
+    bool onGetPixels(const SkImageInfo& info, void* pixels, size_t rowBytes,
+                     const Options&) override {
+        fDecodes++;
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        return SkPixmap(info, pixels, rowBytes).erase(SK_ColorRED);
+    }
+
+    bool onGetSubsetPixels(const SkPixmap& pm, const SkIRect&) override {
+        if (!fDecodesSubsets) {
+            return false;
+        }
+        fSubsetDecodes++;
+        return pm.erase(SK_ColorBLUE);
+    }
+
+private:
+    const bool fDecodesSubsets;
+};
+
+static SkColor read_color(const sk_sp<SkImage>& image) {
+    SkBitmap bm;
+    bm.allocPixels(SkImageInfo::MakeN32Premul(1, 1));
+    if (!image->readPixels(nullptr, bm.pixmap(), 0, 0, SkImage::kAllow_CachingHint)) {
+        return SK_ColorTRANSPARENT;
+    }
+    return bm.getColor(0, 0);
+}
+
+// Threads that want the same lazy image decoded at the same time should share one decode.
+DEF_TEST(ImageGenerator_ConcurrentDecodesAreShared, reporter) {
+    auto gen = std::make_unique<CountingImageGenerator>(/*decodesSubsets=*/false);
+    CountingImageGenerator* counts = gen.get();
+    sk_sp<SkImage> image = SkImages::DeferredFromGenerator(std::move(gen));
+    REPORTER_ASSERT(reporter, image);
+
+    const SkImage_Lazy::DecodeStats before = SkImage_Lazy::GetDecodeStats();
+
+    static constexpr int kThreads = 4;
+    std::atomic<int> red{0};
+    std::vector<std::thread> threads;
+    for (int i = 0; i < kThreads; i++) {
+        threads.emplace_back([&] { red += read_color(image) == SK_ColorRED; });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    REPORTER_ASSERT(reporter, red == kThreads);
+    REPORTER_ASSERT(reporter, counts->fDecodes == 1, "%d decodes", counts->fDecodes.load());
+
+    // Other tests may decode lazy images concurrently, so these are only lower bounds.
+    const SkImage_Lazy::DecodeStats after = SkImage_Lazy::GetDecodeStats();
+    REPORTER_ASSERT(reporter, after.fDecodes - before.fDecodes >= 1);
+    REPORTER_ASSERT(reporter, after.fCacheMisses - before.fCacheMisses >= 1);
+    REPORTER_ASSERT(reporter, (after.fCacheHits - before.fCacheHits) +
+                              (after.fCacheMisses - before.fCacheMisses) >= kThreads);
+}
+
+// Generators that can decode subsets are asked for just the subset, unless the whole image is
+// decoded already.
+DEF_TEST(ImageGenerator_SubsetDecodes, reporter) {
+    for (bool decodesSubsets : {false, true}) {
+        auto gen = std::make_unique<CountingImageGenerator>(decodesSubsets);
+        CountingImageGenerator* counts = gen.get();
+        sk_sp<SkImage> image = SkImages::DeferredFromGenerator(std::move(gen));
+
+        sk_sp<SkImage> subset = image->makeSubset(nullptr, SkIRect::MakeXYWH(8, 8, 16, 16));
+        REPORTER_ASSERT(reporter, subset && subset->dimensions() == SkISize::Make(16, 16));
+        REPORTER_ASSERT(reporter, read_color(subset) ==
+                                  (decodesSubsets ? SK_ColorBLUE : SK_ColorRED));
+        REPORTER_ASSERT(reporter, counts->fSubsetDecodes == (decodesSubsets ? 1 : 0));
+        REPORTER_ASSERT(reporter, counts->fDecodes == (decodesSubsets ? 0 : 1));
+
+        // Once the whole image is in the cache, subsets come from there.
+        REPORTER_ASSERT(reporter, read_color(image) == SK_ColorRED);
+        subset = image->makeSubset(nullptr, SkIRect::MakeXYWH(32, 32, 16, 16));
+        REPORTER_ASSERT(reporter, subset && read_color(subset) == SK_ColorRED);
+        REPORTER_ASSERT(reporter, counts->fSubsetDecodes == (decodesSubsets ? 1 : 0));
+        // (The whole image decoded for the first subset wasn't cached.)
+        REPORTER_ASSERT(reporter, counts->fDecodes == (decodesSubsets ? 1 : 2));
+    }
+}
+
+class DecodeStatsDump : public SkTraceMemoryDump {
+public:
+    void dumpNumericValue(const char* dumpName, const char* valueName, const char*,
+                          uint64_t value) override {
+        if (SkString("skia/lazy_image_decodes") == SkString(dumpName) &&
+            SkString("decodes") == SkString(valueName)) {
+            fDecodes = value;
+        }
+    }
+    void setMemoryBacking(const char*, const char*, const char*) override {}
+    void setDiscardableMemoryBacking(const char*, const SkDiscardableMemory&) override {}
+    LevelOfDetail getRequestedDetails() const override {
+        return SkTraceMemoryDump::kLight_LevelOfDetail;
+    }
+
+    uint64_t fDecodes = 0;
+};
+
+DEF_TEST(ImageGenerator_DecodeStatsDump, reporter) {
+    sk_sp<SkImage> image = SkImages::DeferredFromGenerator(
+            std::make_unique<CountingImageGenerator>(/*decodesSubsets=*/false));
+    REPORTER_ASSERT(reporter, read_color(image) == SK_ColorRED);
+
+    DecodeStatsDump dump;
+    SkGraphics::DumpMemoryStatistics(&dump);
+    REPORTER_ASSERT(reporter, dump.fDecodes >= 1);
+}
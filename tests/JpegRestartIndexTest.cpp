@@ -0,0 +1,183 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkTypes.h"
+
+#if defined(SK_CODEC_DECODES_JPEG)
+#include "include/codec/SkAndroidCodec.h"
+#include "include/codec/SkCodec.h"
+#include "include/codec/SkJpegDecoder.h"
+#include "include/core/SkBitmap.h"
+#include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkImageInfo.h"
+#include "include/core/SkRect.h"
+#include "include/core/SkRefCnt.h"
+#include "include/core/SkStream.h"
+#include "src/codec/SkJpegRestartIndex.h"
+#include "tests/FakeStreams.h"
+#include "tests/Test.h"
+#include "tools/Resources.h"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+static SkBitmap decode(skiatest::Reporter* r, sk_sp<SkData> data, SkExecutor* executor) {
+    SkBitmap bitmap;
+    std::unique_ptr<SkCodec> codec = SkJpegDecoder::Decode(std::move(data), nullptr);
+    if (!codec) {
+        ERRORF(r, "Could not make a codec");
+        return bitmap;
+    }
+    bitmap.allocPixels(codec->getInfo().makeColorType(kN32_SkColorType));
+    SkCodec::Options options;
+    options.fExecutor = executor;
+    REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getPixels(bitmap.pixmap(), &options));
+    return bitmap;
+}
+
+// Decodes rows [skip, skip + rows) of a band, into dst's rows starting at top.
+static bool decode_band(sk_sp<SkData> band, int skip, int rows, int top, const SkBitmap& dst) {
+    std::unique_ptr<SkCodec> codec = SkJpegDecoder::Decode(std::move(band), nullptr);
+    return codec &&
+           SkCodec::kSuccess == codec->startScanlineDecode(
+                                        dst.info().makeDimensions(codec->dimensions())) &&
+           codec->skipScanlines(skip) &&
+           rows == codec->getScanlines(dst.getAddr(0, top), rows, dst.rowBytes());
+}
+
+static bool rows_equal(const SkBitmap& a, const SkBitmap& b, int top, int bottom) {
+    for (int y = top; y < bottom; y++) {
+        if (0 != memcmp(a.getAddr(0, y), b.getAddr(0, y), a.info().minRowBytes())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Every band cut at a restart row should decode to exactly the rows of the whole image, given
+// the context rows that SkJpegCodec gives it.
+DEF_TEST(JpegRestartIndex_Bands, r) {
+    for (const char* path : {"images/icc-v2-gbr.jpg",       // 4:2:0, an interval per MCU row
+                             "images/crbug1465627.jpeg"}) {
+        sk_sp<SkData> data = GetResourceAsData(path);
+        if (!data) {
+            continue;
+        }
+        std::unique_ptr<SkJpegRestartIndex> index = SkJpegRestartIndex::Make(data);
+        if (!index) {
+            ERRORF(r, "%s: could not index restart markers", path);
+            continue;
+        }
+        REPORTER_ASSERT(r, index->restartRows().front() == 0);
+        REPORTER_ASSERT(r, std::is_sorted(index->restartRows().begin(),
+                                          index->restartRows().end()));
+
+        const SkBitmap expected = decode(r, data, nullptr);
+        const int mcuHeight = index->mcuRowHeight(),
+                  mcuRows = index->mcuRows();
+        const std::vector<int>& restartRows = index->restartRows();
+        for (size_t i = 1; i < restartRows.size(); i++) {
+            const int row = restartRows[i],
+                      contextRow = index->needsVerticalContext() ? restartRows[i - 1] : row;
+            SkBitmap actual;
+            actual.allocPixels(expected.info());
+
+            // Everything from the row down...
+            const int top = row * mcuHeight;
+            REPORTER_ASSERT(r, decode_band(index->makeBand(contextRow, mcuRows),
+                                           (row - contextRow) * mcuHeight,
+                                           expected.height() - top, top, actual));
+            // ... and everything above it.
+            const int endRow = std::min(row + (index->needsVerticalContext() ? 1 : 0), mcuRows);
+            REPORTER_ASSERT(r, decode_band(index->makeBand(0, endRow), 0, top, 0, actual));
+
+            REPORTER_ASSERT(r, rows_equal(expected, actual, 0, expected.height()),
+                            "%s: split at MCU row %d", path, row);
+        }
+    }
+}
+
+DEF_TEST(JpegRestartIndex_Unsupported, r) {
+    for (const char* path : {"images/mandrill_512_q075.jpg",                // No restart markers.
+                             "images/progressive_kitten_missing_eof.jpg"}) {  // Progressive.
+        REPORTER_ASSERT(r, !SkJpegRestartIndex::Make(GetResourceAsData(path)), "%s", path);
+    }
+    REPORTER_ASSERT(r, !SkJpegRestartIndex::Make(nullptr));
+}
+
+// A big camera JPEG, with a restart interval per MCU row, decodes identically in parallel bands.
+DEF_TEST(Codec_jpeg_parallel, r) {
+    sk_sp<SkData> data = GetResourceAsData("images/iphone_13_pro.jpeg");
+    if (!data) {
+        return;
+    }
+    REPORTER_ASSERT(r, SkJpegRestartIndex::Make(data));
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    const SkBitmap serial = decode(r, data, nullptr),
+                   parallel = decode(r, data, executor.get());
+    REPORTER_ASSERT(r, rows_equal(serial, parallel, 0, serial.height()));
+}
+
+static SkBitmap decode_region(skiatest::Reporter* r, std::unique_ptr<SkStream> stream,
+                              const SkIRect& subset, int sampleSize) {
+    SkBitmap bitmap;
+    std::unique_ptr<SkAndroidCodec> codec =
+            SkAndroidCodec::MakeFromCodec(SkJpegDecoder::Decode(std::move(stream), nullptr));
+    if (!codec) {
+        ERRORF(r, "Could not make a codec");
+        return bitmap;
+    }
+    bitmap.allocPixels(codec->getInfo()
+                               .makeDimensions(codec->getSampledSubsetDimensions(sampleSize,
+                                                                                 subset))
+                               .makeColorType(kN32_SkColorType));
+    SkAndroidCodec::AndroidOptions options;
+    options.fSampleSize = sampleSize;
+    options.fSubset = &subset;
+    REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getAndroidPixels(bitmap.info(),
+                                                                    bitmap.getPixels(),
+                                                                    bitmap.rowBytes(),
+                                                                    &options));
+    return bitmap;
+}
+
+// Region decodes that start from a restart marker match those that skip down from the top.
+// (Only codecs with their data in memory can start from a restart marker.)
+DEF_TEST(Codec_jpeg_regions, r) {
+    for (const char* path : {"images/icc-v2-gbr.jpg", "images/crbug1465627.jpeg"}) {
+        sk_sp<SkData> data = GetResourceAsData(path);
+        if (!data) {
+            continue;
+        }
+        std::unique_ptr<SkCodec> codec = SkJpegDecoder::Decode(data, nullptr);
+        if (!codec) {
+            ERRORF(r, "%s: could not make a codec", path);
+            continue;
+        }
+        const int w = codec->dimensions().width(),
+                  h = codec->dimensions().height();
+        for (int top : {1, 15, 16, 17, h / 3, h / 2 + 5, h - 20}) {
+            for (int sampleSize : {1, 3}) {
+                const SkIRect subset = SkIRect::MakeLTRB(w / 5, top, w - w / 3, h);
+                const SkBitmap actual = decode_region(r, SkMemoryStream::Make(data), subset,
+                                                      sampleSize),
+                               expected = decode_region(
+                                       r, std::make_unique<NotAssetMemStream>(data), subset,
+                                       sampleSize);
+                REPORTER_ASSERT(r, rows_equal(expected, actual, 0, expected.height()),
+                                "%s: rows [%d, %d), sample size %d",
+                                path, subset.top(), subset.bottom(), sampleSize);
+            }
+        }
+    }
+}
+
+#endif  // SK_CODEC_DECODES_JPEG
@@ -0,0 +1,56 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkPoint.h"
+#include "include/core/SkRect.h"
+#include "src/base/SkRandom.h"
+#include "src/core/SkMask.h"
+#include "src/core/SkMaskBlurFilter.h"
+#include "tests/Test.h"
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+DEF_SERIAL_TEST(MaskBlurFilter_LanesMatchScalar, r) {
+    // Rows are blurred eight at a time in the lanes of a vector, with any left over blurred one
+    // at a time. Either way the results must be exactly the same.
+    SkRandom random;
+    for (double sigma : {2.0, 3.7, 10.0, 25.0, 60.0, 100.0}) {
+        for (SkISize size : {SkISize{1, 1}, SkISize{5, 13}, SkISize{37, 9}, SkISize{64, 64},
+                             SkISize{300, 17}, SkISize{16, 200}}) {
+            for (SkMask::Format format : {SkMask::kBW_Format, SkMask::kA8_Format,
+                                          SkMask::kARGB32_Format}) {
+                const int bytesPerPixel = format == SkMask::kARGB32_Format ? 4 : 1;
+                const size_t rowBytes = format == SkMask::kBW_Format
+                                                ? (size.width() + 7) / 8
+                                                : size.width() * bytesPerPixel;
+                std::vector<uint8_t> pixels(rowBytes * size.height());
+                for (uint8_t& pixel : pixels) {
+                    pixel = random.nextBool() ? random.nextU() & 0xFF : 0;
+                }
+                const SkMask src(pixels.data(), SkIRect::MakeSize(size), rowBytes, format);
+                const SkMaskBlurFilter filter(sigma, sigma);
+
+                SkMaskBuilder lanes, scalar;
+                const SkIPoint lanesBorder = filter.blur(src, &lanes);
+                gSkForceScalarMaskBlur = true;
+                const SkIPoint scalarBorder = filter.blur(src, &scalar);
+                gSkForceScalarMaskBlur = false;
+                SkAutoMaskFreeImage freeLanes(lanes.image()), freeScalar(scalar.image());
+
+                REPORTER_ASSERT(r, lanesBorder == scalarBorder);
+                REPORTER_ASSERT(r, lanes.fBounds == scalar.fBounds);
+                REPORTER_ASSERT(r, lanes.fRowBytes == scalar.fRowBytes);
+                REPORTER_ASSERT(r, 0 == memcmp(lanes.fImage, scalar.fImage,
+                                               lanes.computeImageSize()),
+                                "sigma %g, %dx%d, format %d", sigma, size.width(), size.height(),
+                                format);
+            }
+        }
+    }
+}
@@ -5,7 +5,14 @@
  * found in the LICENSE file.
  */
 
+#include "include/core/SkBitmap.h"
 #include "include/core/SkBlurTypes.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkColor.h"
+#include "include/core/SkMaskFilter.h"
+#include "include/core/SkPaint.h"
+#include "include/core/SkPath.h"
+#include "include/core/SkPathBuilder.h"
 #include "include/core/SkRRect.h"
 #include "include/core/SkRect.h"
 #include "include/core/SkScalar.h"
@@ -108,3 +115,123 @@ DEF_TEST(RectsMaskCache, reporter) {
     check_data(reporter, data, 1, kNotInCache, kLocked);
     data->unref();
 }
+
+static SkPath make_path_at(SkScalar x, SkScalar y) {
+    return SkPathBuilder()
+            .moveTo(x + 10.25f, y + 0.5f)
+            .quadTo(x + 30, y + 5, x + 20.75f, y + 30)
+            .conicTo(x + 10, y + 40, x, y + 20, 0.7f)
+            .close()
+            .detach();
+}
+
+DEF_SERIAL_TEST(PathMaskCache, reporter) {
+    SkResourceCache cache(1024);
+
+    SkScalar sigma = 0.8f;
+    SkBlurStyle style = kNormal_SkBlurStyle;
+    SkPath path = make_path_at(100.125f, 50);
+    SkTLazy<SkMask> lazyMask;
+
+    const SkMaskCache::PathStats before = SkMaskCache::GetPathStats();
+    SkCachedData* data = SkMaskCache::FindAndRef(sigma, style, path, &lazyMask, &cache);
+    REPORTER_ASSERT(reporter, nullptr == data);
+    REPORTER_ASSERT(reporter, !lazyMask.isValid());
+    REPORTER_ASSERT(reporter, SkMaskCache::GetPathStats().fMisses == before.fMisses + 1);
+
+    size_t size = 256;
+    data = cache.newCachedData(size);
+    memset(data->writable_data(), 0xff, size);
+    SkMask mask(nullptr, SkIRect::MakeXYWH(98, 48, 36, 44), 36, SkMask::kA8_Format);
+    SkMaskCache::Add(sigma, style, path, mask, data, &cache);
+    check_data(reporter, data, 2, kInCache, kLocked);
+
+    data->unref();
+    check_data(reporter, data, 1, kInCache, kUnlocked);
+
+    // The same path translated by whole pixels finds the mask, moved along with it.
+    lazyMask.reset();
+    data = SkMaskCache::FindAndRef(sigma, style, make_path_at(87.125f, 63), &lazyMask, &cache);
+    REPORTER_ASSERT(reporter, data);
+    REPORTER_ASSERT(reporter, SkMaskCache::GetPathStats().fHits == before.fHits + 1);
+    REPORTER_ASSERT(reporter, lazyMask->fBounds == SkIRect::MakeXYWH(85, 61, 36, 44));
+    REPORTER_ASSERT(reporter, data->data() == static_cast<const void*>(lazyMask->fImage));
+    check_data(reporter, data, 2, kInCache, kLocked);
+    data->unref();
+
+    // A different sub-pixel phase, sigma, or style doesn't.
+    lazyMask.reset();
+    REPORTER_ASSERT(reporter, !SkMaskCache::FindAndRef(sigma, style, make_path_at(100.375f, 50),
+                                                       &lazyMask, &cache));
+    REPORTER_ASSERT(reporter, !SkMaskCache::FindAndRef(2 * sigma, style, path, &lazyMask, &cache));
+    REPORTER_ASSERT(reporter, !SkMaskCache::FindAndRef(sigma, kOuter_SkBlurStyle, path, &lazyMask,
+                                                       &cache));
+    REPORTER_ASSERT(reporter, SkMaskCache::GetPathStats().fMisses == before.fMisses + 4);
+
+    cache.purgeAll();
+}
+
+DEF_SERIAL_TEST(PathMaskCacheDrawing, reporter) {
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    paint.setMaskFilter(SkMaskFilter::MakeBlur(kNormal_SkBlurStyle, 3));
+
+    auto draw = [&](SkScalar x, SkScalar y, const SkIRect* clip) {
+        SkBitmap bitmap;
+        bitmap.allocN32Pixels(100, 100);
+        bitmap.eraseColor(SK_ColorTRANSPARENT);
+        SkCanvas canvas(bitmap);
+        if (clip) {
+            canvas.clipIRect(*clip);
+        }
+        canvas.drawPath(make_path_at(x, y), paint);
+        return bitmap;
+    };
+
+    SkResourceCache::PurgeAll();
+    const SkMaskCache::PathStats before = SkMaskCache::GetPathStats();
+    SkBitmap first = draw(20.5f, 20, nullptr);
+
+    // Drawn again 13 pixels right and 7 down, the mask comes from the cache and is identical.
+    SkBitmap moved = draw(33.5f, 27, nullptr);
+    REPORTER_ASSERT(reporter, SkMaskCache::GetPathStats().fHits > before.fHits);
+    for (int y = 0; y < 93; ++y) {
+        for (int x = 0; x < 87; ++x) {
+            REPORTER_ASSERT(reporter, *first.getAddr32(x, y) == *moved.getAddr32(x + 13, y + 7),
+                            "(%d, %d)", x, y);
+        }
+    }
+
+    // With the path partly clipped out, the cached mask still matches the unclipped draw.
+    const SkIRect clip = SkIRect::MakeLTRB(0, 0, 40, 38);
+    SkBitmap clipped = draw(20.5f, 20, &clip);
+    for (int y = 0; y < 100; ++y) {
+        for (int x = 0; x < 100; ++x) {
+            const SkPMColor expected = clip.contains(x, y) ? *first.getAddr32(x, y) : 0;
+            REPORTER_ASSERT(reporter, *clipped.getAddr32(x, y) == expected, "(%d, %d)", x, y);
+        }
+    }
+    // A path whose mask is too big to cache skips the cache, so it isn't counted as a miss.
+    const SkMaskCache::PathStats beforeBig = SkMaskCache::GetPathStats();
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(100, 100);
+    SkCanvas canvas(bitmap);
+    canvas.drawPath(SkPath::Polygon({{0, 0}, {1000, 50}, {50, 1000}}, /*isClosed=*/true), paint);
+    const SkMaskCache::PathStats afterBig = SkMaskCache::GetPathStats();
+    REPORTER_ASSERT(reporter, afterBig.fHits == beforeBig.fHits);
+    REPORTER_ASSERT(reporter, afterBig.fMisses == beforeBig.fMisses);
+
+    // Nor does a path drawn with most of its mask clipped out, which is cheaper to blur within
+    // the clip. That part still matches the unclipped draw.
+    const SkIRect corner = SkIRect::MakeLTRB(0, 0, 20, 20);
+    SkBitmap cornerOnly = draw(20.5f, 20, &corner);
+    const SkMaskCache::PathStats afterCorner = SkMaskCache::GetPathStats();
+    REPORTER_ASSERT(reporter, afterCorner.fHits == afterBig.fHits);
+    REPORTER_ASSERT(reporter, afterCorner.fMisses == afterBig.fMisses);
+    for (int y = 0; y < 100; ++y) {
+        for (int x = 0; x < 100; ++x) {
+            const SkPMColor expected = corner.contains(x, y) ? *first.getAddr32(x, y) : 0;
+            REPORTER_ASSERT(reporter, *cornerOnly.getAddr32(x, y) == expected, "(%d, %d)", x, y);
+        }
+    }
+}
@@ -10,6 +10,7 @@
 #include "include/core/SkCanvas.h"
 #include "include/core/SkColor.h"
 #include "include/core/SkColorType.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkPixmap.h"
@@ -21,12 +22,16 @@
 #include "include/core/SkSurface.h"
 #include "include/core/SkTypes.h"
 #include "include/private/base/SkMalloc.h"
+#include "src/base/SkHalf.h"
 #include "src/base/SkRandom.h"
 #include "src/core/SkMipmap.h"
 #include "src/core/SkMipmapBuilder.h"
 #include "tests/Test.h"
 #include "tools/DecodeUtils.h"
 
+#include <cstring>
+#include <memory>
+
 static void make_bitmap(SkBitmap* bm, int width, int height) {
     bm->allocN32Pixels(width, height);
     bm->eraseColor(SK_ColorWHITE);
@@ -235,6 +240,140 @@ DEF_TEST(MipMap_F16, reporter) {
     sk_sp<SkMipmap> mipmap(SkMipmap::Build(bmp, nullptr));
 }
 
+static void fill_random(SkBitmap* bm, SkRandom* rand) {
+    for (int y = 0; y < bm->height(); ++y) {
+        if (bm->colorType() == kRGBA_F16_SkColorType) {
+            uint16_t* row = static_cast<uint16_t*>(bm->getAddr(0, y));
+            for (int x = 0; x < 4 * bm->width(); ++x) {
+                row[x] = SkFloatToHalf(rand->nextF());
+            }
+        } else {
+            uint8_t* row = static_cast<uint8_t*>(bm->getAddr(0, y));
+            for (size_t x = 0; x < bm->info().minRowBytes(); ++x) {
+                row[x] = (uint8_t)rand->nextU();
+            }
+        }
+    }
+}
+
+// Columns (or rows) and weights of the src texels that filter into dst texel i.
+static int taps(int srcSize, int i, int coords[3], int weights[3]) {
+    if (srcSize == 1) {
+        coords[0] = 0;
+        weights[0] = 1;
+        return 1;
+    }
+    if (srcSize & 1) {
+        for (int j = 0; j < 3; ++j) {
+            coords[j] = 2 * i + j;
+            weights[j] = j == 1 ? 2 : 1;
+        }
+        return 3;
+    }
+    coords[0] = 2 * i;
+    coords[1] = 2 * i + 1;
+    weights[0] = weights[1] = 1;
+    return 2;
+}
+
+// Checks every texel of dst against the filter of src, computed channel by channel, where each
+// 32-bit pixel packs channels of the given widths, starting at the low bits.
+static bool levels_match(const SkPixmap& dst, const SkPixmap& src, const int widths[4]) {
+    for (int y = 0; y < dst.height(); ++y) {
+        int ys[3], wys[3];
+        const int ny = taps(src.height(), y, ys, wys);
+        for (int x = 0; x < dst.width(); ++x) {
+            int xs[3], wxs[3];
+            const int nx = taps(src.width(), x, xs, wxs);
+            uint32_t expected = 0;
+            for (int c = 0, shift = 0; c < 4; shift += widths[c++]) {
+                const uint32_t mask = (1u << widths[c]) - 1;
+                uint32_t sum = 0, total = 0;
+                for (int j = 0; j < ny; ++j) {
+                    for (int i = 0; i < nx; ++i) {
+                        const uint32_t texel = *src.addr32(xs[i], ys[j]);
+                        sum += wxs[i] * wys[j] * ((texel >> shift) & mask);
+                        total += wxs[i] * wys[j];
+                    }
+                }
+                expected |= (sum / total) << shift;
+            }
+            if (*dst.addr32(x, y) != expected) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// The 8888 and 1010102 levels are built N pixels at a time, so cover every mix of odd and even
+// sizes, with and without a scalar tail at the end of each row.
+DEF_TEST(MipMap_Filters, reporter) {
+    static const int k8888Widths[] = {8, 8, 8, 8},
+                     k1010102Widths[] = {10, 10, 10, 2};
+    const struct {
+        SkColorType fColorType;
+        const int*  fWidths;
+    } formats[] = {
+        {kRGBA_8888_SkColorType,    k8888Widths},
+        {kBGRA_8888_SkColorType,    k8888Widths},
+        {kRGBA_1010102_SkColorType, k1010102Widths},
+    };
+    const SkISize sizes[] = {{16, 16}, {17, 17}, {33, 16}, {16, 33}, {47, 9}, {3, 70}, {70, 1}};
+
+    SkRandom rand;
+    for (const auto& format : formats) {
+        for (SkISize size : sizes) {
+            SkBitmap bm;
+            bm.allocPixels(SkImageInfo::Make(size, format.fColorType, kPremul_SkAlphaType));
+            fill_random(&bm, &rand);
+
+            sk_sp<SkMipmap> mm(SkMipmap::Build(bm, nullptr));
+            REPORTER_ASSERT(reporter, mm);
+            if (!mm) {
+                return;
+            }
+            SkPixmap src = bm.pixmap();
+            for (int i = 0; i < mm->countLevels(); ++i) {
+                SkMipmap::Level level;
+                REPORTER_ASSERT(reporter, mm->getLevel(i, &level));
+                REPORTER_ASSERT(reporter, levels_match(level.fPixmap, src, format.fWidths),
+                                "color type %d, %dx%d, level %d",
+                                format.fColorType, size.width(), size.height(), i);
+                src = level.fPixmap;
+            }
+        }
+    }
+}
+
+// Building levels in bands on a thread pool must produce exactly the serial result.
+DEF_TEST(MipMap_Parallel, reporter) {
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+
+    SkRandom rand;
+    for (SkColorType ct : {kN32_SkColorType, kRGBA_F16_SkColorType, kRGBA_1010102_SkColorType,
+                           kRGB_565_SkColorType}) {
+        SkBitmap bm;
+        bm.allocPixels(SkImageInfo::Make(1001, 700, ct, kPremul_SkAlphaType));
+        fill_random(&bm, &rand);
+
+        sk_sp<SkMipmap> serial(SkMipmap::Build(bm, nullptr)),
+                        parallel(SkMipmap::Build(bm, nullptr, executor.get()));
+        REPORTER_ASSERT(reporter, serial && parallel);
+        if (!serial || !parallel) {
+            return;
+        }
+        REPORTER_ASSERT(reporter, serial->countLevels() == parallel->countLevels());
+        for (int i = 0; i < serial->countLevels(); ++i) {
+            SkMipmap::Level a, b;
+            REPORTER_ASSERT(reporter, serial->getLevel(i, &a) && parallel->getLevel(i, &b));
+            REPORTER_ASSERT(reporter, 0 == memcmp(a.fPixmap.addr(), b.fPixmap.addr(),
+                                                  a.fPixmap.computeByteSize()),
+                            "color type %d, level %d", ct, i);
+        }
+    }
+}
+
 static void fill_in_mips(SkMipmapBuilder* builder, sk_sp<SkImage> img) {
     int count = builder->countLevels();
     for (int i = 0; i < count; ++i) {
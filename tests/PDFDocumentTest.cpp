@@ -7,11 +7,13 @@
 #include "include/core/SkBitmap.h"
 #include "include/core/SkCanvas.h"
 #include "include/core/SkColor.h"
+#include "include/core/SkColorSpace.h"
 #include "include/core/SkData.h"
 #include "include/core/SkDocument.h"
 #include "include/core/SkExecutor.h"
 #include "include/core/SkFont.h"
 #include "include/core/SkImage.h" // IWYU pragma: keep
+#include "include/core/SkImageInfo.h"
 #include "include/core/SkPaint.h"
 #include "include/core/SkRefCnt.h"
 #include "include/core/SkStream.h"
@@ -273,3 +275,38 @@ DEF_TEST(SkPDF_abort_jobs, rep) {
     doc->abort();
 }
 
+
+static sk_sp<SkData> make_multipage_pdf(SkExecutor* executor) {
+    SkPDF::Metadata metadata = SkPDF::JPEG::MetadataWithCallbacks();
+    metadata.fExecutor = executor;
+    SkDynamicMemoryWStream stream;
+    auto doc = SkPDF::MakeDocument(&stream, metadata);
+    SkFont font = ToolUtils::DefaultFont();
+    for (int i = 0; i < 8; ++i) {
+        SkCanvas* canvas = doc->beginPage(612, 792);
+        // Each page gets its own image, half of them with a soft mask and all with an ICC
+        // profile, to queue work that emits more objects when it's done.
+        SkBitmap bitmap;
+        bitmap.allocPixels(SkImageInfo::MakeN32(64, 64,
+                                                i % 2 ? kOpaque_SkAlphaType : kPremul_SkAlphaType,
+                                                SkColorSpace::MakeSRGBLinear()));
+        bitmap.eraseColor(SkColorSetARGB(i % 2 ? 0xFF : 0x80, (uint8_t)(i * 30), 0x40, 0x80));
+        canvas->drawImage(bitmap.asImage(), 10, 10);
+        canvas->drawString("Reproducible", 10, 100, font, SkPaint());
+        canvas->drawCircle(300, 400, 10.0f * (i + 1), SkPaint());
+        doc->endPage();
+    }
+    doc->close();
+    return stream.detachAsData();
+}
+
+// Output must not depend on whether, or how many, threads help make it.
+DEF_TEST(SkPDF_executor_reproducible, r) {
+    REQUIRE_PDF_DOCUMENT(SkPDF_executor_reproducible, r);
+    sk_sp<SkData> serial = make_multipage_pdf(nullptr);
+    for (int threads : {1, 2, 4}) {
+        std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(threads);
+        sk_sp<SkData> parallel = make_multipage_pdf(executor.get());
+        REPORTER_ASSERT(r, serial->equals(parallel.get()), "%d threads", threads);
+    }
+}
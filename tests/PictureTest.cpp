@@ -11,6 +11,7 @@
 #include "include/core/SkClipOp.h"
 #include "include/core/SkColor.h"
 #include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkFont.h"
 #include "include/core/SkFontStyle.h"
 #include "include/core/SkImage.h" // IWYU pragma: keep
@@ -29,6 +30,7 @@
 #include "include/core/SkStream.h"
 #include "include/core/SkTypeface.h"
 #include "include/core/SkTypes.h"
+#include "include/effects/SkImageFilters.h"
 #include "src/base/SkRandom.h"
 #include "src/core/SkBigPicture.h"
 #include "src/core/SkPicturePriv.h"
@@ -37,6 +39,7 @@
 #include "tools/fonts/FontToolUtils.h"
 
 #include <cstddef>
+#include <cstring>
 #include <memory>
 #include <vector>
 
@@ -924,3 +927,104 @@ DEF_TEST(Picture_nested_op_count, r) {
     check(make_pic(10, leaf1),  10,  10);
     check(make_pic(10, leaf10), 10, 100);
 }
+
+DEF_TEST(Picture_playbackParallel, r) {
+    // Several tiles, with partial ones on the edges. Only rects are drawn: paths that cross a
+    // tile edge get clipped before they're scan converted, which can nudge their edges.
+    const int kW = 700, kH = 530;
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+
+    for (bool useBBH : {false, true}) {
+        SkRTreeFactory factory;
+        SkPictureRecorder recorder;
+        SkCanvas* c = recorder.beginRecording(kW, kH, useBBH ? &factory : nullptr);
+        SkRandom rand;
+        for (int i = 0; i < 60; i++) {
+            SkPaint paint;
+            paint.setColor(rand.nextU() | 0x80000000);
+            paint.setAntiAlias(rand.nextBool());
+            c->drawRect(SkRect::MakeXYWH(rand.nextRangeF(0, kW), rand.nextRangeF(0, kH),
+                                         rand.nextRangeF(5, 200), rand.nextRangeF(5, 200)),
+                        paint);
+        }
+        c->saveLayerAlphaf(nullptr, 0.5f);
+        c->drawRect(SkRect::MakeXYWH(200.5f, 100.25f, 300, 250), SkPaint{});
+        c->restore();
+        sk_sp<SkPicture> pic = recorder.finishRecordingAsPicture();
+
+        const SkMatrix matrix = SkMatrix::Translate(-12, 9);
+        SkBitmap expected, actual;
+        expected.allocN32Pixels(kW, kH);
+        actual.allocN32Pixels(kW, kH);
+        expected.eraseColor(SK_ColorWHITE);
+        actual.eraseColor(SK_ColorWHITE);
+
+        SkCanvas canvas(expected);
+        canvas.concat(matrix);
+        pic->playback(&canvas);
+        REPORTER_ASSERT(r, pic->playbackParallel(actual.pixmap(), executor.get(), &matrix));
+
+        for (int y = 0; y < kH; y++) {
+            if (0 != memcmp(expected.getAddr32(0, y), actual.getAddr32(0, y), kW * 4)) {
+                ERRORF(r, "useBBH %d: row %d differs", useBBH, y);
+                break;
+            }
+        }
+    }
+
+    // Pixels we can't draw into are rejected.
+    SkBitmap unknown;
+    unknown.setInfo(SkImageInfo::MakeUnknown(10, 10));
+    REPORTER_ASSERT(r, !SkPicture::MakePlaceholder({0, 0, 10, 10})->playbackParallel(
+                               unknown.pixmap(), executor.get()));
+}
+
+DEF_TEST(Picture_playbackParallel_Backdrop, r) {
+    // A backdrop blur reads pixels from neighboring tiles, so it must match serial playback
+    // exactly, with no seams at tile edges. It should also be found inside a nested picture.
+    const int kW = 600, kH = 400;
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+
+    auto make_pic = [&](bool useBBH) {
+        SkRTreeFactory factory;
+        SkPictureRecorder recorder;
+        SkCanvas* c = recorder.beginRecording(kW, kH, useBBH ? &factory : nullptr);
+        for (int x = 0; x < kW; x += 20) {
+            SkPaint paint;
+            paint.setColor(x % 40 ? SK_ColorBLUE : SK_ColorYELLOW);
+            c->drawRect(SkRect::MakeXYWH(x, 0, 10, kH), paint);
+        }
+        sk_sp<SkImageFilter> blur = SkImageFilters::Blur(8, 8, nullptr);
+        c->saveLayer(SkCanvas::SaveLayerRec(nullptr, nullptr, blur.get(), 0));
+        c->restore();
+        return recorder.finishRecordingAsPicture();
+    };
+
+    for (bool nested : {false, true}) {
+        for (bool useBBH : {false, true}) {
+            sk_sp<SkPicture> pic = make_pic(useBBH);
+            if (nested) {
+                SkPictureRecorder recorder;
+                recorder.beginRecording(kW, kH)->drawPicture(pic);
+                pic = recorder.finishRecordingAsPicture();
+            }
+
+            SkBitmap expected, actual;
+            expected.allocN32Pixels(kW, kH);
+            actual.allocN32Pixels(kW, kH);
+            expected.eraseColor(SK_ColorWHITE);
+            actual.eraseColor(SK_ColorWHITE);
+
+            SkCanvas canvas(expected);
+            pic->playback(&canvas);
+            REPORTER_ASSERT(r, pic->playbackParallel(actual.pixmap(), executor.get()));
+
+            for (int y = 0; y < kH; y++) {
+                if (0 != memcmp(expected.getAddr32(0, y), actual.getAddr32(0, y), kW * 4)) {
+                    ERRORF(r, "nested %d useBBH %d: row %d differs", nested, useBBH, y);
+                    break;
+                }
+            }
+        }
+    }
+}
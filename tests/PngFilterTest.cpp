@@ -0,0 +1,108 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkTypes.h"
+
+#if defined(SK_CODEC_ENCODES_PNG_WITH_LIBPNG)
+#include "src/base/SkRandom.h"
+#include "src/encode/SkPngFilter.h"
+#include "tests/Test.h"
+
+#include <cstdlib>
+#include <vector>
+
+using namespace SkPngFilter;
+
+// Straight from the PNG spec, one byte at a time.
+static uint8_t reference_filter(Type type, const uint8_t* row, const uint8_t* prior, size_t i,
+                                int bpp) {
+    const int x = row[i],
+              a = i >= (size_t)bpp ? row[i - bpp] : 0,
+              b = prior[i],
+              c = i >= (size_t)bpp ? prior[i - bpp] : 0;
+    switch (type) {
+        case kNone:  return x;
+        case kSub:   return x - a;
+        case kUp:    return x - b;
+        case kAvg:   return x - (a + b) / 2;
+        case kPaeth: {
+            const int p = a + b - c,
+                      pa = std::abs(p - a),
+                      pb = std::abs(p - b),
+                      pc = std::abs(p - c);
+            return x - ((pa <= pb && pa <= pc) ? a : (pb <= pc ? b : c));
+        }
+    }
+    SkUNREACHABLE;
+}
+
+DEF_TEST(PngFilter_MatchesReference, r) {
+    SkRandom rand;
+    for (int bpp : {1, 2, 3, 4, 6, 8}) {
+        for (size_t rowBytes = 1; rowBytes < 300; rowBytes += 7) {
+            std::vector<uint8_t> row(rowBytes), prior(rowBytes), dst(rowBytes);
+            for (int trial = 0; trial < 10; trial++) {
+                // Extremes exercise the saturation in the vectorized Paeth predictor.
+                const bool extremes = trial < 4;
+                for (size_t i = 0; i < rowBytes; i++) {
+                    row[i]   = extremes ? (rand.nextBool() ? 0xFF : 0) : rand.nextU() & 0xFF;
+                    prior[i] = extremes ? (rand.nextBool() ? 0xFF : 0) : rand.nextU() & 0xFF;
+                }
+
+                uint64_t costs[kTypeCount];
+                SumCosts(row.data(), prior.data(), rowBytes, bpp, costs);
+
+                uint64_t bestCost = UINT64_MAX;
+                Type bestType = kNone;
+                for (int t = 0; t < kTypeCount; t++) {
+                    const Type type = (Type)t;
+                    Apply(type, row.data(), prior.data(), rowBytes, bpp, dst.data());
+                    uint64_t cost = 0;
+                    for (size_t i = 0; i < rowBytes; i++) {
+                        const uint8_t expected =
+                                reference_filter(type, row.data(), prior.data(), i, bpp);
+                        REPORTER_ASSERT(r, dst[i] == expected,
+                                        "type %d, bpp %d, byte %zu of %zu", t, bpp, i, rowBytes);
+                        cost += expected < 128 ? expected : 256 - expected;
+                    }
+                    REPORTER_ASSERT(r, costs[t] == cost, "type %d, bpp %d, %zu bytes",
+                                    t, bpp, rowBytes);
+                    if (cost < bestCost) {
+                        bestCost = cost;
+                        bestType = type;
+                    }
+                }
+                REPORTER_ASSERT(r, Choose(0xF8, row.data(), prior.data(), rowBytes, bpp) ==
+                                   bestType);
+            }
+        }
+    }
+}
+
+DEF_TEST(PngFilter_Choose, r) {
+    // A ramp across and down the rows: Up and Paeth leave only ones, and ties go to the lower
+    // type. Avg does better than Sub, which leaves threes.
+    constexpr size_t kRowBytes = 64;
+    uint8_t prior[kRowBytes], row[kRowBytes];
+    for (size_t i = 0; i < kRowBytes; i++) {
+        prior[i] = i * 3;
+        row[i] = i * 3 + 1;
+    }
+    REPORTER_ASSERT(r, Choose(Flag(kNone) | Flag(kUp), row, prior, kRowBytes, 1) == kUp);
+    REPORTER_ASSERT(r, Choose(Flag(kUp) | Flag(kPaeth), row, prior, kRowBytes, 1) == kUp);
+    REPORTER_ASSERT(r, Choose(Flag(kSub) | Flag(kAvg), row, prior, kRowBytes, 1) == kAvg);
+
+    // A single filter is used as is, and none at all means kNone.
+    REPORTER_ASSERT(r, Choose(Flag(kPaeth), row, prior, kRowBytes, 1) == kPaeth);
+    REPORTER_ASSERT(r, Choose(0, row, prior, kRowBytes, 1) == kNone);
+
+    REPORTER_ASSERT(r, !HasChoice(0));
+    REPORTER_ASSERT(r, !HasChoice(Flag(kAvg)));
+    REPORTER_ASSERT(r, HasChoice(Flag(kNone) | Flag(kPaeth)));
+}
+
+#endif  // defined(SK_CODEC_ENCODES_PNG_WITH_LIBPNG)
@@ -0,0 +1,137 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkTypes.h"
+
+#if defined(SK_CODEC_DECODES_PNG_WITH_LIBPNG)
+#include "include/codec/SkAndroidCodec.h"
+#include "include/codec/SkCodec.h"
+#include "include/codec/SkPngDecoder.h"
+#include "include/core/SkBitmap.h"
+#include "include/core/SkData.h"
+#include "include/core/SkImageInfo.h"
+#include "include/core/SkRect.h"
+#include "include/core/SkRefCnt.h"
+#include "include/core/SkStream.h"
+#include "src/codec/SkPngRowIndex.h"
+#include "tests/FakeStreams.h"
+#include "tests/Test.h"
+#include "tools/Resources.h"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+
+// Only a codec whose data is in memory can build a row index.
+static std::unique_ptr<SkAndroidCodec> make_codec(sk_sp<SkData> data, bool inMemory) {
+    std::unique_ptr<SkStream> stream;
+    if (inMemory) {
+        stream = SkMemoryStream::Make(std::move(data));
+    } else {
+        stream = std::make_unique<NotAssetMemStream>(std::move(data));
+    }
+    return SkAndroidCodec::MakeFromCodec(SkPngDecoder::Decode(std::move(stream), nullptr));
+}
+
+static SkBitmap decode_region(skiatest::Reporter* r, SkAndroidCodec* codec,
+                              const SkIRect& subset, int sampleSize) {
+    SkBitmap bitmap;
+    bitmap.allocPixels(codec->getInfo()
+                               .makeDimensions(codec->getSampledSubsetDimensions(sampleSize,
+                                                                                 subset))
+                               .makeColorType(kN32_SkColorType)
+                               .makeAlphaType(codec->computeOutputAlphaType(false)));
+    SkAndroidCodec::AndroidOptions options;
+    options.fSampleSize = sampleSize;
+    options.fSubset = &subset;
+    REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getAndroidPixels(bitmap.info(),
+                                                                    bitmap.getPixels(),
+                                                                    bitmap.rowBytes(),
+                                                                    &options));
+    return bitmap;
+}
+
+static bool equal(const SkBitmap& a, const SkBitmap& b) {
+    if (a.dimensions() != b.dimensions()) {
+        return false;
+    }
+    for (int y = 0; y < a.height(); y++) {
+        if (0 != memcmp(a.getAddr(0, y), b.getAddr(0, y), a.info().minRowBytes())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Regions decoded by resuming from the row index should match those decoded from the top.
+DEF_TEST(PngRowIndex_Regions, r) {
+    for (const char* path : {"images/mandrill_512.png",   // RGB
+                             "images/example_3.png",      // 16-bit RGB, many IDATs
+                             "images/index8.png",         // Palette
+                             "images/grayscale.png",
+                             "images/gamut.png"}) {       // RGBA, many IDATs
+        sk_sp<SkData> data = GetResourceAsData(path);
+        if (!data) {
+            continue;
+        }
+        std::unique_ptr<SkAndroidCodec> indexed = make_codec(data, true),
+                                        reference = make_codec(data, false);
+        if (!indexed || !reference) {
+            ERRORF(r, "%s: could not make codecs", path);
+            continue;
+        }
+        const int w = indexed->getInfo().width(),
+                  h = indexed->getInfo().height();
+        // Start past the top, so the index has checkpoints to go back to for the later regions.
+        for (int top : {h / 2, h - 1, h / 3, 5, h - 40}) {
+            top = std::max(top, 0);
+            for (int sampleSize : {1, 3}) {
+                const SkIRect subset =
+                        SkIRect::MakeXYWH(w / 4, top, w / 2, std::min(64, h - top));
+                REPORTER_ASSERT(r, equal(decode_region(r, indexed.get(), subset, sampleSize),
+                                         decode_region(r, reference.get(), subset, sampleSize)),
+                                "%s: rows [%d, %d), sample size %d",
+                                path, subset.top(), subset.bottom(), sampleSize);
+            }
+        }
+    }
+}
+
+DEF_TEST(PngRowIndex_ByteLimit, r) {
+    sk_sp<SkData> data = GetResourceAsData("images/gamut.png");
+    if (!data) {
+        return;
+    }
+    constexpr size_t kByteLimit = 256 << 10;
+    std::unique_ptr<SkPngRowIndex> index = SkPngRowIndex::Make(data, kByteLimit);
+    REPORTER_ASSERT(r, index);
+    if (!index) {
+        return;
+    }
+    const int height = index->height();
+    REPORTER_ASSERT(r, index->makeIdat(height - 1, height));
+
+    // Indexing the whole image spread as many checkpoints over it as fit.
+    REPORTER_ASSERT(r, index->bytesUsed() <= kByteLimit, "%zu", index->bytesUsed());
+    REPORTER_ASSERT(r, index->checkpointCount() > 1);
+    REPORTER_ASSERT(r, index->checkpointCount() * index->checkpointSpacing() <= height);
+
+    // Going back up doesn't need any more.
+    const int checkpoints = index->checkpointCount();
+    REPORTER_ASSERT(r, index->makeIdat(height / 2, height / 2 + 10));
+    REPORTER_ASSERT(r, index->checkpointCount() == checkpoints);
+}
+
+DEF_TEST(PngRowIndex_Unsupported, r) {
+    for (const char* path : {"images/plane_interlaced.png",
+                             "images/mandrill_512_q075.jpg"}) {
+        REPORTER_ASSERT(r, !SkPngRowIndex::Make(GetResourceAsData(path), 1 << 20), "%s", path);
+    }
+    REPORTER_ASSERT(r, !SkPngRowIndex::Make(nullptr, 1 << 20));
+}
+
+#endif  // SK_CODEC_DECODES_PNG_WITH_LIBPNG
@@ -9,9 +9,11 @@
 #include "include/core/SkTypes.h"
 #include "include/private/base/SkTemplates.h"
 #include "src/base/SkRandom.h"
+#include "src/core/SkDynamicRTree.h"
 #include "src/core/SkRTree.h"
 #include "tests/Test.h"
 
+#include <algorithm>
 #include <cmath>
 #include <cstddef>
 #include <vector>
@@ -97,3 +99,93 @@ DEF_TEST(RTree, reporter) {
                                   expectedDepthMax >= rtree.getDepth());
     }
 }
+
+static bool verify_dynamic_query(const SkRect& query, const std::vector<SkRect>& rects,
+                                 const std::vector<int>& found) {
+    std::vector<int> expected;
+    for (int i = 0; i < (int)rects.size(); ++i) {
+        if (SkRect::Intersects(query, rects[i])) {
+            expected.push_back(i);
+        }
+    }
+    return found == expected;
+}
+
+DEF_TEST(DynamicRTree_BulkLoad, reporter) {
+    SkRandom rand;
+    for (int n : {0, 1, SkDynamicRTree::kMaxChildren, SkDynamicRTree::kMaxChildren + 1, 200}) {
+        std::vector<SkRect> rects(n);
+        for (SkRect& r : rects) {
+            r = random_rect(rand);
+        }
+        if (n > 0) {
+            rects[n / 2].setEmpty();  // Never found.
+        }
+
+        SkDynamicRTree tree;
+        tree.insert(rects.data(), n);
+        REPORTER_ASSERT(reporter, tree.isValid());
+        REPORTER_ASSERT(reporter, tree.getCount() == std::max(0, n - 1));
+
+        for (size_t i = 0; i < NUM_QUERIES; ++i) {
+            std::vector<int> hits;
+            SkRect query = random_rect(rand);
+            tree.search(query, &hits);
+            REPORTER_ASSERT(reporter, verify_dynamic_query(query, rects, hits));
+        }
+    }
+}
+
+DEF_TEST(DynamicRTree_Incremental, reporter) {
+    SkRandom rand;
+    std::vector<SkRect> rects(NUM_RECTS);
+    for (SkRect& r : rects) {
+        r = random_rect(rand);
+    }
+    SkDynamicRTree tree;
+    tree.insert(rects.data(), NUM_RECTS);
+
+    // Randomly add, remove and move rects, checking the tree against brute force as we go.
+    for (size_t i = 0; i < NUM_ITERATIONS * 20; ++i) {
+        const int id = rand.nextULessThan(NUM_RECTS + 50);
+        if (id >= (int)rects.size()) {
+            rects.resize(id + 1, SkRect::MakeEmpty());
+        }
+        switch (rand.nextULessThan(3)) {
+            case 0:
+                REPORTER_ASSERT(reporter, tree.remove(id) == !rects[id].isEmpty());
+                rects[id].setEmpty();
+                break;
+            case 1:
+                if (rects[id].isEmpty()) {
+                    rects[id] = random_rect(rand);
+                    tree.add(id, rects[id]);
+                }
+                break;
+            case 2: {
+                // Mix small nudges (which stay in the leaf) with big moves.
+                rects[id] = rand.nextBool() && !rects[id].isEmpty()
+                                    ? rects[id].makeInset(0.5f, 0.5f)
+                                    : random_rect(rand);
+                tree.update(id, rects[id]);
+                break;
+            }
+        }
+        if (i % 50 == 0) {
+            REPORTER_ASSERT(reporter, tree.isValid());
+            std::vector<int> hits;
+            SkRect query = random_rect(rand);
+            tree.search(query, &hits);
+            REPORTER_ASSERT(reporter, verify_dynamic_query(query, rects, hits));
+        }
+    }
+
+    // Remove everything.
+    for (int id = 0; id < (int)rects.size(); id++) {
+        REPORTER_ASSERT(reporter, tree.remove(id) == !rects[id].isEmpty());
+    }
+    REPORTER_ASSERT(reporter, tree.isValid());
+    REPORTER_ASSERT(reporter, tree.getCount() == 0);
+    REPORTER_ASSERT(reporter, tree.getDepth() == 0);
+    REPORTER_ASSERT(reporter, !tree.remove(0));
+}
@@ -0,0 +1,214 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkBitmap.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkColor.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkImage.h"
+#include "include/core/SkImageFilter.h"
+#include "include/core/SkImageInfo.h"
+#include "include/core/SkPaint.h"
+#include "include/core/SkPath.h"
+#include "include/core/SkPicture.h"
+#include "include/core/SkPictureRecorder.h"
+#include "include/core/SkPixmap.h"
+#include "include/core/SkPoint.h"
+#include "include/core/SkRRect.h"
+#include "include/core/SkRect.h"
+#include "include/core/SkRefCnt.h"
+#include "include/core/SkShader.h"
+#include "include/core/SkSurface.h"
+#include "include/core/SkTileMode.h"
+#include "include/effects/SkGradientShader.h"
+#include "include/effects/SkImageFilters.h"
+#include "src/image/SkSurface_RasterTiled.h"
+#include "tests/Test.h"
+
+#include <cstring>
+#include <functional>
+#include <memory>
+
+static constexpr int kW = 700, kH = 500;  // Several tiles, with partial ones on the edges.
+
+static void draw_scene(SkCanvas* canvas, int step) {
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    switch (step) {
+        case 0: {
+            canvas->clear(SK_ColorWHITE);
+            const SkPoint pts[] = {{0, 0}, {kW, kH}};
+            const SkColor colors[] = {SK_ColorRED, SK_ColorBLUE};
+            paint.setShader(SkGradientShader::MakeLinear(pts, colors, nullptr, 2,
+                                                         SkTileMode::kClamp));
+            canvas->drawRect(SkRect::MakeXYWH(20, 20, kW - 40, 200), paint);
+            break;
+        }
+        case 1: {
+            canvas->translate(13.5f, 7.25f);
+            canvas->clipRRect(SkRRect::MakeOval(SkRect::MakeWH(kW - 40, kH - 20)), true);
+            paint.setColor(0x8000FF00);
+            for (int i = 0; i < 20; i++) {
+                canvas->drawCircle(35.f * i, 24.f * i, 60, paint);
+            }
+            break;
+        }
+        case 2: {
+            SkPaint layerPaint;
+            layerPaint.setAlphaf(0.5f);
+            layerPaint.setImageFilter(SkImageFilters::Blur(4, 4, nullptr));
+            canvas->saveLayer(nullptr, &layerPaint);
+            SkPath path;
+            path.moveTo(10, 400).lineTo(kW / 2, 60).lineTo(kW - 10, 480).close();
+            paint.setColor(SK_ColorMAGENTA);
+            canvas->drawPath(path, paint);
+            break;
+        }
+        case 3: {
+            paint.setStyle(SkPaint::kStroke_Style);
+            paint.setStrokeWidth(5);
+            paint.setColor(SK_ColorBLACK);
+            canvas->drawLine(0, 0, kW, kH, paint);
+            canvas->restore();  // The layer from step 2.
+            canvas->drawRect(SkRect::MakeXYWH(250, 250, 300, 100), paint);
+            break;
+        }
+    }
+}
+
+// Draws the scene one step at a time, calling betweenSteps() after each step.
+static void draw_steps(SkCanvas* canvas, const std::function<void()>& betweenSteps) {
+    for (int step = 0; step < 4; step++) {
+        draw_scene(canvas, step);
+        betweenSteps();
+    }
+}
+
+static bool equal_pixels(const SkPixmap& a, const SkPixmap& b) {
+    if (a.info() != b.info()) {
+        return false;
+    }
+    for (int y = 0; y < a.height(); y++) {
+        if (0 != memcmp(a.addr(0, y), b.addr(0, y), a.info().minRowBytes())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+DEF_TEST(RasterMultiThreaded_MatchesSerialDraw, reporter) {
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(kW, kH);
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+
+    // Anti-aliased edges that cross a tile get clipped to it before they're scan converted, which
+    // can nudge their coverage. So the expected result is the scene drawn serially, tile by tile.
+    SkBitmap expected;
+    expected.allocPixels(info);
+    const int kTile = SkSurface_RasterTiled::kTileSize;
+    for (int y = 0; y < kH; y += kTile) {
+        for (int x = 0; x < kW; x += kTile) {
+            SkCanvas canvas(expected);
+            canvas.clipIRect(SkIRect::MakeXYWH(x, y, kTile, kTile));
+            draw_steps(&canvas, []{});
+        }
+    }
+    const SkPixmap& expectedPixels = expected.pixmap();
+
+    // Draw everything before looking at the pixels.
+    sk_sp<SkSurface> deferred = SkSurfaces::RasterMultiThreaded(info, executor.get());
+    REPORTER_ASSERT(reporter, deferred);
+    draw_steps(deferred->getCanvas(), []{});
+    SkPixmap pixels;
+    REPORTER_ASSERT(reporter, deferred->peekPixels(&pixels));
+    REPORTER_ASSERT(reporter, equal_pixels(expectedPixels, pixels));
+
+    // Flush between every step, including while the layer from step 2 is still open. The matrix,
+    // clip and layer state must carry across flushes.
+    sk_sp<SkSurface> flushed = SkSurfaces::RasterMultiThreaded(info, executor.get());
+    draw_steps(flushed->getCanvas(), [&] {
+        SkPixmap unused;
+        REPORTER_ASSERT(reporter, flushed->peekPixels(&unused));
+    });
+    SkBitmap readBack;
+    readBack.allocPixels(info);
+    REPORTER_ASSERT(reporter, flushed->readPixels(readBack, 0, 0));
+    REPORTER_ASSERT(reporter, equal_pixels(expectedPixels, readBack.pixmap()));
+}
+
+DEF_TEST(RasterMultiThreaded_OpenLayerIsNotFlushed, reporter) {
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(kW, kH);
+    sk_sp<SkSurface> surface = SkSurfaces::RasterMultiThreaded(info, nullptr);
+    SkCanvas* canvas = surface->getCanvas();
+
+    canvas->clear(SK_ColorWHITE);
+    canvas->saveLayer(nullptr, nullptr);
+    canvas->clear(SK_ColorRED);
+
+    SkBitmap bm;
+    bm.allocPixels(info);
+    REPORTER_ASSERT(reporter, surface->readPixels(bm, 0, 0));
+    REPORTER_ASSERT(reporter, bm.getColor(kW - 1, kH - 1) == SK_ColorWHITE);
+
+    canvas->restore();
+    REPORTER_ASSERT(reporter, surface->readPixels(bm, 0, 0));
+    REPORTER_ASSERT(reporter, bm.getColor(kW - 1, kH - 1) == SK_ColorRED);
+}
+
+DEF_TEST(RasterMultiThreaded_CopyOnWrite, reporter) {
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(kW, kH);
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(2);
+    sk_sp<SkSurface> surface = SkSurfaces::RasterMultiThreaded(info, executor.get());
+    SkCanvas* canvas = surface->getCanvas();
+
+    canvas->clear(SK_ColorRED);
+    const uint32_t redID = surface->generationID();
+    sk_sp<SkImage> red = surface->makeImageSnapshot();
+
+    canvas->clear(SK_ColorBLUE);
+    REPORTER_ASSERT(reporter, surface->generationID() != redID);
+    sk_sp<SkImage> blue = surface->makeImageSnapshot();
+    REPORTER_ASSERT(reporter, red != blue);
+
+    SkPixmap pm;
+    REPORTER_ASSERT(reporter, red->peekPixels(&pm) && pm.getColor(kW / 2, kH / 2) == SK_ColorRED);
+    REPORTER_ASSERT(reporter, blue->peekPixels(&pm) && pm.getColor(kW / 2, kH / 2) == SK_ColorBLUE);
+    REPORTER_ASSERT(reporter, canvas->imageInfo() == info);
+}
+
+// A backdrop filter reads pixels outside the tile it's drawn in, even from inside a picture, so
+// the surface has to draw it as one tile to match a plain raster surface.
+DEF_TEST(RasterMultiThreaded_BackdropInPicture, reporter) {
+    SkPictureRecorder recorder;
+    SkCanvas* recording = recorder.beginRecording(SkRect::MakeWH(kW, kH));
+    sk_sp<SkImageFilter> blur = SkImageFilters::Blur(8, 8, nullptr);
+    recording->saveLayer(SkCanvas::SaveLayerRec(nullptr, nullptr, blur.get(), 0));
+    recording->restore();
+    sk_sp<SkPicture> picture = recorder.finishRecordingAsPicture();
+
+    auto draw = [&](SkCanvas* canvas) {
+        canvas->clear(SK_ColorWHITE);
+        SkPaint paint;
+        for (int x = 0; x < kW; x += 32) {
+            paint.setColor(x % 64 ? SK_ColorBLUE : SK_ColorRED);
+            canvas->drawRect(SkRect::MakeXYWH(x, 0, 16, kH), paint);
+        }
+        canvas->drawPicture(picture);
+    };
+
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(kW, kH);
+    sk_sp<SkSurface> expected = SkSurfaces::Raster(info);
+    draw(expected->getCanvas());
+    SkPixmap expectedPixels;
+    REPORTER_ASSERT(reporter, expected->peekPixels(&expectedPixels));
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    sk_sp<SkSurface> tiled = SkSurfaces::RasterMultiThreaded(info, executor.get());
+    draw(tiled->getCanvas());
+    SkPixmap pixels;
+    REPORTER_ASSERT(reporter, tiled->peekPixels(&pixels));
+    REPORTER_ASSERT(reporter, equal_pixels(expectedPixels, pixels));
+}
@@ -0,0 +1,85 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkBitmap.h"
+#include "include/core/SkBlurTypes.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkColor.h"
+#include "include/core/SkImageInfo.h"
+#include "include/core/SkMaskFilter.h"
+#include "include/core/SkPaint.h"
+#include "include/core/SkPath.h"
+#include "include/core/SkPixmap.h"
+#include "include/core/SkRect.h"
+#include "tests/Test.h"
+
+#include <cmath>
+#include <cstring>
+
+static constexpr int kSize = 64;
+
+// Exercises the rect, anti-aliased and A8 mask blit pipelines, all with a constant paint color.
+static void draw(SkCanvas* canvas, SkColor color) {
+    canvas->clear(SK_ColorWHITE);
+
+    SkPaint paint;
+    paint.setColor(color);
+    canvas->drawRect(SkRect::MakeXYWH(4, 4, 40, 20), paint);
+
+    paint.setAntiAlias(true);
+    canvas->drawCircle(40, 40, 17.3f, paint);
+
+    paint.setMaskFilter(SkMaskFilter::MakeBlur(kNormal_SkBlurStyle, 2.5f));
+    SkPath path;
+    path.moveTo(2, 60).lineTo(30, 30).lineTo(60, 62).close();
+    canvas->drawPath(path, paint);
+}
+
+static bool equal_pixels(const SkPixmap& a, const SkPixmap& b) {
+    for (int y = 0; y < kSize; y++) {
+        if (0 != memcmp(a.addr(0, y), b.addr(0, y), kSize * a.info().bytesPerPixel())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Blitters for paints that differ only in their (constant) color share compiled programs. Each one
+// must still draw with its own color, into its own pixels.
+DEF_TEST(RasterPipelineBlitter_SharedPrograms, reporter) {
+    for (SkColorType ct : {kN32_SkColorType, kRGBA_F16_SkColorType, kRGB_565_SkColorType}) {
+        const SkColor colors[] = {0x80336699, 0xC0FF8000, 0x80336699};
+        SkBitmap bitmaps[3];
+        for (int i = 0; i < 3; i++) {
+            // Vary the row bytes, so that the destination contexts differ too.
+            const SkImageInfo info = SkImageInfo::Make(kSize + 7 * i, kSize, ct,
+                                                       kPremul_SkAlphaType);
+            bitmaps[i].allocPixels(info);
+            SkCanvas canvas(bitmaps[i]);
+            draw(&canvas, colors[i]);
+        }
+
+        REPORTER_ASSERT(reporter, equal_pixels(bitmaps[0].pixmap(), bitmaps[2].pixmap()),
+                        "color type %d", ct);
+        REPORTER_ASSERT(reporter, !equal_pixels(bitmaps[0].pixmap(), bitmaps[1].pixmap()),
+                        "color type %d", ct);
+
+        // The middle of the rect is the color blended over white.
+        SkColor4f expected = SkColor4f::FromColor(colors[1]);
+        expected = {expected.fR * expected.fA + (1 - expected.fA),
+                    expected.fG * expected.fA + (1 - expected.fA),
+                    expected.fB * expected.fA + (1 - expected.fA),
+                    1.0f};
+        const SkColor4f actual = bitmaps[1].getColor4f(10, 10);
+        const float tolerance = ct == kRGB_565_SkColorType ? 1 / 31.0f : 1 / 255.0f;
+        for (int c = 0; c < 4; c++) {
+            REPORTER_ASSERT(reporter, std::abs(actual[c] - expected[c]) <= tolerance,
+                            "color type %d, channel %d: %g vs %g",
+                            ct, c, actual[c], expected[c]);
+        }
+    }
+}
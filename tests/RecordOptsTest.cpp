@@ -5,21 +5,26 @@
  * found in the LICENSE file.
  */
 
+#include "include/core/SkBitmap.h"
 #include "include/core/SkBlendMode.h"
 #include "include/core/SkCanvas.h"
 #include "include/core/SkColor.h"
 #include "include/core/SkColorFilter.h"
+#include "include/core/SkImage.h"
 #include "include/core/SkImageFilter.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkPaint.h"
 #include "include/core/SkPicture.h"
 #include "include/core/SkPictureRecorder.h"
+#include "include/core/SkRRect.h"
 #include "include/core/SkRect.h"
 #include "include/core/SkRefCnt.h"
+#include "include/core/SkSamplingOptions.h"
 #include "include/core/SkScalar.h"
 #include "include/core/SkSurface.h"
 #include "include/effects/SkImageFilters.h"
 #include "src/core/SkRecord.h"
+#include "src/core/SkRecordDraw.h"
 #include "src/core/SkRecordOpts.h"
 #include "src/core/SkRecorder.h"
 #include "src/core/SkRecords.h"
@@ -28,6 +33,7 @@
 
 #include <array>
 #include <cstddef>
+#include <cstring>
 
 static const int W = 1920, H = 1080;
 
@@ -359,6 +365,185 @@ DEF_TEST(RecordOpts_MergeSvgOpacityAndFilterLayers, r) {
     index += 4;
 }
 
+DEF_TEST(RecordOpts_NoopUnusedClips, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, W, H);
+
+    // Both clips are dead: nothing draws before the Restore.
+    recorder.save();
+        recorder.clipRect(SkRect::MakeWH(200, 200));
+        recorder.translate(10, 10);
+        recorder.clipRRect(SkRRect::MakeOval(SkRect::MakeWH(100, 100)));
+    recorder.restore();
+
+    // This clip is used.
+    recorder.save();
+        recorder.clipRect(SkRect::MakeWH(200, 200));
+        recorder.drawRect(SkRect::MakeWH(300, 300), SkPaint());
+    recorder.restore();
+
+    // The nested SaveLayer is sized by the clip.
+    recorder.save();
+        recorder.clipRect(SkRect::MakeWH(200, 200));
+        recorder.saveLayer(nullptr, nullptr);
+        recorder.restore();
+    recorder.restore();
+
+    REPORTER_ASSERT(r, 2 == SkRecordNoopUnusedClips(&record));
+    assert_type<SkRecords::NoOp>     (r, record, 1);
+    assert_type<SkRecords::Translate>(r, record, 2);
+    assert_type<SkRecords::NoOp>     (r, record, 3);
+    assert_type<SkRecords::ClipRect> (r, record, 6);
+    assert_type<SkRecords::ClipRect> (r, record, 10);
+}
+
+static sk_sp<SkImage> make_image(SkColor color, int w = 8, int h = 8) {
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(w, h);
+    bitmap.eraseColor(color);
+    return bitmap.asImage();
+}
+
+static bool draws_same(const SkRecord& a, const SkRecord& b) {
+    SkBitmap bitmaps[2];
+    const SkRecord* records[] = {&a, &b};
+    for (int i = 0; i < 2; i++) {
+        bitmaps[i].allocN32Pixels(100, 100);
+        SkCanvas canvas(bitmaps[i]);
+        canvas.clear(SK_ColorWHITE);
+        SkRecordDraw(*records[i], &canvas, nullptr, nullptr, 0, nullptr, nullptr);
+    }
+    return 0 == memcmp(bitmaps[0].getPixels(), bitmaps[1].getPixels(),
+                       bitmaps[0].computeByteSize());
+}
+
+DEF_TEST(RecordOpts_BatchImageRects, r) {
+    SkRecord record, reference;
+    SkRecorder recorder(&record, W, H), referenceRecorder(&reference, W, H);
+
+    sk_sp<SkImage> red = make_image(SK_ColorRED),
+                   blue = make_image(0x800000FF);
+    SkPaint translucent;
+    translucent.setAlphaf(0.5f);
+    for (SkCanvas* canvas : {(SkCanvas*)&recorder, (SkCanvas*)&referenceRecorder}) {
+        // These three share a paint, so they become one set...
+        canvas->drawImageRect(red, SkRect::MakeXYWH(0, 0, 30, 30), SkSamplingOptions());
+        canvas->drawImageRect(blue, SkRect::MakeXYWH(20, 20, 30, 30), SkSamplingOptions());
+        canvas->drawImageRect(red, SkRect::MakeXYWH(40, 40, 30, 30), SkSamplingOptions());
+        // ... while these two, with their own paint, become another.
+        canvas->drawImageRect(blue, SkRect::MakeXYWH(0, 50, 30, 30), SkSamplingOptions(),
+                              &translucent);
+        canvas->drawImageRect(red, SkRect::MakeXYWH(10, 60, 30, 30), SkSamplingOptions(),
+                              &translucent);
+        // A matrix change ends the run.
+        canvas->translate(5, 5);
+        canvas->drawImageRect(red, SkRect::MakeXYWH(60, 0, 30, 30), SkSamplingOptions(),
+                              &translucent);
+    }
+
+    REPORTER_ASSERT(r, 3 == SkRecordBatchImageRects(&record));
+    record.defrag();
+    REPORTER_ASSERT(r, 4 == record.count());
+    auto set = assert_type<SkRecords::DrawEdgeAAImageSet>(r, record, 0);
+    REPORTER_ASSERT(r, set && 3 == set->count && !set->paint);
+    set = assert_type<SkRecords::DrawEdgeAAImageSet>(r, record, 1);
+    REPORTER_ASSERT(r, set && 2 == set->count && set->paint->getAlphaf() == 0.5f);
+    assert_type<SkRecords::Translate>    (r, record, 2);
+    assert_type<SkRecords::DrawImageRect>(r, record, 3);
+
+    REPORTER_ASSERT(r, draws_same(record, reference));
+}
+
+DEF_TEST(RecordOpts_BatchImageRects_Oversized, r) {
+    SkRecord record, reference;
+    SkRecorder recorder(&record, W, H), referenceRecorder(&reference, W, H);
+
+    // Wide enough that a device may tile it, so it must reach the canvas on its own.
+    sk_sp<SkImage> big = make_image(SK_ColorRED, 4096, 4),
+                   small = make_image(SK_ColorBLUE);
+    for (SkCanvas* canvas : {(SkCanvas*)&recorder, (SkCanvas*)&referenceRecorder}) {
+        canvas->drawImageRect(big, SkRect::MakeXYWH(0, 0, 60, 30), SkSamplingOptions());
+        canvas->drawImageRect(big, SkRect::MakeXYWH(0, 40, 60, 30), SkSamplingOptions());
+        canvas->drawImageRect(small, SkRect::MakeXYWH(40, 40, 30, 30), SkSamplingOptions());
+    }
+
+    // SkRecordOptimize() never batches, and the batching pass leaves oversized images alone.
+    SkRecordOptimize(&record);
+    REPORTER_ASSERT(r, 0 == SkRecordBatchImageRects(&record));
+    for (int i = 0; i < 3; i++) {
+        assert_type<SkRecords::DrawImageRect>(r, record, i);
+    }
+
+    REPORTER_ASSERT(r, draws_same(record, reference));
+}
+
+DEF_TEST(RecordOpts_NoopOccludedDraws, r) {
+    SkRecord record, reference;
+    SkRecorder recorder(&record, W, H), referenceRecorder(&reference, W, H);
+
+    SkPaint opaque, translucent, aa;
+    opaque.setColor(SK_ColorGREEN);
+    translucent.setColor(0x80FF0000);
+    aa.setAntiAlias(true);
+    for (SkCanvas* canvas : {(SkCanvas*)&recorder, (SkCanvas*)&referenceRecorder}) {
+        canvas->drawRect(SkRect::MakeXYWH(10, 10, 20, 20), aa);           // 0: covered by 2
+        canvas->drawRect(SkRect::MakeXYWH(50, 50, 20, 20), translucent);  // 1: covered by 2
+        canvas->drawPaint(opaque);                                        // 2
+
+        canvas->drawRect(SkRect::MakeXYWH(10, 10, 20, 20), translucent);  // 3: covered by 4
+        canvas->drawRect(SkRect::MakeXYWH(5, 5, 40, 40), opaque);         // 4
+        canvas->drawRect(SkRect::MakeXYWH(10, 10, 20, 20), translucent);  // 5: drawn after
+        canvas->drawRect(SkRect::MakeXYWH(0, 0, 20, 20), opaque);         // 6: partly covers 5
+
+        // A matrix change doesn't stop a draw covering the clip, but it does a smaller rect.
+        canvas->translate(1, 1);                                          // 7
+        canvas->drawRect(SkRect::MakeXYWH(10, 10, 20, 20), aa);           // 8: aa, not known
+        canvas->drawRect(SkRect::MakeXYWH(5, 5, 40, 40), opaque);         // 9
+
+        canvas->drawRect(SkRect::MakeXYWH(10, 10, 20, 20), opaque);       // 10
+        canvas->drawPaint(translucent);                                   // 11: not opaque
+
+        canvas->save();                                                   // 12
+        canvas->clipRect(SkRect::MakeXYWH(0.5f, 0.5f, 60, 60), true);     // 13
+        canvas->drawRect(SkRect::MakeXYWH(10, 10, 20, 20), opaque);       // 14: aa clip
+        canvas->drawPaint(opaque);                                        // 15
+        canvas->restore();                                                // 16
+    }
+
+    REPORTER_ASSERT(r, 3 == SkRecordNoopOccludedDraws(&record));
+    for (int i : {0, 1, 3}) {
+        assert_type<SkRecords::NoOp>(r, record, i);
+    }
+    for (int i : {4, 5, 6, 8, 9, 10, 14}) {
+        assert_type<SkRecords::DrawRect>(r, record, i);
+    }
+
+    REPORTER_ASSERT(r, draws_same(record, reference));
+}
+
+DEF_TEST(RecordOpts_Stats, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, W, H);
+
+    sk_sp<SkImage> image = make_image(SK_ColorRED);
+    recorder.saveLayer(nullptr, nullptr);
+        recorder.drawRect(SkRect::MakeWH(50, 60), SkPaint());
+    recorder.restore();
+    recorder.save();
+        recorder.clipRect(SkRect::MakeWH(200, 200));
+    recorder.restore();
+    recorder.drawImageRect(image, SkRect::MakeWH(10, 10), SkSamplingOptions());
+    recorder.drawImageRect(image, SkRect::MakeWH(20, 20), SkSamplingOptions());
+
+    SkRecordOptimizeStats stats;
+    SkRecordOptimize(&record, &stats);
+    REPORTER_ASSERT(r, 1 == stats.noopSaveLayerDrawRestores);
+    REPORTER_ASSERT(r, 0 == stats.mergedSvgOpacityAndFilterLayers);
+    REPORTER_ASSERT(r, 1 == stats.noopUnusedClips);
+    // Image rects are only batched on request.
+    REPORTER_ASSERT(r, 5 == record.count());
+}
+
 static void do_draw(SkCanvas* canvas, SkColor color, bool doLayer) {
     canvas->drawColor(SK_ColorWHITE);
 
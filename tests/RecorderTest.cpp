@@ -9,17 +9,23 @@
 #include "include/core/SkColor.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkImageInfo.h"
+#include "include/core/SkFont.h"
 #include "include/core/SkPaint.h"
+#include "include/core/SkPath.h"
+#include "include/core/SkPicture.h"
+#include "include/core/SkPictureRecorder.h"
 #include "include/core/SkRect.h"
 #include "include/core/SkRefCnt.h"
 #include "include/core/SkSamplingOptions.h"
 #include "include/core/SkScalar.h"
 #include "include/core/SkShader.h"
 #include "include/core/SkSurface.h"
+#include "include/core/SkTextBlob.h"
 #include "include/private/base/SkMalloc.h"
 #include "src/core/SkRecord.h"
 #include "src/core/SkRecorder.h"
 #include "src/core/SkRecords.h"
+#include "tests/RecordTestUtils.h"
 #include "tests/Test.h"
 
 #define COUNT(T) + 1
@@ -128,3 +134,94 @@ DEF_TEST(Recorder_boundsOverflow, reporter) {
     REPORTER_ASSERT(reporter, recorder.imageInfo().width() > 0 &&
                               recorder.imageInfo().height() > 0);
 }
+
+// Builds a new path, text blob and shader on each call, all with the same contents.
+static void draw_payloads(SkCanvas* canvas) {
+    SkPaint paint;
+    paint.setShader(SkShaders::Color(SK_ColorRED));
+    canvas->drawPath(SkPath::Polygon({{0, 0}, {10, 0}, {5, 8}}, true), paint);
+
+    SkTextBlobBuilder builder;
+    const auto& run = builder.allocRunPos(SkFont(), 3);
+    for (int i = 0; i < 3; i++) {
+        run.glyphs[i] = i + 1;
+        run.points()[i] = {10.0f * i, 20};
+    }
+    canvas->drawTextBlob(builder.make(), 0, 0, paint);
+}
+
+DEF_TEST(Recorder_InternPayloads, r) {
+    for (bool intern : {false, true}) {
+        SkRecord record;
+        SkRecorder recorder(&record, 100, 100);
+        recorder.setInternPayloads(intern);
+        draw_payloads(&recorder);
+        draw_payloads(&recorder);
+
+        auto path0 = assert_type<SkRecords::DrawPath>(r, record, 0),
+             path1 = assert_type<SkRecords::DrawPath>(r, record, 2);
+        REPORTER_ASSERT(r, path0->path == path1->path);
+        REPORTER_ASSERT(r, intern == (path0->path.getGenerationID() ==
+                                      path1->path.getGenerationID()));
+        REPORTER_ASSERT(r, intern == (path0->paint.getShader() == path1->paint.getShader()));
+
+        auto blob0 = assert_type<SkRecords::DrawTextBlob>(r, record, 1),
+             blob1 = assert_type<SkRecords::DrawTextBlob>(r, record, 3);
+        REPORTER_ASSERT(r, intern == (blob0->blob == blob1->blob));
+        REPORTER_ASSERT(r, intern == (blob0->paint.getShader() == blob1->paint.getShader()));
+        REPORTER_ASSERT(r, intern == (path0->paint.getShader() == blob1->paint.getShader()));
+    }
+}
+
+DEF_TEST(Recorder_InternPayloadsBytesUsed, r) {
+    auto savedBytes = [](bool intern, int draws) {
+        SkRecord record;
+        SkRecorder recorder(&record, 100, 100);
+        recorder.setInternPayloads(intern);
+        for (int i = 0; i < draws; i++) {
+            draw_payloads(&recorder);
+        }
+        return recorder.approxBytesSavedByInterning();
+    };
+    REPORTER_ASSERT(r, savedBytes(false, 100) == 0);
+    // One path and one text blob are kept, and each later one with the same contents is shared.
+    const size_t savedOnce = savedBytes(true, 2);
+    REPORTER_ASSERT(r, savedBytes(true, 1) == 0);
+    REPORTER_ASSERT(r, savedOnce > 0);
+    REPORTER_ASSERT(r, savedBytes(true, 100) == 99 * savedOnce,
+                    "%zu vs %zu", savedBytes(true, 100), savedOnce);
+
+    // Paths and text blobs aren't counted by the picture, so interning doesn't change its size.
+    size_t pictureBytes[2];
+    for (bool intern : {false, true}) {
+        SkPictureRecorder pictureRecorder;
+        SkCanvas* canvas = pictureRecorder.beginRecording(
+                SkRect::MakeWH(100, 100), nullptr,
+                intern ? SkPictureRecorder::kInternPayloads_RecordFlag : 0);
+        for (int i = 0; i < 100; i++) {
+            draw_payloads(canvas);
+        }
+        pictureBytes[intern] = pictureRecorder.finishRecordingAsPicture()->approximateBytesUsed();
+    }
+    REPORTER_ASSERT(r, pictureBytes[true] == pictureBytes[false],
+                    "%zu vs %zu", pictureBytes[true], pictureBytes[false]);
+
+    // Drawing the same path and text blob objects again is shared by reference even without
+    // interning, so it isn't counted as saved.
+    SkRecord record;
+    SkRecorder recorder(&record, 100, 100);
+    recorder.setInternPayloads(true);
+    const SkPath path = SkPath::Polygon({{0, 0}, {10, 0}, {5, 8}}, true);
+    SkTextBlobBuilder builder;
+    const auto& run = builder.allocRun(SkFont(), 3, 0, 20);
+    for (int i = 0; i < 3; i++) {
+        run.glyphs[i] = i + 1;
+    }
+    const sk_sp<SkTextBlob> blob = builder.make();
+    for (int i = 0; i < 100; i++) {
+        recorder.drawPath(path, SkPaint());
+        recorder.drawTextBlob(blob, 0, 0, SkPaint());
+    }
+    REPORTER_ASSERT(r, recorder.approxBytesSavedByInterning() == 0,
+                    "%zu", recorder.approxBytesSavedByInterning());
+}
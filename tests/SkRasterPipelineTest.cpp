@@ -5,7 +5,9 @@
  * found in the LICENSE file.
  */
 
+#include "include/core/SkExecutor.h"
 #include "include/private/base/SkTo.h"
+#include "modules/skcms/skcms.h"
 #include "src/base/SkHalf.h"
 #include "src/base/SkUtils.h"
 #include "src/core/SkOpts.h"
@@ -16,7 +18,9 @@
 #include "tests/Test.h"
 
 #include <cmath>
+#include <memory>
 #include <numeric>
+#include <vector>
 
 using namespace skia_private;
 
@@ -2928,6 +2932,33 @@ DEF_TEST(SkRasterPipeline_JIT, r) {
     }
 }
 
+DEF_TEST(SkRasterPipeline_runParallel, r) {
+    // Big enough to be split into several bands, and narrow enough to leave a tail on each row.
+    constexpr int kW = 333, kH = 600;
+    std::vector<uint32_t> src(kW * kH), serial(kW * kH), parallel(kW * kH);
+    std::iota(src.begin(), src.end(), 0x12345);
+
+    auto convert = [&](uint32_t* dst, SkExecutor* executor) {
+        SkRasterPipeline_MemoryCtx srcCtx = { src.data(), kW },
+                                   dstCtx = { dst, kW };
+        SkRasterPipeline_<256> p;
+        p.append(SkRasterPipelineOp::load_8888, &srcCtx);
+        p.append(SkRasterPipelineOp::swap_rb);
+        p.appendTransferFunction({2.2f, 1, 0, 0, 0, 0, 0});
+        p.append(SkRasterPipelineOp::store_8888, &dstCtx);
+        if (executor) {
+            p.runParallel(0,0, kW,kH, *executor);
+        } else {
+            p.run(0,0, kW,kH);
+        }
+    };
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    convert(serial.data(), nullptr);
+    convert(parallel.data(), executor.get());
+    REPORTER_ASSERT(r, serial == parallel);
+}
+
 static uint16_t h(float f) {
     // Remember, a float is 1-8-23 (sign-exponent-mantissa) with 127 exponent bias.
     uint32_t sem;
@@ -14,6 +14,8 @@
 #include "include/core/SkMatrix.h"
 #include "include/core/SkPicture.h"  // IWYU pragma: keep
 #include "include/core/SkPictureRecorder.h"
+#include "include/core/SkPixmap.h"
+#include "include/core/SkRect.h"
 #include "include/core/SkRefCnt.h"
 #include "include/core/SkSamplingOptions.h"
 #include "include/core/SkSize.h"
@@ -31,6 +33,7 @@
 #include <array>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <initializer_list>
 #include <memory>
 
@@ -124,6 +127,61 @@ static void test_mipmap_notify(skiatest::Reporter* reporter, SkResourceCache* ca
     }
 }
 
+static void test_mipmap_levels(skiatest::Reporter* reporter, SkResourceCache* cache) {
+    cache->purgeAll();
+
+    SkBitmap src;
+    src.allocN32Pixels(100, 60);
+    for (int y = 0; y < src.height(); ++y) {
+        for (int x = 0; x < src.width(); ++x) {
+            *src.getAddr32(x, y) = (x * 7 + y * 13) * 2654435761u;
+        }
+    }
+    src.setImmutable();
+    sk_sp<SkImage> img = src.asImage();
+    const auto desc = SkBitmapCacheDesc::Make(img.get());
+    sk_sp<SkMipmap> expected(SkMipmap::Build(src, nullptr));
+    REPORTER_ASSERT(reporter, expected && expected->countLevels() == 6);
+    REPORTER_ASSERT(reporter, SkMipmapCache::CachedLevels(desc, cache) == 0);
+
+    // Each level must match the one in a full mipmap, wherever it was built from.
+    auto check_level = [&](int index) {
+        SkPixmap level;
+        sk_sp<SkCachedData> data(
+                SkMipmapCache::FindOrBuildLevelAndRef(as_IB(img.get()), index, &level, cache));
+        REPORTER_ASSERT(reporter, data);
+        if (!data) {
+            return;
+        }
+        SkMipmap::Level expectedLevel;
+        SkAssertResult(expected->getLevel(index, &expectedLevel));
+        REPORTER_ASSERT(reporter, level.dimensions() == expectedLevel.fPixmap.dimensions());
+        for (int y = 0; y < level.height(); ++y) {
+            REPORTER_ASSERT(reporter, 0 == memcmp(level.addr(0, y),
+                                                  expectedLevel.fPixmap.addr(0, y),
+                                                  level.info().minRowBytes()),
+                            "level %d, row %d", index, y);
+        }
+    };
+
+    check_level(3);  // from the image
+    REPORTER_ASSERT(reporter, SkMipmapCache::CachedLevels(desc, cache) == 0b001000);
+    check_level(4);  // from level 3
+    check_level(1);  // from the image
+    check_level(2);  // from level 1
+    REPORTER_ASSERT(reporter, SkMipmapCache::CachedLevels(desc, cache) == 0b011110);
+    check_level(2);  // found
+    REPORTER_ASSERT(reporter, SkMipmapCache::CachedLevels(desc, cache) == 0b011110);
+
+    SkPixmap unused;
+    REPORTER_ASSERT(reporter, !SkMipmapCache::FindOrBuildLevelAndRef(as_IB(img.get()), 6,
+                                                                     &unused, cache));
+    REPORTER_ASSERT(reporter, !SkMipmapCache::FindAndRef(desc, cache));
+
+    cache->purgeAll();
+    REPORTER_ASSERT(reporter, SkMipmapCache::CachedLevels(desc, cache) == 0);
+}
+
 static SkDiscardableMemoryPool* gPool = nullptr;
 static int gFactoryCalls = 0;
 
@@ -137,6 +195,7 @@ static void testBitmapCache_discarded_bitmap(skiatest::Reporter* reporter, SkRes
                                              SkResourceCache::DiscardableFactory factory) {
     test_mipmapcache(reporter, cache);
     test_mipmap_notify(reporter, cache);
+    test_mipmap_levels(reporter, cache);
 }
 
 DEF_TEST(BitmapCache_discarded_bitmap, reporter) {
@@ -155,6 +214,30 @@ DEF_TEST(BitmapCache_discarded_bitmap, reporter) {
     REPORTER_ASSERT(reporter, gFactoryCalls > 0);
 }
 
+// Sampling a raster image with mipmaps only builds, and caches, the levels it samples.
+DEF_TEST(BitmapCache_mipmap_levels_on_demand, reporter) {
+    SkBitmap src;
+    src.allocN32Pixels(240, 240);
+    src.eraseColor(SK_ColorMAGENTA);
+    src.setImmutable();
+    sk_sp<SkImage> img = src.asImage();
+    const auto desc = SkBitmapCacheDesc::Make(img.get());
+
+    // A 1/12 scale samples level 3 (index 2) with kNearest.
+    auto surface(SkSurfaces::Raster(SkImageInfo::MakeN32Premul(20, 20)));
+    surface->getCanvas()->drawImageRect(img, SkRect::MakeWH(20, 20),
+                                        SkSamplingOptions(SkFilterMode::kLinear,
+                                                          SkMipmapMode::kNearest));
+
+    // Other threads may purge the global cache, but nothing should build the other levels.
+    REPORTER_ASSERT(reporter, (SkMipmapCache::CachedLevels(desc) & ~0b100) == 0);
+    REPORTER_ASSERT(reporter, !SkMipmapCache::FindAndRef(desc));
+
+    SkPixmap pixels;
+    REPORTER_ASSERT(reporter, surface->peekPixels(&pixels));
+    REPORTER_ASSERT(reporter, pixels.getColor(10, 10) == SK_ColorMAGENTA);
+}
+
 static void test_discarded_image(skiatest::Reporter* reporter, const SkMatrix& transform,
                                  sk_sp<SkImage> (*buildImage)()) {
     auto surface(SkSurfaces::Raster(SkImageInfo::MakeN32Premul(10, 10)));
@@ -151,6 +151,73 @@ DEF_TEST(SwizzleOpts, r) {
     REPORTER_ASSERT(r, dst == 0xFA04ADCA);
 }
 
+// The vectorized 16-bit, gray-alpha and palette swizzles should match a pixel at a time, at
+// widths that leave every length of tail.
+DEF_TEST(SwizzleOpts16, r) {
+    constexpr int kMaxWidth = 100;
+    uint8_t src[8 * kMaxWidth];
+    for (int i = 0; i < (int)sizeof(src); i++) {
+        src[i] = (uint8_t)(i * 131 + (i >> 3) * 7);
+    }
+    uint32_t table[256];
+    for (int i = 0; i < 256; i++) {
+        table[i] = 0x01010101u * (uint32_t)i ^ 0x5A3C0F00u;
+    }
+
+    auto pack = [](uint8_t r, uint8_t g, uint8_t b, uint8_t a) {
+        return (uint32_t)a << 24 | (uint32_t)b << 16 | (uint32_t)g << 8 | (uint32_t)r;
+    };
+    auto premul = [](uint8_t c, uint8_t a) { return (uint8_t)((c * a + 127) / 255); };
+
+    for (int width = 1; width <= kMaxWidth; width++) {
+        uint32_t dst[kMaxWidth];
+        uint8_t dst8[kMaxWidth];
+
+        SkOpts::RGB16_to_RGB1(dst, src, width);
+        for (int x = 0; x < width; x++) {
+            const uint8_t* p = src + 6*x;
+            REPORTER_ASSERT(r, dst[x] == pack(p[0], p[2], p[4], 0xFF), "RGB1 %d", width);
+        }
+        SkOpts::RGB16_to_BGR1(dst, src, width);
+        for (int x = 0; x < width; x++) {
+            const uint8_t* p = src + 6*x;
+            REPORTER_ASSERT(r, dst[x] == pack(p[4], p[2], p[0], 0xFF), "BGR1 %d", width);
+        }
+        SkOpts::RGBA16_to_RGBA(dst, src, width);
+        for (int x = 0; x < width; x++) {
+            const uint8_t* p = src + 8*x;
+            REPORTER_ASSERT(r, dst[x] == pack(p[0], p[2], p[4], p[6]), "RGBA %d", width);
+        }
+        SkOpts::RGBA16_to_BGRA(dst, src, width);
+        for (int x = 0; x < width; x++) {
+            const uint8_t* p = src + 8*x;
+            REPORTER_ASSERT(r, dst[x] == pack(p[4], p[2], p[0], p[6]), "BGRA %d", width);
+        }
+        SkOpts::RGBA16_to_rgbA(dst, src, width);
+        for (int x = 0; x < width; x++) {
+            const uint8_t* p = src + 8*x;
+            const uint8_t a = p[6];
+            REPORTER_ASSERT(r, dst[x] == pack(premul(p[0], a), premul(p[2], a),
+                                              premul(p[4], a), a), "rgbA %d", width);
+        }
+        SkOpts::RGBA16_to_bgrA(dst, src, width);
+        for (int x = 0; x < width; x++) {
+            const uint8_t* p = src + 8*x;
+            const uint8_t a = p[6];
+            REPORTER_ASSERT(r, dst[x] == pack(premul(p[4], a), premul(p[2], a),
+                                              premul(p[0], a), a), "bgrA %d", width);
+        }
+        SkOpts::grayA_to_A8(dst8, src, width);
+        for (int x = 0; x < width; x++) {
+            REPORTER_ASSERT(r, dst8[x] == src[2*x + 1], "A8 %d", width);
+        }
+        SkOpts::index_to_8888(dst, src, width, table);
+        for (int x = 0; x < width; x++) {
+            REPORTER_ASSERT(r, dst[x] == table[src[x]], "index %d", width);
+        }
+    }
+}
+
 DEF_TEST(PublicSwizzleOpts, r) {
     uint32_t dst, src;
 
@@ -40,6 +40,7 @@ CORE_TESTS = [
     "DrawBitmapRectTest.cpp",
     "DrawPathTest.cpp",
     "EmptyPathTest.cpp",
+    "ExecutorTest.cpp",
     "F16StagesTest.cpp",
     "FillPathTest.cpp",
     "FitsInTest.cpp",
@@ -65,6 +66,7 @@ CORE_TESTS = [
     "M44Test.cpp",
     "MD5Test.cpp",
     "MallocPixelRefTest.cpp",
+    "MaskBlurFilterTest.cpp",
     "MaskCacheTest.cpp",
     "MathTest.cpp",
     "MatrixProcsTest.cpp",
@@ -96,6 +98,8 @@ CORE_TESTS = [
     "RRectInPathTest.cpp",
     "RTreeTest.cpp",
     "RandomTest.cpp",
+    "RasterMultiThreadedTest.cpp",
+    "RasterPipelineBlitterTest.cpp",
     "ReadPixelsTest.cpp",
     "RecorderTest.cpp",
     "RecordingXfermodeTest.cpp",
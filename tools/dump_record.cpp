@@ -25,6 +25,9 @@
 static DEFINE_string2(skps, r, "", ".SKPs to dump.");
 static DEFINE_string(match, "", "The usual filters on file names to dump.");
 static DEFINE_bool2(optimize, O, false, "Run SkRecordOptimize before dumping.");
+static DEFINE_bool(occlusion, false,
+                   "With --optimize, also drop draws covered by later opaque draws.");
+static DEFINE_bool(batch, false, "With --optimize, also batch runs of DrawImageRects.");
 static DEFINE_int(tile, 1000000000, "Simulated tile size.");
 static DEFINE_bool(timeWithCommand, false,
                    "If true, print time next to command, else in first column.");
@@ -168,8 +171,18 @@ int main(int argc, char** argv) {
         SkRecorder rec(&record, w, h);
         src->playback(&rec);
 
+        SkRecordOptimizeStats stats;
+        int occluded = 0, batched = 0;
         if (FLAGS_optimize) {
-            SkRecordOptimize(&record);
+            if (FLAGS_occlusion) {
+                occluded = SkRecordNoopOccludedDraws(&record);
+            }
+            SkRecordOptimize(&record, &stats);
+            if (FLAGS_batch) {
+                // This must follow the SaveLayer passes, which only fold layers around one draw.
+                batched = SkRecordBatchImageRects(&record);
+                record.defrag();
+            }
         }
 
         SkBitmap bitmap;
@@ -179,6 +192,18 @@ int main(int argc, char** argv) {
                                        SkIntToScalar(FLAGS_tile)));
 
         printf("%s %s\n", FLAGS_optimize ? "optimized" : "not-optimized", FLAGS_skps[i]);
+        if (FLAGS_optimize) {
+            printf("  %d SaveLayer/Restores folded into their draw\n"
+                   "  %d SVG opacity layers merged\n"
+                   "  %d unused clips removed\n"
+                   "  %d DrawImageRects batched\n"
+                   "  %d occluded draws removed\n",
+                   stats.noopSaveLayerDrawRestores,
+                   stats.mergedSvgOpacityAndFilterLayers,
+                   stats.noopUnusedClips,
+                   batched,
+                   occluded);
+        }
 
         Dumper dumper(&canvas, record.count());
         for (int j = 0; j < record.count(); j++) {